@@ -1,11 +1,378 @@
-#ifdef EVM_H
+#ifndef EVM_H
 #define EVM_H
 
 #include <evmc/evmc.h>
 #include <evmc/utils.h>
 
-#if __cpplusplus
+#ifdef __cplusplus
 extern "C" {
-    #endif
-    EVM_EXPORT struct evm_vm* evmc_create_evmone(void) EVMC_NOEXCEPT;
-}
\ No newline at end of file
+#endif
+
+/**
+ * Returns the storage value of the given account at the beginning of the current transaction.
+ */
+typedef evmc_bytes32 (*evm_get_original_storage_fn)(struct evmc_host_context* context,
+    const evmc_address* address, const evmc_bytes32* key);
+
+/**
+ * Hints the host that the given storage keys of the account are likely to be read soon.
+ * The host may load them asynchronously; the results are still queried with get_storage.
+ */
+typedef void (*evm_prefetch_storage_fn)(struct evmc_host_context* context,
+    const evmc_address* address, const evmc_bytes32* keys, size_t num_keys);
+
+/**
+ * Prepares a nested message for execution by the VM itself.
+ *
+ * The host takes a state snapshot and applies the message prologue (value transfer and, for
+ * CREATE/CREATE2, the new account with msg->recipient set to its address). It returns the
+ * code to execute, valid until the matching evm_leave_call_fn. Returns false if the message
+ * must be passed to evmc_host_interface::call() instead, e.g. for precompiles.
+ */
+typedef bool (*evm_enter_call_fn)(struct evmc_host_context* context, struct evmc_message* msg,
+    int32_t* snapshot, const uint8_t** code, size_t* code_size);
+
+/**
+ * Completes a nested message started with evm_enter_call_fn.
+ *
+ * The host reverts to the snapshot if the result is not a success and, for CREATE/CREATE2,
+ * deposits the code and updates the result accordingly.
+ */
+typedef void (*evm_leave_call_fn)(
+    struct evmc_host_context* context, int32_t snapshot, struct evmc_result* result);
+
+/**
+ * A 256-bit word as four 64-bit words in native byte order, the least significant first.
+ */
+typedef struct evm_word
+{
+    uint64_t words[4];
+} evm_word;
+
+/** evmc_get_storage_fn with the key and the value passed as native words. */
+typedef evm_word (*evm_get_storage_word_fn)(
+    struct evmc_host_context* context, const evmc_address* address, const evm_word* key);
+
+/** evmc_set_storage_fn with the key and the value passed as native words. */
+typedef enum evmc_storage_status (*evm_set_storage_word_fn)(struct evmc_host_context* context,
+    const evmc_address* address, const evm_word* key, const evm_word* value);
+
+/** evmc_get_balance_fn with the balance returned as a native word. */
+typedef evm_word (*evm_get_balance_word_fn)(
+    struct evmc_host_context* context, const evmc_address* address);
+
+/** evmc_emit_log_fn with the topics passed as native words. */
+typedef void (*evm_emit_log_words_fn)(struct evmc_host_context* context,
+    const evmc_address* address, const uint8_t* data, size_t data_size, const evm_word topics[],
+    size_t topics_count);
+
+/** A log record emitted by an account. */
+struct evm_log
+{
+    evmc_address address;
+    const uint8_t* data;
+    size_t data_size;
+    const evmc_bytes32* topics;
+    size_t num_topics;
+};
+
+/**
+ * Receives all logs of a successful transaction, in order of emission.
+ * The records are valid only during the call.
+ */
+typedef void (*evm_emit_logs_fn)(
+    struct evmc_host_context* context, const struct evm_log* logs, size_t num_logs);
+
+/** The kind of a state item requested with evm_request_state_fn. */
+enum evm_state_kind
+{
+    EVM_STATE_STORAGE = 0, /**< A storage slot. */
+    EVM_STATE_BALANCE = 1, /**< The balance of an account. */
+    EVM_STATE_CODE = 2     /**< The code, code size or code hash of an account. */
+};
+
+/**
+ * Checks that a state item can be accessed without blocking, before the VM reads it.
+ *
+ * Returns false if the host does not have the item: the host starts loading it and the
+ * execution is suspended until the next evm_run_execution(). key is NULL unless the kind is
+ * EVM_STATE_STORAGE.
+ */
+typedef bool (*evm_request_state_fn)(struct evmc_host_context* context, enum evm_state_kind kind,
+    const evmc_address* address, const evmc_bytes32* key);
+
+/** A storage key of an account. */
+struct evm_storage_key
+{
+    evmc_address address;
+    evmc_bytes32 key;
+};
+
+/**
+ * Optional host extensions.
+ *
+ * Installed once per VM instance with evm_set_host_extensions(). Any member may be NULL;
+ * a feature depending on a missing member cannot be enabled with evmc_set_option().
+ * The context passed to the callbacks is the one passed to evmc_vm::execute().
+ */
+struct evm_host_extensions
+{
+    /** Required by the "storage_journal" option. */
+    evm_get_original_storage_fn get_original_storage;
+
+    /** Required by the "prefetch" option, available with the "advanced" interpreter only. */
+    evm_prefetch_storage_fn prefetch_storage;
+
+    /** Required by the "call_frames" option. */
+    evm_enter_call_fn enter_call;
+    evm_leave_call_fn leave_call;
+
+    /** Required by the "native_words" option. */
+    evm_get_storage_word_fn get_storage_word;
+    evm_set_storage_word_fn set_storage_word;
+    evm_get_balance_word_fn get_balance_word;
+    evm_emit_log_words_fn emit_log_words;
+
+    /** Required by the "log_batching" option. */
+    evm_emit_logs_fn emit_logs;
+
+    /** Required by evm_create_execution(). */
+    evm_request_state_fn request_state;
+};
+
+/**
+ * Creates a VM instance.
+ *
+ * With the "unmetered" option, meant for trusted simulations, the baseline interpreter does
+ * not account for gas: neither the base nor the dynamic costs of instructions are computed,
+ * and no refunds are given. The gas of a frame is instead its budget of loop iterations:
+ * each JUMPDEST uses 1, nested calls and creations get the whole budget left and return what
+ * they have not used, whatever their status, and precompiles use their gas cost. The memory of
+ * each frame is limited to 16 MiB. The stack limits are kept. GAS reports the budget left.
+ */
+EVMC_EXPORT struct evmc_vm* evmc_create_evm(void) EVMC_NOEXCEPT;
+
+/**
+ * Installs the host extensions table. The table must outlive the VM instance.
+ */
+EVMC_EXPORT void evm_set_host_extensions(
+    struct evmc_vm* vm, const struct evm_host_extensions* extensions) EVMC_NOEXCEPT;
+
+/**
+ * Returns the accounts accessed by the last pre-execution, in order of first access.
+ *
+ * Pre-execution is enabled with the "preexecution" option set to the maximum number of
+ * recorded accounts and storage keys. In this mode executions do not pass any state changes
+ * to the host and end with EVMC_REJECTED once the limit is reached. Nested calls are executed
+ * by the VM itself, without value transfers and without the "call_frames" host extensions;
+ * creations are not executed and end as reverted. The returned array is valid until the next
+ * execution.
+ */
+EVMC_EXPORT size_t evm_get_preexecution_accounts(
+    struct evmc_vm* vm, const evmc_address** accounts) EVMC_NOEXCEPT;
+
+/**
+ * Returns the storage keys accessed by the last pre-execution, in order of first access.
+ */
+EVMC_EXPORT size_t evm_get_preexecution_storage_keys(
+    struct evmc_vm* vm, const struct evm_storage_key** keys) EVMC_NOEXCEPT;
+
+/**
+ * Returns the minimum gas limit of the last execution for the same result, or -1.
+ *
+ * Gas estimation is enabled with the "gas_estimation" option. The message is then executed
+ * once with a gas limit high enough not to run out of gas, e.g. the block gas limit, instead
+ * of being executed repeatedly in a binary search. The estimate covers the gas used and the
+ * gas left required by the SSTORE stipend check and by nested calls under the 63/64 rule,
+ * and the code deposit of creations, but not the intrinsic gas of the transaction. Code using
+ * the value of GAS other than as the gas of a call is assumed to behave the same with less
+ * gas. For a failed execution the estimate is the gas limit. A failed nested call is costed at
+ * all the gas given to it, so catching the failure of a call given all the gas left, e.g. an
+ * INVALID or out of gas callee, brings the estimate close to the gas limit.
+ */
+EVMC_EXPORT int64_t evm_get_gas_estimate(struct evmc_vm* vm) EVMC_NOEXCEPT;
+
+/**
+ * Installs the block context shared by all executions until the next call.
+ *
+ * Only the block_* members and chain_id are used. The transaction context must be installed
+ * with evm_set_tx_context() after each call. NULL removes the shared context and the VM
+ * falls back to evmc_host_interface::get_tx_context().
+ */
+EVMC_EXPORT void evm_set_block_context(
+    struct evmc_vm* vm, const struct evmc_tx_context* block) EVMC_NOEXCEPT;
+
+/**
+ * Installs the transaction context shared by all executions of the transaction.
+ *
+ * Only the tx_* members are used. NULL removes the transaction context, e.g. after the
+ * transaction, and the VM falls back to evmc_host_interface::get_tx_context() until the next
+ * call. The shared context is used only while both parts are installed.
+ */
+EVMC_EXPORT void evm_set_tx_context(
+    struct evmc_vm* vm, const struct evmc_tx_context* tx) EVMC_NOEXCEPT;
+
+/**
+ * The status of a frame ended by a cancellation token or a deadline.
+ *
+ * Like other failures, the frame's state changes are reverted and no gas is left. The callers
+ * of the frame end with it too, as soon as the call returns.
+ */
+#define EVM_CANCELLED ((enum evmc_status_code)-100)
+
+/** A flag cancelling the executions watching it, which can be set from any thread. */
+struct evm_cancellation_token;
+
+EVMC_EXPORT struct evm_cancellation_token* evm_create_cancellation_token(void) EVMC_NOEXCEPT;
+
+/** Cancels the executions watching the token. The token stays cancelled. */
+EVMC_EXPORT void evm_cancel(struct evm_cancellation_token* token) EVMC_NOEXCEPT;
+
+EVMC_EXPORT void evm_destroy_cancellation_token(
+    struct evm_cancellation_token* token) EVMC_NOEXCEPT;
+
+/**
+ * Installs the cancellation of the executions started until the next call.
+ *
+ * The executions end with EVM_CANCELLED once the token is cancelled or timeout_ns
+ * nanoseconds after this call. Both are checked only at basic block entries and after
+ * precompiles, so straight-line code and host callbacks are not interrupted. token may be
+ * NULL and timeout_ns 0 for none. The token must outlive the executions.
+ *
+ * Executions already started, including resumable executions (from their creation) and
+ * batches, keep the cancellation installed when they started, also in their nested calls.
+ * This must not be called concurrently with the start of an execution of the VM.
+ */
+EVMC_EXPORT void evm_set_cancellation(struct evmc_vm* vm,
+    const struct evm_cancellation_token* token, uint64_t timeout_ns) EVMC_NOEXCEPT;
+
+/** A message of a batch and the code to execute. */
+struct evm_batch_message
+{
+    const struct evmc_message* msg;
+    const uint8_t* code;
+    size_t code_size;
+};
+
+/** Statistics of a batch execution. */
+struct evm_batch_stats
+{
+    /** The wall-clock time of the batch in nanoseconds. */
+    uint64_t elapsed_ns;
+
+    /** The gas used by all messages. */
+    int64_t gas_used;
+
+    /** The number of worker threads, including the calling thread. */
+    uint32_t num_threads;
+
+    /** The number of code analyses, one per distinct code pointer. */
+    uint32_t num_analyses;
+
+    /** The number of ranges of messages stolen by idle workers. */
+    uint64_t num_steals;
+};
+
+/**
+ * Executes independent messages concurrently with the baseline interpreter.
+ *
+ * The messages share the host context, which must serve concurrent callbacks from an
+ * immutable snapshot, e.g. for eth_call requests against one block; state changes requested
+ * by a message must not be visible to the others. Messages with the same code pointer share
+ * one code analysis. The results are stored in results[i] and must be released by the caller.
+ * stats may be NULL. Batches may run concurrently on one VM.
+ *
+ * Returns false without executing anything if a transaction-scoped feature
+ * (storage_journal, access_tracking, log_batching, preexecution, gas_estimation, tracing)
+ * is enabled.
+ */
+EVMC_EXPORT bool evm_execute_batch(struct evmc_vm* vm, const struct evmc_host_interface* host,
+    struct evmc_host_context* context, enum evmc_revision rev,
+    const struct evm_batch_message* messages, size_t num_messages, size_t num_threads,
+    struct evmc_result* results, struct evm_batch_stats* stats) EVMC_NOEXCEPT;
+
+/** A secp256k1 ECDSA signature of a message hash, e.g. of a transaction. */
+struct evm_ecdsa_signature
+{
+    evmc_bytes32 hash;
+    evmc_bytes32 r;
+    evmc_bytes32 s;
+
+    /**
+     * The parity of the y coordinate of the point R, 0 or 1. Other values, e.g. a legacy v of
+     * 27 or 28, make the signature invalid.
+     */
+    uint8_t y_parity;
+};
+
+/**
+ * Recovers the signer addresses of the signatures concurrently, e.g. the senders of the
+ * transactions of a block during import.
+ *
+ * addresses[i] is set to the signer of signatures[i], or to the zero address if the signature
+ * is invalid. The upper bound of s of EIP-2 is left to the caller. num_threads 0 runs one
+ * worker per hardware thread, the calling thread being one of them.
+ *
+ * Returns the number of valid signatures.
+ */
+EVMC_EXPORT size_t evm_ecrecover_batch(const struct evm_ecdsa_signature* signatures,
+    size_t num_signatures, size_t num_threads, evmc_address* addresses) EVMC_NOEXCEPT;
+
+/** An execution which can be suspended and resumed. */
+struct evm_execution;
+
+/** The state of an execution after evm_run_execution(). */
+enum evm_execution_status
+{
+    EVM_EXECUTION_DONE = 0,      /**< The execution has ended. */
+    EVM_EXECUTION_PENDING = 1,   /**< Suspended until the requested state item is loaded. */
+    EVM_EXECUTION_PREEMPTED = 2  /**< Suspended after its gas slice, can be resumed any time. */
+};
+
+/**
+ * Creates a resumable execution of the message with the baseline interpreter.
+ *
+ * If the request_state host extension is installed, the execution is suspended on state items
+ * the host does not have (see evm_request_state_fn), so that one thread can interleave many
+ * executions while their loads are outstanding. With a gas slice set by
+ * evm_set_execution_slice(), which requires the "call_frames" option, it is also preempted at
+ * basic block boundaries, so that long executions can be scheduled fairly with short ones.
+ * Nested calls are suspendable too if the "call_frames" option is enabled, otherwise they are
+ * executed synchronously by evmc_host_interface::call(). An execution may be resumed on any
+ * thread, but not concurrently with another execution of the same VM. The message and the code
+ * must outlive the execution.
+ *
+ * Returns NULL if a transaction-scoped feature (storage_journal, access_tracking,
+ * log_batching, preexecution, gas_estimation, tracing) is enabled.
+ */
+EVMC_EXPORT struct evm_execution* evm_create_execution(struct evmc_vm* vm,
+    const struct evmc_host_interface* host, struct evmc_host_context* context,
+    enum evmc_revision rev, const struct evmc_message* msg, const uint8_t* code,
+    size_t code_size) EVMC_NOEXCEPT;
+
+/**
+ * Sets the gas a frame may use before it is preempted at the next JUMPDEST; 0, the default,
+ * disables preemption. The slice is counted from each start or resumption of a frame.
+ *
+ * Returns false and leaves the slice unchanged if the "call_frames" option is disabled:
+ * nested calls executed by the host could not be preempted.
+ */
+EVMC_EXPORT bool evm_set_execution_slice(
+    struct evm_execution* execution, int64_t gas_slice) EVMC_NOEXCEPT;
+
+/**
+ * Runs the execution until it ends or is suspended.
+ *
+ * When it ends, the result is stored in *result. Otherwise the function must be called again,
+ * for EVM_EXECUTION_PENDING once the requested item is loaded.
+ */
+EVMC_EXPORT enum evm_execution_status evm_run_execution(
+    struct evm_execution* execution, struct evmc_result* result) EVMC_NOEXCEPT;
+
+EVMC_EXPORT void evm_destroy_execution(struct evm_execution* execution) EVMC_NOEXCEPT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
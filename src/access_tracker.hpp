@@ -0,0 +1,75 @@
+#pragma once
+
+#include "hash_set.hpp"
+#include <evmc/evmc.hpp>
+#include <vector>
+
+namespace evm
+{
+/// Transaction-scoped EIP-2929 accessed addresses and storage keys.
+///
+/// The host is consulted only on the first access of an item in the transaction
+/// (it may report it as warm, e.g. for access list entries); later accesses are decided
+/// locally. Frames record a checkpoint on entry and drop their accesses on failure,
+/// matching the host reverting its own access sets.
+class AccessTracker
+{
+    FlatHashSet<evmc::address, AddressHash> m_accounts;
+    FlatHashSet<StorageKey, StorageKeyHash> m_slots;
+    std::vector<evmc::address> m_accounts_log;
+    std::vector<StorageKey> m_slots_log;
+
+public:
+    struct Checkpoint
+    {
+        size_t accounts = 0;
+        size_t slots = 0;
+    };
+
+    [[nodiscard]] Checkpoint checkpoint() const noexcept
+    {
+        return {m_accounts_log.size(), m_slots_log.size()};
+    }
+
+    void rollback(const Checkpoint& checkpoint) noexcept
+    {
+        while (m_accounts_log.size() > checkpoint.accounts)
+        {
+            m_accounts.erase(m_accounts_log.back());
+            m_accounts_log.pop_back();
+        }
+        while (m_slots_log.size() > checkpoint.slots)
+        {
+            m_slots.erase(m_slots_log.back());
+            m_slots_log.pop_back();
+        }
+    }
+
+    template <typename Host>
+    evmc_access_status access_account(Host& host, const evmc::address& addr) noexcept
+    {
+        if (!m_accounts.insert(addr))
+            return EVMC_ACCESS_WARM;
+        m_accounts_log.push_back(addr);
+        return host.access_account(addr);
+    }
+
+    template <typename Host>
+    evmc_access_status access_storage(
+        Host& host, const evmc::address& addr, const evmc::bytes32& key) noexcept
+    {
+        if (!m_slots.insert({addr, key}))
+            return EVMC_ACCESS_WARM;
+        m_slots_log.push_back({addr, key});
+        return host.access_storage(addr, key);
+    }
+
+    void clear() noexcept
+    {
+        m_accounts.clear();
+        m_slots.clear();
+        m_accounts_log.clear();
+        m_slots_log.clear();
+    }
+};
+}  // namespace evm
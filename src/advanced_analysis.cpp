@@ -1,5 +1,6 @@
 #include "advanced_analysis.hpp"
 #include "opcodes_helpers.h"
+#include <algorithm>
 #include <cassert>
 
 namespace evm::advanced
@@ -28,6 +29,62 @@ struct BlockAnalysis
     }
 };
 
+namespace
+{
+/// The minimal number of selector checks worth replacing with a hash table lookup.
+constexpr size_t min_selector_dispatch_size = 4;
+
+/// Finds chains of blocks consisting of DUP1 PUSH sel EQ PUSH dest JUMPI, each starting
+/// right after a JUMPI or with a JUMPDEST, and installs the selector lookup at their beginning.
+void analyze_selector_dispatches(AdvancedCodeAnalysis& analysis, const OpTable& op_tbl) noexcept
+{
+    auto& instrs = analysis.instrs;
+    const auto is_check = [&](size_t i) noexcept {
+        return i + 5 <= instrs.size() && instrs[i].fn == op_tbl[OP_DUP1].fn &&
+               instrs[i + 1].fn == op_tbl[OP_PUSH1].fn &&
+               instrs[i + 1].arg.small_push_value <= std::numeric_limits<uint32_t>::max() &&
+               instrs[i + 2].fn == op_tbl[OP_EQ].fn && instrs[i + 3].fn == op_tbl[OP_PUSH1].fn &&
+               instrs[i + 4].fn == op_tbl[OP_JUMPI].fn;
+    };
+
+    for (size_t begin = 0; begin < instrs.size(); ++begin)
+    {
+        const auto begin_fn = instrs[begin].fn;
+        if (begin_fn != op_tbl[OPX_BEGINBLOCK].fn && begin_fn != op_tbl[OP_JUMPI].fn)
+            continue;
+
+        const auto& block = instrs[begin].arg.block;
+        SelectorDispatch dispatch{static_cast<int32_t>(begin), 0, 0, {}};
+        auto end = begin;
+        for (auto i = begin + 1; is_check(i); i += 5)
+        {
+            const auto& check_block = instrs[i - 1].arg.block;
+            const auto dest = instrs[i + 3].arg.small_push_value;
+            const auto target = dest <= std::numeric_limits<int>::max() ?
+                                    find_jumpdest(analysis, static_cast<int>(dest)) :
+                                    -1;
+            if (target < 0 || check_block.stack_req != block.stack_req ||
+                check_block.stack_max_growth != block.stack_max_growth)
+                break;
+
+            dispatch.gas_cost += check_block.gas_cost;
+            const auto selector = static_cast<uint32_t>(instrs[i + 1].arg.small_push_value);
+            dispatch.targets.try_emplace(
+                selector, SelectorDispatch::Target{target, dispatch.gas_cost});
+            end = i + 4;
+        }
+        if (dispatch.targets.size() < min_selector_dispatch_size)
+            continue;
+
+        dispatch.end = static_cast<int32_t>(end);
+        instrs[begin].fn =
+            (begin_fn == op_tbl[OP_JUMPI].fn) ? op_jumpi_dispatch_selector : opx_dispatch_selector;
+        analysis.selector_dispatches.emplace_back(std::move(dispatch));
+        begin = end - 1;
+    }
+}
+}  // namespace
+
 AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
 {
     const auto& op_tbl = get_op_table(rev);
@@ -43,11 +100,18 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
     const auto code_begin = code.data();
     const auto code_end = code_begin + code.size();
     auto code_pos = code_begin;
+    std::vector<intx::uint256> storage_keys;
+    const intx::uint256* prev_push_value = nullptr;
+    intx::uint256 small_push_value;
     while (code_pos != code_end)
     {
         const auto opcode = *code_pos++;
         const auto& opcode_info = op_tbl[opcode];
 
+        if (opcode == OP_SLOAD && prev_push_value != nullptr)
+            storage_keys.emplace_back(*prev_push_value);
+        prev_push_value = nullptr;
+
         if (opcode == OP_JUMPDEST)
         {
             analysis.instrs[block.begin_block_index].arg.block = block.close();
@@ -108,6 +172,8 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
                 insert_bit_pos -= 8;
             }
             instr.arg.small_push_value = value;
+            small_push_value = value;
+            prev_push_value = &small_push_value;
             break;
         }
 
@@ -122,14 +188,20 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
                 *insert_pos-- = *code_pos++;
 
             instr.arg.push_value = &push_value;
+            prev_push_value = &push_value;
             break;
         }
 
-        case OP_GAS:
         case OP_CALL:
         case OP_CALLCODE:
         case OP_DELEGATECALL:
         case OP_STATICCALL:
+            analysis.call_site_indices.emplace_back(
+                static_cast<int32_t>(analysis.instrs.size() - 1));
+            instr.arg.number = block.gas_cost;
+            break;
+
+        case OP_GAS:
         case OP_CREATE:
         case OP_CREATE2:
         case OP_SSTORE:
@@ -139,6 +211,11 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
         case OP_PC:
             instr.arg.number = code_pos - code_begin - 1;
             break;
+
+        case OP_PUSH0:
+            small_push_value = 0;
+            prev_push_value = &small_push_value;
+            break;
         }
     }
 
@@ -147,6 +224,16 @@ AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept
     assert(analysis.instrs.size() <= max_instrs_size);
     assert(analysis.push_values.size() <= max_args_storage_size);
 
+    analyze_selector_dispatches(analysis, op_tbl);
+    analysis.call_site_caches = std::make_unique<CallSiteCache<AdvancedCodeAnalysis>[]>(
+        analysis.call_site_indices.size());
+
+    std::sort(storage_keys.begin(), storage_keys.end());
+    storage_keys.erase(std::unique(storage_keys.begin(), storage_keys.end()), storage_keys.end());
+    analysis.storage_keys.reserve(storage_keys.size());
+    for (const auto& key : storage_keys)
+        analysis.storage_keys.emplace_back(intx::be::store<evmc::bytes32>(key));
+
     return analysis;
 }
 }
\ No newline at end of file
@@ -1,12 +1,16 @@
 #pragma once
 
+#include "call_site_cache.hpp"
 #include "execution_state.hpp"
 #include <evmc/evmc.hpp>
 #include <evmc/instructions.h>
 #include <evmc/utils.h>
 #include <intx/intx.hpp>
 #include <array>
+#include <cassert>
 #include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace evm::advanced
@@ -113,12 +117,37 @@ struct Instruction
     explicit constexpr Instruction(instruction_exec_fn f) noexcept : fn{f}, arg{} {}
 };
 
+/// A chain of Solidity selector checks (DUP1 PUSH sel EQ PUSH dest JUMPI), one per block.
+struct SelectorDispatch
+{
+    struct Target
+    {
+        int32_t instr_index;  ///< The index of the JUMPDEST instruction jumped to.
+        int64_t gas_cost;     ///< The cost of the chain up to and including the matching check.
+    };
+
+    int32_t begin;     ///< The index of the instruction beginning the first block of the chain.
+    int32_t end;       ///< The index of the last JUMPI of the chain.
+    int64_t gas_cost;  ///< The cost of the whole chain.
+    std::unordered_map<uint32_t, Target> targets;
+};
+
 struct AdvancedCodeAnalysis
 {
     std::vector<Instruction> instrs;
     std::vector<intx::uint256> push_values;
     std::vector<int32_t> jumpdest_offsets;
     std::vector<int32_t> jumpdest_targets;
+
+    /// Constant keys of SLOADs directly preceded by a PUSH (sorted, unique).
+    std::vector<evmc::bytes32> storage_keys;
+
+    /// Selector dispatch chains (sorted by begin).
+    std::vector<SelectorDispatch> selector_dispatches;
+
+    /// The indices of the CALL* instructions (sorted) and the caches of their callees.
+    std::vector<int32_t> call_site_indices;
+    std::unique_ptr<CallSiteCache<AdvancedCodeAnalysis>[]> call_site_caches;
 };
 
 inline int find_jumpdest(const AdvancedCodeAnalysis& analysis, int offset) noexcept
@@ -130,6 +159,35 @@ inline int find_jumpdest(const AdvancedCodeAnalysis& analysis, int offset) noexc
                analysis.jumpdest_targets[static_cast<size_t>(it - begin)] :
                -1;
 }
+
+inline const CallSiteCache<AdvancedCodeAnalysis>& find_call_site(
+    const AdvancedCodeAnalysis& analysis, int32_t index) noexcept
+{
+    const auto begin = std::begin(analysis.call_site_indices);
+    const auto end = std::end(analysis.call_site_indices);
+    const auto it = std::lower_bound(begin, end, index);
+    assert(it != end && *it == index);
+    return analysis.call_site_caches[static_cast<size_t>(it - begin)];
+}
+
+inline const SelectorDispatch& find_selector_dispatch(
+    const AdvancedCodeAnalysis& analysis, int32_t begin) noexcept
+{
+    const auto it = std::lower_bound(std::begin(analysis.selector_dispatches),
+        std::end(analysis.selector_dispatches), begin,
+        [](const SelectorDispatch& d, int32_t index) noexcept { return d.begin < index; });
+    assert(it != std::end(analysis.selector_dispatches) && it->begin == begin);
+    return *it;
+}
+
+/// Replaces the OPX_BEGINBLOCK starting a selector dispatch chain.
+const Instruction* opx_dispatch_selector(
+    const Instruction* instr, AdvancedExecutionState& state) noexcept;
+
+/// Replaces the JUMPI whose fall-through block starts a selector dispatch chain.
+const Instruction* op_jumpi_dispatch_selector(
+    const Instruction* instr, AdvancedExecutionState& state) noexcept;
+
 EVMC_EXPORT AdvancedCodeAnalysis analyze(evmc_revision rev, bytes_view code) noexcept;
 EVMC_EXPORT const OpTable& get_op_table(evmc_revision rev) noexcept;
 
@@ -1,6 +1,7 @@
 #include "advanced_execution.hpp"
 #include "advanced_analysis.hpp"
 #include "eof.hpp"
+#include "vm.hpp"
 #include <memory>
 
 namespace evm::advanced
@@ -22,24 +23,49 @@ evmc_result execute(AdvancedExecutionState& state, const AdvancedCodeAnalysis& a
         state.memory.data() + state.output_offset, state.output_size);
 }
 
-evmc_result execute(evmc_vm* /*unused*/, const evmc_host_interface* host, evmc_host_context* ctx,
+namespace
+{
+AdvancedCodeAnalysis analyze_container(evmc_revision rev, bytes_view container) noexcept
+{
+    if (rev >= EVMC_SHANGHAI && is_eof_code(container))
+    {
+        const auto eof1_header = read_valid_eof1_header(container.begin());
+        return analyze(rev, {&container[eof1_header.code_begin()], eof1_header.code_size});
+    }
+    return analyze(rev, container);
+}
+}  // namespace
+
+evmc_result execute(evmc_vm* c_vm, const evmc_host_interface* host, evmc_host_context* ctx,
     evmc_revision rev, const evmc_message* msg, const uint8_t* code, size_t code_size) noexcept
 {
-    AdvancedCodeAnalysis analysis;
     const bytes_view container = {code, code_size};
-    if (is_eof_code(container))
+    if (is_eof_code(container) && rev < EVMC_SHANGHAI)
+        return evmc::make_result(EVMC_UNDEFINED_INSTRUCTION, 0, 0, nullptr, 0);
+
+    // The callee of a call made by the host takes its analysis from the call site cache.
+    const AdvancedCodeAnalysis* cached_analysis = nullptr;
+    if (const auto* call_site = take_host_call_site<AdvancedCodeAnalysis>(*msg);
+        call_site != nullptr)
     {
-        if (rev >= EVMC_SHANGHAI)
-        {
-            const auto eof1_header = read_valid_eof1_header(container.begin());
-            analysis = analyze(rev, {&container[eof1_header.code_begin()], eof1_header.code_size});
-        }
-        else
-            return evmc::make_result(EVMC_UNDEFINED_INSTRUCTION, 0, 0, nullptr, 0);
+        cached_analysis =
+            call_site->get(evmc::HostContext{*host, ctx}, rev, *msg, container, analyze_container);
     }
-    else
-        analysis = analyze(rev, container);
+    AdvancedCodeAnalysis local_analysis;
+    if (cached_analysis == nullptr)
+        local_analysis = analyze_container(rev, container);
+    const auto& analysis = cached_analysis != nullptr ? *cached_analysis : local_analysis;
+
+    const auto& vm = *static_cast<VM*>(c_vm);
     auto state = std::make_unique<AdvancedExecutionState>(*msg, rev, *host, ctx, container);
-    return execute(*state, analysis);
+    vm.begin_frame(*state, ctx);
+    if (vm.prefetch && !analysis.storage_keys.empty())
+    {
+        state->host_ext.prefetch_storage(
+            msg->recipient, analysis.storage_keys.data(), analysis.storage_keys.size());
+    }
+    const auto result = execute(*state, analysis);
+    vm.end_frame(*state, result.status_code);
+    return result;
 }
 }
\ No newline at end of file
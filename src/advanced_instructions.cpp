@@ -100,6 +100,9 @@ const Instruction* opx_beginblock(const Instruction* instr, AdvancedExecutionSta
 {
     auto& block = instr->arg.block;
 
+    if (INTX_UNLIKELY(state.cancellable) && state.is_cancelled())
+        return state.exit(EVM_CANCELLED);
+
     if ((state.gas_left -= block.gas_cost) < 0)
         return state.exit(EVMC_OUT_OF_GAS);
 
@@ -172,7 +175,15 @@ const Instruction* op_call(const Instruction* instr, AdvancedExecutionState& sta
     const auto gas_left_correction = state.current_block_cost - instr->arg.number;
     state.gas_left += gas_left_correction;
 
-    const auto status = instr::impl<Op>(state);
+    const auto& analysis = *state.analysis.advanced;
+    const auto index = static_cast<int32_t>(instr - analysis.instrs.data());
+    evmc_status_code status = EVMC_SUCCESS;
+    {
+        // The callee executed by the host takes its analysis from the call site cache.
+        const HostCallSiteScope<AdvancedCodeAnalysis> call_site{
+            &find_call_site(analysis, index), state.msg->depth + 1};
+        status = instr::impl<Op>(state);
+    }
     if (status != EVMC_SUCCESS)
         return state.exit(status);
 
@@ -231,6 +242,51 @@ constexpr std::array<instruction_exec_fn, 256> instruction_implementations = [](
 }();
 }
 
+const Instruction* opx_dispatch_selector(
+    const Instruction* instr, AdvancedExecutionState& state) noexcept
+{
+    const auto& analysis = *state.analysis.advanced;
+    const auto& dispatch =
+        find_selector_dispatch(analysis, static_cast<int32_t>(instr - analysis.instrs.data()));
+
+    // All blocks of the chain have the same stack requirements and do not change the stack.
+    // Failures are left to the regular execution of the chain.
+    const auto& block = instr->arg.block;
+    const auto stack_size = static_cast<int>(state.stack.size());
+    if (stack_size < block.stack_req || stack_size + block.stack_max_growth > StackSpace::limit)
+        return opx_beginblock(instr, state);
+
+    const SelectorDispatch::Target* target = nullptr;
+    if (const auto& selector = state.stack.top(); selector <= std::numeric_limits<uint32_t>::max())
+    {
+        if (const auto it = dispatch.targets.find(static_cast<uint32_t>(selector));
+            it != dispatch.targets.end())
+            target = &it->second;
+    }
+
+    const auto gas_cost = target != nullptr ? target->gas_cost : dispatch.gas_cost;
+    if (state.gas_left < gas_cost)
+        return opx_beginblock(instr, state);
+    state.gas_left -= gas_cost;
+
+    if (target != nullptr)
+        return &analysis.instrs[static_cast<size_t>(target->instr_index)];
+
+    // Continue with the block following the last JUMPI of the chain.
+    return opx_beginblock(&analysis.instrs[static_cast<size_t>(dispatch.end)], state);
+}
+
+const Instruction* op_jumpi_dispatch_selector(
+    const Instruction* instr, AdvancedExecutionState& state) noexcept
+{
+    if (state.stack[1] != 0)
+        return op_jumpi(instr, state);
+
+    state.stack.pop();
+    state.stack.pop();
+    return opx_dispatch_selector(instr, state);
+}
+
 EVMC_EXPORT const OpTable& get_op_table(evmc_revision rev) noexcept
 {
     static constexpr auto op_tables = []() noexcept {
@@ -1,30 +1,20 @@
 #include "baseline.hpp"
-#include "baseline_instruction_table.hpp"
+#include "baseline_dispatch.hpp"
 #include "eof.hpp"
 #include "execution_state.hpp"
 #include "instructions.hpp"
 #include "vm.hpp"
 #include <evmc/instructions.h>
+#include <algorithm>
+#include <array>
 #include <memory>
-
-#ifdef NDEBUG
-// TODO: msvc::forceinline can be used in C++20.
-#define release_inline gnu::always_inline
-#else
-#define release_inline
-#endif
-
-#if defined(__GNUC__)
-#define ASM_COMMENT(COMMENT) asm("# " #COMMENT)  // NOLINT(hicpp-no-assembler)
-#else
-#define ASM_COMMENT(COMMENT)
-#endif
+#include <utility>
 
 namespace evm::baseline
 {
 namespace
 {
-CodeAnalysis::JumpdestMap analyze_jumpdests(bytes_view code)
+CodeAnalysis::JumpdestMap analyze_jumpdests(bytes_view code, std::vector<uint32_t>& call_sites)
 {
 
     static_assert(OP_PUSH32 == std::numeric_limits<int8_t>::max());
@@ -37,6 +27,8 @@ CodeAnalysis::JumpdestMap analyze_jumpdests(bytes_view code)
             i += op - size_t{OP_PUSH1 - 1};
         else if (INTX_UNLIKELY(op == OP_JUMPDEST))
             map[i] = true;
+        else if (INTX_UNLIKELY(is_call(op)))
+            call_sites.push_back(static_cast<uint32_t>(i));
     }
 
     return map;
@@ -52,15 +44,54 @@ std::unique_ptr<uint8_t[]> pad_code(bytes_view code)
 }
 
 
+/// The EIP-1167 minimal proxy runtime code with the implementation address zeroed.
+constexpr uint8_t minimal_proxy_code[] = {0x36, 0x3d, 0x3d, 0x37, 0x3d, 0x3d, 0x3d, 0x36, 0x3d,
+    0x73, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x5a, 0xf4, 0x3d, 0x82,
+    0x80, 0x3e, 0x90, 0x3d, 0x91, 0x60, 0x2b, 0x57, 0xfd, 0x5b, 0xf3};
+constexpr size_t minimal_proxy_target_offset = 10;
+constexpr size_t minimal_proxy_delegatecall_offset = 0x1f;
+constexpr size_t minimal_proxy_revert_offset = 0x2a;
+static_assert(minimal_proxy_code[minimal_proxy_delegatecall_offset] == OP_DELEGATECALL);
+static_assert(minimal_proxy_code[minimal_proxy_revert_offset] == OP_REVERT);
+
+std::optional<evmc::address> find_minimal_proxy_target(bytes_view code) noexcept
+{
+    constexpr auto target_end = minimal_proxy_target_offset + sizeof(evmc::address);
+    const auto proxy_code = bytes_view{minimal_proxy_code, std::size(minimal_proxy_code)};
+    if (code.size() != proxy_code.size() ||
+        code.substr(0, minimal_proxy_target_offset) !=
+            proxy_code.substr(0, minimal_proxy_target_offset) ||
+        code.substr(target_end) != proxy_code.substr(target_end))
+        return std::nullopt;
+
+    evmc::address target;
+    std::copy_n(&code[minimal_proxy_target_offset], sizeof(target), target.bytes);
+    return target;
+}
+
+void set_call_sites(CodeAnalysis& analysis, std::vector<uint32_t> call_sites)
+{
+    analysis.call_site_caches =
+        std::make_unique<CallSiteCache<CodeAnalysis>[]>(call_sites.size());
+    analysis.call_site_offsets = std::move(call_sites);
+}
+
 CodeAnalysis analyze_legacy(bytes_view code)
 {
-    return {pad_code(code), analyze_jumpdests(code)};
+    std::vector<uint32_t> call_sites;
+    CodeAnalysis analysis{pad_code(code), analyze_jumpdests(code, call_sites)};
+    analysis.minimal_proxy_target = find_minimal_proxy_target(code);
+    set_call_sites(analysis, std::move(call_sites));
+    return analysis;
 }
 
 CodeAnalysis analyze_eof1(bytes_view eof_container, const EOF1Header& header)
 {
     const auto executable_code = eof_container.substr(header.code_begin(), header.code_size);
-    return {executable_code.data(), analyze_jumpdests(executable_code)};
+    std::vector<uint32_t> call_sites;
+    CodeAnalysis analysis{executable_code.data(), analyze_jumpdests(executable_code, call_sites)};
+    set_call_sites(analysis, std::move(call_sites));
+    return analysis;
 }
 }  // namespace
 
@@ -72,252 +103,164 @@ CodeAnalysis analyze(evmc_revision rev, bytes_view code)
     const auto eof1_header = read_valid_eof1_header(code.begin());
     return analyze_eof1(code, eof1_header);
 }
-namespace
-{
 
-template <evmc_opcode Op>
-inline evmc_status_code check_requirements(
-    const CostTable& cost_table, int64_t& gas_left, ptrdiff_t stack_size) noexcept
+const CodeAnalysis* analyze_callee(const CallSiteCache<CodeAnalysis>& call_site,
+    const evmc::HostInterface& host, evmc_revision rev, const evmc_message& msg,
+    bytes_view code) noexcept
 {
-    static_assert(
-        !(instr::has_const_gas_cost(Op) && instr::gas_costs[EVMC_FRONTIER][Op] == instr::undefined),
-        "undefined instructions must not be handled by check_requirements()");
-
-    auto gas_cost = instr::gas_costs[EVMC_FRONTIER][Op];
-    if constexpr (!instr::has_const_gas_cost(Op))
-    {
-        gas_cost = cost_table[Op];
-
-        if (INTX_UNLIKELY(gas_cost < 0))
-            return EVMC_UNDEFINED_INSTRUCTION;
-    }
-
-    if constexpr (instr::traits[Op].stack_height_change > 0)
-    {
-        static_assert(instr::traits[Op].stack_height_change == 1);
-        if (INTX_UNLIKELY(stack_size == StackSpace::limit))
-            return EVMC_STACK_OVERFLOW;
-    }
-    if constexpr (instr::traits[Op].stack_height_required > 0)
-    {
-        if (INTX_UNLIKELY(stack_size < instr::traits[Op].stack_height_required))
-            return EVMC_STACK_UNDERFLOW;
-    }
-
-    if (INTX_UNLIKELY((gas_left -= gas_cost) < 0))
-        return EVMC_OUT_OF_GAS;
-
-    return EVMC_SUCCESS;
-}
-
-
-
-struct Position
-{
-    code_iterator code_it;
-    uint256* stack_top;
-};
-
-[[release_inline]] inline code_iterator invoke(
-    void (*instr_fn)(StackTop) noexcept, Position pos, ExecutionState& /*state*/) noexcept
-{
-    instr_fn(pos.stack_top);
-    return pos.code_it + 1;
+    // The analysis of EOF code refers to the code of the host.
+    if (rev >= EVMC_SHANGHAI && is_eof_code(code))
+        return nullptr;
+    return call_site.get(host, rev, msg, code, analyze);
 }
-
-[[release_inline]] inline code_iterator invoke(
-    StopToken (*instr_fn)() noexcept, Position /*pos*/, ExecutionState& state) noexcept
+namespace
 {
-    state.status = instr_fn().status;
-    return nullptr;
-}
-
-[[release_inline]] inline code_iterator invoke(
-    evmc_status_code (*instr_fn)(StackTop, ExecutionState&) noexcept, Position pos,
-    ExecutionState& state) noexcept
+/// Returns the sum of the constant costs of the minimal proxy instructions in [begin, end).
+int64_t minimal_proxy_cost(evmc_revision rev, size_t begin, size_t end) noexcept
 {
-    if (const auto status = instr_fn(pos.stack_top, state); status != EVMC_SUCCESS)
+    int64_t cost = 0;
+    for (auto i = begin; i < end; ++i)
     {
-        state.status = status;
-        return nullptr;
+        const auto op = minimal_proxy_code[i];
+        cost += instr::gas_costs[rev][op];
+        if (op >= OP_PUSH1 && op <= OP_PUSH32)
+            i += op - size_t{OP_PUSH1 - 1};
     }
-    return pos.code_it + 1;
-}
-
-[[release_inline]] inline code_iterator invoke(void (*instr_fn)(StackTop, ExecutionState&) noexcept,
-    Position pos, ExecutionState& state) noexcept
-{
-    instr_fn(pos.stack_top, state);
-    return pos.code_it + 1;
+    return cost;
 }
 
-[[release_inline]] inline code_iterator invoke(
-    code_iterator (*instr_fn)(StackTop, ExecutionState&, code_iterator) noexcept, Position pos,
-    ExecutionState& state) noexcept
+/// Executes the EIP-1167 minimal proxy code without interpreting it.
+/// The effects on gas, memory and the host are the same as of the interpreted code.
+void execute_minimal_proxy(ExecutionState& state, const evmc::address& target) noexcept
 {
-    return instr_fn(pos.stack_top, state, pos.code_it);
-}
+    const auto rev = state.rev;
 
-[[release_inline]] inline code_iterator invoke(
-    StopToken (*instr_fn)(StackTop, ExecutionState&) noexcept, Position pos,
-    ExecutionState& state) noexcept
-{
-    state.status = instr_fn(pos.stack_top, state).status;
-    return nullptr;
-}
-/// @}
-
-template <evmc_opcode Op>
-[[release_inline]] inline Position invoke(const CostTable& cost_table, const uint256* stack_bottom,
-    Position pos, ExecutionState& state) noexcept
-{
-    const auto stack_size = pos.stack_top - stack_bottom;
-    if (const auto status = check_requirements<Op>(cost_table, state.gas_left, stack_size);
-        status != EVMC_SUCCESS)
+    // CALLDATASIZE ... GAS, including CALLDATACOPY(0, 0, CALLDATASIZE).
+    const auto input_size = state.msg->input_size;
+    if ((state.gas_left -= minimal_proxy_cost(rev, 0, minimal_proxy_delegatecall_offset)) < 0 ||
+        !check_memory<true>(state, 0, input_size) ||
+        (state.gas_left -= num_words(input_size) * 3) < 0)
     {
-        state.status = status;
-        return {nullptr, pos.stack_top};
+        state.status = EVMC_OUT_OF_GAS;
+        return;
     }
-    const auto new_pos = invoke(instr::core::impl<Op>, pos, state);
-    const auto new_stack_top = pos.stack_top + instr::traits[Op].stack_height_change;
-    return {new_pos, new_stack_top};
-}
-
-
-template <bool TracingEnabled>
-void dispatch(const CostTable& cost_table, ExecutionState& state, const uint8_t* code,
-    Tracer* tracer = nullptr) noexcept
-{
-    const auto stack_bottom = state.stack_space.bottom();
-
-    Position position{code, stack_bottom};
-
-    while (true)
+    if (input_size != 0)
+        std::memcpy(&state.memory[0], state.msg->input_data, input_size);
+
+    StackTop stack{state.stack_space.bottom()};
+    stack.push(0);
+    stack.push(0);
+    stack.push(0);
+    stack.push(input_size);
+    stack.push(0);
+    stack.push(intx::be::load<uint256>(target));
+    stack.push(state.gas_left);
+
+    if ((state.gas_left -= instr::gas_costs[rev][OP_DELEGATECALL]) < 0)
     {
-        if constexpr (TracingEnabled)
-        {
-            const auto offset = static_cast<uint32_t>(position.code_it - code);
-            const auto stack_height = static_cast<int>(position.stack_top - stack_bottom);
-            if (offset < state.original_code.size())
-                tracer->notify_instruction_start(offset, position.stack_top, stack_height, state);
-        }
-
-        const auto op = *position.code_it;
-        switch (op)
+        state.status = EVMC_OUT_OF_GAS;
+        return;
+    }
+    {
+        const HostCallSiteScope<CodeAnalysis> call_site{
+            &state.analysis.baseline->find_call_site(minimal_proxy_delegatecall_offset),
+            state.msg->depth + 1};
+        if (const auto status = instr::core::delegatecall(stack, state); status != EVMC_SUCCESS)
         {
-#define ON_OPCODE(OPCODE)                                                                \
-    case OPCODE:                                                                         \
-        ASM_COMMENT(OPCODE);                                                             \
-        if (const auto next = invoke<OPCODE>(cost_table, stack_bottom, position, state); \
-            next.code_it == nullptr)                                                     \
-        {                                                                                \
-            return;                                                                      \
-        }                                                                                \
-        else                                                                             \
-        {                                                                                \
-            /* Update current position only when no error,                               \
-               this improves compiler optimization. */                                   \
-            position = next;                                                             \
-        }                                                                                \
-        break;
-
-            MAP_OPCODES
-#undef ON_OPCODE
-
-        default:
-            state.status = EVMC_UNDEFINED_INSTRUCTION;
+            state.status = status;
             return;
         }
     }
+    const auto success = stack[5] != 0;
+
+    // RETURNDATASIZE ... JUMPI, including RETURNDATACOPY(0, 0, RETURNDATASIZE).
+    const auto output_size = state.return_data.size();
+    if ((state.gas_left -= minimal_proxy_cost(rev, minimal_proxy_delegatecall_offset + 1,
+             minimal_proxy_revert_offset)) < 0 ||
+        !check_memory<true>(state, 0, output_size) ||
+        (state.gas_left -= num_words(output_size) * 3) < 0)
+    {
+        state.status = EVMC_OUT_OF_GAS;
+        return;
+    }
+    if (output_size != 0)
+        std::memcpy(&state.memory[0], state.return_data.data(), output_size);
+
+    // REVERT or JUMPDEST RETURN.
+    const auto end_begin = success ? minimal_proxy_revert_offset + 1 : minimal_proxy_revert_offset;
+    const auto end_end = success ? std::size(minimal_proxy_code) : minimal_proxy_revert_offset + 1;
+    if ((state.gas_left -= minimal_proxy_cost(rev, end_begin, end_end)) < 0)
+    {
+        state.status = EVMC_OUT_OF_GAS;
+        return;
+    }
+    state.output_offset = 0;
+    state.output_size = output_size;
+    state.status = success ? EVMC_SUCCESS : EVMC_REVERT;
 }
+}  // namespace
 
-#if EVM_CGOTO_SUPPORTED
-void dispatch_cgoto(
-    const CostTable& cost_table, ExecutionState& state, const uint8_t* code) noexcept
+evmc_result get_result(ExecutionState& state, bool metered) noexcept
 {
-#pragma GCC diagnostic ignored "-Wpedantic"
-
-    static constexpr void* cgoto_table[] = {
-#define ON_OPCODE(OPCODE) &&TARGET_##OPCODE,
-#undef ON_OPCODE_UNDEFINED
-#define ON_OPCODE_UNDEFINED(_) &&TARGET_OP_UNDEFINED,
-        MAP_OPCODES
-#undef ON_OPCODE
-#undef ON_OPCODE_UNDEFINED
-#define ON_OPCODE_UNDEFINED ON_OPCODE_UNDEFINED_DEFAULT
-    };
-    static_assert(std::size(cgoto_table) == 256);
-    const auto stack_bottom = state.stack_space.bottom();
-    Position position{code, stack_bottom};
-    goto* cgoto_table[*position.code_it];
-
-#define ON_OPCODE(OPCODE)                                                            \
-    TARGET_##OPCODE : ASM_COMMENT(OPCODE);                                           \
-    if (const auto next = invoke<OPCODE>(cost_table, stack_bottom, position, state); \
-        next.code_it == nullptr)                                                     \
-    {                                                                                \
-        return;                                                                      \
-    }                                                                                \
-    else                                                                             \
-    {                                                                                \                                  \
-        position = next;                                                             \
-    }                                                                                \
-    goto* cgoto_table[*position.code_it];
-
-    MAP_OPCODES
-#undef ON_OPCODE
+    // The unmetered frames return the loop budget they have not used, whatever their status.
+    const auto gas_left =
+        (state.status == EVMC_SUCCESS || state.status == EVMC_REVERT || !metered) ?
+            std::max(state.gas_left, int64_t{0}) :
+            0;
+    const auto gas_refund = (state.status == EVMC_SUCCESS) ? state.gas_refund : 0;
 
-TARGET_OP_UNDEFINED:
-    state.status = EVMC_UNDEFINED_INSTRUCTION;
+    assert(state.output_size != 0 || state.output_offset == 0);
+    return evmc::make_result(state.status, gas_left, gas_refund,
+        state.output_size != 0 ? &state.memory[state.output_offset] : nullptr, state.output_size);
 }
-#endif
-}  // namespace
 
 evmc_result execute(const VM& vm, ExecutionState& state, const CodeAnalysis& analysis) noexcept
 {
     state.analysis.baseline = &analysis;
 
-    const auto code = analysis.executable_code;
-
-    const auto& cost_table = get_baseline_cost_table(state.rev);
-
-    auto* tracer = vm.get_tracer();
-    if (INTX_UNLIKELY(tracer != nullptr))
+    if (auto* tracer = vm.get_tracer(); INTX_UNLIKELY(tracer != nullptr))
+        tracer->notify_execution_start(state.rev, *state.msg, analysis.executable_code);
+    else if (analysis.minimal_proxy_target && state.rev >= EVMC_BYZANTIUM &&
+             !state.suspend_on_call && !vm.unmetered)
     {
-        tracer->notify_execution_start(state.rev, *state.msg, code);
-        dispatch<true>(cost_table, state, code, tracer);
+        execute_minimal_proxy(state, *analysis.minimal_proxy_target);
+        return get_result(state, true);
     }
-    else
-    {
-#if EVM_CGOTO_SUPPORTED
-        if (vm.cgoto)
-            dispatch_cgoto(cost_table, state, code);
-        else
-#endif
-            dispatch<false>(cost_table, state, code);
-    }
-
-    const auto gas_left =
-        (state.status == EVMC_SUCCESS || state.status == EVMC_REVERT) ? state.gas_left : 0;
-    const auto gas_refund = (state.status == EVMC_SUCCESS) ? state.gas_refund : 0;
 
-    assert(state.output_size != 0 || state.output_offset == 0);
-    const auto result = evmc::make_result(state.status, gas_left, gas_refund,
-        state.output_size != 0 ? &state.memory[state.output_offset] : nullptr, state.output_size);
-
-    if (INTX_UNLIKELY(tracer != nullptr))
-        tracer->notify_execution_end(result);
+    return run<evmc::HostContext>(
+        vm, state, {analysis.executable_code, state.stack_space.bottom()});
+}
 
-    return result;
+evmc_result resume(const VM& vm, ExecutionState& state) noexcept
+{
+    state.status = EVMC_SUCCESS;
+    return run<evmc::HostContext>(vm, state, {state.resume_code, state.resume_stack_top});
 }
 
 evmc_result execute(evmc_vm* c_vm, const evmc_host_interface* host, evmc_host_context* ctx,
     evmc_revision rev, const evmc_message* msg, const uint8_t* code, size_t code_size) noexcept
 {
     auto vm = static_cast<VM*>(c_vm);
-    const auto jumpdest_map = analyze(rev, {code, code_size});
+    // Entering a call would apply its prologue to the host, bypassing the pre-execution host.
+    if (vm->call_frames && vm->get_access_recorder() == nullptr)
+        return execute_call_frames(*vm, *host, ctx, rev, *msg, {code, code_size});
+
+    const CodeAnalysis* cached_analysis = nullptr;
+    if (const auto* call_site = take_host_call_site<CodeAnalysis>(*msg); call_site != nullptr)
+    {
+        cached_analysis = analyze_callee(
+            *call_site, evmc::HostContext{*host, ctx}, rev, *msg, {code, code_size});
+    }
+    std::optional<CodeAnalysis> analysis;
+    if (cached_analysis == nullptr)
+        analysis.emplace(analyze(rev, {code, code_size}));
+
     auto state =
         std::make_unique<ExecutionState>(*msg, rev, *host, ctx, bytes_view{code, code_size});
-    return execute(*vm, *state, jumpdest_map);
+    vm->begin_frame(*state, ctx);
+    const auto result =
+        execute(*vm, *state, cached_analysis != nullptr ? *cached_analysis : *analysis);
+    vm->end_frame(*state, result.status_code);
+    return result;
 }
 } 
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 
-#include <evmc/evmc.h>
+#include "call_site_cache.hpp"
+#include <evmc/evmc.hpp>
 #include <evmc/utils.h>
 #include <memory>
+#include <algorithm>
+#include <cassert>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -19,9 +23,17 @@ namespace baseline
     {
     public:
         using JumpdestMap = std::vector<bool>;
+
         const uint8_t* executable_code;
         JumpdestMap jumpdest_map;
 
+        /// The implementation address if the code is an EIP-1167 minimal proxy.
+        std::optional<evmc::address> minimal_proxy_target;
+
+        /// The code offsets of the CALL* instructions (sorted) and the caches of their callees.
+        std::vector<uint32_t> call_site_offsets;
+        std::unique_ptr<CallSiteCache<CodeAnalysis>[]> call_site_caches;
+
     private:
         std::unique_ptr<uint8_t[]> m_padded_code;
 
@@ -35,16 +47,43 @@ namespace baseline
         CodeAnalysis(const uint8_t* code, JumpdestMap map)
         : executable_code{code}, jumpdest_map{std::move(map)}
         {}
+
+        /// Returns the cache of the CALL* instruction at the code offset.
+        [[nodiscard]] const CallSiteCache<CodeAnalysis>& find_call_site(
+            size_t offset) const noexcept
+        {
+            const auto it =
+                std::lower_bound(call_site_offsets.begin(), call_site_offsets.end(), offset);
+            assert(it != call_site_offsets.end() && *it == offset);
+            return call_site_caches[static_cast<size_t>(it - call_site_offsets.begin())];
+        }
     };
     static_assert(std::is_move_constructible_v<CodeAnalysis>);
     static_assert(std::is_move_assignable_v<CodeAnalysis>);
     static_assert(!std::is_copy_constructible_v<CodeAnalysis>);
     static_assert(!std::is_copy_assignable_v<CodeAnalysis>);
     EVMC_EXPORT CodeAnalysis analyze(evmc_revision rev, bytes_view code);
+
+    /// Returns the analysis of the code of the message from the cache of its call site,
+    /// or null if it is not cached.
+    const CodeAnalysis* analyze_callee(const CallSiteCache<CodeAnalysis>& call_site,
+        const evmc::HostInterface& host, evmc_revision rev, const evmc_message& msg,
+        bytes_view code) noexcept;
+
     evmc_result execute(evmc_vm* vm, const evmc_host_interface* host, evmc_host_context* ctx,
         evmc_revision rev, const evmc_message* msg, const uint8_t* code, size_t code_size) noexcept;
     EVMC_EXPORT evmc_result execute(
         const VM&, ExecutionState& state, const CodeAnalysis& analysis) noexcept;
 
+    /// Continues the execution suspended on a nested call, after finish_nested_call(),
+    /// or on a state item, after it is loaded by the host.
+    EVMC_EXPORT evmc_result resume(const VM&, ExecutionState& state) noexcept;
+
+    /// Executes the message and all nested EVM-to-EVM calls with an explicit frame stack
+    /// (see the "call_frames" option).
+    evmc_result execute_call_frames(const VM& vm, const evmc_host_interface& host,
+        evmc_host_context* ctx, evmc_revision rev, const evmc_message& msg,
+        bytes_view code) noexcept;
+
     }
 }
\ No newline at end of file
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "baseline.hpp"
+#include "baseline_instruction_table.hpp"
+#include "execution_state.hpp"
+#include "instructions.hpp"
+#include "vm.hpp"
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#ifdef NDEBUG
+// TODO: msvc::forceinline can be used in C++20.
+#define release_inline gnu::always_inline
+#else
+#define release_inline
+#endif
+
+#if defined(__GNUC__)
+#define ASM_COMMENT(COMMENT) asm("# " #COMMENT)  // NOLINT(hicpp-no-assembler)
+#else
+#define ASM_COMMENT(COMMENT)
+#endif
+
+namespace evm::baseline
+{
+constexpr bool is_call(uint8_t op) noexcept
+{
+    return op == OP_CALL || op == OP_CALLCODE || op == OP_DELEGATECALL || op == OP_STATICCALL;
+}
+
+template <int Rev, bool Metered, evmc_opcode Op>
+inline evmc_status_code check_requirements(
+    const CostTable& cost_table, int64_t& gas_left, ptrdiff_t stack_size) noexcept
+{
+    static_assert(
+        !(instr::has_const_gas_cost(Op) && instr::gas_costs[EVMC_FRONTIER][Op] == instr::undefined),
+        "undefined instructions must not be handled by check_requirements()");
+
+    auto gas_cost = instr::gas_costs[EVMC_FRONTIER][Op];
+    if constexpr (!instr::has_const_gas_cost(Op))
+    {
+        if constexpr (Rev == any_revision)
+        {
+            gas_cost = cost_table[Op];
+
+            if (INTX_UNLIKELY(gas_cost < 0))
+                return EVMC_UNDEFINED_INSTRUCTION;
+        }
+        else
+        {
+            static_assert(instr::gas_costs[Rev][Op] != instr::undefined);
+            gas_cost = instr::gas_costs[Rev][Op];
+        }
+    }
+
+    if constexpr (instr::traits[Op].stack_height_change > 0)
+    {
+        static_assert(instr::traits[Op].stack_height_change == 1);
+        if (INTX_UNLIKELY(stack_size == StackSpace::limit))
+            return EVMC_STACK_OVERFLOW;
+    }
+    if constexpr (instr::traits[Op].stack_height_required > 0)
+    {
+        if (INTX_UNLIKELY(stack_size < instr::traits[Op].stack_height_required))
+            return EVMC_STACK_UNDERFLOW;
+    }
+
+    // The gas of the unmetered loops is their loop budget, which only JUMPDEST uses.
+    if constexpr (Metered || Op == OP_JUMPDEST)
+    {
+        if (INTX_UNLIKELY((gas_left -= gas_cost) < 0))
+            return EVMC_OUT_OF_GAS;
+    }
+    else
+        (void)gas_cost;
+
+    return EVMC_SUCCESS;
+}
+
+
+
+struct Position
+{
+    code_iterator code_it;
+    uint256* stack_top;
+};
+
+[[release_inline]] inline code_iterator invoke(
+    void (*instr_fn)(StackTop) noexcept, Position pos, ExecutionState& /*state*/) noexcept
+{
+    instr_fn(pos.stack_top);
+    return pos.code_it + 1;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    StopToken (*instr_fn)() noexcept, Position /*pos*/, ExecutionState& state) noexcept
+{
+    state.status = instr_fn().status;
+    return nullptr;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    evmc_status_code (*instr_fn)(StackTop, ExecutionState&) noexcept, Position pos,
+    ExecutionState& state) noexcept
+{
+    if (const auto status = instr_fn(pos.stack_top, state); status != EVMC_SUCCESS)
+    {
+        state.status = status;
+        return nullptr;
+    }
+    return pos.code_it + 1;
+}
+
+[[release_inline]] inline code_iterator invoke(void (*instr_fn)(StackTop, ExecutionState&) noexcept,
+    Position pos, ExecutionState& state) noexcept
+{
+    instr_fn(pos.stack_top, state);
+    return pos.code_it + 1;
+}
+
+[[release_inline]] inline code_iterator invoke(
+    code_iterator (*instr_fn)(StackTop, ExecutionState&, code_iterator) noexcept, Position pos,
+    ExecutionState& state) noexcept
+{
+    return instr_fn(pos.stack_top, state, pos.code_it);
+}
+
+[[release_inline]] inline code_iterator invoke(
+    StopToken (*instr_fn)(StackTop, ExecutionState&) noexcept, Position pos,
+    ExecutionState& state) noexcept
+{
+    state.status = instr_fn(pos.stack_top, state).status;
+    return nullptr;
+}
+/// @}
+
+template <int Rev, bool Metered, bool Interruptible, evmc_opcode Op, typename Host>
+[[release_inline]] inline Position invoke(const CostTable& cost_table, const uint256* stack_bottom,
+    Position pos, ExecutionState& state) noexcept
+{
+    if constexpr (Rev != any_revision && instr::gas_costs[Rev][Op] == instr::undefined)
+    {
+        state.status = EVMC_UNDEFINED_INSTRUCTION;
+        return {nullptr, pos.stack_top};
+    }
+    else
+    {
+        const auto stack_size = pos.stack_top - stack_bottom;
+        if (const auto status =
+                check_requirements<Rev, Metered, Op>(cost_table, state.gas_left, stack_size);
+            status != EVMC_SUCCESS)
+        {
+            state.status = status;
+            return {nullptr, pos.stack_top};
+        }
+
+        code_iterator new_pos = nullptr;
+        if constexpr (Op == OP_JUMPDEST && !Interruptible)
+            new_pos = pos.code_it + 1;
+        else if constexpr (is_call(Op))
+        {
+            // The callee executed by the host takes its analysis from the call site cache.
+            const auto& analysis = *state.analysis.baseline;
+            const auto offset = static_cast<size_t>(pos.code_it - analysis.executable_code);
+            const HostCallSiteScope<CodeAnalysis> call_site{
+                &analysis.find_call_site(offset), state.msg->depth + 1};
+            new_pos = invoke(instr::core::specialized_impl<Op, Rev, Metered, Host>, pos, state);
+        }
+        else
+            new_pos = invoke(instr::core::specialized_impl<Op, Rev, Metered, Host>, pos, state);
+        const auto new_stack_top = pos.stack_top + instr::traits[Op].stack_height_change;
+        return {new_pos, new_stack_top};
+    }
+}
+
+
+/// Returns the position of the instruction which ended the execution.
+/// Only the Interruptible loops check the cancellation and the preemption at JUMPDESTs.
+template <int Rev, bool Metered, bool Interruptible, bool TracingEnabled, typename Host>
+Position dispatch(const CostTable& cost_table, ExecutionState& state, const uint8_t* code,
+    Position position, Tracer* tracer = nullptr) noexcept
+{
+    const auto stack_bottom = state.stack_space.bottom();
+
+    while (true)
+    {
+        if constexpr (TracingEnabled)
+        {
+            const auto offset = static_cast<uint32_t>(position.code_it - code);
+            const auto stack_height = static_cast<int>(position.stack_top - stack_bottom);
+            if (offset < state.original_code.size())
+                tracer->notify_instruction_start(offset, position.stack_top, stack_height, state);
+        }
+
+        const auto op = *position.code_it;
+        switch (op)
+        {
+#define ON_OPCODE(OPCODE)                                                                      \
+    case OPCODE:                                                                               \
+        ASM_COMMENT(OPCODE);                                                                   \
+        if (const auto next =                                                                  \
+                invoke<Rev, Metered, Interruptible, OPCODE, Host>(                            \
+                    cost_table, stack_bottom, position, state);                                \
+            next.code_it == nullptr)                                                           \
+        {                                                                                      \
+            return position;                                                                   \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            /* Update current position only when no error,                                     \
+               this improves compiler optimization. */                                         \
+            position = next;                                                                   \
+        }                                                                                      \
+        break;
+
+            MAP_OPCODES
+#undef ON_OPCODE
+
+        default:
+            state.status = EVMC_UNDEFINED_INSTRUCTION;
+            return position;
+        }
+    }
+}
+
+#if EVM_CGOTO_SUPPORTED
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+template <int Rev, bool Metered, bool Interruptible, typename Host>
+Position dispatch_cgoto(
+    const CostTable& cost_table, ExecutionState& state, Position position) noexcept
+{
+
+    static constexpr void* cgoto_table[] = {
+#define ON_OPCODE(OPCODE) &&TARGET_##OPCODE,
+#undef ON_OPCODE_UNDEFINED
+#define ON_OPCODE_UNDEFINED(_) &&TARGET_OP_UNDEFINED,
+        MAP_OPCODES
+#undef ON_OPCODE
+#undef ON_OPCODE_UNDEFINED
+#define ON_OPCODE_UNDEFINED ON_OPCODE_UNDEFINED_DEFAULT
+    };
+    static_assert(std::size(cgoto_table) == 256);
+    const auto stack_bottom = state.stack_space.bottom();
+    goto* cgoto_table[*position.code_it];
+
+#define ON_OPCODE(OPCODE)                                                                  \
+    TARGET_##OPCODE : ASM_COMMENT(OPCODE);                                                 \
+    if (const auto next =                                                                  \
+            invoke<Rev, Metered, Interruptible, OPCODE, Host>(                             \
+                cost_table, stack_bottom, position, state);                                \
+        next.code_it == nullptr)                                                           \
+    {                                                                                      \
+        return position;                                                                   \
+    }                                                                                      \
+    else                                                                                   \
+    {                                                                                      \
+        position = next;                                                                   \
+    }                                                                                      \
+    goto* cgoto_table[*position.code_it];
+
+    MAP_OPCODES
+#undef ON_OPCODE
+
+TARGET_OP_UNDEFINED:
+    state.status = EVMC_UNDEFINED_INSTRUCTION;
+    return position;
+}
+#pragma GCC diagnostic pop
+#endif
+
+/// Runs the interpreter loop without tracing selected by the "cgoto" option.
+template <int Rev, bool Metered, bool Interruptible, typename Host>
+Position dispatch_untraced(const VM& vm, const CostTable& cost_table, ExecutionState& state,
+    const uint8_t* code, Position position) noexcept
+{
+#if EVM_CGOTO_SUPPORTED
+    if (vm.cgoto)
+        return dispatch_cgoto<Rev, Metered, Interruptible, Host>(cost_table, state, position);
+#else
+    (void)vm;
+#endif
+    return dispatch<Rev, Metered, Interruptible, false, Host>(cost_table, state, code, position);
+}
+
+/// The first revision with specialized interpreter loops. Each specialization adds two loops
+/// (switch and computed goto) to the binary, so older revisions, only executed in historical
+/// syncs and tests, share the any_revision loops.
+inline constexpr auto first_specialized_revision = EVMC_SHANGHAI;
+
+template <typename Host, size_t... Revs>
+constexpr auto make_revision_dispatch_table(std::index_sequence<Revs...>) noexcept
+{
+    return std::array{
+        &dispatch_untraced<static_cast<int>(first_specialized_revision + Revs), true, false,
+            Host>...};
+}
+
+/// The interpreter loops without tracing specialized for the revisions from
+/// first_specialized_revision, for executions which cannot be cancelled or preempted.
+template <typename Host>
+inline constexpr auto revision_dispatch_table = make_revision_dispatch_table<Host>(
+    std::make_index_sequence<EVMC_MAX_REVISION - first_specialized_revision + 1>{});
+
+evmc_result get_result(ExecutionState& state, bool metered) noexcept;
+
+/// Runs the interpreter loop selected for the execution. Only the loops specialized per revision
+/// call the host as an instance of Host; the others call it through the evmc::HostContext.
+/// Executions which can be cancelled or preempted take the any_revision loops checking for it
+/// at JUMPDESTs, so that the other loops execute JUMPDEST without any check.
+template <typename Host>
+evmc_result run(const VM& vm, ExecutionState& state, Position position) noexcept
+{
+    const auto code = state.analysis.baseline->executable_code;
+
+    const auto& cost_table = get_baseline_cost_table(state.rev);
+
+    auto* tracer = vm.get_tracer();
+    const auto metered = tracer != nullptr || !vm.unmetered;
+    const auto interruptible = state.cancellable || state.preempt_gas_left > 0;
+    if (INTX_UNLIKELY(tracer != nullptr))
+    {
+        position = dispatch<any_revision, true, true, true, evmc::HostContext>(
+            cost_table, state, code, position, tracer);
+    }
+    else if (INTX_UNLIKELY(!metered))
+    {
+        position = interruptible ?
+                       dispatch_untraced<any_revision, false, true, evmc::HostContext>(
+                           vm, cost_table, state, code, position) :
+                       dispatch_untraced<any_revision, false, false, evmc::HostContext>(
+                           vm, cost_table, state, code, position);
+    }
+    else if (INTX_UNLIKELY(interruptible))
+    {
+        position = dispatch_untraced<any_revision, true, true, evmc::HostContext>(
+            vm, cost_table, state, code, position);
+    }
+    else if (state.rev >= first_specialized_revision)
+    {
+        const auto index = static_cast<size_t>(state.rev - first_specialized_revision);
+        position = revision_dispatch_table<Host>[index](vm, cost_table, state, code, position);
+    }
+    else
+    {
+        position = dispatch_untraced<any_revision, true, false, evmc::HostContext>(
+            vm, cost_table, state, code, position);
+    }
+
+    if (INTX_UNLIKELY(state.status == EVM_CALL_SUSPENDED || state.status == EVM_PREEMPTED))
+    {
+        // CALL*, CREATE* and JUMPDEST have no immediates. The result of a call is the new
+        // stack top, JUMPDEST does not change the stack.
+        state.resume_code = position.code_it + 1;
+        state.resume_stack_top =
+            position.stack_top + instr::traits[*position.code_it].stack_height_change;
+        evmc_result result{};
+        result.status_code = state.status;
+        return result;
+    }
+
+    if (INTX_UNLIKELY(state.status == EVM_STATE_PENDING))
+    {
+        // The instruction is executed again when resumed, so its base cost is charged again.
+        if (metered)
+            state.gas_left += cost_table[*position.code_it];
+        state.resume_code = position.code_it;
+        state.resume_stack_top = position.stack_top;
+        evmc_result result{};
+        result.status_code = EVM_STATE_PENDING;
+        return result;
+    }
+
+    const auto result = get_result(state, metered);
+
+    if (INTX_UNLIKELY(tracer != nullptr))
+        tracer->notify_execution_end(result);
+
+    return result;
+}
+
+/// Executes the code like execute(vm, state, analysis), calling the host of the state as an
+/// instance of Host (see get_host()), e.g. the final evmc::Host type of a node embedding the VM.
+/// The evmc C ABI is the evmc::HostContext instantiation, which is execute() itself. Tracing,
+/// unmetered executions, revisions before Shanghai and minimal proxies take its generic path.
+template <typename Host>
+evmc_result execute(const VM& vm, ExecutionState& state, const CodeAnalysis& analysis) noexcept
+{
+    if constexpr (!std::is_same_v<Host, evmc::HostContext>)
+    {
+        if (vm.get_tracer() == nullptr && !analysis.minimal_proxy_target)
+        {
+            state.analysis.baseline = &analysis;
+            return run<Host>(vm, state, {analysis.executable_code, state.stack_space.bottom()});
+        }
+    }
+    return execute(vm, state, analysis);
+}
+}  // namespace evm::baseline
+
+#undef ASM_COMMENT
+#undef release_inline
@@ -0,0 +1,258 @@
+#include "baseline.hpp"
+#include "execution_state.hpp"
+#include "precompiles/secp256k1.hpp"
+#include "vm.hpp"
+#include <evm/evm.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace evm
+{
+namespace
+{
+/// The range of message indices owned by a worker. The bounds are packed in one word so that
+/// the owner popping from the front and thieves splitting off the back only need one CAS.
+class alignas(64) WorkRange
+{
+    std::atomic<uint64_t> m_range{0};
+
+    static constexpr uint64_t pack(uint32_t begin, uint32_t end) noexcept
+    {
+        return begin | uint64_t{end} << 32;
+    }
+
+public:
+    void reset(uint32_t begin, uint32_t end) noexcept { m_range = pack(begin, end); }
+
+    bool pop(uint32_t& index) noexcept
+    {
+        auto range = m_range.load();
+        while (true)
+        {
+            const auto begin = static_cast<uint32_t>(range);
+            const auto end = static_cast<uint32_t>(range >> 32);
+            if (begin >= end)
+                return false;
+            if (m_range.compare_exchange_weak(range, pack(begin + 1, end)))
+            {
+                index = begin;
+                return true;
+            }
+        }
+    }
+
+    /// Moves the back half of the remaining indices to the empty range of the thief.
+    bool steal_into(WorkRange& thief) noexcept
+    {
+        auto range = m_range.load();
+        while (true)
+        {
+            const auto begin = static_cast<uint32_t>(range);
+            const auto end = static_cast<uint32_t>(range >> 32);
+            if (begin >= end)
+                return false;
+            const auto mid = begin + (end - begin) / 2;
+            if (m_range.compare_exchange_weak(range, pack(begin, mid)))
+            {
+                thief.reset(mid, end);
+                return true;
+            }
+        }
+    }
+};
+
+/// The code analysis shared by the messages of a batch executing the same code.
+struct SharedAnalysis
+{
+    std::once_flag once;
+    std::optional<baseline::CodeAnalysis> analysis;
+};
+
+class Batch
+{
+    const VM& m_vm;
+    const evmc_host_interface& m_host;
+    evmc_host_context* m_ctx;
+    evmc_revision m_rev;
+    const evm_batch_message* m_messages;
+    evmc_result* m_results;
+    std::vector<uint32_t> m_analysis_indices;
+    std::unique_ptr<SharedAnalysis[]> m_analyses;
+    std::unique_ptr<WorkRange[]> m_ranges;
+    /// The execution states of the workers, owned by the batch so that batches can run
+    /// concurrently on one VM.
+    std::unique_ptr<ExecutionState[]> m_states;
+    size_t m_num_workers;
+    Cancellation m_cancellation;
+
+public:
+    uint32_t num_analyses = 0;
+    std::atomic<int64_t> gas_used{0};
+    std::atomic<uint64_t> num_steals{0};
+
+    Batch(const VM& vm, const evmc_host_interface& host, evmc_host_context* ctx,
+        evmc_revision rev, const evm_batch_message* messages, size_t num_messages,
+        evmc_result* results, size_t num_workers) noexcept
+      : m_vm{vm},
+        m_host{host},
+        m_ctx{ctx},
+        m_rev{rev},
+        m_messages{messages},
+        m_results{results},
+        m_analysis_indices(num_messages),
+        m_ranges{std::make_unique<WorkRange[]>(num_workers)},
+        m_states{std::make_unique<ExecutionState[]>(num_workers)},
+        m_num_workers{num_workers},
+        m_cancellation{vm.get_cancellation()}
+    {
+        std::unordered_map<const uint8_t*, uint32_t> code_indices;
+        std::vector<size_t> code_sizes;
+        for (size_t i = 0; i < num_messages; ++i)
+        {
+            const auto& m = messages[i];
+            const auto [it, inserted] = code_indices.try_emplace(m.code, num_analyses);
+            if (inserted || code_sizes[it->second] != m.code_size)
+            {
+                m_analysis_indices[i] = num_analyses++;
+                code_sizes.push_back(m.code_size);
+            }
+            else
+                m_analysis_indices[i] = it->second;
+        }
+        m_analyses = std::make_unique<SharedAnalysis[]>(num_analyses);
+
+        for (size_t w = 0; w < num_workers; ++w)
+        {
+            m_ranges[w].reset(static_cast<uint32_t>(num_messages * w / num_workers),
+                static_cast<uint32_t>(num_messages * (w + 1) / num_workers));
+        }
+    }
+
+    void execute(ExecutionState& state, uint32_t index) noexcept
+    {
+        const auto& m = m_messages[index];
+        const auto code = bytes_view{m.code, m.code_size};
+        auto& shared = m_analyses[m_analysis_indices[index]];
+        std::call_once(
+            shared.once, [&] { shared.analysis.emplace(baseline::analyze(m_rev, code)); });
+
+        state.reset(*m.msg, m_rev, m_host, m_ctx, code);
+        state.host_ext = {m_vm.host_extensions, m_ctx};
+        state.native_words = m_vm.native_words;
+        state.precompiles = m_vm.precompiles;
+        if (const auto* tx_context = m_vm.get_tx_context(); tx_context != nullptr)
+            state.set_tx_context(*tx_context);
+        state.set_cancellation(m_cancellation);
+        m_results[index] = baseline::execute(m_vm, state, *shared.analysis);
+        gas_used += m.msg->gas - m_results[index].gas_left;
+    }
+
+    void run(size_t worker) noexcept
+    {
+        auto& state = m_states[worker];
+        auto& own = m_ranges[worker];
+        while (true)
+        {
+            uint32_t index = 0;
+            while (own.pop(index))
+                execute(state, index);
+
+            auto stolen = false;
+            for (size_t k = 1; k < m_num_workers && !stolen; ++k)
+                stolen = m_ranges[(worker + k) % m_num_workers].steal_into(own);
+            if (!stolen)
+                return;
+            ++num_steals;
+        }
+    }
+};
+}  // namespace
+}  // namespace evm
+
+extern "C" {
+EVMC_EXPORT bool evm_execute_batch(evmc_vm* c_vm, const evmc_host_interface* host,
+    evmc_host_context* context, evmc_revision rev, const evm_batch_message* messages,
+    size_t num_messages, size_t num_threads, evmc_result* results, evm_batch_stats* stats) noexcept
+{
+    auto& vm = *static_cast<evm::VM*>(c_vm);
+    if (!vm.is_stateless())
+        return false;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    num_threads = std::max(std::min(num_threads, num_messages), size_t{1});
+
+    evm::Batch batch{vm, *host, context, rev, messages, num_messages, results, num_threads};
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (size_t w = 1; w < num_threads; ++w)
+        workers.emplace_back([&batch, w] { batch.run(w); });
+    batch.run(0);
+    for (auto& worker : workers)
+        worker.join();
+
+    if (stats != nullptr)
+    {
+        stats->elapsed_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_time)
+                .count());
+        stats->gas_used = batch.gas_used;
+        stats->num_threads = static_cast<uint32_t>(num_threads);
+        stats->num_analyses = batch.num_analyses;
+        stats->num_steals = batch.num_steals;
+    }
+    return true;
+}
+
+EVMC_EXPORT size_t evm_ecrecover_batch(const evm_ecdsa_signature* signatures,
+    size_t num_signatures, size_t num_threads, evmc_address* addresses) noexcept
+{
+    // The signatures cost the same, so workers take fixed chunks from a shared counter.
+    constexpr size_t chunk_size = 16;
+    const auto num_chunks = (num_signatures + chunk_size - 1) / chunk_size;
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    num_threads = std::max(std::min(num_threads, num_chunks), size_t{1});
+
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<size_t> num_valid{0};
+    const auto run = [&]() noexcept {
+        size_t valid = 0;
+        for (auto chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++)
+        {
+            const auto end = std::min((chunk + 1) * chunk_size, num_signatures);
+            for (auto i = chunk * chunk_size; i < end; ++i)
+            {
+                const auto& sig = signatures[i];
+                auto& address = addresses[i];
+                // A raw v of 27 or 28 is not a parity: it is rejected rather than read as 1.
+                if (sig.y_parity <= 1 &&
+                    evm::precompiles::ecrecover(address.bytes, sig.hash.bytes, sig.r.bytes,
+                        sig.s.bytes, sig.y_parity != 0))
+                    ++valid;
+                else
+                    address = {};
+            }
+        }
+        num_valid += valid;
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (size_t w = 1; w < num_threads; ++w)
+        workers.emplace_back(run);
+    run();
+    for (auto& worker : workers)
+        worker.join();
+    return num_valid;
+}
+}
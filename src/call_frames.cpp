@@ -0,0 +1,229 @@
+#include "baseline.hpp"
+#include "execution_state.hpp"
+#include "instructions.hpp"
+#include "vm.hpp"
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace evm::baseline
+{
+namespace
+{
+struct Frame
+{
+    evmc_message msg;
+    int32_t snapshot;
+    std::optional<CodeAnalysis> own_analysis;
+    const CodeAnalysis* analysis;
+    ExecutionState* state;
+};
+
+/// Returns the cache of the call site the frame is suspended on.
+inline const CallSiteCache<CodeAnalysis>& find_call_site(const ExecutionState& state) noexcept
+{
+    const auto& analysis = *state.analysis.baseline;
+    const auto call_site = state.resume_code - 1;
+    return analysis.find_call_site(static_cast<size_t>(call_site - analysis.executable_code));
+}
+
+inline void release(evmc_result& result) noexcept
+{
+    if (result.release != nullptr)
+        result.release(&result);
+}
+
+/// The result of a frame ended by the completion of its nested call, i.e. cancelled.
+inline evmc_result make_failure(evmc_status_code status) noexcept
+{
+    evmc_result result{};
+    result.status_code = status;
+    return result;
+}
+}  // namespace
+
+/// An execution with an explicit frame stack: nested calls entered with the call_frames host
+/// extensions run on the stack instead of recursively, and any frame can be suspended.
+/// The gas slice of preemption is counted from each (re)start of a frame. All frames keep the
+/// cancellation installed in the VM when the execution was created.
+class Execution
+{
+    const VM& m_vm;
+    const evmc_host_interface& m_host;
+    evmc_host_context* m_ctx;
+    evmc_revision m_rev;
+    const evmc_message& m_msg;
+    bytes_view m_code;
+    bool m_suspend_on_state;
+    Cancellation m_cancellation;
+    int64_t m_gas_slice = 0;
+    std::deque<Frame> m_frames;
+
+    /// The states of the frames by depth, reused by the following frames at the same depth.
+    std::vector<std::unique_ptr<ExecutionState>> m_states;
+
+    void start_slice(ExecutionState& state) const noexcept
+    {
+        state.preempt_gas_left = (m_gas_slice != 0) ? state.gas_left - m_gas_slice : 0;
+    }
+
+    evmc_result resume_frame(ExecutionState& state) const noexcept
+    {
+        start_slice(state);
+        return resume(m_vm, state);
+    }
+
+    /// Enters the message with the analysis of the code from the cache of the call site,
+    /// if any, or analyzes the code.
+    evmc_result enter(const evmc_message& msg, int32_t snapshot, bytes_view code,
+        const CallSiteCache<CodeAnalysis>* call_site) noexcept
+    {
+        auto& frame = m_frames.emplace_back(Frame{msg, snapshot, std::nullopt, nullptr, nullptr});
+        if (call_site != nullptr)
+        {
+            frame.analysis =
+                analyze_callee(*call_site, evmc::HostContext{m_host, m_ctx}, m_rev, msg, code);
+        }
+        if (frame.analysis == nullptr)
+            frame.analysis = &frame.own_analysis.emplace(analyze(m_rev, code));
+        const auto depth = m_frames.size() - 1;
+        if (depth == m_states.size())
+            m_states.push_back(std::make_unique<ExecutionState>());
+        frame.state = m_states[depth].get();
+        frame.state->reset(frame.msg, m_rev, m_host, m_ctx, code);
+        frame.state->suspend_on_call = m_vm.call_frames;
+        frame.state->suspend_on_state = m_suspend_on_state;
+        start_slice(*frame.state);
+        m_vm.begin_frame(*frame.state, m_ctx);
+        frame.state->set_cancellation(m_cancellation);
+        return execute(m_vm, *frame.state, *frame.analysis);
+    }
+
+public:
+    Execution(const VM& vm, const evmc_host_interface& host, evmc_host_context* ctx,
+        evmc_revision rev, const evmc_message& msg, bytes_view code,
+        bool suspend_on_state) noexcept
+      : m_vm{vm},
+        m_host{host},
+        m_ctx{ctx},
+        m_rev{rev},
+        m_msg{msg},
+        m_code{code},
+        m_suspend_on_state{suspend_on_state},
+        m_cancellation{vm.get_cancellation()}
+    {}
+
+    /// Nested calls run by the host cannot be preempted, so slices require call frames.
+    bool set_gas_slice(int64_t gas_slice) noexcept
+    {
+        if (gas_slice != 0 && !m_vm.call_frames)
+            return false;
+        m_gas_slice = gas_slice;
+        return true;
+    }
+
+    /// Runs until the execution ends, storing its result, or until it is suspended.
+    evm_execution_status run(evmc_result& final_result) noexcept
+    {
+        auto result =
+            m_frames.empty() ? enter(m_msg, 0, m_code, take_host_call_site<CodeAnalysis>(m_msg)) :
+                               resume_frame(*m_frames.back().state);
+        while (true)
+        {
+            auto& state = *m_frames.back().state;
+
+            if (result.status_code == EVM_STATE_PENDING)
+                return EVM_EXECUTION_PENDING;
+            if (result.status_code == EVM_PREEMPTED)
+                return EVM_EXECUTION_PREEMPTED;
+
+            if (result.status_code == EVM_CALL_SUSPENDED)
+            {
+                auto nested_msg = state.nested_call.msg;
+                int32_t snapshot = 0;
+                bytes_view nested_code;
+                const auto is_create =
+                    nested_msg.kind == EVMC_CREATE || nested_msg.kind == EVMC_CREATE2;
+                const auto* call_site = is_create ? nullptr : &find_call_site(state);
+                if (state.host_ext.enter_call(nested_msg, snapshot, nested_code))
+                {
+                    result = enter(nested_msg, snapshot, nested_code, call_site);
+                    continue;
+                }
+
+                const HostCallSiteScope<CodeAnalysis> host_call_site{
+                    call_site, state.msg->depth + 1};
+                auto host_result = call_host(state, state.nested_call.msg).release_raw();
+                const auto status = instr::core::finish_nested_call(state, host_result);
+                release(host_result);
+                result = (status == EVMC_SUCCESS) ? resume_frame(state) : make_failure(status);
+                continue;
+            }
+
+            if (m_frames.size() == 1)
+            {
+                m_vm.end_frame(state, result.status_code);
+                final_result = result;
+                return EVM_EXECUTION_DONE;
+            }
+
+            // The host can still fail a creation on code deposit: the frame ends with the status
+            // returned by leave_call().
+            state.host_ext.leave_call(m_frames.back().snapshot, result);
+            m_vm.end_frame(state, result.status_code);
+            m_frames.pop_back();
+
+            auto& caller = *m_frames.back().state;
+            const auto status = instr::core::finish_nested_call(caller, result);
+            release(result);
+            result = (status == EVMC_SUCCESS) ? resume_frame(caller) : make_failure(status);
+        }
+    }
+};
+
+evmc_result execute_call_frames(const VM& vm, const evmc_host_interface& host,
+    evmc_host_context* ctx, evmc_revision rev, const evmc_message& msg, bytes_view code) noexcept
+{
+    Execution execution{vm, host, ctx, rev, msg, code, false};
+    evmc_result result{};
+    [[maybe_unused]] const auto status = execution.run(result);
+    assert(status == EVM_EXECUTION_DONE);
+    return result;
+}
+}  // namespace evm::baseline
+
+struct evm_execution : evm::baseline::Execution
+{
+    using Execution::Execution;
+};
+
+extern "C" {
+EVMC_EXPORT evm_execution* evm_create_execution(evmc_vm* c_vm, const evmc_host_interface* host,
+    evmc_host_context* context, evmc_revision rev, const evmc_message* msg, const uint8_t* code,
+    size_t code_size) noexcept
+{
+    const auto& vm = *static_cast<evm::VM*>(c_vm);
+    if (!vm.is_stateless())
+        return nullptr;
+    const auto suspend_on_state =
+        vm.host_extensions != nullptr && vm.host_extensions->request_state != nullptr;
+    return new evm_execution{vm, *host, context, rev, *msg, {code, code_size}, suspend_on_state};
+}
+
+EVMC_EXPORT bool evm_set_execution_slice(evm_execution* execution, int64_t gas_slice) noexcept
+{
+    return execution->set_gas_slice(gas_slice);
+}
+
+EVMC_EXPORT evm_execution_status evm_run_execution(
+    evm_execution* execution, evmc_result* result) noexcept
+{
+    return execution->run(*result);
+}
+
+EVMC_EXPORT void evm_destroy_execution(evm_execution* execution) noexcept
+{
+    delete execution;
+}
+}
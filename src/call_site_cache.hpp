@@ -0,0 +1,116 @@
+#pragma once
+
+#include <evmc/evmc.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace evm
+{
+/// The inline cache of the callees of a CALL* instruction: the code address, its code hash and
+/// the analysis of its code, for up to `size` callees.
+///
+/// Entries are validated by the code hash reported by the host, so state changes between
+/// executions sharing the analysis of the caller miss. Entries are immutable, published with
+/// compare-and-swap and kept until the cache is destroyed, so analyses shared by threads
+/// (see evm_execute_batch()) share their caches without locks, and cached analyses live as long
+/// as the analysis of the caller. Call sites with more callees are left uncached.
+template <typename Analysis>
+class CallSiteCache
+{
+public:
+    static constexpr size_t size = 4;
+
+private:
+    struct Entry
+    {
+        evmc_revision rev;
+        evmc::address code_address;
+        evmc::bytes32 code_hash;
+        size_t code_size;
+        Analysis analysis;
+    };
+
+    mutable std::array<std::atomic<const Entry*>, size> m_entries{};
+
+public:
+    CallSiteCache() noexcept = default;
+    ~CallSiteCache() noexcept
+    {
+        for (auto& entry : m_entries)
+            delete entry.load(std::memory_order_relaxed);
+    }
+
+    CallSiteCache(const CallSiteCache&) = delete;
+    CallSiteCache& operator=(const CallSiteCache&) = delete;
+
+    /// Returns the analysis of the code of the message, analyzed with analyze(rev, code)
+    /// unless cached for the code address and hash, or null if all entries are taken.
+    template <typename AnalyzeFn>
+    const Analysis* get(const evmc::HostInterface& host, evmc_revision rev,
+        const evmc_message& msg, std::basic_string_view<uint8_t> code,
+        AnalyzeFn analyze) const noexcept
+    {
+        const auto code_hash = host.get_code_hash(msg.code_address);
+        std::unique_ptr<const Entry> new_entry;
+        for (auto& slot : m_entries)
+        {
+            const auto* entry = slot.load(std::memory_order_acquire);
+            if (entry == nullptr)
+            {
+                if (new_entry == nullptr)
+                {
+                    new_entry.reset(new Entry{
+                        rev, msg.code_address, code_hash, code.size(), analyze(rev, code)});
+                }
+                if (slot.compare_exchange_strong(entry, new_entry.get(),
+                        std::memory_order_acq_rel, std::memory_order_acquire))
+                    return &new_entry.release()->analysis;
+                // Taken by another thread, maybe for the same callee.
+            }
+            if (entry->rev == rev && entry->code_address == msg.code_address &&
+                entry->code_hash == code_hash && entry->code_size == code.size())
+                return &entry->analysis;
+        }
+        return nullptr;
+    }
+};
+
+/// The call site of the nested call the host is executing on this thread, and the depth of
+/// the callee, for the evmc entry point of the VM called back by the host.
+template <typename Analysis>
+struct HostCallSite
+{
+    const CallSiteCache<Analysis>* cache = nullptr;
+    int32_t depth = 0;
+};
+
+template <typename Analysis>
+inline thread_local HostCallSite<Analysis> host_call_site{};
+
+/// Installs the cache of the call site while the instruction calls the host.
+template <typename Analysis>
+class HostCallSiteScope
+{
+    HostCallSite<Analysis> m_caller_site;
+
+public:
+    HostCallSiteScope(const CallSiteCache<Analysis>* cache, int32_t depth) noexcept
+      : m_caller_site{std::exchange(host_call_site<Analysis>, {cache, depth})}
+    {}
+    ~HostCallSiteScope() noexcept { host_call_site<Analysis> = m_caller_site; }
+
+    HostCallSiteScope(const HostCallSiteScope&) = delete;
+    HostCallSiteScope& operator=(const HostCallSiteScope&) = delete;
+};
+
+/// Takes the call site installed for the message, so that its own nested calls do not see it.
+template <typename Analysis>
+inline const CallSiteCache<Analysis>* take_host_call_site(const evmc_message& msg) noexcept
+{
+    const auto site = std::exchange(host_call_site<Analysis>, {});
+    return site.depth == msg.depth ? site.cache : nullptr;
+}
+}  // namespace evm
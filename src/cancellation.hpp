@@ -0,0 +1,37 @@
+#pragma once
+
+#include <evm/evm.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+struct evm_cancellation_token
+{
+    std::atomic<bool> cancelled{false};
+};
+
+namespace evm
+{
+/// The cancellation token and the deadline of an execution, copied from the VM when it starts.
+///
+/// The interpreters poll it only at basic block entries, which all loops go through.
+/// The token is a relaxed load; the clock is read once per clock_interval polls of a frame.
+struct Cancellation
+{
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t clock_interval = 64;
+
+    const evm_cancellation_token* token = nullptr;
+    Clock::time_point deadline = Clock::time_point::max();
+
+    [[nodiscard]] bool is_active() const noexcept
+    {
+        return token != nullptr || deadline != Clock::time_point::max();
+    }
+};
+
+/// The cancellation of the frame calling the host on this thread, inherited by the nested
+/// frames the host executes instead of the one installed in the VM since.
+inline thread_local const Cancellation* host_caller_cancellation = nullptr;
+}  // namespace evm
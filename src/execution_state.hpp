@@ -1,5 +1,8 @@
 #pragma once
 
+#include "access_tracker.hpp"
+#include "cancellation.hpp"
+#include "host_extensions.hpp"
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
 #include <string>
@@ -7,6 +10,10 @@
 
 namespace evm
 {
+class GasEstimator;
+class LogArena;
+class StorageJournal;
+
 namespace advanced
 {
 struct AdvancedCodeAnalysis;
@@ -85,6 +92,23 @@ public:
     void clear() noexcept { m_size = 0; }
 };
 
+/// Internal status of a frame suspended on a nested call; never returned to the host.
+inline constexpr auto EVM_CALL_SUSPENDED = static_cast<evmc_status_code>(-1000);
+
+/// Internal status of a frame suspended on a state item being loaded by the host.
+inline constexpr auto EVM_STATE_PENDING = static_cast<evmc_status_code>(-1001);
+
+/// Internal status of a frame preempted at a JUMPDEST after its gas slice.
+inline constexpr auto EVM_PREEMPTED = static_cast<evmc_status_code>(-1002);
+
+/// A nested call prepared by CALL* or CREATE* for the caller of the interpreter to execute.
+struct NestedCall
+{
+    evmc_message msg{};
+    size_t output_offset = 0;
+    size_t output_size = 0;
+};
+
 class ExecutionState
 {
 public:
@@ -93,6 +117,11 @@ public:
     Memory memory;
     const evmc_message* msg = nullptr;
     evmc::HostContext host;
+
+    /// The context of the host, the host object itself for hosts derived from evmc::Host.
+    evmc_host_context* host_context = nullptr;
+
+    HostExtensions host_ext;
     evmc_revision rev = {};
     bytes return_data;
     bytes_view original_code;
@@ -101,8 +130,47 @@ public:
     size_t output_offset = 0;
     size_t output_size = 0;
 
+    StorageJournal* storage_journal = nullptr;
+    size_t storage_checkpoint = 0;
+    AccessTracker* access_tracker = nullptr;
+    AccessTracker::Checkpoint access_checkpoint;
+    LogArena* log_arena = nullptr;
+    size_t log_checkpoint = 0;
+
+    /// The gas estimation of the transaction, null if not enabled.
+    GasEstimator* gas_estimator = nullptr;
+
+    /// The minimum gas the frame must start with for the gas left checks passed so far,
+    /// tracked in gas estimation mode; the gas used is accounted for on exit.
+    int64_t gas_required = 0;
+
+    /// Pass storage, balances and log topics to the host extensions as native words.
+    bool native_words = false;
+
+    /// Execute calls to the precompiled contracts implemented natively in the VM.
+    bool precompiles = false;
+
+    /// Suspend the interpreter on CALL* and CREATE* instead of calling the host.
+    bool suspend_on_call = false;
+    NestedCall nested_call;
+
+    /// Suspend the interpreter on state items not loaded by the host (request_state extension).
+    bool suspend_on_state = false;
+
+    /// Preempt the baseline interpreter at the next JUMPDEST once gas_left is below this value.
+    int64_t preempt_gas_left = 0;
+
+    /// The cancellation polled at block entries if it is active.
+    Cancellation cancellation;
+    bool cancellable = false;
+    uint32_t clock_countdown = 1;
+
+    const uint8_t* resume_code = nullptr;
+    uint256* resume_stack_top = nullptr;
+
 private:
     evmc_tx_context m_tx = {};
+    const evmc_tx_context* m_tx_context = nullptr;
 
 public:
 
@@ -122,6 +190,7 @@ public:
       : gas_left{message.gas},
         msg{&message},
         host{host_interface, host_ctx},
+        host_context{host_ctx},
         rev{revision},
         original_code{_code}
     {}
@@ -135,22 +204,64 @@ public:
         memory.clear();
         msg = &message;
         host = {host_interface, host_ctx};
+        host_context = host_ctx;
+        host_ext = {};
         rev = revision;
         return_data.clear();
         original_code = _code;
         status = EVMC_SUCCESS;
         output_offset = 0;
         output_size = 0;
-        m_tx = {};
+        storage_journal = nullptr;
+        log_arena = nullptr;
+        storage_checkpoint = 0;
+        access_tracker = nullptr;
+        access_checkpoint = {};
+        gas_estimator = nullptr;
+        gas_required = 0;
+        native_words = false;
+        precompiles = false;
+        suspend_on_call = false;
+        suspend_on_state = false;
+        preempt_gas_left = 0;
+        cancellation = {};
+        cancellable = false;
+        clock_countdown = 1;
+        m_tx_context = nullptr;
+    }
+
+    void set_cancellation(const Cancellation& c) noexcept
+    {
+        cancellation = c;
+        cancellable = c.is_active();
+    }
+
+    /// Checks the cancellation, reading the clock every clock_interval calls or if read_clock.
+    [[nodiscard]] bool is_cancelled(bool read_clock = false) noexcept
+    {
+        if (cancellation.token != nullptr &&
+            cancellation.token->cancelled.load(std::memory_order_relaxed))
+            return true;
+        if (--clock_countdown != 0 && !read_clock)
+            return false;
+        clock_countdown = Cancellation::clock_interval;
+        return Cancellation::Clock::now() >= cancellation.deadline;
     }
 
     [[nodiscard]] bool in_static_mode() const { return (msg->flags & EVMC_STATIC) != 0; }
 
+    /// Uses the given context instead of fetching it from the host.
+    /// The context must outlive the execution.
+    void set_tx_context(const evmc_tx_context& tx_context) noexcept { m_tx_context = &tx_context; }
+
     const evmc_tx_context& get_tx_context() noexcept
     {
-        if (INTX_UNLIKELY(m_tx.block_timestamp == 0))
+        if (INTX_UNLIKELY(m_tx_context == nullptr))
+        {
             m_tx = host.get_tx_context();
-        return m_tx;
+            m_tx_context = &m_tx;
+        }
+        return *m_tx_context;
     }
 };
 }  // namespace evm
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <evmc/evmc.h>
+#include <cstdint>
+
+namespace evm
+{
+/// Transaction-scoped single-pass gas estimation.
+///
+/// The transaction is executed once with a gas limit high enough not to run out of gas.
+/// Each frame tracks the minimum gas it must start with to execute the same way: the gas it
+/// uses, and the gas left required by the SSTORE stipend check and by nested calls under
+/// the 63/64 rule (see ExecutionState::gas_required), plus the code deposit of a creation,
+/// charged by the host after the frame. Frames report this figure on exit, where the caller of
+/// a nested call picks it up. Code using the value of GAS other than as the gas of a call is
+/// assumed to behave the same with less gas.
+///
+/// A failed frame uses all its gas, so it is costed at all of it. The estimate of a caller
+/// catching the failure of a nested call therefore grows with the gas given to the call,
+/// up to the gas limit of the execution when the call is given all the gas left.
+class GasEstimator
+{
+    static constexpr int64_t unknown = -1;
+
+    int64_t m_frame_gas = unknown;
+
+public:
+    /// The cost of a byte of code deposited by a creation.
+    static constexpr int64_t code_deposit_cost = 200;
+
+    /// Forgets the last ended frame before a nested call is started.
+    void begin_call() noexcept { m_frame_gas = unknown; }
+
+    void end_frame(int64_t min_gas) noexcept { m_frame_gas = min_gas; }
+
+    /// Returns the minimum gas of the nested call with the given result. For calls not
+    /// executed by the VM, e.g. to precompiles, it is the gas used, or all gas on failure.
+    [[nodiscard]] int64_t callee_gas(
+        const evmc_message& msg, evmc_status_code status, int64_t gas_left) const noexcept
+    {
+        if (m_frame_gas != unknown)
+            return m_frame_gas;
+        return (status == EVMC_SUCCESS || status == EVMC_REVERT) ? msg.gas - gas_left : msg.gas;
+    }
+
+    /// Returns the minimum gas of the last ended frame, i.e. of the top-level frame after
+    /// an execution, -1 if none.
+    [[nodiscard]] int64_t estimate() const noexcept { return m_frame_gas; }
+};
+}  // namespace evm
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <evmc/evmc.hpp>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace evm
+{
+struct StorageKey
+{
+    evmc::address addr;
+    evmc::bytes32 key;
+
+    friend bool operator==(const StorageKey& a, const StorageKey& b) noexcept
+    {
+        return a.key == b.key && a.addr == b.addr;
+    }
+};
+
+inline constexpr uint64_t mix_hash(uint64_t x) noexcept
+{
+    x *= 0x9e3779b97f4a7c15;
+    return x ^ (x >> 32);
+}
+
+struct AddressHash
+{
+    size_t operator()(const evmc::address& addr) const noexcept
+    {
+        return static_cast<size_t>(
+            mix_hash(evmc::load64le(&addr.bytes[0]) ^ evmc::load64le(&addr.bytes[12])));
+    }
+};
+
+struct Bytes32Hash
+{
+    size_t operator()(const evmc::bytes32& key) const noexcept
+    {
+        return static_cast<size_t>(
+            mix_hash(evmc::load64le(&key.bytes[24]) ^ evmc::load64le(&key.bytes[0])));
+    }
+};
+
+struct StorageKeyHash
+{
+    size_t operator()(const StorageKey& k) const noexcept
+    {
+        // Storage keys are often small integers so the low-order (last) bytes must be included.
+        return static_cast<size_t>(mix_hash(evmc::load64le(&k.key.bytes[24]) ^
+                                            evmc::load64le(&k.key.bytes[0]) ^
+                                            evmc::load64le(&k.addr.bytes[12])));
+    }
+};
+
+/// Open-addressing hash set with linear probing, for small trivially copyable keys.
+/// Supports erase() so that insertions can be undone on revert.
+template <typename Key, typename Hash>
+class FlatHashSet
+{
+    struct Entry
+    {
+        Key key;
+        bool used;
+    };
+
+    std::vector<Entry> m_entries;
+    size_t m_size = 0;
+
+    [[nodiscard]] size_t mask() const noexcept { return m_entries.size() - 1; }
+
+    [[nodiscard]] size_t find_index(const Key& key) const noexcept
+    {
+        auto i = Hash{}(key) & mask();
+        while (m_entries[i].used && !(m_entries[i].key == key))
+            i = (i + 1) & mask();
+        return i;
+    }
+
+    void grow() noexcept
+    {
+        auto old_entries = std::move(m_entries);
+        m_entries.assign(old_entries.size() * 2, Entry{});
+        for (const auto& e : old_entries)
+        {
+            if (e.used)
+                m_entries[find_index(e.key)] = e;
+        }
+    }
+
+public:
+    explicit FlatHashSet(size_t capacity = 64) noexcept : m_entries(capacity, Entry{})
+    {
+        assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] bool contains(const Key& key) const noexcept
+    {
+        return m_entries[find_index(key)].used;
+    }
+
+    /// Returns true if the key was not in the set.
+    bool insert(const Key& key) noexcept
+    {
+        if ((m_size + 1) * 2 > m_entries.size())
+            grow();
+
+        auto& e = m_entries[find_index(key)];
+        if (e.used)
+            return false;
+        e = {key, true};
+        ++m_size;
+        return true;
+    }
+
+    void erase(const Key& key) noexcept
+    {
+        auto i = find_index(key);
+        if (!m_entries[i].used)
+            return;
+
+        // Backward-shift deletion: move later entries of the probe sequence into the hole.
+        for (auto j = (i + 1) & mask(); m_entries[j].used; j = (j + 1) & mask())
+        {
+            const auto home = Hash{}(m_entries[j].key) & mask();
+            const auto in_place = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (!in_place)
+            {
+                m_entries[i] = m_entries[j];
+                i = j;
+            }
+        }
+        m_entries[i].used = false;
+        --m_size;
+    }
+
+    void clear() noexcept
+    {
+        if (m_size == 0)
+            return;
+        for (auto& e : m_entries)
+            e.used = false;
+        m_size = 0;
+    }
+};
+
+/// Open-addressing hash map with linear probing, for small trivially copyable keys.
+/// The entries are allocated on the first insertion, so empty maps are cheap to nest.
+/// Insertions invalidate references to values.
+template <typename Key, typename Value, typename Hash>
+class FlatHashMap
+{
+    struct Entry
+    {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    std::vector<Entry> m_entries;
+    size_t m_size = 0;
+
+    [[nodiscard]] size_t mask() const noexcept { return m_entries.size() - 1; }
+
+    [[nodiscard]] size_t find_index(const Key& key) const noexcept
+    {
+        auto i = Hash{}(key) & mask();
+        while (m_entries[i].used && !(m_entries[i].key == key))
+            i = (i + 1) & mask();
+        return i;
+    }
+
+    void grow() noexcept
+    {
+        auto old_entries = std::move(m_entries);
+        m_entries.clear();
+        m_entries.resize(old_entries.empty() ? 16 : old_entries.size() * 2);
+        for (auto& e : old_entries)
+        {
+            if (e.used)
+                m_entries[find_index(e.key)] = std::move(e);
+        }
+    }
+
+public:
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] Value* find(const Key& key) noexcept
+    {
+        if (m_size == 0)
+            return nullptr;
+        auto& e = m_entries[find_index(key)];
+        return e.used ? &e.value : nullptr;
+    }
+
+    [[nodiscard]] const Value* find(const Key& key) const noexcept
+    {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+
+    /// Returns the value of the key, default-constructed if the key was not in the map,
+    /// and whether it has been inserted.
+    std::pair<Value&, bool> try_emplace(const Key& key) noexcept
+    {
+        if ((m_size + 1) * 2 > m_entries.size())
+            grow();
+
+        auto& e = m_entries[find_index(key)];
+        if (e.used)
+            return {e.value, false};
+        e.key = key;
+        e.used = true;
+        ++m_size;
+        return {e.value, true};
+    }
+
+    void erase(const Key& key) noexcept
+    {
+        if (m_size == 0)
+            return;
+        auto i = find_index(key);
+        if (!m_entries[i].used)
+            return;
+
+        for (auto j = (i + 1) & mask(); m_entries[j].used; j = (j + 1) & mask())
+        {
+            const auto home = Hash{}(m_entries[j].key) & mask();
+            const auto in_place = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (!in_place)
+            {
+                m_entries[i] = std::move(m_entries[j]);
+                i = j;
+            }
+        }
+        m_entries[i] = Entry{};
+        --m_size;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn)
+    {
+        for (auto& e : m_entries)
+        {
+            if (e.used)
+                fn(e.key, e.value);
+        }
+    }
+
+    void clear() noexcept
+    {
+        m_entries.clear();
+        m_size = 0;
+    }
+};
+}  // namespace evm
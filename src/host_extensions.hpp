@@ -0,0 +1,114 @@
+#pragma once
+
+#include <evm/evm.h>
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <cstring>
+#include <string_view>
+
+namespace evm
+{
+using bytes_view = std::basic_string_view<uint8_t>;
+
+static_assert(sizeof(evm_word) == sizeof(intx::uint256));
+// evm_word and intx::uint256 both store the least significant 64-bit word first.
+static_assert((intx::uint256{1} << 64)[1] == 1 && (intx::uint256{1} << 192)[3] == 1);
+
+inline evm_word to_word(const intx::uint256& x) noexcept
+{
+    evm_word word;
+    std::memcpy(&word, &x, sizeof(word));
+    return word;
+}
+
+inline intx::uint256 from_word(const evm_word& word) noexcept
+{
+    intx::uint256 x;
+    std::memcpy(&x, &word, sizeof(x));
+    return x;
+}
+
+/// Binds the optional evm_host_extensions table to the host context of an execution,
+/// the same way evmc::HostContext wraps evmc_host_interface.
+class HostExtensions
+{
+    const evm_host_extensions* m_extensions = nullptr;
+    evmc_host_context* m_context = nullptr;
+
+public:
+    HostExtensions() noexcept = default;
+
+    HostExtensions(const evm_host_extensions* extensions, evmc_host_context* ctx) noexcept
+      : m_extensions{extensions}, m_context{ctx}
+    {}
+
+    [[nodiscard]] const evm_host_extensions* get_extensions() const noexcept
+    {
+        return m_extensions;
+    }
+
+    [[nodiscard]] evmc::bytes32 get_original_storage(
+        const evmc::address& addr, const evmc::bytes32& key) const noexcept
+    {
+        return m_extensions->get_original_storage(m_context, &addr, &key);
+    }
+
+    void prefetch_storage(
+        const evmc::address& addr, const evmc::bytes32* keys, size_t num_keys) const noexcept
+    {
+        m_extensions->prefetch_storage(m_context, &addr, keys, num_keys);
+    }
+
+    bool enter_call(evmc_message& msg, int32_t& snapshot, bytes_view& code) const noexcept
+    {
+        const uint8_t* code_data = nullptr;
+        size_t code_size = 0;
+        if (!m_extensions->enter_call(m_context, &msg, &snapshot, &code_data, &code_size))
+            return false;
+        code = {code_data, code_size};
+        return true;
+    }
+
+    void leave_call(int32_t snapshot, evmc_result& result) const noexcept
+    {
+        m_extensions->leave_call(m_context, snapshot, &result);
+    }
+
+    [[nodiscard]] intx::uint256 get_storage(
+        const evmc::address& addr, const intx::uint256& key) const noexcept
+    {
+        const auto key_word = to_word(key);
+        return from_word(m_extensions->get_storage_word(m_context, &addr, &key_word));
+    }
+
+    evmc_storage_status set_storage(const evmc::address& addr, const intx::uint256& key,
+        const intx::uint256& value) const noexcept
+    {
+        const auto key_word = to_word(key);
+        const auto value_word = to_word(value);
+        return m_extensions->set_storage_word(m_context, &addr, &key_word, &value_word);
+    }
+
+    [[nodiscard]] intx::uint256 get_balance(const evmc::address& addr) const noexcept
+    {
+        return from_word(m_extensions->get_balance_word(m_context, &addr));
+    }
+
+    void emit_log(const evmc::address& addr, const uint8_t* data, size_t data_size,
+        const evm_word topics[], size_t num_topics) const noexcept
+    {
+        m_extensions->emit_log_words(m_context, &addr, data, data_size, topics, num_topics);
+    }
+
+    void emit_logs(const evm_log* logs, size_t num_logs) const noexcept
+    {
+        m_extensions->emit_logs(m_context, logs, num_logs);
+    }
+
+    [[nodiscard]] bool request_state(
+        evm_state_kind kind, const evmc::address& addr, const evmc::bytes32* key) const noexcept
+    {
+        return m_extensions->request_state(m_context, kind, &addr, key);
+    }
+};
+}  // namespace evm
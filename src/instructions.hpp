@@ -4,6 +4,8 @@
 #include "execution_state.hpp"
 #include "instructions_traits.hpp"
 #include "instructions_xmacro.hpp"
+#include "log_arena.hpp"
+#include "storage_journal.hpp"
 #include <ethash/keccak.hpp>
 
 namespace evm
@@ -27,6 +29,21 @@ struct StopToken
     const evmc_status_code status;
 };
 
+/// The revision parameter of the instructions and the interpreter loops taking the revision
+/// from the execution state. Other instantiations are specialized for a single revision,
+/// so that their revision checks and costs are constants.
+inline constexpr int any_revision = -1;
+
+/// Returns the revision Rev, or the revision of the execution for any_revision.
+template <int Rev>
+inline evmc_revision get_revision(const ExecutionState& state) noexcept
+{
+    if constexpr (Rev == any_revision)
+        return state.rev;
+    else
+        return static_cast<evmc_revision>(Rev);
+}
+
 constexpr auto max_buffer_size = std::numeric_limits<uint32_t>::max();
 
 constexpr auto word_size = 32;
@@ -36,21 +53,44 @@ inline constexpr int64_t num_words(uint64_t size_in_bytes) noexcept
     return static_cast<int64_t>((size_in_bytes + (word_size - 1)) / word_size);
 }
 
+/// The memory size limit of the frames executed by the unmetered loops, which do not charge
+/// for memory expansion. Nested calls may use up to the call depth limit times as much.
+constexpr auto max_unmetered_memory_size = 16 * 1024 * 1024;
+
+/// Charges the cost of the instruction beyond its base cost in the metered loops. The unmetered
+/// loops charge nothing and drop the computation of the cost. Returns false if out of gas.
+template <bool Metered>
+[[nodiscard]] inline bool charge_gas(
+    [[maybe_unused]] ExecutionState& state, [[maybe_unused]] int64_t cost) noexcept
+{
+    if constexpr (Metered)
+        return (state.gas_left -= cost) >= 0;
+    else
+        return true;
+}
+
+template <bool Metered>
 [[gnu::noinline]] inline bool grow_memory(ExecutionState& state, uint64_t new_size) noexcept
 {
     const auto new_words = num_words(new_size);
-    const auto current_words = static_cast<int64_t>(state.memory.size() / word_size);
-    const auto new_cost = 3 * new_words + new_words * new_words / 512;
-    const auto current_cost = 3 * current_words + current_words * current_words / 512;
-    const auto cost = new_cost - current_cost;
+    if constexpr (Metered)
+    {
+        const auto current_words = static_cast<int64_t>(state.memory.size() / word_size);
+        const auto new_cost = 3 * new_words + new_words * new_words / 512;
+        const auto current_cost = 3 * current_words + current_words * current_words / 512;
+        const auto cost = new_cost - current_cost;
 
-    if ((state.gas_left -= cost) < 0)
+        if ((state.gas_left -= cost) < 0)
+            return false;
+    }
+    else if (new_size > max_unmetered_memory_size)
         return false;
 
     state.memory.grow(static_cast<size_t>(new_words * word_size));
     return true;
 }
 
+template <bool Metered>
 inline bool check_memory(ExecutionState& state, const uint256& offset, uint64_t size) noexcept
 {
     if (((offset[3] | offset[2] | offset[1]) != 0) || (offset[0] > max_buffer_size))
@@ -58,11 +98,12 @@ inline bool check_memory(ExecutionState& state, const uint256& offset, uint64_t
 
     const auto new_size = static_cast<uint64_t>(offset) + size;
     if (new_size > state.memory.size())
-        return grow_memory(state, new_size);
+        return grow_memory<Metered>(state, new_size);
 
     return true;
 }
 
+template <bool Metered>
 inline bool check_memory(ExecutionState& state, const uint256& offset, const uint256& size) noexcept
 {
     if (size == 0)
@@ -71,7 +112,93 @@ inline bool check_memory(ExecutionState& state, const uint256& offset, const uin
     if (((size[3] | size[2] | size[1]) != 0) || (size[0] > max_buffer_size))
         return false;
 
-    return check_memory(state, offset, static_cast<uint64_t>(size));
+    return check_memory<Metered>(state, offset, static_cast<uint64_t>(size));
+}
+
+/// Returns the host of the execution as an instance of the Host type, so that its methods are
+/// called directly instead of through the evmc_host_interface. Host is evmc::HostContext, the
+/// host of the evmc C ABI, or the final type of an evmc::Host whose context the state was
+/// created with.
+template <typename Host>
+inline Host& get_host(ExecutionState& state) noexcept
+{
+    if constexpr (std::is_same_v<Host, evmc::HostContext>)
+        return state.host;
+    else
+        return *evmc::Host::from_context<Host>(state.host_context);
+}
+
+template <typename Host = evmc::HostContext>
+inline evmc_access_status access_account(ExecutionState& state, const evmc::address& addr) noexcept
+{
+    auto& host = get_host<Host>(state);
+    if (state.access_tracker != nullptr)
+        return state.access_tracker->access_account(host, addr);
+    return host.access_account(addr);
+}
+
+template <typename Host = evmc::HostContext>
+inline evmc_access_status access_storage(ExecutionState& state, const evmc::bytes32& key) noexcept
+{
+    auto& host = get_host<Host>(state);
+    if (state.access_tracker != nullptr)
+        return state.access_tracker->access_storage(host, state.msg->recipient, key);
+    return host.access_storage(state.msg->recipient, key);
+}
+
+/// Executes a nested message with the host.
+///
+/// The callee's frame keeps its changes to the transaction-scoped VM state when the interpreter
+/// succeeds, but the host can still fail the message afterwards, e.g. a creation on code
+/// deposit. The changes made since the call are then dropped here.
+inline evmc::Result call_host(ExecutionState& state, const evmc_message& msg) noexcept
+{
+    auto* const journal = state.storage_journal;
+    const auto storage_checkpoint = (journal != nullptr) ? journal->checkpoint() : 0;
+    auto* const tracker = state.access_tracker;
+    const auto access_checkpoint =
+        (tracker != nullptr) ? tracker->checkpoint() : AccessTracker::Checkpoint{};
+    auto* const arena = state.log_arena;
+    const auto log_checkpoint = (arena != nullptr) ? arena->checkpoint() : 0;
+
+    const auto* const caller_cancellation = host_caller_cancellation;
+    host_caller_cancellation = &state.cancellation;
+    auto result = state.host.call(msg);
+    host_caller_cancellation = caller_cancellation;
+    if (result.status_code != EVMC_SUCCESS)
+    {
+        if (journal != nullptr)
+            journal->rollback(storage_checkpoint);
+        if (tracker != nullptr)
+            tracker->rollback(access_checkpoint);
+        if (arena != nullptr)
+            arena->rollback(log_checkpoint);
+    }
+    return result;
+}
+
+/// Records, in gas estimation mode, that the frame needs at least min_gas_left gas left
+/// at this point for the same execution.
+inline void require_gas_left(ExecutionState& state, int64_t min_gas_left) noexcept
+{
+    state.gas_required =
+        std::max(state.gas_required, state.msg->gas - state.gas_left + min_gas_left);
+}
+
+/// Returns false if the host has not loaded the state item: the instruction must then return
+/// EVM_STATE_PENDING before any side effect, to be re-executed when the frame is resumed.
+inline bool is_state_ready(ExecutionState& state, evm_state_kind kind, const evmc::address& addr,
+    const evmc::bytes32* key = nullptr) noexcept
+{
+    return !state.suspend_on_state || state.host_ext.request_state(kind, addr, key);
+}
+
+template <typename Host = evmc::HostContext>
+inline uint256 get_balance(ExecutionState& state, const evmc::address& addr) noexcept
+{
+    if (state.native_words)
+        return state.host_ext.get_balance(addr);
+    return intx::be::load<uint256>(get_host<Host>(state).get_balance(addr));
 }
 
 namespace instr::core
@@ -79,7 +206,15 @@ namespace instr::core
 
 inline void noop(StackTop /*stack*/) noexcept {}
 inline constexpr auto pop = noop;
-inline constexpr auto jumpdest = noop;
+
+/// Basic block entry, where a baseline execution can be cancelled or preempted.
+/// In advanced execution it is replaced by the block's OPX_BEGINBLOCK.
+inline evmc_status_code jumpdest(StackTop /*stack*/, ExecutionState& state) noexcept
+{
+    if (INTX_UNLIKELY(state.cancellable) && state.is_cancelled())
+        return EVM_CANCELLED;
+    return INTX_UNLIKELY(state.gas_left < state.preempt_gas_left) ? EVM_PREEMPTED : EVMC_SUCCESS;
+}
 
 template <evmc_status_code Status>
 inline StopToken stop_impl() noexcept
@@ -144,21 +279,23 @@ inline void mulmod(StackTop stack) noexcept
     m = m != 0 ? intx::mulmod(x, y, m) : 0;
 }
 
-inline evmc_status_code exp(StackTop stack, ExecutionState& state) noexcept
+template <int Rev, bool Metered>
+inline evmc_status_code exp_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& base = stack.pop();
     auto& exponent = stack.top();
 
     const auto exponent_significant_bytes =
         static_cast<int>(intx::count_significant_bytes(exponent));
-    const auto exponent_cost = state.rev >= EVMC_SPURIOUS_DRAGON ? 50 : 10;
+    const auto exponent_cost = get_revision<Rev>(state) >= EVMC_SPURIOUS_DRAGON ? 50 : 10;
     const auto additional_cost = exponent_significant_bytes * exponent_cost;
-    if ((state.gas_left -= additional_cost) < 0)
+    if (!charge_gas<Metered>(state, additional_cost))
         return EVMC_OUT_OF_GAS;
 
     exponent = intx::exp(base, exponent);
     return EVMC_SUCCESS;
 }
+inline constexpr auto exp = exp_impl<any_revision, true>;
 
 inline void signextend(StackTop stack) noexcept
 {
@@ -279,25 +416,27 @@ inline void sar(StackTop stack) noexcept
     x = (x >> y) | (sign_mask << mask_shift);
 }
 
-inline evmc_status_code keccak256(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code keccak256_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& index = stack.pop();
     auto& size = stack.top();
 
-    if (!check_memory(state, index, size))
+    if (!check_memory<Metered>(state, index, size))
         return EVMC_OUT_OF_GAS;
 
     const auto i = static_cast<size_t>(index);
     const auto s = static_cast<size_t>(size);
     const auto w = num_words(s);
     const auto cost = w * 6;
-    if ((state.gas_left -= cost) < 0)
+    if (!charge_gas<Metered>(state, cost))
         return EVMC_OUT_OF_GAS;
 
     auto data = s != 0 ? &state.memory[i] : nullptr;
     size = intx::be::load<uint256>(ethash::keccak256(data, s));
     return EVMC_SUCCESS;
 }
+inline constexpr auto keccak256 = keccak256_impl<true>;
 
 
 inline void address(StackTop stack, ExecutionState& state) noexcept
@@ -305,20 +444,25 @@ inline void address(StackTop stack, ExecutionState& state) noexcept
     stack.push(intx::be::load<uint256>(state.msg->recipient));
 }
 
-inline evmc_status_code balance(StackTop stack, ExecutionState& state) noexcept
+template <int Rev, bool Metered, typename Host>
+inline evmc_status_code balance_impl(StackTop stack, ExecutionState& state) noexcept
 {
     auto& x = stack.top();
     const auto addr = intx::be::trunc<evmc::address>(x);
+    if (!is_state_ready(state, EVM_STATE_BALANCE, addr))
+        return EVM_STATE_PENDING;
 
-    if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+    if (get_revision<Rev>(state) >= EVMC_BERLIN &&
+        access_account<Host>(state, addr) == EVMC_ACCESS_COLD)
     {
-        if ((state.gas_left -= instr::additional_cold_account_access_cost) < 0)
+        if (!charge_gas<Metered>(state, instr::additional_cold_account_access_cost))
             return EVMC_OUT_OF_GAS;
     }
 
-    x = intx::be::load<uint256>(state.host.get_balance(addr));
+    x = get_balance<Host>(state, addr);
     return EVMC_SUCCESS;
 }
+inline constexpr auto balance = balance_impl<any_revision, true, evmc::HostContext>;
 
 inline void origin(StackTop stack, ExecutionState& state) noexcept
 {
@@ -359,13 +503,14 @@ inline void calldatasize(StackTop stack, ExecutionState& state) noexcept
     stack.push(state.msg->input_size);
 }
 
-inline evmc_status_code calldatacopy(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code calldatacopy_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& mem_index = stack.pop();
     const auto& input_index = stack.pop();
     const auto& size = stack.pop();
 
-    if (!check_memory(state, mem_index, size))
+    if (!check_memory<Metered>(state, mem_index, size))
         return EVMC_OUT_OF_GAS;
 
     auto dst = static_cast<size_t>(mem_index);
@@ -375,7 +520,7 @@ inline evmc_status_code calldatacopy(StackTop stack, ExecutionState& state) noex
     auto copy_size = std::min(s, state.msg->input_size - src);
 
     const auto copy_cost = num_words(s) * 3;
-    if ((state.gas_left -= copy_cost) < 0)
+    if (!charge_gas<Metered>(state, copy_cost))
         return EVMC_OUT_OF_GAS;
 
     if (copy_size > 0)
@@ -386,19 +531,21 @@ inline evmc_status_code calldatacopy(StackTop stack, ExecutionState& state) noex
 
     return EVMC_SUCCESS;
 }
+inline constexpr auto calldatacopy = calldatacopy_impl<true>;
 
 inline void codesize(StackTop stack, ExecutionState& state) noexcept
 {
     stack.push(state.original_code.size());
 }
 
-inline evmc_status_code codecopy(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code codecopy_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& mem_index = stack.pop();
     const auto& input_index = stack.pop();
     const auto& size = stack.pop();
 
-    if (!check_memory(state, mem_index, size))
+    if (!check_memory<Metered>(state, mem_index, size))
         return EVMC_OUT_OF_GAS;
 
     const auto code_size = state.original_code.size();
@@ -408,7 +555,7 @@ inline evmc_status_code codecopy(StackTop stack, ExecutionState& state) noexcept
     const auto copy_size = std::min(s, code_size - src);
 
     const auto copy_cost = num_words(s) * 3;
-    if ((state.gas_left -= copy_cost) < 0)
+    if (!charge_gas<Metered>(state, copy_cost))
         return EVMC_OUT_OF_GAS;
     if (copy_size > 0)
         std::memcpy(&state.memory[dst], &state.original_code[src], copy_size);
@@ -418,6 +565,7 @@ inline evmc_status_code codecopy(StackTop stack, ExecutionState& state) noexcept
 
     return EVMC_SUCCESS;
 }
+inline constexpr auto codecopy = codecopy_impl<true>;
 
 
 inline void gasprice(StackTop stack, ExecutionState& state) noexcept
@@ -430,39 +578,49 @@ inline void basefee(StackTop stack, ExecutionState& state) noexcept
     stack.push(intx::be::load<uint256>(state.get_tx_context().block_base_fee));
 }
 
-inline evmc_status_code extcodesize(StackTop stack, ExecutionState& state) noexcept
+template <int Rev, bool Metered, typename Host>
+inline evmc_status_code extcodesize_impl(StackTop stack, ExecutionState& state) noexcept
 {
     auto& x = stack.top();
     const auto addr = intx::be::trunc<evmc::address>(x);
+    if (!is_state_ready(state, EVM_STATE_CODE, addr))
+        return EVM_STATE_PENDING;
 
-    if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+    if (get_revision<Rev>(state) >= EVMC_BERLIN &&
+        access_account<Host>(state, addr) == EVMC_ACCESS_COLD)
     {
-        if ((state.gas_left -= instr::additional_cold_account_access_cost) < 0)
+        if (!charge_gas<Metered>(state, instr::additional_cold_account_access_cost))
             return EVMC_OUT_OF_GAS;
     }
 
-    x = state.host.get_code_size(addr);
+    x = get_host<Host>(state).get_code_size(addr);
     return EVMC_SUCCESS;
 }
+inline constexpr auto extcodesize = extcodesize_impl<any_revision, true, evmc::HostContext>;
 
-inline evmc_status_code extcodecopy(StackTop stack, ExecutionState& state) noexcept
+template <int Rev, bool Metered, typename Host>
+inline evmc_status_code extcodecopy_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto addr = intx::be::trunc<evmc::address>(stack.pop());
     const auto& mem_index = stack.pop();
     const auto& input_index = stack.pop();
     const auto& size = stack.pop();
 
-    if (!check_memory(state, mem_index, size))
+    if (!is_state_ready(state, EVM_STATE_CODE, addr))
+        return EVM_STATE_PENDING;
+
+    if (!check_memory<Metered>(state, mem_index, size))
         return EVMC_OUT_OF_GAS;
 
     const auto s = static_cast<size_t>(size);
     const auto copy_cost = num_words(s) * 3;
-    if ((state.gas_left -= copy_cost) < 0)
+    if (!charge_gas<Metered>(state, copy_cost))
         return EVMC_OUT_OF_GAS;
 
-    if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+    if (get_revision<Rev>(state) >= EVMC_BERLIN &&
+        access_account<Host>(state, addr) == EVMC_ACCESS_COLD)
     {
-        if ((state.gas_left -= instr::additional_cold_account_access_cost) < 0)
+        if (!charge_gas<Metered>(state, instr::additional_cold_account_access_cost))
             return EVMC_OUT_OF_GAS;
     }
 
@@ -471,26 +629,29 @@ inline evmc_status_code extcodecopy(StackTop stack, ExecutionState& state) noexc
         const auto src =
             (max_buffer_size < input_index) ? max_buffer_size : static_cast<size_t>(input_index);
         const auto dst = static_cast<size_t>(mem_index);
-        const auto num_bytes_copied = state.host.copy_code(addr, src, &state.memory[dst], s);
+        const auto num_bytes_copied =
+            get_host<Host>(state).copy_code(addr, src, &state.memory[dst], s);
         if (const auto num_bytes_to_clear = s - num_bytes_copied; num_bytes_to_clear > 0)
             std::memset(&state.memory[dst + num_bytes_copied], 0, num_bytes_to_clear);
     }
 
     return EVMC_SUCCESS;
 }
+inline constexpr auto extcodecopy = extcodecopy_impl<any_revision, true, evmc::HostContext>;
 
 inline void returndatasize(StackTop stack, ExecutionState& state) noexcept
 {
     stack.push(state.return_data.size());
 }
 
-inline evmc_status_code returndatacopy(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code returndatacopy_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& mem_index = stack.pop();
     const auto& input_index = stack.pop();
     const auto& size = stack.pop();
 
-    if (!check_memory(state, mem_index, size))
+    if (!check_memory<Metered>(state, mem_index, size))
         return EVMC_OUT_OF_GAS;
 
     auto dst = static_cast<size_t>(mem_index);
@@ -504,7 +665,7 @@ inline evmc_status_code returndatacopy(StackTop stack, ExecutionState& state) no
         return EVMC_INVALID_MEMORY_ACCESS;
 
     const auto copy_cost = num_words(s) * 3;
-    if ((state.gas_left -= copy_cost) < 0)
+    if (!charge_gas<Metered>(state, copy_cost))
         return EVMC_OUT_OF_GAS;
 
     if (s > 0)
@@ -512,24 +673,31 @@ inline evmc_status_code returndatacopy(StackTop stack, ExecutionState& state) no
 
     return EVMC_SUCCESS;
 }
+inline constexpr auto returndatacopy = returndatacopy_impl<true>;
 
-inline evmc_status_code extcodehash(StackTop stack, ExecutionState& state) noexcept
+template <int Rev, bool Metered, typename Host>
+inline evmc_status_code extcodehash_impl(StackTop stack, ExecutionState& state) noexcept
 {
     auto& x = stack.top();
     const auto addr = intx::be::trunc<evmc::address>(x);
+    if (!is_state_ready(state, EVM_STATE_CODE, addr))
+        return EVM_STATE_PENDING;
 
-    if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+    if (get_revision<Rev>(state) >= EVMC_BERLIN &&
+        access_account<Host>(state, addr) == EVMC_ACCESS_COLD)
     {
-        if ((state.gas_left -= instr::additional_cold_account_access_cost) < 0)
+        if (!charge_gas<Metered>(state, instr::additional_cold_account_access_cost))
             return EVMC_OUT_OF_GAS;
     }
 
-    x = intx::be::load<uint256>(state.host.get_code_hash(addr));
+    x = intx::be::load<uint256>(get_host<Host>(state).get_code_hash(addr));
     return EVMC_SUCCESS;
 }
+inline constexpr auto extcodehash = extcodehash_impl<any_revision, true, evmc::HostContext>;
 
 
-inline void blockhash(StackTop stack, ExecutionState& state) noexcept
+template <typename Host>
+inline void blockhash_impl(StackTop stack, ExecutionState& state) noexcept
 {
     auto& number = stack.top();
 
@@ -537,9 +705,11 @@ inline void blockhash(StackTop stack, ExecutionState& state) noexcept
     const auto lower_bound = std::max(upper_bound - 256, decltype(upper_bound){0});
     const auto n = static_cast<int64_t>(number);
     const auto header =
-        (number < upper_bound && n >= lower_bound) ? state.host.get_block_hash(n) : evmc::bytes32{};
+        (number < upper_bound && n >= lower_bound) ? get_host<Host>(state).get_block_hash(n) :
+                                                     evmc::bytes32{};
     number = intx::be::load<uint256>(header);
 }
+inline constexpr auto blockhash = blockhash_impl<evmc::HostContext>;
 
 inline void coinbase(StackTop stack, ExecutionState& state) noexcept
 {
@@ -571,49 +741,223 @@ inline void chainid(StackTop stack, ExecutionState& state) noexcept
     stack.push(intx::be::load<uint256>(state.get_tx_context().chain_id));
 }
 
-inline void selfbalance(StackTop stack, ExecutionState& state) noexcept
+template <typename Host>
+inline evmc_status_code selfbalance_impl(StackTop stack, ExecutionState& state) noexcept
 {
-    stack.push(intx::be::load<uint256>(state.host.get_balance(state.msg->recipient)));
+    if (!is_state_ready(state, EVM_STATE_BALANCE, state.msg->recipient))
+        return EVM_STATE_PENDING;
+    stack.push(get_balance<Host>(state, state.msg->recipient));
+    return EVMC_SUCCESS;
 }
+inline constexpr auto selfbalance = selfbalance_impl<evmc::HostContext>;
 
-inline evmc_status_code mload(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code mload_impl(StackTop stack, ExecutionState& state) noexcept
 {
     auto& index = stack.top();
 
-    if (!check_memory(state, index, 32))
+    if (!check_memory<Metered>(state, index, 32))
         return EVMC_OUT_OF_GAS;
 
     index = intx::be::unsafe::load<uint256>(&state.memory[static_cast<size_t>(index)]);
     return EVMC_SUCCESS;
 }
+inline constexpr auto mload = mload_impl<true>;
 
-inline evmc_status_code mstore(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code mstore_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& index = stack.pop();
     const auto& value = stack.pop();
 
-    if (!check_memory(state, index, 32))
+    if (!check_memory<Metered>(state, index, 32))
         return EVMC_OUT_OF_GAS;
 
     intx::be::unsafe::store(&state.memory[static_cast<size_t>(index)], value);
     return EVMC_SUCCESS;
 }
+inline constexpr auto mstore = mstore_impl<true>;
 
-inline evmc_status_code mstore8(StackTop stack, ExecutionState& state) noexcept
+template <bool Metered>
+inline evmc_status_code mstore8_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& index = stack.pop();
     const auto& value = stack.pop();
 
-    if (!check_memory(state, index, 1))
+    if (!check_memory<Metered>(state, index, 1))
         return EVMC_OUT_OF_GAS;
 
     state.memory[static_cast<size_t>(index)] = static_cast<uint8_t>(value);
     return EVMC_SUCCESS;
 }
+inline constexpr auto mstore8 = mstore8_impl<true>;
+
+struct StorageCostSpec
+{
+    bool net_cost;
+    int16_t warm_access;
+    int16_t set;
+    int16_t reset;
+    int16_t clear;
+};
+
+inline constexpr auto storage_cost_spec = []() noexcept {
+    std::array<StorageCostSpec, EVMC_MAX_REVISION + 1> tbl{};
+    for (auto rev : {EVMC_FRONTIER, EVMC_HOMESTEAD, EVMC_TANGERINE_WHISTLE, EVMC_SPURIOUS_DRAGON,
+             EVMC_BYZANTIUM, EVMC_PETERSBURG})
+        tbl[rev] = {false, 200, 20000, 5000, 15000};
+
+    tbl[EVMC_CONSTANTINOPLE] = {true, 200, 20000, 5000, 15000};
+    tbl[EVMC_ISTANBUL] = {true, 800, 20000, 5000, 15000};
+    tbl[EVMC_BERLIN] = {
+        true, instr::warm_storage_read_cost, 20000, 5000 - instr::cold_sload_cost, 15000};
+    tbl[EVMC_LONDON] = {
+        true, instr::warm_storage_read_cost, 20000, 5000 - instr::cold_sload_cost, 4800};
+    tbl[EVMC_PARIS] = tbl[EVMC_LONDON];
+    tbl[EVMC_SHANGHAI] = tbl[EVMC_LONDON];
+    tbl[EVMC_CANCUN] = tbl[EVMC_LONDON];
+    return tbl;
+}();
+
+struct StorageStoreCost
+{
+    int16_t gas_cost;
+    int16_t gas_refund;
+};
+
+inline constexpr auto sstore_costs = []() noexcept {
+    std::array<std::array<StorageStoreCost, EVMC_STORAGE_MODIFIED_RESTORED + 1>,
+        EVMC_MAX_REVISION + 1>
+        tbl{};
+
+    for (size_t rev = EVMC_FRONTIER; rev <= EVMC_MAX_REVISION; ++rev)
+    {
+        auto& e = tbl[rev];
+        if (const auto c = storage_cost_spec[rev]; !c.net_cost)
+        {
+            e[EVMC_STORAGE_ADDED] = {c.set, 0};
+            e[EVMC_STORAGE_DELETED] = {c.reset, c.clear};
+            e[EVMC_STORAGE_MODIFIED] = {c.reset, 0};
+            e[EVMC_STORAGE_ASSIGNED] = e[EVMC_STORAGE_MODIFIED];
+            e[EVMC_STORAGE_DELETED_ADDED] = e[EVMC_STORAGE_ADDED];
+            e[EVMC_STORAGE_MODIFIED_DELETED] = e[EVMC_STORAGE_DELETED];
+            e[EVMC_STORAGE_DELETED_RESTORED] = e[EVMC_STORAGE_ADDED];
+            e[EVMC_STORAGE_ADDED_DELETED] = e[EVMC_STORAGE_DELETED];
+            e[EVMC_STORAGE_MODIFIED_RESTORED] = e[EVMC_STORAGE_MODIFIED];
+        }
+        else
+        {
+            e[EVMC_STORAGE_ASSIGNED] = {c.warm_access, 0};
+            e[EVMC_STORAGE_ADDED] = {c.set, 0};
+            e[EVMC_STORAGE_DELETED] = {c.reset, c.clear};
+            e[EVMC_STORAGE_MODIFIED] = {c.reset, 0};
+            e[EVMC_STORAGE_DELETED_ADDED] = {c.warm_access, static_cast<int16_t>(-c.clear)};
+            e[EVMC_STORAGE_MODIFIED_DELETED] = {c.warm_access, c.clear};
+            e[EVMC_STORAGE_DELETED_RESTORED] = {
+                c.warm_access, static_cast<int16_t>(c.reset - c.warm_access - c.clear)};
+            e[EVMC_STORAGE_ADDED_DELETED] = {
+                c.warm_access, static_cast<int16_t>(c.set - c.warm_access)};
+            e[EVMC_STORAGE_MODIFIED_RESTORED] = {
+                c.warm_access, static_cast<int16_t>(c.reset - c.warm_access)};
+        }
+    }
+
+    return tbl;
+}();
+
+template <typename Host>
+inline uint256 get_storage(ExecutionState& state, const uint256& key) noexcept
+{
+    const auto& addr = state.msg->recipient;
+    if (state.native_words && state.storage_journal == nullptr)
+        return state.host_ext.get_storage(addr, key);
+
+    const auto k = intx::be::store<evmc::bytes32>(key);
+    if (state.storage_journal != nullptr)
+        return intx::be::load<uint256>(
+            state.storage_journal->load(state.host, state.host_ext, addr, k));
+    return intx::be::load<uint256>(get_host<Host>(state).get_storage(addr, k));
+}
+
+template <typename Host>
+inline evmc_storage_status set_storage(
+    ExecutionState& state, const uint256& key, const uint256& value) noexcept
+{
+    const auto& addr = state.msg->recipient;
+    if (state.native_words && state.storage_journal == nullptr)
+        return state.host_ext.set_storage(addr, key, value);
+
+    const auto k = intx::be::store<evmc::bytes32>(key);
+    const auto v = intx::be::store<evmc::bytes32>(value);
+    if (state.storage_journal != nullptr)
+        return state.storage_journal->store(state.host, state.host_ext, addr, k, v);
+    return get_host<Host>(state).set_storage(addr, k, v);
+}
+
+template <int Rev, bool Metered, typename Host>
+inline evmc_status_code sload_impl(StackTop stack, ExecutionState& state) noexcept
+{
+    const auto rev = get_revision<Rev>(state);
+    auto& x = stack.top();
+    if (state.suspend_on_state || rev >= EVMC_BERLIN)
+    {
+        const auto key = intx::be::store<evmc::bytes32>(x);
+        if (!is_state_ready(state, EVM_STATE_STORAGE, state.msg->recipient, &key))
+            return EVM_STATE_PENDING;
+
+        if (rev >= EVMC_BERLIN && access_storage<Host>(state, key) == EVMC_ACCESS_COLD)
+        {
+            constexpr auto additional_cold_sload_cost =
+                instr::cold_sload_cost - instr::warm_storage_read_cost;
+            if (!charge_gas<Metered>(state, additional_cold_sload_cost))
+                return EVMC_OUT_OF_GAS;
+        }
+    }
+    x = get_storage<Host>(state, x);
+    return EVMC_SUCCESS;
+}
+inline constexpr auto sload = sload_impl<any_revision, true, evmc::HostContext>;
 
-evmc_status_code sload(StackTop stack, ExecutionState& state) noexcept;
+template <int Rev, bool Metered, typename Host>
+inline evmc_status_code sstore_impl(StackTop stack, ExecutionState& state) noexcept
+{
+    if (state.in_static_mode())
+        return EVMC_STATIC_MODE_VIOLATION;
 
-evmc_status_code sstore(StackTop stack, ExecutionState& state) noexcept;
+    const auto rev = get_revision<Rev>(state);
+    if (Metered && rev >= EVMC_ISTANBUL)
+    {
+        if (state.gas_left <= 2300)
+            return EVMC_OUT_OF_GAS;
+        if (state.gas_estimator != nullptr)
+            require_gas_left(state, 2301);
+    }
+
+    const auto key = stack.pop();
+    const auto value = stack.pop();
+    int64_t gas_cost_cold = 0;
+    if (state.suspend_on_state || rev >= EVMC_BERLIN)
+    {
+        const auto key_bytes = intx::be::store<evmc::bytes32>(key);
+        if (!is_state_ready(state, EVM_STATE_STORAGE, state.msg->recipient, &key_bytes))
+            return EVM_STATE_PENDING;
+
+        if (rev >= EVMC_BERLIN && access_storage<Host>(state, key_bytes) == EVMC_ACCESS_COLD)
+            gas_cost_cold = instr::cold_sload_cost;
+    }
+    const auto status = set_storage<Host>(state, key, value);
+
+    if constexpr (Metered)
+    {
+        const auto [gas_cost_warm, gas_refund] = sstore_costs[rev][status];
+        const auto gas_cost = gas_cost_warm + gas_cost_cold;
+        if ((state.gas_left -= gas_cost) < 0)
+            return EVMC_OUT_OF_GAS;
+        state.gas_refund += gas_refund;
+    }
+    return EVMC_SUCCESS;
+}
+inline constexpr auto sstore = sstore_impl<any_revision, true, evmc::HostContext>;
 
 inline code_iterator jump_impl(ExecutionState& state, const uint256& dst) noexcept
 {
@@ -730,7 +1074,7 @@ inline void swap(StackTop stack) noexcept
     std::swap(stack.top(), stack[N]);
 }
 
-template <size_t NumTopics>
+template <size_t NumTopics, bool Metered = true, typename Host = evmc::HostContext>
 inline evmc_status_code log(StackTop stack, ExecutionState& state) noexcept
 {
     static_assert(NumTopics <= 4);
@@ -741,44 +1085,63 @@ inline evmc_status_code log(StackTop stack, ExecutionState& state) noexcept
     const auto& offset = stack.pop();
     const auto& size = stack.pop();
 
-    if (!check_memory(state, offset, size))
+    if (!check_memory<Metered>(state, offset, size))
         return EVMC_OUT_OF_GAS;
 
     const auto o = static_cast<size_t>(offset);
     const auto s = static_cast<size_t>(size);
 
     const auto cost = int64_t(s) * 8;
-    if ((state.gas_left -= cost) < 0)
+    if (!charge_gas<Metered>(state, cost))
         return EVMC_OUT_OF_GAS;
 
+    const auto data = s != 0 ? &state.memory[o] : nullptr;
+    if (state.native_words && state.log_arena == nullptr)
+    {
+        std::array<evm_word, NumTopics> topics;
+        for (auto& topic : topics)
+            topic = to_word(stack.pop());
+        state.host_ext.emit_log(state.msg->recipient, data, s, topics.data(), NumTopics);
+        return EVMC_SUCCESS;
+    }
+
     std::array<evmc::bytes32, NumTopics> topics;
     for (auto& topic : topics)
         topic = intx::be::store<evmc::bytes32>(stack.pop());
 
-    const auto data = s != 0 ? &state.memory[o] : nullptr;
-    state.host.emit_log(state.msg->recipient, data, s, topics.data(), NumTopics);
+    if (state.log_arena != nullptr)
+        state.log_arena->append(state.msg->recipient, data, s, topics.data(), NumTopics);
+    else
+        get_host<Host>(state).emit_log(state.msg->recipient, data, s, topics.data(), NumTopics);
     return EVMC_SUCCESS;
 }
 
-template <evmc_opcode Op>
+/// Calls and creations are instantiated in instructions_calls.cpp for the baseline loops.
+template <evmc_opcode Op, int Rev, bool Metered>
 evmc_status_code call_impl(StackTop stack, ExecutionState& state) noexcept;
-inline constexpr auto call = call_impl<OP_CALL>;
-inline constexpr auto callcode = call_impl<OP_CALLCODE>;
-inline constexpr auto delegatecall = call_impl<OP_DELEGATECALL>;
-inline constexpr auto staticcall = call_impl<OP_STATICCALL>;
+inline constexpr auto call = call_impl<OP_CALL, any_revision, true>;
+inline constexpr auto callcode = call_impl<OP_CALLCODE, any_revision, true>;
+inline constexpr auto delegatecall = call_impl<OP_DELEGATECALL, any_revision, true>;
+inline constexpr auto staticcall = call_impl<OP_STATICCALL, any_revision, true>;
 
-template <evmc_opcode Op>
+template <evmc_opcode Op, int Rev, bool Metered>
 evmc_status_code create_impl(StackTop stack, ExecutionState& state) noexcept;
-inline constexpr auto create = create_impl<OP_CREATE>;
-inline constexpr auto create2 = create_impl<OP_CREATE2>;
+inline constexpr auto create = create_impl<OP_CREATE, any_revision, true>;
+inline constexpr auto create2 = create_impl<OP_CREATE2, any_revision, true>;
 
-template <evmc_status_code StatusCode>
+/// Completes the CALL* or CREATE* instruction the frame is suspended on
+/// (ExecutionState::suspend_on_call) with the result of the nested call.
+/// Returns EVM_CANCELLED if the frame must end because the nested call was cancelled.
+[[nodiscard]] evmc_status_code finish_nested_call(
+    ExecutionState& state, const evmc_result& result) noexcept;
+
+template <evmc_status_code StatusCode, bool Metered>
 inline StopToken return_impl(StackTop stack, ExecutionState& state) noexcept
 {
     const auto& offset = stack[0];
     const auto& size = stack[1];
 
-    if (!check_memory(state, offset, size))
+    if (!check_memory<Metered>(state, offset, size))
         return {EVMC_OUT_OF_GAS};
 
     state.output_size = static_cast<size_t>(size);
@@ -786,25 +1149,32 @@ inline StopToken return_impl(StackTop stack, ExecutionState& state) noexcept
         state.output_offset = static_cast<size_t>(offset);
     return {StatusCode};
 }
-inline constexpr auto return_ = return_impl<EVMC_SUCCESS>;
-inline constexpr auto revert = return_impl<EVMC_REVERT>;
+inline constexpr auto return_ = return_impl<EVMC_SUCCESS, true>;
+inline constexpr auto revert = return_impl<EVMC_REVERT, true>;
 
-inline StopToken selfdestruct(StackTop stack, ExecutionState& state) noexcept
+template <int Rev, bool Metered>
+inline StopToken selfdestruct_impl(StackTop stack, ExecutionState& state) noexcept
 {
     if (state.in_static_mode())
         return {EVMC_STATIC_MODE_VIOLATION};
 
+    const auto rev = get_revision<Rev>(state);
     const auto beneficiary = intx::be::trunc<evmc::address>(stack[0]);
 
-    if (state.rev >= EVMC_BERLIN && state.host.access_account(beneficiary) == EVMC_ACCESS_COLD)
+    if (rev >= EVMC_TANGERINE_WHISTLE &&
+        (!is_state_ready(state, EVM_STATE_BALANCE, state.msg->recipient) ||
+            !is_state_ready(state, EVM_STATE_BALANCE, beneficiary)))
+        return {EVM_STATE_PENDING};
+
+    if (rev >= EVMC_BERLIN && access_account(state, beneficiary) == EVMC_ACCESS_COLD)
     {
-        if ((state.gas_left -= instr::cold_account_access_cost) < 0)
+        if (!charge_gas<Metered>(state, instr::cold_account_access_cost))
             return {EVMC_OUT_OF_GAS};
     }
 
-    if (state.rev >= EVMC_TANGERINE_WHISTLE)
+    if (Metered && rev >= EVMC_TANGERINE_WHISTLE)
     {
-        if (state.rev == EVMC_TANGERINE_WHISTLE || state.host.get_balance(state.msg->recipient))
+        if (rev == EVMC_TANGERINE_WHISTLE || get_balance(state, state.msg->recipient) != 0)
         {
             if (!state.host.account_exists(beneficiary))
             {
@@ -816,11 +1186,12 @@ inline StopToken selfdestruct(StackTop stack, ExecutionState& state) noexcept
 
     if (state.host.selfdestruct(state.msg->recipient, beneficiary))
     {
-        if (state.rev < EVMC_LONDON)
+        if (Metered && rev < EVMC_LONDON)
             state.gas_refund += 24000;
     }
     return {EVMC_SUCCESS};
 }
+inline constexpr auto selfdestruct = selfdestruct_impl<any_revision, true>;
 
 template <evmc_opcode Op>
 inline constexpr auto impl = nullptr;
@@ -832,5 +1203,88 @@ inline constexpr auto impl = nullptr;
 MAP_OPCODES
 #undef ON_OPCODE_IDENTIFIER
 #define ON_OPCODE_IDENTIFIER ON_OPCODE_IDENTIFIER_DEFAULT
+
+/// The implementation of the instruction for the revision Rev (see get_revision()), charging
+/// its dynamic costs if Metered (see charge_gas()) and calling the host as an instance of Host
+/// (see get_host()). Calls, creations and SELFDESTRUCT go through the evmc::HostContext.
+template <evmc_opcode Op, int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl = impl<Op>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_EXP, Rev, Metered, Host> = exp_impl<Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_KECCAK256, Rev, Metered, Host> = keccak256_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_BALANCE, Rev, Metered, Host> =
+    balance_impl<Rev, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_CALLDATACOPY, Rev, Metered, Host> =
+    calldatacopy_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_CODECOPY, Rev, Metered, Host> = codecopy_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_EXTCODESIZE, Rev, Metered, Host> =
+    extcodesize_impl<Rev, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_EXTCODECOPY, Rev, Metered, Host> =
+    extcodecopy_impl<Rev, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_RETURNDATACOPY, Rev, Metered, Host> =
+    returndatacopy_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_EXTCODEHASH, Rev, Metered, Host> =
+    extcodehash_impl<Rev, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_BLOCKHASH, Rev, Metered, Host> = blockhash_impl<Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_SELFBALANCE, Rev, Metered, Host> = selfbalance_impl<Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_MLOAD, Rev, Metered, Host> = mload_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_MSTORE, Rev, Metered, Host> = mstore_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_MSTORE8, Rev, Metered, Host> = mstore8_impl<Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_SLOAD, Rev, Metered, Host> =
+    sload_impl<Rev, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_SSTORE, Rev, Metered, Host> =
+    sstore_impl<Rev, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_LOG0, Rev, Metered, Host> = log<0, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_LOG1, Rev, Metered, Host> = log<1, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_LOG2, Rev, Metered, Host> = log<2, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_LOG3, Rev, Metered, Host> = log<3, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_LOG4, Rev, Metered, Host> = log<4, Metered, Host>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_CREATE, Rev, Metered, Host> =
+    create_impl<OP_CREATE, Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_CALL, Rev, Metered, Host> =
+    call_impl<OP_CALL, Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_CALLCODE, Rev, Metered, Host> =
+    call_impl<OP_CALLCODE, Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_RETURN, Rev, Metered, Host> =
+    return_impl<EVMC_SUCCESS, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_DELEGATECALL, Rev, Metered, Host> =
+    call_impl<OP_DELEGATECALL, Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_CREATE2, Rev, Metered, Host> =
+    create_impl<OP_CREATE2, Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_STATICCALL, Rev, Metered, Host> =
+    call_impl<OP_STATICCALL, Rev, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_REVERT, Rev, Metered, Host> =
+    return_impl<EVMC_REVERT, Metered>;
+template <int Rev, bool Metered, typename Host>
+inline constexpr auto specialized_impl<OP_SELFDESTRUCT, Rev, Metered, Host> =
+    selfdestruct_impl<Rev, Metered>;
 }  // namespace instr::core
 }
\ No newline at end of file
@@ -1,12 +1,116 @@
+#include "gas_estimator.hpp"
 #include "instructions.hpp"
+#include "precompiles/precompiles.hpp"
 
 namespace evm::instr::core
 {
-template <evmc_opcode Op>
+namespace
+{
+/// Records the gas left the caller needs when starting the nested call, not including the
+/// stipend, for the callee to get the minimum gas it needs for the same result.
+inline void require_callee_gas(ExecutionState& state, const evmc_message& msg,
+    evmc_status_code status, int64_t gas_left) noexcept
+{
+    const auto has_stipend = (msg.kind == EVMC_CALL || msg.kind == EVMC_CALLCODE) &&
+                             !evmc::is_zero(msg.value);
+    const auto stipend = has_stipend ? int64_t{2300} : 0;
+    const auto callee_gas =
+        std::min(state.gas_estimator->callee_gas(msg, status, gas_left), msg.gas);
+    auto min_gas_left = std::max(callee_gas - stipend, int64_t{0});
+
+    // Since Tangerine Whistle the callee gets at most all but one 64th of the gas left:
+    // this is the least L such that L - L / 64 >= min_gas_left.
+    if (state.rev >= EVMC_TANGERINE_WHISTLE && min_gas_left > 0)
+        min_gas_left += (min_gas_left - 1) / 63;
+
+    // The gas left includes the stipend until the call is finished.
+    require_gas_left(state, min_gas_left + stipend);
+}
+
+/// The completions of nested calls return EVM_CANCELLED if the callee was cancelled:
+/// the caller then ends at once instead of continuing as after a failed call.
+template <typename Result>
+[[nodiscard]] inline evmc_status_code finish_call(StackTop stack, ExecutionState& state,
+    const evmc_message& msg, const Result& result, size_t output_offset,
+    size_t output_size) noexcept
+{
+    if (result.status_code == EVM_CANCELLED)
+        return EVM_CANCELLED;
+    if (state.gas_estimator != nullptr)
+        require_callee_gas(state, msg, result.status_code, result.gas_left);
+
+    state.return_data.assign(result.output_data, result.output_size);
+    stack.top() = result.status_code == EVMC_SUCCESS;
+
+    if (const auto copy_size = std::min(output_size, result.output_size); copy_size > 0)
+        std::memcpy(&state.memory[output_offset], result.output_data, copy_size);
+    const auto gas_used = msg.gas - result.gas_left;
+    state.gas_left -= gas_used;
+    state.gas_refund += result.gas_refund;
+    return EVMC_SUCCESS;
+}
+
+template <typename Result>
+[[nodiscard]] inline evmc_status_code finish_create(StackTop stack, ExecutionState& state,
+    const evmc_message& msg, const Result& result) noexcept
+{
+    if (result.status_code == EVM_CANCELLED)
+        return EVM_CANCELLED;
+    if (state.gas_estimator != nullptr)
+        require_callee_gas(state, msg, result.status_code, result.gas_left);
+
+    state.gas_left -= msg.gas - result.gas_left;
+    state.gas_refund += result.gas_refund;
+    state.return_data.assign(result.output_data, result.output_size);
+    if (result.status_code == EVMC_SUCCESS)
+        stack.top() = intx::be::load<uint256>(result.create_address);
+    return EVMC_SUCCESS;
+}
+
+/// Completes a call to a precompile executed in the VM, whose output is the return data.
+/// Precompiles are not interrupted, so the deadline is checked once they are done.
+[[nodiscard]] inline evmc_status_code finish_precompile(StackTop stack, ExecutionState& state,
+    const evmc_message& msg, const precompiles::ExecutionResult& result, size_t output_offset,
+    size_t output_size) noexcept
+{
+    if (INTX_UNLIKELY(state.cancellable) && state.is_cancelled(true))
+        return EVM_CANCELLED;
+
+    if (state.gas_estimator != nullptr)
+        require_callee_gas(state, msg, result.status_code, result.gas_left);
+
+    stack.top() = result.status_code == EVMC_SUCCESS;
+    if (const auto copy_size = std::min(output_size, state.return_data.size()); copy_size > 0)
+        std::memcpy(&state.memory[output_offset], state.return_data.data(), copy_size);
+    state.gas_left -= msg.gas - result.gas_left;
+    return EVMC_SUCCESS;
+}
+
+inline evmc_status_code suspend_on_call(ExecutionState& state, const evmc_message& msg,
+    size_t output_offset, size_t output_size) noexcept
+{
+    state.nested_call = {msg, output_offset, output_size};
+    return EVM_CALL_SUSPENDED;
+}
+}  // namespace
+
+template <evmc_opcode Op, int Rev, bool Metered>
 evmc_status_code call_impl(StackTop stack, ExecutionState& state) noexcept
 {
     static_assert(
         Op == OP_CALL || Op == OP_CALLCODE || Op == OP_DELEGATECALL || Op == OP_STATICCALL);
+    const auto rev = get_revision<Rev>(state);
+    if constexpr (Op == OP_CALL || Op == OP_CALLCODE)
+    {
+        // The balance check and account_exists() below, before the operands are popped.
+        const auto has_value = stack[2] != 0;
+        if (has_value && !is_state_ready(state, EVM_STATE_BALANCE, state.msg->recipient))
+            return EVM_STATE_PENDING;
+        if (Op == OP_CALL && (has_value || rev < EVMC_SPURIOUS_DRAGON) &&
+            !is_state_ready(state, EVM_STATE_BALANCE, intx::be::trunc<evmc::address>(stack[1])))
+            return EVM_STATE_PENDING;
+    }
+
     const auto gas = stack.pop();
     const auto dst = intx::be::trunc<evmc::address>(stack.pop());
     const auto value = (Op == OP_STATICCALL || Op == OP_DELEGATECALL) ? 0 : stack.pop();
@@ -18,16 +122,16 @@ evmc_status_code call_impl(StackTop stack, ExecutionState& state) noexcept
 
     stack.push(0);
 
-    if (state.rev >= EVMC_BERLIN && state.host.access_account(dst) == EVMC_ACCESS_COLD)
+    if (rev >= EVMC_BERLIN && access_account(state, dst) == EVMC_ACCESS_COLD)
     {
-        if ((state.gas_left -= instr::additional_cold_account_access_cost) < 0)
+        if (!charge_gas<Metered>(state, instr::additional_cold_account_access_cost))
             return EVMC_OUT_OF_GAS;
     }
 
-    if (!check_memory(state, input_offset, input_size))
+    if (!check_memory<Metered>(state, input_offset, input_size))
         return EVMC_OUT_OF_GAS;
 
-    if (!check_memory(state, output_offset, output_size))
+    if (!check_memory<Metered>(state, output_offset, output_size))
         return EVMC_OUT_OF_GAS;
 
     auto msg = evmc_message{};
@@ -53,53 +157,74 @@ evmc_status_code call_impl(StackTop stack, ExecutionState& state) noexcept
     {
         if (has_value && state.in_static_mode())
             return EVMC_STATIC_MODE_VIOLATION;
-        if ((has_value || state.rev < EVMC_SPURIOUS_DRAGON) && !state.host.account_exists(dst))
+        if (Metered && (has_value || rev < EVMC_SPURIOUS_DRAGON) &&
+            !state.host.account_exists(dst))
             cost += 25000;
     }
 
-    if ((state.gas_left -= cost) < 0)
-        return EVMC_OUT_OF_GAS;
-    msg.gas = std::numeric_limits<int64_t>::max();
-    if (gas < msg.gas)
-        msg.gas = static_cast<int64_t>(gas);
-    if (state.rev >= EVMC_TANGERINE_WHISTLE)  // TODO: Always true for STATICCALL.
-        msg.gas = std::min(msg.gas, state.gas_left - state.gas_left / 64);
-    else if (msg.gas > state.gas_left)
-        return EVMC_OUT_OF_GAS;
-
-    if (has_value)
+    if constexpr (!Metered)
+    {
+        // The callee shares the loop budget of the caller, whatever the gas requested.
+        (void)gas;
+        (void)cost;
+        msg.gas = state.gas_left;
+    }
+    else
     {
-        msg.gas += 2300;
-        state.gas_left += 2300;
+        if ((state.gas_left -= cost) < 0)
+            return EVMC_OUT_OF_GAS;
+        msg.gas = std::numeric_limits<int64_t>::max();
+        if (gas < msg.gas)
+            msg.gas = static_cast<int64_t>(gas);
+        if (rev >= EVMC_TANGERINE_WHISTLE)  // TODO: Always true for STATICCALL.
+            msg.gas = std::min(msg.gas, state.gas_left - state.gas_left / 64);
+        else if (msg.gas > state.gas_left)
+            return EVMC_OUT_OF_GAS;
+
+        if (state.gas_estimator != nullptr)
+        {
+            // Before Tangerine Whistle the caller must have all the gas of the call left.
+            require_gas_left(state, rev >= EVMC_TANGERINE_WHISTLE ? 0 : msg.gas);
+        }
+
+        if (has_value)
+        {
+            msg.gas += 2300;
+            state.gas_left += 2300;
+        }
     }
 
     state.return_data.clear();
 
     if (state.msg->depth >= 1024)
         return EVMC_SUCCESS;
-    if (has_value && intx::be::load<uint256>(state.host.get_balance(state.msg->recipient)) < value)
+    if (has_value && get_balance(state, state.msg->recipient) < value)
         return EVMC_SUCCESS;
 
-    const auto result = state.host.call(msg);
-    state.return_data.assign(result.output_data, result.output_size);
-    stack.top() = result.status_code == EVMC_SUCCESS;
+    if (state.gas_estimator != nullptr)
+        state.gas_estimator->begin_call();
 
-    if (const auto copy_size = std::min(size_t(output_size), result.output_size); copy_size > 0)
-        std::memcpy(&state.memory[size_t(output_offset)], result.output_data, copy_size);
-    const auto gas_used = msg.gas - result.gas_left;
-    state.gas_left -= gas_used;
-    state.gas_refund += result.gas_refund;
-    return EVMC_SUCCESS;
-}
+    // A call with value transfers it, which is left to the host.
+    if (state.precompiles && !has_value)
+    {
+        if (const auto result = precompiles::execute(rev, dst,
+                {msg.input_data, msg.input_size}, msg.gas, state.return_data);
+            result.has_value())
+        {
+            return finish_precompile(
+                stack, state, msg, *result, size_t(output_offset), size_t(output_size));
+        }
+    }
 
-template evmc_status_code call_impl<OP_CALL>(StackTop stack, ExecutionState& state) noexcept;
-template evmc_status_code call_impl<OP_STATICCALL>(StackTop stack, ExecutionState& state) noexcept;
-template evmc_status_code call_impl<OP_DELEGATECALL>(
-    StackTop stack, ExecutionState& state) noexcept;
-template evmc_status_code call_impl<OP_CALLCODE>(StackTop stack, ExecutionState& state) noexcept;
+    if (state.suspend_on_call)
+        return suspend_on_call(state, msg, size_t(output_offset), size_t(output_size));
 
+    const auto result = call_host(state, msg);
+    return finish_call(stack, state, msg, result, size_t(output_offset), size_t(output_size));
+}
 
-template <evmc_opcode Op>
+
+template <evmc_opcode Op, int Rev, bool Metered>
 evmc_status_code create_impl(StackTop stack, ExecutionState& state) noexcept
 {
     static_assert(Op == OP_CREATE || Op == OP_CREATE2);
@@ -111,7 +236,7 @@ evmc_status_code create_impl(StackTop stack, ExecutionState& state) noexcept
     const auto init_code_offset = stack.pop();
     const auto init_code_size = stack.pop();
 
-    if (!check_memory(state, init_code_offset, init_code_size))
+    if (!check_memory<Metered>(state, init_code_offset, init_code_size))
         return EVMC_OUT_OF_GAS;
 
     auto salt = uint256{};
@@ -119,7 +244,7 @@ evmc_status_code create_impl(StackTop stack, ExecutionState& state) noexcept
     {
         salt = stack.pop();
         auto salt_cost = num_words(static_cast<size_t>(init_code_size)) * 6;
-        if ((state.gas_left -= salt_cost) < 0)
+        if (!charge_gas<Metered>(state, salt_cost))
             return EVMC_OUT_OF_GAS;
     }
 
@@ -128,12 +253,11 @@ evmc_status_code create_impl(StackTop stack, ExecutionState& state) noexcept
 
     if (state.msg->depth >= 1024)
         return EVMC_SUCCESS;
-    if (endowment != 0 &&
-        intx::be::load<uint256>(state.host.get_balance(state.msg->recipient)) < endowment)
+    if (endowment != 0 && get_balance(state, state.msg->recipient) < endowment)
         return EVMC_SUCCESS;
     auto msg = evmc_message{};
     msg.gas = state.gas_left;
-    if (state.rev >= EVMC_TANGERINE_WHISTLE)
+    if (Metered && get_revision<Rev>(state) >= EVMC_TANGERINE_WHISTLE)
         msg.gas = msg.gas - msg.gas / 64;
     msg.kind = (Op == OP_CREATE) ? EVMC_CREATE : EVMC_CREATE2;
     if (size_t(init_code_size) > 0)
@@ -145,15 +269,44 @@ evmc_status_code create_impl(StackTop stack, ExecutionState& state) noexcept
     msg.depth = state.msg->depth + 1;
     msg.create2_salt = intx::be::store<evmc::bytes32>(salt);
     msg.value = intx::be::store<evmc::uint256be>(endowment);
-    const auto result = state.host.call(msg);
-    state.gas_left -= msg.gas - result.gas_left;
-    state.gas_refund += result.gas_refund;
-    state.return_data.assign(result.output_data, result.output_size);
-    if (result.status_code == EVMC_SUCCESS)
-        stack.top() = intx::be::load<uint256>(result.create_address);
-    return EVMC_SUCCESS;
+
+    if (state.gas_estimator != nullptr)
+        state.gas_estimator->begin_call();
+
+    if (state.suspend_on_call)
+        return suspend_on_call(state, msg, 0, 0);
+
+    const auto result = call_host(state, msg);
+    return finish_create(stack, state, msg, result);
 }
 
-template evmc_status_code create_impl<OP_CREATE>(StackTop stack, ExecutionState& state) noexcept;
-template evmc_status_code create_impl<OP_CREATE2>(StackTop stack, ExecutionState& state) noexcept;
+// Instantiated for the metered and unmetered any_revision loops and the revisions of the
+// specialized baseline loops (baseline::first_specialized_revision and up).
+#define INSTANTIATE_CALLS(REV, METERED)                                                            \
+    template evmc_status_code call_impl<OP_CALL, REV, METERED>(                                    \
+        StackTop, ExecutionState&) noexcept;                                                       \
+    template evmc_status_code call_impl<OP_CALLCODE, REV, METERED>(                                \
+        StackTop, ExecutionState&) noexcept;                                                       \
+    template evmc_status_code call_impl<OP_DELEGATECALL, REV, METERED>(                            \
+        StackTop, ExecutionState&) noexcept;                                                       \
+    template evmc_status_code call_impl<OP_STATICCALL, REV, METERED>(                              \
+        StackTop, ExecutionState&) noexcept;                                                       \
+    template evmc_status_code create_impl<OP_CREATE, REV, METERED>(                                \
+        StackTop, ExecutionState&) noexcept;                                                       \
+    template evmc_status_code create_impl<OP_CREATE2, REV, METERED>(                               \
+        StackTop, ExecutionState&) noexcept;
+INSTANTIATE_CALLS(any_revision, true)
+INSTANTIATE_CALLS(any_revision, false)
+INSTANTIATE_CALLS(EVMC_SHANGHAI, true)
+INSTANTIATE_CALLS(EVMC_CANCUN, true)
+#undef INSTANTIATE_CALLS
+
+evmc_status_code finish_nested_call(ExecutionState& state, const evmc_result& result) noexcept
+{
+    const auto& call = state.nested_call;
+    const auto stack = StackTop{state.resume_stack_top};
+    if (call.msg.kind == EVMC_CREATE || call.msg.kind == EVMC_CREATE2)
+        return finish_create(stack, state, call.msg, result);
+    return finish_call(stack, state, call.msg, result, call.output_offset, call.output_size);
+}
 }  // namespace evm::instr::core
\ No newline at end of file
@@ -1,123 +0,0 @@
-#include "instructions.hpp"
-
-namespace evm::instr::core
-{
-namespace
-{
-
-struct StorageCostSpec
-{
-    bool net_cost;
-    int16_t warm_access;
-    int16_t set;
-    int16_t reset;
-    int16_t clear;
-};
-
-constexpr auto storage_cost_spec = []() noexcept {
-    std::array<StorageCostSpec, EVMC_MAX_REVISION + 1> tbl{};
-    for (auto rev : {EVMC_FRONTIER, EVMC_HOMESTEAD, EVMC_TANGERINE_WHISTLE, EVMC_SPURIOUS_DRAGON,
-             EVMC_BYZANTIUM, EVMC_PETERSBURG})
-        tbl[rev] = {false, 200, 20000, 5000, 15000};
-
-    tbl[EVMC_CONSTANTINOPLE] = {true, 200, 20000, 5000, 15000};
-    tbl[EVMC_ISTANBUL] = {true, 800, 20000, 5000, 15000};
-    tbl[EVMC_BERLIN] = {
-        true, instr::warm_storage_read_cost, 20000, 5000 - instr::cold_sload_cost, 15000};
-    tbl[EVMC_LONDON] = {
-        true, instr::warm_storage_read_cost, 20000, 5000 - instr::cold_sload_cost, 4800};
-    tbl[EVMC_PARIS] = tbl[EVMC_LONDON];
-    tbl[EVMC_SHANGHAI] = tbl[EVMC_LONDON];
-    tbl[EVMC_CANCUN] = tbl[EVMC_LONDON];
-    return tbl;
-}();
-
-struct StorageStoreCost
-{
-    int16_t gas_cost;
-    int16_t gas_refund;
-};
-
-constexpr auto sstore_costs = []() noexcept {
-    std::array<std::array<StorageStoreCost, EVMC_STORAGE_MODIFIED_RESTORED + 1>,
-        EVMC_MAX_REVISION + 1>
-        tbl{};
-
-    for (size_t rev = EVMC_FRONTIER; rev <= EVMC_MAX_REVISION; ++rev)
-    {
-        auto& e = tbl[rev];
-        if (const auto c = storage_cost_spec[rev]; !c.net_cost)
-        {
-            e[EVMC_STORAGE_ADDED] = {c.set, 0};
-            e[EVMC_STORAGE_DELETED] = {c.reset, c.clear};
-            e[EVMC_STORAGE_MODIFIED] = {c.reset, 0};
-            e[EVMC_STORAGE_ASSIGNED] = e[EVMC_STORAGE_MODIFIED];
-            e[EVMC_STORAGE_DELETED_ADDED] = e[EVMC_STORAGE_ADDED];
-            e[EVMC_STORAGE_MODIFIED_DELETED] = e[EVMC_STORAGE_DELETED];
-            e[EVMC_STORAGE_DELETED_RESTORED] = e[EVMC_STORAGE_ADDED];
-            e[EVMC_STORAGE_ADDED_DELETED] = e[EVMC_STORAGE_DELETED];
-            e[EVMC_STORAGE_MODIFIED_RESTORED] = e[EVMC_STORAGE_MODIFIED];
-        }
-        else
-        {
-            e[EVMC_STORAGE_ASSIGNED] = {c.warm_access, 0};
-            e[EVMC_STORAGE_ADDED] = {c.set, 0};
-            e[EVMC_STORAGE_DELETED] = {c.reset, c.clear};
-            e[EVMC_STORAGE_MODIFIED] = {c.reset, 0};
-            e[EVMC_STORAGE_DELETED_ADDED] = {c.warm_access, static_cast<int16_t>(-c.clear)};
-            e[EVMC_STORAGE_MODIFIED_DELETED] = {c.warm_access, c.clear};
-            e[EVMC_STORAGE_DELETED_RESTORED] = {
-                c.warm_access, static_cast<int16_t>(c.reset - c.warm_access - c.clear)};
-            e[EVMC_STORAGE_ADDED_DELETED] = {
-                c.warm_access, static_cast<int16_t>(c.set - c.warm_access)};
-            e[EVMC_STORAGE_MODIFIED_RESTORED] = {
-                c.warm_access, static_cast<int16_t>(c.reset - c.warm_access)};
-        }
-    }
-
-    return tbl;
-}();
-}
-
-evmc_status_code sload(StackTop stack, ExecutionState& state) noexcept
-{
-    auto& x = stack.top();
-    const auto key = intx::be::store<evmc::bytes32>(x);
-
-    if (state.rev >= EVMC_BERLIN &&
-        state.host.access_storage(state.msg->recipient, key) == EVMC_ACCESS_COLD)
-    {
-        constexpr auto additional_cold_sload_cost =
-            instr::cold_sload_cost - instr::warm_storage_read_cost;
-        if ((state.gas_left -= additional_cold_sload_cost) < 0)
-            return EVMC_OUT_OF_GAS;
-    }
-    x = intx::be::load<uint256>(state.host.get_storage(state.msg->recipient, key));
-    return EVMC_SUCCESS;
-}
-
-evmc_status_code sstore(StackTop stack, ExecutionState& state) noexcept
-{
-    if (state.in_static_mode())
-        return EVMC_STATIC_MODE_VIOLATION;
-
-    if (state.rev >= EVMC_ISTANBUL && state.gas_left <= 2300)
-        return EVMC_OUT_OF_GAS;
-
-    const auto key = intx::be::store<evmc::bytes32>(stack.pop());
-    const auto value = intx::be::store<evmc::bytes32>(stack.pop());
-    const auto gas_cost_cold =
-        (state.rev >= EVMC_BERLIN &&
-            state.host.access_storage(state.msg->recipient, key) == EVMC_ACCESS_COLD) ?
-            instr::cold_sload_cost :
-            0;
-    const auto status = state.host.set_storage(state.msg->recipient, key, value);
-
-    const auto [gas_cost_warm, gas_refund] = sstore_costs[state.rev][status];
-    const auto gas_cost = gas_cost_warm + gas_cost_cold;
-    if ((state.gas_left -= gas_cost) < 0)
-        return EVMC_OUT_OF_GAS;
-    state.gas_refund += gas_refund;
-    return EVMC_SUCCESS;
-}
-}
\ No newline at end of file
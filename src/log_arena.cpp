@@ -0,0 +1,45 @@
+#include "log_arena.hpp"
+
+namespace evm
+{
+void LogArena::rollback(Checkpoint checkpoint) noexcept
+{
+    if (checkpoint >= m_records.size())
+        return;
+    const auto& first_dropped = m_records[checkpoint];
+    m_data.resize(first_dropped.data_offset);
+    m_topics.resize(first_dropped.topics_offset);
+    m_records.resize(checkpoint);
+}
+
+void LogArena::append(const evmc::address& addr, const uint8_t* data, size_t data_size,
+    const evmc::bytes32 topics[], size_t num_topics) noexcept
+{
+    m_records.push_back({addr, m_data.size(), data_size, m_topics.size(), num_topics});
+    m_data.insert(m_data.end(), data, data + data_size);
+    m_topics.insert(m_topics.end(), topics, topics + num_topics);
+}
+
+void LogArena::flush(const HostExtensions& host_ext) noexcept
+{
+    if (!m_records.empty())
+    {
+        m_logs.clear();
+        m_logs.reserve(m_records.size());
+        for (const auto& r : m_records)
+        {
+            m_logs.push_back({r.address, m_data.data() + r.data_offset, r.data_size,
+                m_topics.data() + r.topics_offset, r.num_topics});
+        }
+        host_ext.emit_logs(m_logs.data(), m_logs.size());
+    }
+    clear();
+}
+
+void LogArena::clear() noexcept
+{
+    m_records.clear();
+    m_data.clear();
+    m_topics.clear();
+}
+}  // namespace evm
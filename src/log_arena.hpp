@@ -0,0 +1,46 @@
+#pragma once
+
+#include "host_extensions.hpp"
+#include <evmc/evmc.hpp>
+#include <vector>
+
+namespace evm
+{
+/// Transaction-scoped buffer of emitted logs.
+///
+/// LOG only appends the record to the arena. Frames record a checkpoint on entry and drop
+/// their logs on failure. The logs are passed to the host in a single call when the
+/// top-level frame succeeds.
+class LogArena
+{
+    struct Record
+    {
+        evmc::address address;
+        size_t data_offset;
+        size_t data_size;
+        size_t topics_offset;
+        size_t num_topics;
+    };
+
+    std::vector<Record> m_records;
+    std::vector<uint8_t> m_data;
+    std::vector<evmc::bytes32> m_topics;
+    std::vector<evm_log> m_logs;
+
+public:
+    using Checkpoint = size_t;
+
+    [[nodiscard]] Checkpoint checkpoint() const noexcept { return m_records.size(); }
+
+    /// Drops all logs appended after the checkpoint.
+    void rollback(Checkpoint checkpoint) noexcept;
+
+    void append(const evmc::address& addr, const uint8_t* data, size_t data_size,
+        const evmc::bytes32 topics[], size_t num_topics) noexcept;
+
+    /// Passes all logs to the host and clears the arena.
+    void flush(const HostExtensions& host_ext) noexcept;
+
+    void clear() noexcept;
+};
+}  // namespace evm
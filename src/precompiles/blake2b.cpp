@@ -0,0 +1,189 @@
+#include "blake2b.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EVM_AVX2_SUPPORTED 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define EVM_AVX2_SUPPORTED 0
+#endif
+
+namespace evm::precompiles
+{
+namespace
+{
+constexpr uint64_t iv[8] = {0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b,
+    0x5be0cd19137e2179};
+
+constexpr uint8_t sigma[10][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+};
+
+using CompressFn = void (*)(
+    uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool last);
+
+inline uint64_t rotr(uint64_t x, int n) noexcept
+{
+    return (x >> n) | (x << (64 - n));
+}
+
+inline void g(uint64_t v[16], int a, int b, int c, int d, uint64_t x, uint64_t y) noexcept
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr(v[d] ^ v[a], 32);
+    v[c] = v[c] + v[d];
+    v[b] = rotr(v[b] ^ v[c], 24);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr(v[b] ^ v[c], 63);
+}
+
+void compress_generic(
+    uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool last) noexcept
+{
+    uint64_t v[16];
+    std::copy_n(h, 8, v);
+    std::copy_n(iv, 8, &v[8]);
+    v[12] ^= t[0];
+    v[13] ^= t[1];
+    if (last)
+        v[14] = ~v[14];
+
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+        const auto& s = sigma[r % 10];
+        g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; ++i)
+        h[i] ^= v[i] ^ v[i + 8];
+}
+
+#if EVM_AVX2_SUPPORTED
+/// The G function on the four columns, or diagonals, held by the rows a, b, c and d.
+__attribute__((target("avx2"))) inline void g4(
+    __m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i x, __m256i y) noexcept
+{
+    const auto rotr24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3,
+        4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+    const auto rotr16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2,
+        3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+    d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+    c = _mm256_add_epi64(c, d);
+    b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rotr24);
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+    d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rotr16);
+    c = _mm256_add_epi64(c, d);
+    b = _mm256_xor_si256(b, c);
+    b = _mm256_or_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+}
+
+__attribute__((target("avx2"))) void compress_avx2(
+    uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool last) noexcept
+{
+    const auto h0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h[0]));
+    const auto h1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&h[4]));
+    auto a = h0;
+    auto b = h1;
+    auto c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&iv[0]));
+    auto d = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&iv[4])),
+        _mm256_set_epi64x(0, last ? -1 : 0, static_cast<int64_t>(t[1]),
+            static_cast<int64_t>(t[0])));
+
+    // The message words of the steps of each of the 10 distinct rounds, gathered once as the
+    // rounds repeat for large round numbers.
+    __m256i schedule[10][4];
+    const auto num_schedules = std::min(rounds, uint32_t{10});
+    for (uint32_t r = 0; r < num_schedules; ++r)
+    {
+        const auto& s = sigma[r];
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto j = (i / 2) * 8 + (i % 2);
+            schedule[r][i] = _mm256_set_epi64x(static_cast<int64_t>(m[s[j + 6]]),
+                static_cast<int64_t>(m[s[j + 4]]), static_cast<int64_t>(m[s[j + 2]]),
+                static_cast<int64_t>(m[s[j]]));
+        }
+    }
+
+    for (uint32_t r = 0, k = 0; r < rounds; ++r, k = (k == 9) ? 0 : k + 1)
+    {
+        const auto& s = schedule[k];
+        g4(a, b, c, d, s[0], s[1]);
+        // Rotate the rows to align the diagonals as columns.
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+        g4(a, b, c, d, s[2], s[3]);
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&h[0]), _mm256_xor_si256(h0, _mm256_xor_si256(a, c)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&h[4]), _mm256_xor_si256(h1, _mm256_xor_si256(b, d)));
+}
+
+bool has_avx2() noexcept
+{
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 || (ecx & bit_OSXSAVE) == 0 ||
+        (ecx & bit_AVX) == 0)
+        return false;
+    // The OS must save the YMM registers.
+    unsigned xcr0 = 0, xcr0_high = 0;
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+    if ((xcr0 & 0x6) != 0x6)
+        return false;
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0 && (ebx & bit_AVX2) != 0;
+}
+#endif
+
+CompressFn select_compress(bool avx2) noexcept
+{
+#if EVM_AVX2_SUPPORTED
+    if (avx2 && has_avx2())
+        return compress_avx2;
+#endif
+    (void)avx2;
+    return compress_generic;
+}
+
+CompressFn compress = select_compress(true);
+}  // namespace
+
+bool blake2b_use_avx2(bool avx2) noexcept
+{
+    compress = select_compress(avx2);
+    return compress != compress_generic;
+}
+
+void blake2b_compress(
+    uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool last) noexcept
+{
+    compress(rounds, h, m, t, last);
+}
+}  // namespace evm::precompiles
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace evm::precompiles
+{
+/// Applies the BLAKE2b compression function F with the number of rounds, as in EIP-152.
+/// Uses AVX2 if available.
+void blake2b_compress(
+    uint32_t rounds, uint64_t h[8], const uint64_t m[16], const uint64_t t[2], bool last) noexcept;
+
+/// Selects the AVX2 implementation, if available, or the generic one, for testing.
+/// Returns true if AVX2 is used. Must not be called concurrently with blake2b_compress().
+bool blake2b_use_avx2(bool avx2) noexcept;
+}  // namespace evm::precompiles
@@ -0,0 +1,72 @@
+#include "bn254.hpp"
+
+#if EVM_BN254_SUPPORTED
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EVM_BN254_ADX_SUPPORTED 1
+#include <cpuid.h>
+#else
+#define EVM_BN254_ADX_SUPPORTED 0
+#endif
+
+#include "bn254_impl.hpp"
+
+namespace evm::precompiles
+{
+namespace bn254
+{
+#if EVM_BN254_ADX_SUPPORTED
+/// The implementation compiled for BMI2 and ADX, in bn254_adx.cpp.
+extern const Functions adx_functions;
+#endif
+
+namespace
+{
+constexpr Functions generic_functions = {add, mul, pairing_check};
+
+#if EVM_BN254_ADX_SUPPORTED
+bool has_adx() noexcept
+{
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0 && (ebx & bit_BMI2) != 0 &&
+           (ebx & bit_ADX) != 0;
+}
+#endif
+
+const Functions* select_functions(bool adx) noexcept
+{
+#if EVM_BN254_ADX_SUPPORTED
+    if (adx && has_adx())
+        return &adx_functions;
+#endif
+    (void)adx;
+    return &generic_functions;
+}
+
+const Functions* functions = select_functions(true);
+}  // namespace
+}  // namespace bn254
+
+bool bn254_use_adx(bool adx) noexcept
+{
+    bn254::functions = bn254::select_functions(adx);
+    return bn254::functions != &bn254::generic_functions;
+}
+
+bool bn254_add(uint8_t output[64], const uint8_t input[128]) noexcept
+{
+    return bn254::functions->add(output, input);
+}
+
+bool bn254_mul(uint8_t output[64], const uint8_t input[96]) noexcept
+{
+    return bn254::functions->mul(output, input);
+}
+
+bool bn254_pairing_check(bool& result, const uint8_t* input, size_t num_pairs) noexcept
+{
+    return bn254::functions->pairing_check(result, input, num_pairs);
+}
+}  // namespace evm::precompiles
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// The field arithmetic needs 128-bit integers.
+#ifdef __SIZEOF_INT128__
+#define EVM_BN254_SUPPORTED 1
+#else
+#define EVM_BN254_SUPPORTED 0
+#endif
+
+namespace evm::precompiles
+{
+/// Adds two points of the BN254 G1, as in EIP-196.
+/// Returns false if a point is invalid.
+bool bn254_add(uint8_t output[64], const uint8_t input[128]) noexcept;
+
+/// Multiplies a point of the BN254 G1 by a scalar, as in EIP-196.
+/// Returns false if the point is invalid.
+bool bn254_mul(uint8_t output[64], const uint8_t input[96]) noexcept;
+
+/// Checks that the product of the pairings of the (G1, G2) pairs is one, as in EIP-197.
+/// The Miller loops of all pairs share their squarings and the final exponentiation.
+/// Returns false if a point is invalid.
+bool bn254_pairing_check(bool& result, const uint8_t* input, size_t num_pairs) noexcept;
+
+/// Selects the implementation for BMI2 and ADX, if available, or the generic one, for testing.
+/// Returns true if the ADX one is used. Must not be called concurrently with the functions.
+bool bn254_use_adx(bool adx) noexcept;
+}  // namespace evm::precompiles
@@ -0,0 +1,35 @@
+// The BN254 implementation compiled for the MULX and ADCX/ADOX instructions of x86-64,
+// selected at run time by bn254.cpp.
+#include "bn254.hpp"
+
+#if EVM_BN254_SUPPORTED && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+// The standard and intx headers are included before the target is changed so that only the
+// functions of the implementation are compiled for it.
+#include <intx/intx.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("bmi2,adx"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("bmi2,adx")
+#endif
+
+#include "bn254_impl.hpp"
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+namespace evm::precompiles::bn254
+{
+extern const Functions adx_functions;
+constexpr Functions adx_functions = {add, mul, pairing_check};
+}  // namespace evm::precompiles::bn254
+
+#endif
@@ -0,0 +1,777 @@
+// The BN254 (alt_bn128) arithmetic of the ECADD, ECMUL and ECPAIRING precompiles.
+//
+// Everything is defined in an unnamed namespace: the header is included by the translation
+// units compiling the implementation for different instruction sets, and each of them exports
+// only its Functions table.
+#pragma once
+
+#include <intx/intx.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace evm::precompiles::bn254
+{
+/// The entry points of an implementation, with the input and output encoding of EIP-196
+/// and EIP-197. They return false if the input is invalid.
+struct Functions
+{
+    bool (*add)(uint8_t output[64], const uint8_t input[128]) noexcept;
+    bool (*mul)(uint8_t output[64], const uint8_t input[96]) noexcept;
+    bool (*pairing_check)(bool& result, const uint8_t* input, size_t num_pairs) noexcept;
+};
+
+namespace
+{
+using intx::uint128;
+
+/// An element of the base field in Montgomery form, with R = 2^256.
+struct Fp
+{
+    uint64_t v[4];
+};
+
+constexpr uint64_t p[4] = {
+    0x3c208c16d87cfd47, 0x97816a916871ca8d, 0xb85045b68181585d, 0x30644e72e131a029};
+constexpr uint64_t p_inv = 0x87d20782e4866389;  ///< -p^-1 mod 2^64.
+constexpr Fp r_squared = {
+    {0xf32cfc5b538afa89, 0xb5e71911d44501fb, 0x47ab1eff0a417ff6, 0x06d89f71cab8351f}};
+
+/// Returns the low word of a + b + carry, setting carry to the high word.
+constexpr uint64_t adc(uint64_t a, uint64_t b, uint64_t& carry) noexcept
+{
+    const auto t = uint128{a} + b + carry;
+    carry = t[1];
+    return t[0];
+}
+
+/// Returns the low word of a - b - borrow, setting borrow to 1 on underflow.
+constexpr uint64_t sbb(uint64_t a, uint64_t b, uint64_t& borrow) noexcept
+{
+    const auto t = uint128{a} - b - borrow;
+    borrow = t[1] & 1;
+    return t[0];
+}
+
+/// Returns the low word of a + b * c + carry, setting carry to the high word.
+constexpr uint64_t mac(uint64_t a, uint64_t b, uint64_t c, uint64_t& carry) noexcept
+{
+    const auto t = intx::umul(b, c) + a + carry;
+    carry = t[1];
+    return t[0];
+}
+
+/// Subtracts p if a >= p, for a < 2p.
+constexpr Fp reduce_once(const Fp& a) noexcept
+{
+    uint64_t borrow = 0;
+    const Fp d = {{sbb(a.v[0], p[0], borrow), sbb(a.v[1], p[1], borrow),
+        sbb(a.v[2], p[2], borrow), sbb(a.v[3], p[3], borrow)}};
+    return borrow != 0 ? a : d;
+}
+
+constexpr Fp operator+(const Fp& a, const Fp& b) noexcept
+{
+    // p < 2^254, so the sum does not overflow.
+    uint64_t carry = 0;
+    return reduce_once({{adc(a.v[0], b.v[0], carry), adc(a.v[1], b.v[1], carry),
+        adc(a.v[2], b.v[2], carry), adc(a.v[3], b.v[3], carry)}});
+}
+
+constexpr Fp operator-(const Fp& a, const Fp& b) noexcept
+{
+    uint64_t borrow = 0;
+    const Fp d = {{sbb(a.v[0], b.v[0], borrow), sbb(a.v[1], b.v[1], borrow),
+        sbb(a.v[2], b.v[2], borrow), sbb(a.v[3], b.v[3], borrow)}};
+    if (borrow == 0)
+        return d;
+    uint64_t carry = 0;
+    return {{adc(d.v[0], p[0], carry), adc(d.v[1], p[1], carry), adc(d.v[2], p[2], carry),
+        adc(d.v[3], p[3], carry)}};
+}
+
+/// Montgomery multiplication (CIOS). The top word of p is below 2^62, so the intermediate
+/// results fit in four words.
+constexpr Fp operator*(const Fp& a, const Fp& b) noexcept
+{
+    uint64_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+    for (const auto bi : b.v)
+    {
+        uint64_t c1 = 0;
+        uint64_t c2 = 0;
+        r0 = mac(r0, a.v[0], bi, c1);
+        const auto m = r0 * p_inv;
+        mac(r0, m, p[0], c2);
+        r1 = mac(r1, a.v[1], bi, c1);
+        r0 = mac(r1, m, p[1], c2);
+        r2 = mac(r2, a.v[2], bi, c1);
+        r1 = mac(r2, m, p[2], c2);
+        r3 = mac(r3, a.v[3], bi, c1);
+        r2 = mac(r3, m, p[3], c2);
+        r3 = c1 + c2;
+    }
+    return reduce_once({{r0, r1, r2, r3}});
+}
+
+constexpr bool operator==(const Fp& a, const Fp& b) noexcept
+{
+    return ((a.v[0] ^ b.v[0]) | (a.v[1] ^ b.v[1]) | (a.v[2] ^ b.v[2]) | (a.v[3] ^ b.v[3])) == 0;
+}
+
+constexpr bool operator!=(const Fp& a, const Fp& b) noexcept
+{
+    return !(a == b);
+}
+
+constexpr bool is_zero(const Fp& a) noexcept
+{
+    return (a.v[0] | a.v[1] | a.v[2] | a.v[3]) == 0;
+}
+
+constexpr Fp operator-(const Fp& a) noexcept
+{
+    return Fp{} - a;
+}
+
+constexpr Fp sqr(const Fp& a) noexcept
+{
+    return a * a;
+}
+
+/// Converts a value below p to Montgomery form.
+constexpr Fp to_mont(uint64_t l0, uint64_t l1, uint64_t l2, uint64_t l3) noexcept
+{
+    return Fp{{l0, l1, l2, l3}} * r_squared;
+}
+
+constexpr Fp fp_one = to_mont(1, 0, 0, 0);
+
+inline Fp inv(const Fp& a) noexcept
+{
+    // a^(p-2), with the bits of p-2 taken from the top.
+    constexpr uint64_t e[4] = {p[0] - 2, p[1], p[2], p[3]};
+    auto r = fp_one;
+    for (int i = 253; i >= 0; --i)
+    {
+        r = sqr(r);
+        if (((e[i / 64] >> (i % 64)) & 1) != 0)
+            r = r * a;
+    }
+    return r;
+}
+
+/// Loads a big-endian value, returning false if it is not below p.
+inline bool load(Fp& a, const uint8_t bytes[32]) noexcept
+{
+    uint64_t v[4]{};
+    for (int i = 0; i < 32; ++i)
+        v[3 - i / 8] = (v[3 - i / 8] << 8) | bytes[i];
+    for (int i = 3; i >= 0; --i)
+    {
+        if (v[i] != p[i])
+        {
+            if (v[i] > p[i])
+                return false;
+            break;
+        }
+        if (i == 0)
+            return false;
+    }
+    a = to_mont(v[0], v[1], v[2], v[3]);
+    return true;
+}
+
+inline void store(uint8_t bytes[32], const Fp& a) noexcept
+{
+    const auto x = a * Fp{{1, 0, 0, 0}};
+    for (int i = 0; i < 32; ++i)
+        bytes[i] = static_cast<uint8_t>(x.v[3 - i / 8] >> (56 - (i % 8) * 8));
+}
+
+
+/// An element c0 + c1 u of Fp2 = Fp[u]/(u^2 + 1).
+struct Fp2
+{
+    Fp c0;
+    Fp c1;
+};
+
+constexpr Fp2 operator+(const Fp2& a, const Fp2& b) noexcept
+{
+    return {a.c0 + b.c0, a.c1 + b.c1};
+}
+
+constexpr Fp2 operator-(const Fp2& a, const Fp2& b) noexcept
+{
+    return {a.c0 - b.c0, a.c1 - b.c1};
+}
+
+constexpr Fp2 operator-(const Fp2& a) noexcept
+{
+    return {-a.c0, -a.c1};
+}
+
+constexpr Fp2 operator*(const Fp2& a, const Fp2& b) noexcept
+{
+    const auto t0 = a.c0 * b.c0;
+    const auto t1 = a.c1 * b.c1;
+    return {t0 - t1, (a.c0 + a.c1) * (b.c0 + b.c1) - t0 - t1};
+}
+
+constexpr Fp2 operator*(const Fp2& a, const Fp& b) noexcept
+{
+    return {a.c0 * b, a.c1 * b};
+}
+
+constexpr bool operator==(const Fp2& a, const Fp2& b) noexcept
+{
+    return a.c0 == b.c0 && a.c1 == b.c1;
+}
+
+constexpr bool operator!=(const Fp2& a, const Fp2& b) noexcept
+{
+    return !(a == b);
+}
+
+constexpr bool is_zero(const Fp2& a) noexcept
+{
+    return is_zero(a.c0) && is_zero(a.c1);
+}
+
+constexpr Fp2 sqr(const Fp2& a) noexcept
+{
+    const auto t = a.c0 * a.c1;
+    return {(a.c0 + a.c1) * (a.c0 - a.c1), t + t};
+}
+
+constexpr Fp2 conj(const Fp2& a) noexcept
+{
+    return {a.c0, -a.c1};
+}
+
+/// Multiplies by the non-residue xi = 9 + u of the Fp6 and Fp12 extensions.
+constexpr Fp2 mul_by_xi(const Fp2& a) noexcept
+{
+    const auto a0_2 = a.c0 + a.c0;
+    const auto a1_2 = a.c1 + a.c1;
+    const auto a0_8 = (a0_2 + a0_2) + (a0_2 + a0_2);
+    const auto a1_8 = (a1_2 + a1_2) + (a1_2 + a1_2);
+    return {a0_8 + a.c0 - a.c1, a1_8 + a.c1 + a.c0};
+}
+
+inline Fp2 inv(const Fp2& a) noexcept
+{
+    const auto t = inv(sqr(a.c0) + sqr(a.c1));
+    return {a.c0 * t, -(a.c1 * t)};
+}
+
+constexpr Fp2 to_mont2(const uint64_t (&c0)[4], const uint64_t (&c1)[4]) noexcept
+{
+    return {to_mont(c0[0], c0[1], c0[2], c0[3]), to_mont(c1[0], c1[1], c1[2], c1[3])};
+}
+
+
+/// An element c0 + c1 v + c2 v^2 of Fp6 = Fp2[v]/(v^3 - xi).
+struct Fp6
+{
+    Fp2 c0;
+    Fp2 c1;
+    Fp2 c2;
+};
+
+inline Fp6 operator+(const Fp6& a, const Fp6& b) noexcept
+{
+    return {a.c0 + b.c0, a.c1 + b.c1, a.c2 + b.c2};
+}
+
+inline Fp6 operator-(const Fp6& a, const Fp6& b) noexcept
+{
+    return {a.c0 - b.c0, a.c1 - b.c1, a.c2 - b.c2};
+}
+
+inline Fp6 operator-(const Fp6& a) noexcept
+{
+    return {-a.c0, -a.c1, -a.c2};
+}
+
+inline Fp6 operator*(const Fp6& a, const Fp6& b) noexcept
+{
+    const auto t0 = a.c0 * b.c0;
+    const auto t1 = a.c1 * b.c1;
+    const auto t2 = a.c2 * b.c2;
+    return {
+        mul_by_xi((a.c1 + a.c2) * (b.c1 + b.c2) - t1 - t2) + t0,
+        (a.c0 + a.c1) * (b.c0 + b.c1) - t0 - t1 + mul_by_xi(t2),
+        (a.c0 + a.c2) * (b.c0 + b.c2) - t0 - t2 + t1,
+    };
+}
+
+inline Fp6 mul_by_v(const Fp6& a) noexcept
+{
+    return {mul_by_xi(a.c2), a.c0, a.c1};
+}
+
+/// Multiplies by b0 + b2 v^2.
+inline Fp6 mul_by_02(const Fp6& a, const Fp2& b0, const Fp2& b2) noexcept
+{
+    return {a.c0 * b0 + mul_by_xi(a.c1 * b2), a.c1 * b0 + mul_by_xi(a.c2 * b2),
+        a.c2 * b0 + a.c0 * b2};
+}
+
+/// Multiplies by b1 v.
+inline Fp6 mul_by_1(const Fp6& a, const Fp2& b1) noexcept
+{
+    return {mul_by_xi(a.c2 * b1), a.c0 * b1, a.c1 * b1};
+}
+
+inline Fp6 inv(const Fp6& a) noexcept
+{
+    const auto t0 = sqr(a.c0) - mul_by_xi(a.c1 * a.c2);
+    const auto t1 = mul_by_xi(sqr(a.c2)) - a.c0 * a.c1;
+    const auto t2 = sqr(a.c1) - a.c0 * a.c2;
+    const auto d = inv(a.c0 * t0 + mul_by_xi(a.c2 * t1 + a.c1 * t2));
+    return {t0 * d, t1 * d, t2 * d};
+}
+
+
+/// An element c0 + c1 w of Fp12 = Fp6[w]/(w^2 - v).
+struct Fp12
+{
+    Fp6 c0;
+    Fp6 c1;
+};
+
+constexpr Fp12 fp12_one = {{{fp_one, {}}, {}, {}}, {}};
+
+inline Fp12 operator*(const Fp12& a, const Fp12& b) noexcept
+{
+    const auto t0 = a.c0 * b.c0;
+    const auto t1 = a.c1 * b.c1;
+    return {t0 + mul_by_v(t1), (a.c0 + a.c1) * (b.c0 + b.c1) - t0 - t1};
+}
+
+inline Fp12 sqr(const Fp12& a) noexcept
+{
+    const auto t = a.c0 * a.c1;
+    const auto c0 = (a.c0 + a.c1) * (a.c0 + mul_by_v(a.c1)) - t - mul_by_v(t);
+    return {c0, t + t};
+}
+
+/// The conjugate, which is the inverse of the elements of the cyclotomic subgroup.
+inline Fp12 conj(const Fp12& a) noexcept
+{
+    return {a.c0, -a.c1};
+}
+
+inline Fp12 inv(const Fp12& a) noexcept
+{
+    const auto t = inv(a.c0 * a.c0 - mul_by_v(a.c1 * a.c1));
+    return {a.c0 * t, -(a.c1 * t)};
+}
+
+/// Multiplies by the sparse element (b0 + b2 v^2) + b4 v w of a line evaluation.
+inline Fp12 mul_by_line(const Fp12& a, const Fp2& b0, const Fp2& b2, const Fp2& b4) noexcept
+{
+    const auto t0 = mul_by_02(a.c0, b0, b2);
+    const auto t1 = mul_by_1(a.c1, b4);
+    const auto c1 = (a.c0 + a.c1) * Fp6{b0, b4, b2} - t0 - t1;
+    return {t0 + mul_by_v(t1), c1};
+}
+
+/// The Frobenius coefficients: frobenius_coeffs[k-1][m-1] = xi^(m(p^k - 1)/6).
+constexpr Fp2 frobenius_coeffs[3][5] = {
+    {
+        to_mont2({0xd60b35dadcc9e470, 0x5c521e08292f2176, 0xe8b99fdd76e68b60, 0x1284b71c2865a7df},
+            {0xca5cf05f80f362ac, 0x747992778eeec7e5, 0xa6327cfe12150b8e, 0x246996f3b4fae7e6}),
+        to_mont2({0x99e39557176f553d, 0xb78cc310c2c3330c, 0x4c0bec3cf559b143, 0x2fb347984f7911f7},
+            {0x1665d51c640fcba2, 0x32ae2a1d0b7c9dce, 0x4ba4cc8bd75a0794, 0x16c9e55061ebae20}),
+        to_mont2({0xdc54014671a0135a, 0xdbaae0eda9c95998, 0xdc5ec698b6e2f9b9, 0x063cf305489af5dc},
+            {0x82d37f632623b0e3, 0x21807dc98fa25bd2, 0x0704b5a7ec796f2b, 0x07c03cbcac41049a}),
+        to_mont2({0x848a1f55921ea762, 0xd33365f7be94ec72, 0x80f3c0b75a181e84, 0x05b54f5e64eea801},
+            {0xc13b4711cd2b8126, 0x3685d2ea1bdec763, 0x9f3a80b03b0b1c92, 0x2c145edbe7fd8aee}),
+        to_mont2({0x2ea2c810eab7692f, 0x425c459b55aa1bd3, 0xe93a3661a4353ff4, 0x0183c1e74f798649},
+            {0x24c6b8ee6e0c2c4b, 0xb080cb99678e2ac0, 0xa27fb246c7729f7d, 0x12acf2ca76fd0675}),
+    },
+    {
+        to_mont2({0xe4bd44e5607cfd49, 0xc28f069fbb966e3d, 0x5e6dd9e7e0acccb0, 0x30644e72e131a029},
+            {}),
+        to_mont2({0xe4bd44e5607cfd48, 0xc28f069fbb966e3d, 0x5e6dd9e7e0acccb0, 0x30644e72e131a029},
+            {}),
+        to_mont2({0x3c208c16d87cfd46, 0x97816a916871ca8d, 0xb85045b68181585d, 0x30644e72e131a029},
+            {}),
+        to_mont2({0x5763473177fffffe, 0xd4f263f1acdb5c4f, 0x59e26bcea0d48bac, 0}, {}),
+        to_mont2({0x5763473177ffffff, 0xd4f263f1acdb5c4f, 0x59e26bcea0d48bac, 0}, {}),
+    },
+    {
+        to_mont2({0xe86f7d391ed4a67f, 0x894cb38dbe55d24a, 0xefe9608cd0acaa90, 0x19dc81cfcc82e4bb},
+            {0x7694aa2bf4c0c101, 0x7f03a5e397d439ec, 0x06cbeee33576139d, 0x00abf8b60be77d73}),
+        to_mont2({0x7b746ee87bdcfb6d, 0x805ffd3d5d6942d3, 0xbaff1c77959f25ac, 0x0856e078b755ef0a},
+            {0x380cab2baaa586de, 0x0fdf31bf98ff2631, 0xa9f30e6dec26094f, 0x04f1de41b3d1766f}),
+        to_mont2({0x5fcc8ad066dce9ed, 0xbbd689a3bea870f4, 0xdbf17f1dca9e5ea3, 0x2a275b6d9896aa4c},
+            {0xb94d0cb3b2594c64, 0x7600ecc7d8cf6eba, 0xb14b900e9507e932, 0x28a411b634f09b8f}),
+        to_mont2({0x0e1a92bc3ccbf066, 0xe633094575b06bcb, 0x19bee0f7b5b2444e, 0x0bc58c6611c08dab},
+            {0x5fe3ed9d730c239f, 0xa44a9e08737f96e5, 0xfeb0f6ef0cd21d04, 0x23d5e999e1910a12}),
+        to_mont2({0xebde847076261b43, 0x2ed68098967c84a5, 0x711699fa3b4d3f69, 0x13c49044952c0905},
+            {0x1f25041384282499, 0x3e2ddaea20028021, 0x9fb1b2282a48633d, 0x16db366a59b1dd0b}),
+    },
+};
+
+/// Raises to the power p^k, for k = 1, 2 or 3.
+inline Fp12 frobenius(const Fp12& a, int k) noexcept
+{
+    // The coefficient of w^m is conjugated k times and multiplied by xi^(m(p^k - 1)/6).
+    const auto& g = frobenius_coeffs[k - 1];
+    const auto f = [k](const Fp2& c) noexcept { return (k % 2 != 0) ? conj(c) : c; };
+    return {
+        {f(a.c0.c0), f(a.c0.c1) * g[1], f(a.c0.c2) * g[3]},
+        {f(a.c1.c0) * g[0], f(a.c1.c1) * g[2], f(a.c1.c2) * g[4]},
+    };
+}
+
+
+/// A point in Jacobian coordinates (x = X/Z^2, y = Y/Z^3) of a curve y^2 = x^3 + b over Fp or
+/// Fp2, the point at infinity if Z = 0.
+template <typename F>
+struct Point
+{
+    F x;
+    F y;
+    F z;
+};
+
+template <typename F>
+inline Point<F> dbl(const Point<F>& a) noexcept
+{
+    if (is_zero(a.z))
+        return a;
+    const auto xx = sqr(a.x);
+    const auto yy = sqr(a.y);
+    const auto yyyy = sqr(yy);
+    auto d = sqr(a.x + yy) - xx - yyyy;
+    d = d + d;
+    const auto e = xx + xx + xx;
+    const auto x = sqr(e) - (d + d);
+    auto yyyy_8 = yyyy + yyyy;
+    yyyy_8 = yyyy_8 + yyyy_8;
+    yyyy_8 = yyyy_8 + yyyy_8;
+    const auto yz = a.y * a.z;
+    return {x, e * (d - x) - yyyy_8, yz + yz};
+}
+
+template <typename F>
+inline Point<F> add(const Point<F>& a, const Point<F>& b) noexcept
+{
+    if (is_zero(a.z))
+        return b;
+    if (is_zero(b.z))
+        return a;
+    const auto z1z1 = sqr(a.z);
+    const auto z2z2 = sqr(b.z);
+    const auto u1 = a.x * z2z2;
+    const auto u2 = b.x * z1z1;
+    const auto s1 = a.y * b.z * z2z2;
+    const auto s2 = b.y * a.z * z1z1;
+    const auto h = u2 - u1;
+    auto rr = s2 - s1;
+    if (is_zero(h))
+        return is_zero(rr) ? dbl(a) : Point<F>{};
+    const auto i = sqr(h + h);
+    const auto j = h * i;
+    rr = rr + rr;
+    const auto v = u1 * i;
+    const auto x = sqr(rr) - j - (v + v);
+    const auto s1j = s1 * j;
+    return {x, rr * (v - x) - (s1j + s1j), (sqr(a.z + b.z) - z1z1 - z2z2) * h};
+}
+
+/// Multiplies by the scalar, given as little-endian 64-bit words, with a 4-bit fixed window.
+template <typename F>
+inline Point<F> mul(const Point<F>& a, const uint64_t scalar[4]) noexcept
+{
+    Point<F> table[16];
+    table[0] = {};
+    table[1] = a;
+    for (int i = 2; i < 16; ++i)
+        table[i] = (i % 2 == 0) ? dbl(table[i / 2]) : add(table[i - 1], a);
+
+    Point<F> r{};
+    for (int i = 63; i >= 0; --i)
+    {
+        r = dbl(dbl(dbl(dbl(r))));
+        const auto digit = (scalar[i / 16] >> ((i % 16) * 4)) & 0xf;
+        if (digit != 0)
+            r = add(r, table[digit]);
+    }
+    return r;
+}
+
+template <typename F>
+inline bool operator==(const Point<F>& a, const Point<F>& b) noexcept
+{
+    if (is_zero(a.z) || is_zero(b.z))
+        return is_zero(a.z) && is_zero(b.z);
+    const auto z1z1 = sqr(a.z);
+    const auto z2z2 = sqr(b.z);
+    return a.x * z2z2 == b.x * z1z1 && a.y * b.z * z2z2 == b.y * a.z * z1z1;
+}
+
+/// Converts to affine coordinates, (0, 0) for the point at infinity.
+template <typename F>
+inline void to_affine(F& x, F& y, const Point<F>& a) noexcept
+{
+    if (is_zero(a.z))
+    {
+        x = {};
+        y = {};
+        return;
+    }
+    const auto z_inv = inv(a.z);
+    const auto z_inv2 = sqr(z_inv);
+    x = a.x * z_inv2;
+    y = a.y * z_inv2 * z_inv;
+}
+
+constexpr Fp g1_b = to_mont(3, 0, 0, 0);
+
+/// b / xi of the sextic twist y^2 = x^3 + b / xi of G2.
+constexpr Fp2 g2_b = to_mont2(
+    {0x3267e6dc24a138e5, 0xb5b4c5e559dbefa3, 0x81be18991be06ac3, 0x2b149d40ceb8aaae},
+    {0xe4a2bd0685c315d2, 0xa74fa084e52d1852, 0xcd2cafadeed8fdf4, 0x009713b03af0fed4});
+
+/// Loads an affine point of G1, returning false if it is not on the curve.
+inline bool load_g1(Point<Fp>& a, const uint8_t bytes[64]) noexcept
+{
+    Fp x, y;
+    if (!load(x, &bytes[0]) || !load(y, &bytes[32]))
+        return false;
+    if (is_zero(x) && is_zero(y))
+    {
+        a = {};
+        return true;
+    }
+    a = {x, y, fp_one};
+    return sqr(y) == sqr(x) * x + g1_b;
+}
+
+inline void store_g1(uint8_t bytes[64], const Point<Fp>& a) noexcept
+{
+    Fp x, y;
+    to_affine(x, y, a);
+    store(&bytes[0], x);
+    store(&bytes[32], y);
+}
+
+/// The endomorphism psi(x, y) = (conj(x) xi^((p-1)/3), conj(y) xi^((p-1)/2)) of the twist,
+/// which acts on G2 as the multiplication by p.
+inline Point<Fp2> psi(const Point<Fp2>& a) noexcept
+{
+    return {conj(a.x) * frobenius_coeffs[0][1], conj(a.y) * frobenius_coeffs[0][2], conj(a.z)};
+}
+
+// The G2 subgroup check, the Miller loop and the final exponentiation keep their Fp12 and
+// Fp2 temporaries on the stack, also in the entry points inlining them. They are leaves of
+// the precompile call, which does not recurse.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstack-usage="
+#endif
+
+/// Loads an affine point of G2, with the imaginary parts first, returning false if it is not
+/// on the twist or not in the subgroup of order r.
+inline bool load_g2(Point<Fp2>& a, const uint8_t bytes[128]) noexcept
+{
+    Fp2 x, y;
+    if (!load(x.c1, &bytes[0]) || !load(x.c0, &bytes[32]) || !load(y.c1, &bytes[64]) ||
+        !load(y.c0, &bytes[96]))
+        return false;
+    if (is_zero(x) && is_zero(y))
+    {
+        a = {};
+        return true;
+    }
+    a = {x, y, {fp_one, {}}};
+    if (sqr(y) != sqr(x) * x + g2_b)
+        return false;
+
+    // A point of the twist is in G2 iff psi(Q) = [p]Q = [6z^2]Q (El Housni et al., 2022).
+    // 6z^2 has 127 bits.
+    constexpr uint64_t six_z_squared[2] = {0xf83e9682e87cfd46, 0x6f4d8248eeb859fb};
+    auto r = a;
+    for (int i = 125; i >= 0; --i)
+    {
+        r = dbl(r);
+        if (((six_z_squared[i / 64] >> (i % 64)) & 1) != 0)
+            r = add(r, a);
+    }
+    return psi(a) == r;
+}
+
+
+/// The BN parameter z, positive for BN254.
+constexpr uint64_t z = 0x44e992b44a6909f1;
+
+/// The Miller loop count 6z + 2, of 65 bits, without its top bit.
+constexpr uint64_t ate_loop_count = 0x9d797039be763ba8;
+
+constexpr Fp two_inv = to_mont(
+    0x9e10460b6c3e7ea4, 0xcbc0b548b438e546, 0xdc2822db40c0ac2e, 0x183227397098d014);
+
+/// A pair of the multi-pairing: the G1 point in affine coordinates, the G2 point in affine
+/// coordinates and the G2 point of the Miller loop in homogeneous projective coordinates.
+struct Pair
+{
+    Fp px;
+    Fp py;
+    Fp2 qx;
+    Fp2 qy;
+    Fp2 x;
+    Fp2 y;
+    Fp2 z;
+};
+
+/// Doubles the point of the pair and multiplies f by the tangent line evaluated at P.
+inline Fp12 doubling_step(const Fp12& f, Pair& pair) noexcept
+{
+    const auto a = pair.x * pair.y * two_inv;
+    const auto b = sqr(pair.y);
+    const auto c = sqr(pair.z);
+    const auto e = g2_b * (c + c + c);
+    const auto ff = e + e + e;
+    const auto g = (b + ff) * two_inv;
+    const auto h = sqr(pair.y + pair.z) - (b + c);
+    const auto i = e - b;
+    const auto j = sqr(pair.x);
+    const auto ee = sqr(e);
+    pair.x = a * (b - ff);
+    pair.y = sqr(g) - (ee + ee + ee);
+    pair.z = b * h;
+    return mul_by_line(f, mul_by_xi(i), (j + j + j) * pair.px, -h * pair.py);
+}
+
+/// Adds the affine point (qx, qy) to the point of the pair and multiplies f by the line
+/// through them evaluated at P.
+inline Fp12 addition_step(const Fp12& f, Pair& pair, const Fp2& qx, const Fp2& qy) noexcept
+{
+    const auto d = pair.x - qx * pair.z;
+    const auto e = pair.y - qy * pair.z;
+    const auto ff = sqr(d);
+    const auto g = sqr(e);
+    const auto h = d * ff;
+    const auto i = pair.x * ff;
+    const auto j = h + pair.z * g - (i + i);
+    pair.x = d * j;
+    pair.y = e * (i - j) - h * pair.y;
+    pair.z = pair.z * h;
+    return mul_by_line(f, mul_by_xi(e * qx - d * qy), -e * pair.px, d * pair.py);
+}
+
+/// The optimal ate Miller loop of all pairs, sharing the squarings of f.
+inline Fp12 miller_loop(std::vector<Pair>& pairs) noexcept
+{
+    auto f = fp12_one;
+    for (int i = 63; i >= 0; --i)
+    {
+        f = sqr(f);
+        for (auto& pair : pairs)
+            f = doubling_step(f, pair);
+        if (((ate_loop_count >> i) & 1) != 0)
+        {
+            for (auto& pair : pairs)
+                f = addition_step(f, pair, pair.qx, pair.qy);
+        }
+    }
+
+    // The final additions of Q1 = pi(Q) and -Q2 = -pi^2(Q).
+    for (auto& pair : pairs)
+    {
+        const auto q1 = psi(Point<Fp2>{pair.qx, pair.qy, {fp_one, {}}});
+        f = addition_step(f, pair, q1.x, q1.y);
+        const auto q2 = psi(q1);
+        f = addition_step(f, pair, q2.x, -q2.y);
+    }
+    return f;
+}
+
+inline Fp12 exp_by_z(const Fp12& a) noexcept
+{
+    auto r = a;
+    for (int i = 61; i >= 0; --i)
+    {
+        r = sqr(r);
+        if (((z >> i) & 1) != 0)
+            r = r * a;
+    }
+    return r;
+}
+
+/// The final exponentiation to the power (p^12 - 1)/r, with the hard part computed as in
+/// Fuentes-Castaneda et al., which raises it to a fixed multiple coprime to r.
+inline Fp12 final_exponentiation(const Fp12& a) noexcept
+{
+    // The easy part: f^((p^6 - 1)(p^2 + 1)), in the cyclotomic subgroup.
+    auto f = conj(a) * inv(a);
+    f = frobenius(f, 2) * f;
+
+    // In the cyclotomic subgroup the inverse is the conjugate, so f^-z = conj(f^z).
+    const auto fa = conj(exp_by_z(f));
+    const auto fb = sqr(fa);
+    const auto fd = sqr(fb) * fb;
+    const auto fe = conj(exp_by_z(fd));
+    const auto fk = exp_by_z(sqr(fe)) * fe * conj(fd);
+    const auto fl = fk * fb;
+    const auto fr = frobenius(fl, 1) * (fk * fe * f) * frobenius(fk, 2);
+    return frobenius(conj(f) * fl, 3) * fr;
+}
+
+inline bool is_one(const Fp12& a) noexcept
+{
+    const Fp2 one = {fp_one, {}};
+    return a.c0.c0 == one && is_zero(a.c0.c1) && is_zero(a.c0.c2) && is_zero(a.c1.c0) &&
+           is_zero(a.c1.c1) && is_zero(a.c1.c2);
+}
+
+
+bool add(uint8_t output[64], const uint8_t input[128]) noexcept
+{
+    Point<Fp> a, b;
+    if (!load_g1(a, &input[0]) || !load_g1(b, &input[64]))
+        return false;
+    store_g1(output, add(a, b));
+    return true;
+}
+
+bool mul(uint8_t output[64], const uint8_t input[96]) noexcept
+{
+    Point<Fp> a;
+    if (!load_g1(a, input))
+        return false;
+    uint64_t scalar[4]{};
+    for (int i = 0; i < 32; ++i)
+        scalar[3 - i / 8] = (scalar[3 - i / 8] << 8) | input[64 + i];
+    store_g1(output, mul(a, scalar));
+    return true;
+}
+
+bool pairing_check(bool& result, const uint8_t* input, size_t num_pairs) noexcept
+{
+    std::vector<Pair> pairs;
+    pairs.reserve(num_pairs);
+    for (size_t i = 0; i < num_pairs; ++i, input += 192)
+    {
+        Point<Fp> p;
+        Point<Fp2> q;
+        if (!load_g1(p, &input[0]) || !load_g2(q, &input[64]))
+            return false;
+        // Pairs with a point at infinity are 1.
+        if (!is_zero(p.z) && !is_zero(q.z))
+            pairs.push_back({p.x, p.y, q.x, q.y, q.x, q.y, q.z});
+    }
+    result = pairs.empty() || is_one(final_exponentiation(miller_loop(pairs)));
+    return true;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}  // namespace
+}  // namespace evm::precompiles::bn254
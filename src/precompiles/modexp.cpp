@@ -0,0 +1,486 @@
+#include "modexp.hpp"
+#include <intx/intx.hpp>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace evm::precompiles
+{
+namespace
+{
+using bytes_view = std::basic_string_view<uint8_t>;
+
+/// Returns the low word of a + b + carry, setting carry to the high word.
+inline uint64_t adc(uint64_t a, uint64_t b, uint64_t& carry) noexcept
+{
+    const auto s = a + b;
+    const auto c1 = s < a;
+    const auto r = s + carry;
+    carry = c1 | (r < s);
+    return r;
+}
+
+/// Returns the low word of a - b - borrow, setting borrow to the borrow out.
+inline uint64_t sbb(uint64_t a, uint64_t b, uint64_t& borrow) noexcept
+{
+    const auto d = a - b;
+    const auto b1 = a < b;
+    const auto r = d - borrow;
+    borrow = b1 | (d < borrow);
+    return r;
+}
+
+/// Returns the low word of a * b + c + carry, setting carry to the high word.
+inline uint64_t mac(uint64_t a, uint64_t b, uint64_t c, uint64_t& carry) noexcept
+{
+    const auto t = intx::umul(a, b) + c + carry;
+    carry = t[1];
+    return t[0];
+}
+
+inline bool less(const uint64_t* a, const uint64_t* b, size_t n) noexcept
+{
+    for (auto i = n; i != 0; --i)
+    {
+        if (a[i - 1] != b[i - 1])
+            return a[i - 1] < b[i - 1];
+    }
+    return false;
+}
+
+inline uint64_t sub(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) noexcept
+{
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; ++i)
+        r[i] = sbb(a[i], b[i], borrow);
+    return borrow;
+}
+
+/// Computes r = a * b mod 2^(64 rn). The result must not alias the operands.
+void mul_lo(uint64_t* r, size_t rn, const uint64_t* a, size_t an, const uint64_t* b,
+    size_t bn) noexcept
+{
+    std::fill_n(r, rn, 0);
+    for (size_t i = 0; i < std::min(an, rn); ++i)
+    {
+        uint64_t c = 0;
+        const auto k = std::min(bn, rn - i);
+        for (size_t j = 0; j < k; ++j)
+            r[i + j] = mac(a[i], b[j], r[i + j], c);
+        if (i + bn < rn)
+            r[i + bn] = c;
+    }
+}
+
+/// The arithmetic in Montgomery form modulo an odd number m. The size in limbs is N for the
+/// specialized kernels, or given at run time if N is 0. The modulus may have fewer significant
+/// limbs than the size, with R = 2^(64 size) still greater than it.
+template <size_t N>
+class MontArith
+{
+    const uint64_t* m_;
+    size_t n_;
+    uint64_t m_inv_;  ///< -m^-1 mod 2^64.
+
+public:
+    MontArith(const uint64_t* m, size_t n) noexcept : m_{m}, n_{n}
+    {
+        // Newton's iteration doubles the correct low bits, starting from 3.
+        uint64_t inv = m[0];
+        for (int i = 0; i < 5; ++i)
+            inv *= 2 - m[0] * inv;
+        m_inv_ = 0 - inv;
+    }
+
+    size_t size() const noexcept { return (N != 0) ? N : n_; }
+
+    /// Computes r = a * b / R mod m with the CIOS method. The result must not alias the operands.
+    void mul(uint64_t* r, const uint64_t* a, const uint64_t* b) const noexcept
+    {
+        const auto n = size();
+        std::fill_n(r, n, 0);
+        uint64_t hi = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint64_t c = 0;
+            for (size_t j = 0; j < n; ++j)
+                r[j] = mac(a[j], b[i], r[j], c);
+            uint64_t hi2 = 0;
+            hi = adc(hi, c, hi2);
+
+            const auto q = r[0] * m_inv_;
+            c = 0;
+            mac(q, m_[0], r[0], c);
+            for (size_t j = 1; j < n; ++j)
+                r[j - 1] = mac(q, m_[j], r[j], c);
+            uint64_t carry = 0;
+            r[n - 1] = adc(hi, c, carry);
+            hi = hi2 + carry;
+        }
+        if (hi != 0 || !less(r, m_, n))
+            sub(r, r, m_, n);
+    }
+
+    /// Computes x = 2x mod m.
+    void dbl(uint64_t* x) const noexcept
+    {
+        const auto n = size();
+        const auto top = x[n - 1] >> 63;
+        for (auto i = n - 1; i != 0; --i)
+            x[i] = (x[i] << 1) | (x[i - 1] >> 63);
+        x[0] <<= 1;
+        if (top != 0 || !less(x, m_, n))
+            sub(x, x, m_, n);
+    }
+
+    /// Computes r = a + b mod m.
+    void add(uint64_t* r, const uint64_t* a, const uint64_t* b) const noexcept
+    {
+        const auto n = size();
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; ++i)
+            r[i] = adc(a[i], b[i], carry);
+        if (carry != 0 || !less(r, m_, n))
+            sub(r, r, m_, n);
+    }
+};
+
+/// The arithmetic modulo 2^k, in n = ceil(k / 64) limbs.
+class Pow2Arith
+{
+    size_t n_;
+    uint64_t top_mask_;
+
+public:
+    explicit Pow2Arith(size_t k) noexcept
+      : n_{(k + 63) / 64}, top_mask_{(k % 64 != 0) ? (uint64_t{1} << (k % 64)) - 1 : ~uint64_t{0}}
+    {}
+
+    size_t size() const noexcept { return n_; }
+
+    void reduce(uint64_t* x) const noexcept { x[n_ - 1] &= top_mask_; }
+
+    void mul(uint64_t* r, const uint64_t* a, const uint64_t* b) const noexcept
+    {
+        mul_lo(r, n_, a, n_, b, n_);
+        reduce(r);
+    }
+};
+
+/// The big-endian exponent without its leading zero bytes, followed by zero bytes.
+struct Exponent
+{
+    bytes_view bytes;
+    uint64_t padding = 0;
+
+    size_t bit_length() const noexcept
+    {
+        if (bytes.empty())
+            return 0;
+        auto top = bytes[0];
+        size_t n = 0;
+        for (; top != 0; top >>= 1)
+            ++n;
+        return (bytes.size() - 1) * 8 + n;
+    }
+
+    /// Returns the bit i of the bytes, without the padding.
+    unsigned bit(size_t i) const noexcept
+    {
+        return (bytes[bytes.size() - 1 - i / 8] >> (i % 8)) & 1;
+    }
+};
+
+/// Returns the sliding window size minimizing the multiplications for the exponent size.
+constexpr size_t window_size(size_t num_bits) noexcept
+{
+    return (num_bits > 671) ? 6 :
+           (num_bits > 239) ? 5 :
+           (num_bits > 79)  ? 4 :
+           (num_bits > 23)  ? 3 :
+                              1;
+}
+
+/// Computes result = base^e with left-to-right sliding window exponentiation, where one is the
+/// neutral element of the arithmetic.
+template <typename Arith>
+void exp(const Arith& arith, uint64_t* result, const uint64_t* base, const uint64_t* one,
+    const Exponent& e) noexcept
+{
+    const auto n = arith.size();
+    const auto num_bits = e.bit_length();
+    if (num_bits == 0)
+    {
+        std::copy_n(one, n, result);
+        return;
+    }
+
+    // The odd powers base^1, base^3, ..., base^(2^w - 1).
+    const auto w = window_size(num_bits);
+    std::vector<uint64_t> table(n << (w - 1));
+    std::vector<uint64_t> buffers(2 * n);
+    auto acc = &buffers[0];
+    auto tmp = &buffers[n];
+    std::copy_n(base, n, table.data());
+    if (w > 1)
+    {
+        arith.mul(tmp, base, base);
+        for (size_t i = 1; i < (size_t{1} << (w - 1)); ++i)
+            arith.mul(&table[i * n], &table[(i - 1) * n], tmp);
+    }
+
+    const auto sqr = [&]() noexcept {
+        arith.mul(tmp, acc, acc);
+        std::swap(acc, tmp);
+    };
+
+    bool first = true;
+    for (auto i = num_bits; i != 0;)
+    {
+        if (e.bit(i - 1) == 0)
+        {
+            sqr();
+            --i;
+            continue;
+        }
+
+        // The window [l, i) ends with a set bit.
+        auto l = (i > w) ? i - w : 0;
+        while (e.bit(l) == 0)
+            ++l;
+        size_t value = 0;
+        for (auto j = i; j != l; --j)
+            value = (value << 1) | e.bit(j - 1);
+        const auto power = &table[(value >> 1) * n];
+
+        if (first)
+        {
+            std::copy_n(power, n, acc);
+            first = false;
+        }
+        else
+        {
+            for (auto j = l; j != i; ++j)
+                sqr();
+            arith.mul(tmp, acc, power);
+            std::swap(acc, tmp);
+        }
+        i = l;
+    }
+
+    for (uint64_t i = 0; i < e.padding * 8; ++i)
+        sqr();
+    std::copy_n(acc, n, result);
+}
+
+/// Computes result = base^e mod m for the odd m > 1 of n limbs, in Montgomery form with the
+/// kernel of size N. The result has n limbs.
+template <size_t N>
+void exp_odd(uint64_t* result, const uint64_t* m, size_t n, const uint64_t* base, size_t base_n,
+    const Exponent& e) noexcept
+{
+    const auto size = (N != 0) ? N : n;
+    std::vector<uint64_t> buffer(size * 7);
+    const auto mod = &buffer[0];
+    const auto rr = &buffer[size];
+    const auto x = &buffer[size * 2];
+    const auto y = &buffer[size * 3];
+    const auto chunk = &buffer[size * 4];
+    const auto one = &buffer[size * 5];
+    const auto r = &buffer[size * 6];
+    std::copy_n(m, n, mod);
+    const MontArith<N> arith{mod, size};
+
+    // R^2 mod m is the Montgomery form of 2^(64 size). It is found from 2^b - m, the Montgomery
+    // form of 2^(b - 64 size) for the bit length b of m, by doubling up to the form of 2 and
+    // continuing with the bits of 64 size, where squaring doubles the power.
+    size_t b = n * 64;
+    for (auto top = m[n - 1]; (top >> 63) == 0; top <<= 1)
+        --b;
+    if (b < size * 64)
+        rr[b / 64] = uint64_t{1} << (b % 64);
+    sub(rr, rr, mod, size);
+    for (auto j = size * 64 - b; j != 0; --j)
+        arith.dbl(rr);
+    arith.dbl(rr);
+    const auto target = size * 64;
+    auto bit = 0;
+    while ((target >> (bit + 1)) != 0)
+        ++bit;
+    for (; bit != 0; --bit)
+    {
+        arith.mul(x, rr, rr);
+        std::copy_n(x, size, rr);
+        if (((target >> (bit - 1)) & 1) != 0)
+            arith.dbl(rr);
+    }
+
+    one[0] = 1;
+    arith.mul(y, one, rr);
+
+    // The base in Montgomery form, by Horner's rule on its chunks of the size, most significant
+    // first: x = x * R + chunk.
+    const auto num_chunks = (base_n + size - 1) / size;
+    std::fill_n(x, size, 0);
+    for (auto i = num_chunks; i != 0; --i)
+    {
+        const auto begin = (i - 1) * size;
+        std::fill_n(chunk, size, 0);
+        std::copy_n(&base[begin], std::min(size, base_n - begin), chunk);
+        arith.mul(r, x, rr);
+        arith.mul(one, chunk, rr);
+        arith.add(x, r, one);
+    }
+
+    std::fill_n(one, size, 0);
+    one[0] = 1;
+    exp(arith, r, x, y, e);
+    arith.mul(x, r, one);
+    std::copy_n(x, n, result);
+}
+
+/// Dispatches to the kernel of the smallest specialized size covering n limbs.
+void exp_odd(uint64_t* result, const uint64_t* m, size_t n, const uint64_t* base, size_t base_n,
+    const Exponent& e) noexcept
+{
+    if (n <= 4)
+        return exp_odd<4>(result, m, n, base, base_n, e);
+    if (n <= 8)
+        return exp_odd<8>(result, m, n, base, base_n, e);
+    if (n <= 16)
+        return exp_odd<16>(result, m, n, base, base_n, e);
+    if (n <= 32)
+        return exp_odd<32>(result, m, n, base, base_n, e);
+    if (n <= 64)
+        return exp_odd<64>(result, m, n, base, base_n, e);
+    return exp_odd<0>(result, m, n, base, base_n, e);
+}
+
+/// Computes result = base^e mod 2^k, in ceil(k / 64) limbs.
+void exp_pow2(uint64_t* result, size_t k, const uint64_t* base, size_t base_n,
+    const Exponent& e) noexcept
+{
+    const Pow2Arith arith{k};
+    const auto n = arith.size();
+    std::vector<uint64_t> buffer(n * 2);
+    std::copy_n(base, std::min(n, base_n), &buffer[0]);
+    arith.reduce(&buffer[0]);
+    buffer[n] = 1;
+    exp(arith, result, &buffer[0], &buffer[n], e);
+}
+
+/// Returns m^-1 mod 2^k for the odd m of n limbs, in ceil(k / 64) limbs.
+std::vector<uint64_t> inverse_pow2(const uint64_t* m, size_t n, size_t k) noexcept
+{
+    const Pow2Arith arith{k};
+    const auto kn = arith.size();
+    std::vector<uint64_t> m_lo(kn);
+    std::copy_n(m, std::min(n, kn), m_lo.data());
+    std::vector<uint64_t> inv(kn);
+    std::vector<uint64_t> t(kn);
+    std::vector<uint64_t> u(kn);
+
+    inv[0] = m[0];
+    for (int i = 0; i < 5; ++i)
+        inv[0] *= 2 - m[0] * inv[0];
+    // Newton's iteration inv = inv * (2 - m * inv) doubles the correct limbs.
+    for (size_t precision = 1; precision < kn; precision *= 2)
+    {
+        arith.mul(t.data(), m_lo.data(), inv.data());
+        uint64_t carry = 3;
+        for (auto& limb : t)
+            limb = adc(~limb, 0, carry);
+        arith.mul(u.data(), inv.data(), t.data());
+        std::swap(inv, u);
+    }
+    arith.reduce(inv.data());
+    return inv;
+}
+
+/// Loads the big-endian bytes into n limbs.
+void load(uint64_t* x, size_t n, bytes_view data) noexcept
+{
+    std::fill_n(x, n, 0);
+    for (size_t i = 0; i < data.size(); ++i)
+        x[i / 8] |= uint64_t{data[data.size() - 1 - i]} << (i % 8 * 8);
+}
+}  // namespace
+
+void modexp(uint8_t* output, bytes_view base, bytes_view exp, uint64_t exp_padding,
+    bytes_view mod) noexcept
+{
+    const auto output_size = mod.size();
+    std::memset(output, 0, output_size);
+    while (!mod.empty() && mod[0] == 0)
+        mod.remove_prefix(1);
+    while (!exp.empty() && exp[0] == 0)
+        exp.remove_prefix(1);
+    if (mod.empty() || (mod.size() == 1 && mod[0] == 1))
+        return;
+    const Exponent e{exp, exp.empty() ? 0 : exp_padding};
+
+    const auto n = (mod.size() + 7) / 8;
+    const auto base_n = std::max<size_t>((base.size() + 7) / 8, 1);
+    std::vector<uint64_t> buffer(n * 3 + base_n);
+    const auto m = &buffer[0];
+    const auto result = &buffer[n];
+    const auto tmp = &buffer[n * 2];
+    const auto b = &buffer[n * 3];
+    load(m, n, mod);
+    load(b, base_n, base);
+
+    // m = 2^k * m_odd.
+    size_t k = 0;
+    while (m[k / 64] == 0)
+        k += 64;
+    for (auto limb = m[k / 64]; (limb & 1) == 0; limb >>= 1)
+        ++k;
+    if (k == 0)
+    {
+        exp_odd(result, m, n, b, base_n, e);
+    }
+    else
+    {
+        std::vector<uint64_t> m_odd(n);
+        const auto shift = k % 64;
+        for (size_t i = k / 64; i < n; ++i)
+        {
+            const auto next = (i + 1 < n) ? m[i + 1] : 0;
+            m_odd[i - k / 64] =
+                (shift != 0) ? (m[i] >> shift) | (next << (64 - shift)) : m[i];
+        }
+        auto odd_n = n;
+        while (m_odd[odd_n - 1] == 0)
+            --odd_n;
+
+        const auto kn = (k + 63) / 64;
+        std::vector<uint64_t> x2(kn);
+        exp_pow2(x2.data(), k, b, base_n, e);
+        if (odd_n == 1 && m_odd[0] == 1)
+        {
+            std::copy_n(x2.data(), kn, result);
+        }
+        else
+        {
+            // By the CRT, the result is x1 + m_odd * ((x2 - x1) * m_odd^-1 mod 2^k), for
+            // x1 = base^e mod m_odd and x2 = base^e mod 2^k.
+            exp_odd(result, m_odd.data(), odd_n, b, base_n, e);
+            const Pow2Arith arith{k};
+            const auto inv = inverse_pow2(m_odd.data(), odd_n, k);
+            std::vector<uint64_t> x1(kn);
+            std::copy_n(result, std::min(odd_n, kn), x1.data());
+            sub(x2.data(), x2.data(), x1.data(), kn);
+            std::vector<uint64_t> y(kn);
+            arith.mul(y.data(), x2.data(), inv.data());
+            mul_lo(tmp, n, m_odd.data(), odd_n, y.data(), kn);
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i)
+                result[i] = adc(result[i], tmp[i], carry);
+        }
+    }
+
+    for (size_t i = 0; i < std::min(output_size, n * 8); ++i)
+        output[output_size - 1 - i] = static_cast<uint8_t>(result[i / 8] >> (i % 8 * 8));
+}
+}  // namespace evm::precompiles
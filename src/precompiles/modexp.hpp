@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace evm::precompiles
+{
+/// Computes base^exp mod mod of the big-endian numbers, storing the result, of the size of mod,
+/// in output. The exponent is followed by exp_padding zero bytes, so that an exponent
+/// extending past the input need not be copied. The result is zero if mod is zero.
+void modexp(uint8_t* output, std::basic_string_view<uint8_t> base,
+    std::basic_string_view<uint8_t> exp, uint64_t exp_padding,
+    std::basic_string_view<uint8_t> mod) noexcept;
+}  // namespace evm::precompiles
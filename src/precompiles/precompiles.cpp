@@ -0,0 +1,354 @@
+#include "precompiles.hpp"
+#include "blake2b.hpp"
+#include "bn254.hpp"
+#include "modexp.hpp"
+#include "ripemd160.hpp"
+#include "secp256k1.hpp"
+#include "sha256.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace evm::precompiles
+{
+namespace
+{
+using GasCostFn = int64_t (*)(bytes_view input, evmc_revision rev) noexcept;
+
+/// Computes the output of a precompile. Returns false if the input is invalid.
+using ExecuteFn = bool (*)(bytes_view input, bytes& output) noexcept;
+
+struct Precompile
+{
+    GasCostFn gas_cost = nullptr;
+    ExecuteFn execute = nullptr;  ///< Null if the precompile is left to the host.
+};
+
+constexpr int64_t num_words(size_t size) noexcept
+{
+    return static_cast<int64_t>((size + 31) / 32);
+}
+
+/// Copies the input to a buffer of the size, truncating it or padding it with zeros.
+template <size_t N>
+void pad_input(uint8_t (&buffer)[N], bytes_view input) noexcept
+{
+    const auto size = std::min(input.size(), N);
+    std::memcpy(buffer, input.data(), size);
+    std::memset(&buffer[size], 0, N - size);
+}
+
+int64_t ecrecover_gas_cost(bytes_view /*input*/, evmc_revision /*rev*/) noexcept
+{
+    return 3000;
+}
+
+bool ecrecover_execute(bytes_view input, bytes& output) noexcept
+{
+    uint8_t buffer[128];
+    pad_input(buffer, input);
+
+    // Invalid signatures, including v other than 27 or 28, give an empty output.
+    const auto v = buffer[63];
+    if (!std::all_of(&buffer[32], &buffer[63], [](uint8_t b) { return b == 0; }) ||
+        (v != 27 && v != 28))
+        return true;
+    uint8_t address[20];
+    if (!ecrecover(address, &buffer[0], &buffer[64], &buffer[96], v == 28))
+        return true;
+    output.assign(12, 0);
+    output.append(address, sizeof(address));
+    return true;
+}
+
+int64_t sha256_gas_cost(bytes_view input, evmc_revision /*rev*/) noexcept
+{
+    return 60 + 12 * num_words(input.size());
+}
+
+bool sha256_execute(bytes_view input, bytes& output) noexcept
+{
+    output.resize(32);
+    sha256(output.data(), input.data(), input.size());
+    return true;
+}
+
+int64_t ripemd160_gas_cost(bytes_view input, evmc_revision /*rev*/) noexcept
+{
+    return 600 + 120 * num_words(input.size());
+}
+
+bool ripemd160_execute(bytes_view input, bytes& output) noexcept
+{
+    // The 20-byte hash is left-padded to a word.
+    output.assign(32, 0);
+    ripemd160(&output[12], input.data(), input.size());
+    return true;
+}
+
+int64_t identity_gas_cost(bytes_view input, evmc_revision /*rev*/) noexcept
+{
+    return 15 + 3 * num_words(input.size());
+}
+
+bool identity_execute(bytes_view input, bytes& output) noexcept
+{
+    output.assign(input);
+    return true;
+}
+
+/// Returns the part of the input in [offset, offset + size), shorter if the input ends before.
+bytes_view input_slice(bytes_view input, uint64_t offset, uint64_t size) noexcept
+{
+    if (offset >= input.size())
+        return {};
+    const auto available = input.size() - static_cast<size_t>(offset);
+    return input.substr(static_cast<size_t>(offset),
+        static_cast<size_t>(std::min<uint64_t>(size, available)));
+}
+
+constexpr auto uint64_max = std::numeric_limits<uint64_t>::max();
+
+constexpr uint64_t add_sat(uint64_t a, uint64_t b) noexcept
+{
+    return (a > uint64_max - b) ? uint64_max : a + b;
+}
+
+constexpr uint64_t mul_sat(uint64_t a, uint64_t b) noexcept
+{
+    return (a != 0 && b > uint64_max / a) ? uint64_max : a * b;
+}
+
+/// Reads the big-endian word at the offset of the input padded with zeros, saturated to 64 bits.
+uint64_t load_length(bytes_view input, uint64_t offset) noexcept
+{
+    const auto word = input_slice(input, offset, 32);
+    uint64_t value = 0;
+    for (size_t i = 0; i < word.size(); ++i)
+    {
+        if (i < 24 && word[i] != 0)
+            return uint64_max;
+        if (i >= 24)
+            value |= uint64_t{word[i]} << ((31 - i) * 8);
+    }
+    return value;
+}
+
+/// The lengths of the base, the exponent and the modulus of MODEXP, saturated to 64 bits.
+struct ModexpLengths
+{
+    uint64_t base;
+    uint64_t exp;
+    uint64_t mod;
+
+    explicit ModexpLengths(bytes_view input) noexcept
+      : base{load_length(input, 0)}, exp{load_length(input, 32)}, mod{load_length(input, 64)}
+    {}
+
+    uint64_t exp_offset() const noexcept { return add_sat(96, base); }
+    uint64_t mod_offset() const noexcept { return add_sat(exp_offset(), exp); }
+};
+
+int64_t expmod_gas_cost(bytes_view input, evmc_revision rev) noexcept
+{
+    const ModexpLengths len{input};
+
+    // The adjusted exponent length, from the bit length of the first 32 bytes of the exponent.
+    const auto head = input_slice(input, len.exp_offset(), std::min<uint64_t>(len.exp, 32));
+    uint64_t head_bits = 0;
+    for (size_t i = 0; i < head.size(); ++i)
+    {
+        if (head[i] != 0)
+        {
+            head_bits = (std::min<uint64_t>(len.exp, 32) - i) * 8;
+            for (auto b = head[i]; (b & 0x80) == 0; b = static_cast<uint8_t>(b << 1))
+                --head_bits;
+            break;
+        }
+    }
+    const auto adjusted_exp_len = add_sat((len.exp > 32) ? mul_sat(len.exp - 32, 8) : 0,
+        (head_bits != 0) ? head_bits - 1 : 0);
+    const auto iterations = std::max<uint64_t>(adjusted_exp_len, 1);
+
+    const auto x = std::max(len.base, len.mod);
+    uint64_t cost = 0;
+    if (rev >= EVMC_BERLIN)
+    {
+        // EIP-2565.
+        const auto words = x / 8 + (x % 8 != 0);
+        cost = std::max<uint64_t>(mul_sat(mul_sat(words, words), iterations) / 3, 200);
+    }
+    else
+    {
+        // EIP-198.
+        const auto x2 = mul_sat(x, x);
+        const auto complexity = (x <= 64)   ? x2 :
+                                (x <= 1024) ? add_sat(x2 / 4, 96 * x) - 3072 :
+                                              add_sat(x2 / 16, mul_sat(x, 480)) - 199680;
+        cost = mul_sat(complexity, iterations) / 20;
+    }
+    return static_cast<int64_t>(std::min<uint64_t>(cost, std::numeric_limits<int64_t>::max()));
+}
+
+bool expmod_execute(bytes_view input, bytes& output) noexcept
+{
+    const ModexpLengths len{input};
+    if (len.mod == 0)
+        return true;
+
+    // Larger base or modulus cost more than 2^55 gas.
+    constexpr uint64_t max_len = uint64_t{1} << 32;
+    if (len.base > max_len || len.mod > max_len)
+        return false;
+
+    const auto padded = [&input](uint64_t offset, uint64_t size) noexcept {
+        bytes r(static_cast<size_t>(size), 0);
+        const auto part = input_slice(input, offset, size);
+        std::copy(part.begin(), part.end(), r.begin());
+        return r;
+    };
+    const auto base = padded(96, len.base);
+    const auto mod = padded(len.mod_offset(), len.mod);
+    const auto exp = input_slice(input, len.exp_offset(), len.exp);
+    output.resize(static_cast<size_t>(len.mod));
+    modexp(output.data(), base, exp, len.exp - exp.size(), mod);
+    return true;
+}
+
+#if EVM_BN254_SUPPORTED
+int64_t ecadd_gas_cost(bytes_view /*input*/, evmc_revision rev) noexcept
+{
+    return (rev >= EVMC_ISTANBUL) ? 150 : 500;
+}
+
+bool ecadd_execute(bytes_view input, bytes& output) noexcept
+{
+    uint8_t buffer[128];
+    pad_input(buffer, input);
+    output.resize(64);
+    return bn254_add(output.data(), buffer);
+}
+
+int64_t ecmul_gas_cost(bytes_view /*input*/, evmc_revision rev) noexcept
+{
+    return (rev >= EVMC_ISTANBUL) ? 6000 : 40000;
+}
+
+bool ecmul_execute(bytes_view input, bytes& output) noexcept
+{
+    uint8_t buffer[96];
+    pad_input(buffer, input);
+    output.resize(64);
+    return bn254_mul(output.data(), buffer);
+}
+
+constexpr size_t ecpairing_pair_size = 192;
+
+int64_t ecpairing_gas_cost(bytes_view input, evmc_revision rev) noexcept
+{
+    const auto num_pairs = static_cast<int64_t>(input.size() / ecpairing_pair_size);
+    return (rev >= EVMC_ISTANBUL) ? 45000 + 34000 * num_pairs : 100000 + 80000 * num_pairs;
+}
+
+bool ecpairing_execute(bytes_view input, bytes& output) noexcept
+{
+    if (input.size() % ecpairing_pair_size != 0)
+        return false;
+    bool result = false;
+    if (!bn254_pairing_check(result, input.data(), input.size() / ecpairing_pair_size))
+        return false;
+    output.assign(32, 0);
+    output[31] = result ? 1 : 0;
+    return true;
+}
+#endif
+
+constexpr size_t blake2bf_input_size = 213;
+
+int64_t blake2bf_gas_cost(bytes_view input, evmc_revision /*rev*/) noexcept
+{
+    // The number of rounds. Inputs of other sizes fail without using gas.
+    if (input.size() != blake2bf_input_size)
+        return 0;
+    return int64_t{evmc::load32be(input.data())};
+}
+
+bool blake2bf_execute(bytes_view input, bytes& output) noexcept
+{
+    // The rounds, the state h, the message m, the offset t and the final block flag f, with
+    // the words in little-endian order.
+    if (input.size() != blake2bf_input_size || input[212] > 1)
+        return false;
+    uint64_t h[8];
+    uint64_t m[16];
+    uint64_t t[2];
+    for (size_t i = 0; i < 8; ++i)
+        h[i] = evmc::load64le(&input[4 + i * 8]);
+    for (size_t i = 0; i < 16; ++i)
+        m[i] = evmc::load64le(&input[68 + i * 8]);
+    for (size_t i = 0; i < 2; ++i)
+        t[i] = evmc::load64le(&input[196 + i * 8]);
+    blake2b_compress(evmc::load32be(input.data()), h, m, t, input[212] != 0);
+
+    output.resize(sizeof(h));
+    for (size_t i = 0; i < sizeof(h); ++i)
+        output[i] = static_cast<uint8_t>(h[i / 8] >> (i % 8 * 8));
+    return true;
+}
+
+constexpr Precompile precompiles[] = {
+    {},                                         // 0x00
+    {ecrecover_gas_cost, ecrecover_execute},    // ecrecover
+    {sha256_gas_cost, sha256_execute},          // sha256
+    {ripemd160_gas_cost, ripemd160_execute},    // ripemd160
+    {identity_gas_cost, identity_execute},      // identity
+    {expmod_gas_cost, expmod_execute},          // expmod
+#if EVM_BN254_SUPPORTED
+    {ecadd_gas_cost, ecadd_execute},            // ecadd
+    {ecmul_gas_cost, ecmul_execute},            // ecmul
+    {ecpairing_gas_cost, ecpairing_execute},    // ecpairing
+#else
+    {},                                         // ecadd
+    {},                                         // ecmul
+    {},                                         // ecpairing
+#endif
+    {blake2bf_gas_cost, blake2bf_execute},      // blake2bf
+    {},                                         // point_evaluation
+};
+}  // namespace
+
+std::optional<PrecompileId> find(evmc_revision rev, const evmc::address& addr) noexcept
+{
+    const auto num_precompiles = (rev >= EVMC_CANCUN)    ? 0x0a :
+                                 (rev >= EVMC_ISTANBUL)  ? 0x09 :
+                                 (rev >= EVMC_BYZANTIUM) ? 0x08 :
+                                                           0x04;
+    const auto id = addr.bytes[sizeof(addr) - 1];
+    if (id == 0 || id > num_precompiles ||
+        !std::all_of(addr.bytes, &addr.bytes[sizeof(addr) - 1], [](uint8_t b) { return b == 0; }))
+        return std::nullopt;
+    return static_cast<PrecompileId>(id);
+}
+
+std::optional<ExecutionResult> execute(evmc_revision rev, const evmc::address& addr,
+    bytes_view input, int64_t gas, bytes& output) noexcept
+{
+    const auto id = find(rev, addr);
+    if (!id.has_value())
+        return std::nullopt;
+    const auto& precompile = precompiles[static_cast<size_t>(*id)];
+    if (precompile.execute == nullptr)
+        return std::nullopt;
+
+    output.clear();
+    const auto gas_cost = precompile.gas_cost(input, rev);
+    if (gas_cost > gas)
+        return ExecutionResult{EVMC_OUT_OF_GAS, 0};
+    if (!precompile.execute(input, output))
+    {
+        output.clear();
+        return ExecutionResult{EVMC_PRECOMPILE_FAILURE, 0};
+    }
+    return ExecutionResult{EVMC_SUCCESS, gas - gas_cost};
+}
+}  // namespace evm::precompiles
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <evmc/evmc.hpp>
+#include <optional>
+#include <string>
+
+namespace evm::precompiles
+{
+using bytes = std::basic_string<uint8_t>;
+using bytes_view = std::basic_string_view<uint8_t>;
+
+/// The precompiled contracts, by the last byte of their address.
+enum class PrecompileId : uint8_t
+{
+    ecrecover = 0x01,
+    sha256 = 0x02,
+    ripemd160 = 0x03,
+    identity = 0x04,
+    expmod = 0x05,
+    ecadd = 0x06,
+    ecmul = 0x07,
+    ecpairing = 0x08,
+    blake2bf = 0x09,
+    point_evaluation = 0x0a,
+};
+
+struct ExecutionResult
+{
+    evmc_status_code status_code;
+    int64_t gas_left;
+};
+
+/// Returns the precompiled contract at the address in the revision, nullopt if there is none.
+std::optional<PrecompileId> find(evmc_revision rev, const evmc::address& addr) noexcept;
+
+/// Executes the precompiled contract at the address in the VM, storing the output in output,
+/// empty on failure. Returns nullopt if the address is not a precompile of the revision
+/// implemented natively, and the call must be passed to the host.
+std::optional<ExecutionResult> execute(evmc_revision rev, const evmc::address& addr,
+    bytes_view input, int64_t gas, bytes& output) noexcept;
+}  // namespace evm::precompiles
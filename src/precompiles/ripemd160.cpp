@@ -0,0 +1,118 @@
+#include "ripemd160.hpp"
+#include <cstring>
+
+namespace evm::precompiles
+{
+namespace
+{
+// The message word, the rotation and the constant of each round of the left and the right line.
+constexpr uint8_t r_left[80] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 7, 4, 13,
+    1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8, 3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5,
+    12, 1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2, 4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3,
+    8, 11, 6, 15, 13};
+constexpr uint8_t r_right[80] = {5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12, 6, 11, 3,
+    7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2, 15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4,
+    13, 8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14, 12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13,
+    14, 0, 3, 9, 11};
+constexpr uint8_t s_left[80] = {11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8, 7, 6, 8,
+    13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12, 11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5,
+    12, 7, 5, 11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12, 9, 15, 5, 11, 6, 8, 13, 12,
+    5, 12, 13, 14, 11, 8, 5, 6};
+constexpr uint8_t s_right[80] = {8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6, 9, 13,
+    15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11, 9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13,
+    13, 7, 5, 15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8, 8, 5, 12, 9, 12, 5, 14, 6,
+    8, 13, 6, 5, 15, 13, 11, 11};
+constexpr uint32_t k_left[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+constexpr uint32_t k_right[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+inline uint32_t rotl(uint32_t x, int n) noexcept
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+/// The boolean function of the round group j, used in reverse order by the right line.
+inline uint32_t f(int j, uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    switch (j)
+    {
+    case 0:
+        return x ^ y ^ z;
+    case 1:
+        return (x & y) | (~x & z);
+    case 2:
+        return (x | ~y) ^ z;
+    case 3:
+        return (x & z) | (y & ~z);
+    default:
+        return x ^ (y | ~z);
+    }
+}
+
+void compress(uint32_t state[5], const uint8_t* block) noexcept
+{
+    uint32_t x[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        x[i] = uint32_t{block[i * 4]} | uint32_t{block[i * 4 + 1]} << 8 |
+               uint32_t{block[i * 4 + 2]} << 16 | uint32_t{block[i * 4 + 3]} << 24;
+    }
+
+    auto al = state[0], bl = state[1], cl = state[2], dl = state[3], el = state[4];
+    auto ar = al, br = bl, cr = cl, dr = dl, er = el;
+    for (int i = 0; i < 80; ++i)
+    {
+        const auto j = i / 16;
+        auto t = rotl(al + f(j, bl, cl, dl) + x[r_left[i]] + k_left[j], s_left[i]) + el;
+        al = el;
+        el = dl;
+        dl = rotl(cl, 10);
+        cl = bl;
+        bl = t;
+
+        t = rotl(ar + f(4 - j, br, cr, dr) + x[r_right[i]] + k_right[j], s_right[i]) + er;
+        ar = er;
+        er = dr;
+        dr = rotl(cr, 10);
+        cr = br;
+        br = t;
+    }
+
+    const auto t = state[1] + cl + dr;
+    state[1] = state[2] + dl + er;
+    state[2] = state[3] + el + ar;
+    state[3] = state[4] + al + br;
+    state[4] = state[0] + bl + cr;
+    state[0] = t;
+}
+}  // namespace
+
+void ripemd160(uint8_t hash[20], const uint8_t* data, size_t size) noexcept
+{
+    uint32_t state[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+    const auto num_blocks = size / 64;
+    for (size_t i = 0; i < num_blocks; ++i)
+        compress(state, &data[i * 64]);
+
+    // The padding as in MD4, with the length in little-endian order.
+    const auto tail_size = size % 64;
+    uint8_t tail[128]{};
+    if (tail_size != 0)
+        std::memcpy(tail, &data[num_blocks * 64], tail_size);
+    tail[tail_size] = 0x80;
+    const auto tail_blocks = (tail_size < 56) ? size_t{1} : size_t{2};
+    const auto bit_size = uint64_t{size} * 8;
+    for (int i = 0; i < 8; ++i)
+        tail[tail_blocks * 64 - 8 + i] = static_cast<uint8_t>(bit_size >> (i * 8));
+    for (size_t i = 0; i < tail_blocks; ++i)
+        compress(state, &tail[i * 64]);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        hash[i * 4] = static_cast<uint8_t>(state[i]);
+        hash[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 8);
+        hash[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 16);
+        hash[i * 4 + 3] = static_cast<uint8_t>(state[i] >> 24);
+    }
+}
+}  // namespace evm::precompiles
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace evm::precompiles
+{
+/// Computes the RIPEMD-160 hash of the data.
+void ripemd160(uint8_t hash[20], const uint8_t* data, size_t size) noexcept;
+}  // namespace evm::precompiles
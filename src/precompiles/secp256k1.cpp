@@ -0,0 +1,451 @@
+#include "secp256k1.hpp"
+#include <ethash/keccak.hpp>
+#include <intx/intx.hpp>
+#include <array>
+#include <cstring>
+
+namespace evm::precompiles
+{
+namespace
+{
+/// A prime modulus below 2^256 and its constants for the Montgomery form with R = 2^256.
+struct Modulus
+{
+    uint64_t m[4];
+    uint64_t inv;  ///< -m^-1 mod 2^64.
+    uint64_t r_squared[4];
+};
+
+/// The modulus of the coordinates.
+constexpr Modulus field_p = {
+    {0xfffffffefffffc2f, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff},
+    0xd838091dd2253531, {0x000007a2000e90a1, 0x0000000000000001, 0, 0}};
+
+/// The order of the group, the modulus of the scalars.
+constexpr Modulus order_n = {
+    {0xbfd25e8cd0364141, 0xbaaedce6af48a03b, 0xfffffffffffffffe, 0xffffffffffffffff},
+    0x4b0dff665588b13f,
+    {0x896cf21467d7d140, 0x741496c20e7cf878, 0xe697f5e45bcd07c6, 0x9d671cd581c69bc5}};
+
+/// An element of the field of the modulus, in Montgomery form unless stated otherwise.
+template <const Modulus& M>
+struct Element
+{
+    uint64_t v[4];
+};
+
+using Fp = Element<field_p>;
+using Fn = Element<order_n>;
+
+/// Returns the low word of a + b + carry, setting carry to the high word.
+inline uint64_t adc(uint64_t a, uint64_t b, uint64_t& carry) noexcept
+{
+    const auto s = a + b;
+    const auto c1 = s < a;
+    const auto r = s + carry;
+    carry = c1 | (r < s);
+    return r;
+}
+
+/// Returns the low word of a - b - borrow, setting borrow to the borrow out.
+inline uint64_t sbb(uint64_t a, uint64_t b, uint64_t& borrow) noexcept
+{
+    const auto d = a - b;
+    const auto b1 = a < b;
+    const auto r = d - borrow;
+    borrow = b1 | (d < borrow);
+    return r;
+}
+
+/// Returns the low word of a + b * c + carry, setting carry to the high word.
+inline uint64_t mac(uint64_t a, uint64_t b, uint64_t c, uint64_t& carry) noexcept
+{
+    const auto t = intx::umul(b, c) + a + carry;
+    carry = t[1];
+    return t[0];
+}
+
+/// Subtracts the modulus from hi * 2^256 + a if it is not below it, for values below 2m.
+template <const Modulus& M>
+inline Element<M> reduce_once(const Element<M>& a, uint64_t hi) noexcept
+{
+    uint64_t borrow = 0;
+    const Element<M> d = {{sbb(a.v[0], M.m[0], borrow), sbb(a.v[1], M.m[1], borrow),
+        sbb(a.v[2], M.m[2], borrow), sbb(a.v[3], M.m[3], borrow)}};
+    return (hi == 0 && borrow != 0) ? a : d;
+}
+
+template <const Modulus& M>
+inline Element<M> operator+(const Element<M>& a, const Element<M>& b) noexcept
+{
+    uint64_t carry = 0;
+    const Element<M> s = {{adc(a.v[0], b.v[0], carry), adc(a.v[1], b.v[1], carry),
+        adc(a.v[2], b.v[2], carry), adc(a.v[3], b.v[3], carry)}};
+    return reduce_once(s, carry);
+}
+
+template <const Modulus& M>
+inline Element<M> operator-(const Element<M>& a, const Element<M>& b) noexcept
+{
+    uint64_t borrow = 0;
+    const Element<M> d = {{sbb(a.v[0], b.v[0], borrow), sbb(a.v[1], b.v[1], borrow),
+        sbb(a.v[2], b.v[2], borrow), sbb(a.v[3], b.v[3], borrow)}};
+    if (borrow == 0)
+        return d;
+    uint64_t carry = 0;
+    return {{adc(d.v[0], M.m[0], carry), adc(d.v[1], M.m[1], carry), adc(d.v[2], M.m[2], carry),
+        adc(d.v[3], M.m[3], carry)}};
+}
+
+/// Montgomery multiplication (CIOS), with a fifth word as the moduli are close to 2^256.
+template <const Modulus& M>
+inline Element<M> operator*(const Element<M>& a, const Element<M>& b) noexcept
+{
+    uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0;
+    for (const auto bi : b.v)
+    {
+        uint64_t c = 0;
+        t0 = mac(t0, a.v[0], bi, c);
+        t1 = mac(t1, a.v[1], bi, c);
+        t2 = mac(t2, a.v[2], bi, c);
+        t3 = mac(t3, a.v[3], bi, c);
+        uint64_t t5 = 0;
+        t4 = adc(t4, c, t5);
+
+        const auto q = t0 * M.inv;
+        c = 0;
+        mac(t0, q, M.m[0], c);
+        t0 = mac(t1, q, M.m[1], c);
+        t1 = mac(t2, q, M.m[2], c);
+        t2 = mac(t3, q, M.m[3], c);
+        uint64_t carry = 0;
+        t3 = adc(t4, c, carry);
+        t4 = t5 + carry;
+    }
+    return reduce_once(Element<M>{{t0, t1, t2, t3}}, t4);
+}
+
+template <const Modulus& M>
+inline bool operator==(const Element<M>& a, const Element<M>& b) noexcept
+{
+    return ((a.v[0] ^ b.v[0]) | (a.v[1] ^ b.v[1]) | (a.v[2] ^ b.v[2]) | (a.v[3] ^ b.v[3])) == 0;
+}
+
+template <const Modulus& M>
+inline bool is_zero(const Element<M>& a) noexcept
+{
+    return (a.v[0] | a.v[1] | a.v[2] | a.v[3]) == 0;
+}
+
+template <const Modulus& M>
+inline Element<M> sqr(const Element<M>& a) noexcept
+{
+    return a * a;
+}
+
+/// Converts a value below the modulus to Montgomery form.
+template <const Modulus& M>
+inline Element<M> to_mont(const Element<M>& a) noexcept
+{
+    return a * Element<M>{{M.r_squared[0], M.r_squared[1], M.r_squared[2], M.r_squared[3]}};
+}
+
+/// Converts a value from Montgomery form.
+template <const Modulus& M>
+inline Element<M> from_mont(const Element<M>& a) noexcept
+{
+    return a * Element<M>{{1, 0, 0, 0}};
+}
+
+/// Returns a^(2^n).
+template <const Modulus& M>
+inline Element<M> sqr_n(Element<M> a, int n) noexcept
+{
+    for (int i = 0; i < n; ++i)
+        a = sqr(a);
+    return a;
+}
+
+/// Returns a^e, with one the Montgomery form of 1.
+template <const Modulus& M>
+inline Element<M> pow(const Element<M>& a, const uint64_t e[4], const Element<M>& one) noexcept
+{
+    auto r = one;
+    for (int i = 255; i >= 0; --i)
+    {
+        r = sqr(r);
+        if (((e[i / 64] >> (i % 64)) & 1) != 0)
+            r = r * a;
+    }
+    return r;
+}
+
+/// Loads a big-endian value, returning false if it is not below the modulus.
+template <const Modulus& M>
+inline bool load(Element<M>& a, const uint8_t bytes[32]) noexcept
+{
+    for (int i = 0; i < 32; ++i)
+        a.v[3 - i / 8] = (a.v[3 - i / 8] << 8) | bytes[i];
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i)
+        sbb(a.v[i], M.m[i], borrow);
+    return borrow != 0;
+}
+
+constexpr Fp fp_one = {{0x00000001000003d1, 0, 0, 0}};
+constexpr Fn fn_one = {{0x402da1732fc9bebf, 0x4551231950b75fc4, 1, 0}};
+constexpr Fp curve_b = {{0x0000000700001ab7, 0, 0, 0}};  ///< 7 of y^2 = x^3 + 7.
+
+/// Returns a^(2^223 - 1), the common part of the addition chains of sqrt() and inv(), and sets
+/// x2 and x22 to a^(2^2 - 1) and a^(2^22 - 1).
+Fp pow_x223(const Fp& a, Fp& x2, Fp& x22) noexcept
+{
+    x2 = sqr(a) * a;
+    const auto x3 = sqr(x2) * a;
+    const auto x6 = sqr_n(x3, 3) * x3;
+    const auto x9 = sqr_n(x6, 3) * x3;
+    const auto x11 = sqr_n(x9, 2) * x2;
+    x22 = sqr_n(x11, 11) * x11;
+    const auto x44 = sqr_n(x22, 22) * x22;
+    const auto x88 = sqr_n(x44, 44) * x44;
+    const auto x176 = sqr_n(x88, 88) * x88;
+    const auto x220 = sqr_n(x176, 44) * x44;
+    return sqr_n(x220, 3) * x3;
+}
+
+/// Returns a^((p + 1) / 4), the square root of a if there is one, as p = 3 mod 4.
+Fp sqrt(const Fp& a) noexcept
+{
+    Fp x2;
+    Fp x22;
+    const auto x223 = pow_x223(a, x2, x22);
+    return sqr_n(sqr_n(sqr_n(x223, 23) * x22, 6) * x2, 2);
+}
+
+/// Returns a^(p - 2), the inverse of a.
+Fp inv(const Fp& a) noexcept
+{
+    Fp x2;
+    Fp x22;
+    const auto x223 = pow_x223(a, x2, x22);
+    return sqr_n(sqr_n(sqr_n(sqr_n(x223, 23) * x22, 5) * a, 3) * x2, 2) * a;
+}
+
+struct AffinePoint
+{
+    Fp x;
+    Fp y;
+};
+
+constexpr AffinePoint generator = {
+    {{0xd7362e5a487e2097, 0x231e295329bc66db, 0x979f48c033fd129c, 0x9981e643e9089f48}},
+    {{0xb15ea6d2d3dbabe2, 0x8dfc5d5d1f1dc64d, 0x70b6b59aac19c136, 0xcf3f851fd4a582d6}}};
+
+/// A point in Jacobian coordinates, the point at infinity if z is zero.
+struct Point
+{
+    Fp x;
+    Fp y;
+    Fp z;
+};
+
+inline Point dbl(const Point& a) noexcept
+{
+    if (is_zero(a.z))
+        return a;
+    const auto xx = sqr(a.x);
+    const auto yy = sqr(a.y);
+    const auto yyyy = sqr(yy);
+    auto d = sqr(a.x + yy) - xx - yyyy;
+    d = d + d;
+    const auto e = xx + xx + xx;
+    const auto x = sqr(e) - (d + d);
+    auto yyyy_8 = yyyy + yyyy;
+    yyyy_8 = yyyy_8 + yyyy_8;
+    yyyy_8 = yyyy_8 + yyyy_8;
+    const auto yz = a.y * a.z;
+    return {x, e * (d - x) - yyyy_8, yz + yz};
+}
+
+inline Point add(const Point& a, const Point& b) noexcept
+{
+    if (is_zero(a.z))
+        return b;
+    if (is_zero(b.z))
+        return a;
+    const auto z1z1 = sqr(a.z);
+    const auto z2z2 = sqr(b.z);
+    const auto u1 = a.x * z2z2;
+    const auto u2 = b.x * z1z1;
+    const auto s1 = a.y * b.z * z2z2;
+    const auto s2 = b.y * a.z * z1z1;
+    const auto h = u2 - u1;
+    auto rr = s2 - s1;
+    if (is_zero(h))
+        return is_zero(rr) ? dbl(a) : Point{};
+    const auto i = sqr(h + h);
+    const auto j = h * i;
+    rr = rr + rr;
+    const auto v = u1 * i;
+    const auto x = sqr(rr) - j - (v + v);
+    const auto s1j = s1 * j;
+    return {x, rr * (v - x) - (s1j + s1j), (sqr(a.z + b.z) - z1z1 - z2z2) * h};
+}
+
+/// Adds the affine point b, with 7M + 4S instead of 11M + 5S.
+inline Point add(const Point& a, const AffinePoint& b) noexcept
+{
+    if (is_zero(a.z))
+        return {b.x, b.y, fp_one};
+    const auto z1z1 = sqr(a.z);
+    const auto u2 = b.x * z1z1;
+    const auto s2 = b.y * a.z * z1z1;
+    const auto h = u2 - a.x;
+    auto rr = s2 - a.y;
+    if (is_zero(h))
+        return is_zero(rr) ? dbl(a) : Point{};
+    const auto hh = sqr(h);
+    auto i = hh + hh;
+    i = i + i;
+    const auto j = h * i;
+    rr = rr + rr;
+    const auto v = a.x * i;
+    const auto x = sqr(rr) - j - (v + v);
+    const auto y1j = a.y * j;
+    return {x, rr * (v - x) - (y1j + y1j), sqr(a.z + h) - z1z1 - hh};
+}
+
+/// The window width of the NAFs of the scalars.
+constexpr int wnaf_width = 5;
+constexpr size_t table_size = size_t{1} << (wnaf_width - 2);
+
+/// Sets the digits to the width-5 NAF of k: odd digits in (-16, 16), of which at most one in
+/// any 5 consecutive is non-zero, so that 256 doublings come with about 43 additions.
+void wnaf(int8_t digits[257], const Fn& k) noexcept
+{
+    uint64_t v[5] = {k.v[0], k.v[1], k.v[2], k.v[3], 0};
+    for (int i = 0; i < 257; ++i)
+    {
+        int d = 0;
+        if ((v[0] & 1) != 0)
+        {
+            d = static_cast<int>(v[0] & ((1 << wnaf_width) - 1));
+            if (d >= (1 << (wnaf_width - 1)))
+                d -= 1 << wnaf_width;
+            uint64_t carry = 0;
+            if (d > 0)
+                v[0] = sbb(v[0], static_cast<uint64_t>(d), carry);
+            else
+                v[0] = adc(v[0], static_cast<uint64_t>(-d), carry);
+            for (int j = 1; j < 5; ++j)
+                v[j] = (d > 0) ? sbb(v[j], 0, carry) : adc(v[j], 0, carry);
+        }
+        digits[i] = static_cast<int8_t>(d);
+        for (int j = 0; j < 4; ++j)
+            v[j] = (v[j] >> 1) | (v[j + 1] << 63);
+        v[4] >>= 1;
+    }
+}
+
+/// Returns the odd multiples 1a, 3a, ..., 15a.
+std::array<Point, table_size> make_table(const AffinePoint& a) noexcept
+{
+    std::array<Point, table_size> table;
+    table[0] = {a.x, a.y, fp_one};
+    const auto a2 = dbl(table[0]);
+    for (size_t i = 1; i < table.size(); ++i)
+        table[i] = add(table[i - 1], a2);
+    return table;
+}
+
+/// Returns the odd multiples 1a, 3a, ..., 15a as affine points.
+std::array<AffinePoint, table_size> make_affine_table(const AffinePoint& a) noexcept
+{
+    const auto table = make_table(a);
+    std::array<AffinePoint, table_size> affine_table;
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+        const auto z_inv = inv(table[i].z);
+        const auto z_inv2 = sqr(z_inv);
+        affine_table[i] = {table[i].x * z_inv2, table[i].y * z_inv2 * z_inv};
+    }
+    return affine_table;
+}
+
+/// Computes u1 G + u2 q, with the NAFs of both scalars sharing the doublings.
+Point mul_add(const Fn& u1, const AffinePoint& q, const Fn& u2) noexcept
+{
+    static const auto g_table = make_affine_table(generator);
+    const auto q_table = make_table(q);
+    int8_t d1[257];
+    int8_t d2[257];
+    wnaf(d1, u1);
+    wnaf(d2, u2);
+
+    Point r{};
+    for (int i = 256; i >= 0; --i)
+    {
+        r = dbl(r);
+        if (const auto d = d1[i]; d > 0)
+            r = add(r, g_table[d / 2]);
+        else if (d < 0)
+            r = add(r, AffinePoint{g_table[-d / 2].x, Fp{} - g_table[-d / 2].y});
+        if (const auto d = d2[i]; d > 0)
+            r = add(r, q_table[d / 2]);
+        else if (d < 0)
+            r = add(r, Point{q_table[-d / 2].x, Fp{} - q_table[-d / 2].y, q_table[-d / 2].z});
+    }
+    return r;
+}
+
+inline void store(uint8_t bytes[32], const Fp& a) noexcept
+{
+    const auto x = from_mont(a);
+    for (int i = 0; i < 32; ++i)
+        bytes[i] = static_cast<uint8_t>(x.v[3 - i / 8] >> (56 - (i % 8) * 8));
+}
+}  // namespace
+
+bool ecrecover(uint8_t address[20], const uint8_t hash[32], const uint8_t r[32],
+    const uint8_t s[32], bool y_parity) noexcept
+{
+    Fn r_n{};
+    Fn s_n{};
+    if (!load(r_n, r) || !load(s_n, s) || is_zero(r_n) || is_zero(s_n))
+        return false;
+
+    // The point R with the x coordinate r, which is below n and so below p, and the square root
+    // of x^3 + 7 of the given parity as the y coordinate.
+    const auto x = to_mont(Fp{{r_n.v[0], r_n.v[1], r_n.v[2], r_n.v[3]}});
+    const auto y_squared = sqr(x) * x + curve_b;
+    auto y = sqrt(y_squared);
+    if (!(sqr(y) == y_squared))
+        return false;
+    if ((from_mont(y).v[0] & 1) != static_cast<uint64_t>(y_parity))
+        y = Fp{} - y;
+
+    // Q = r^-1 (s R - z G) for the hash z reduced mod n. With r^-1 in Montgomery form, the
+    // products with the plain s and -z are plain.
+    constexpr uint64_t inv_exp[4] = {
+        0xbfd25e8cd036413f, 0xbaaedce6af48a03b, 0xfffffffffffffffe, 0xffffffffffffffff};
+    const auto r_inv = pow(to_mont(r_n), inv_exp, fn_one);
+    Fn z{};
+    if (!load(z, hash))
+        z = z - Fn{{order_n.m[0], order_n.m[1], order_n.m[2], order_n.m[3]}};
+    const auto u1 = (Fn{} - z) * r_inv;
+    const auto u2 = s_n * r_inv;
+
+    const auto q = mul_add(u1, {x, y}, u2);
+    if (is_zero(q.z))
+        return false;
+
+    const auto z_inv = inv(q.z);
+    const auto z_inv2 = sqr(z_inv);
+    uint8_t public_key[64];
+    store(&public_key[0], q.x * z_inv2);
+    store(&public_key[32], q.y * z_inv2 * z_inv);
+    const auto key_hash = ethash::keccak256(public_key, sizeof(public_key));
+    std::memcpy(address, &key_hash.bytes[12], 20);
+    return true;
+}
+}  // namespace evm::precompiles
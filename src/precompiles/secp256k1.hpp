@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace evm::precompiles
+{
+/// Recovers the address of the signer of the hash from the secp256k1 ECDSA signature (r, s)
+/// and the parity of the y coordinate of the point R. Returns false if the signature is invalid.
+/// The upper bound of s of EIP-2 is left to the caller.
+bool ecrecover(uint8_t address[20], const uint8_t hash[32], const uint8_t r[32],
+    const uint8_t s[32], bool y_parity) noexcept;
+}  // namespace evm::precompiles
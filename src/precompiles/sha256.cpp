@@ -0,0 +1,190 @@
+#include "sha256.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EVM_SHA_NI_SUPPORTED 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define EVM_SHA_NI_SUPPORTED 0
+#endif
+
+namespace evm::precompiles
+{
+namespace
+{
+alignas(16) constexpr uint32_t k[64] = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be,
+    0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
+    0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e,
+    0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624,
+    0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3,
+    0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint32_t initial_state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+using CompressFn = void (*)(uint32_t state[8], const uint8_t* blocks, size_t num_blocks);
+
+inline uint32_t rotr(uint32_t x, int n) noexcept
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t load_be32(const uint8_t* p) noexcept
+{
+    return uint32_t{p[0]} << 24 | uint32_t{p[1]} << 16 | uint32_t{p[2]} << 8 | uint32_t{p[3]};
+}
+
+void compress_generic(uint32_t state[8], const uint8_t* blocks, size_t num_blocks) noexcept
+{
+    for (; num_blocks != 0; --num_blocks, blocks += 64)
+    {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+            w[i] = load_be32(&blocks[i * 4]);
+        for (int i = 16; i < 64; ++i)
+        {
+            const auto s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const auto s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        auto a = state[0], b = state[1], c = state[2], d = state[3];
+        auto e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i)
+        {
+            const auto s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            const auto t1 = h + s1 + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            const auto s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            const auto t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#if EVM_SHA_NI_SUPPORTED
+__attribute__((target("sha,sse4.1"))) void compress_sha_ni(
+    uint32_t state[8], const uint8_t* blocks, size_t num_blocks) noexcept
+{
+    const auto byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0b, 0x0405060700010203);
+
+    // The SHA instructions take the state as the ABEF and CDGH halves.
+    const auto dcba =
+        _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&state[0])), 0xb1);
+    const auto efgh =
+        _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(&state[4])), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (; num_blocks != 0; --num_blocks, blocks += 64)
+    {
+        const auto abef_saved = abef;
+        const auto cdgh_saved = cdgh;
+
+        __m128i w[4];
+        for (int i = 0; i < 16; ++i)
+        {
+            auto& wi = w[i & 3];
+            if (i < 4)
+            {
+                wi = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blocks[i * 16])), byte_swap);
+            }
+            else
+            {
+                const auto w9 = _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4);
+                wi = _mm_sha256msg2_epu32(
+                    _mm_add_epi32(_mm_sha256msg1_epu32(wi, w[(i + 1) & 3]), w9), w[(i + 3) & 3]);
+            }
+            const auto msg =
+                _mm_add_epi32(wi, _mm_load_si128(reinterpret_cast<const __m128i*>(&k[i * 4])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0e));
+        }
+
+        abef = _mm_add_epi32(abef, abef_saved);
+        cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+bool has_sha_ni() noexcept
+{
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 || (ecx & bit_SSE4_1) == 0)
+        return false;
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0 && (ebx & bit_SHA) != 0;
+}
+#endif
+
+CompressFn select_compress(bool sha_ni) noexcept
+{
+#if EVM_SHA_NI_SUPPORTED
+    if (sha_ni && has_sha_ni())
+        return compress_sha_ni;
+#endif
+    (void)sha_ni;
+    return compress_generic;
+}
+
+CompressFn compress = select_compress(true);
+}  // namespace
+
+bool sha256_use_sha_ni(bool sha_ni) noexcept
+{
+    compress = select_compress(sha_ni);
+    return compress != compress_generic;
+}
+
+void sha256(uint8_t hash[32], const uint8_t* data, size_t size) noexcept
+{
+    uint32_t state[8];
+    std::memcpy(state, initial_state, sizeof(state));
+
+    const auto num_blocks = size / 64;
+    compress(state, data, num_blocks);
+
+    // The padding: 0x80, zeros and the 64-bit length in bits, in one or two blocks.
+    const auto tail_size = size % 64;
+    uint8_t tail[128]{};
+    if (tail_size != 0)
+        std::memcpy(tail, &data[num_blocks * 64], tail_size);
+    tail[tail_size] = 0x80;
+    const auto tail_blocks = (tail_size < 56) ? size_t{1} : size_t{2};
+    const auto bit_size = uint64_t{size} * 8;
+    for (int i = 0; i < 8; ++i)
+        tail[tail_blocks * 64 - 1 - i] = static_cast<uint8_t>(bit_size >> (i * 8));
+    compress(state, tail, tail_blocks);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        hash[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        hash[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        hash[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        hash[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+}
+}  // namespace evm::precompiles
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace evm::precompiles
+{
+/// Computes the SHA-256 hash of the data. Uses the SHA extensions of x86 CPUs if available.
+void sha256(uint8_t hash[32], const uint8_t* data, size_t size) noexcept;
+
+/// Selects the SHA extensions, if available, or the portable implementation, for testing.
+/// Returns true if the SHA extensions are used. Must not be called concurrently with sha256().
+bool sha256_use_sha_ni(bool sha_ni) noexcept;
+}  // namespace evm::precompiles
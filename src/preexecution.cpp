@@ -0,0 +1,159 @@
+#include "preexecution.hpp"
+#include "storage_journal.hpp"
+#include "vm.hpp"
+
+namespace evm
+{
+bool AccessRecorder::record_account(const evmc::address& addr) noexcept
+{
+    if (m_accounts_set.contains(addr))
+        return true;
+    if (full())
+        return false;
+    m_accounts_set.insert(addr);
+    m_accounts.push_back(addr);
+    return true;
+}
+
+bool AccessRecorder::record_storage(const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    const auto storage_key = StorageKey{addr, key};
+    if (m_storage_keys_set.contains(storage_key))
+        return true;
+    if (full())
+        return false;
+    m_storage_keys_set.insert(storage_key);
+    m_storage_keys.push_back(storage_key);
+    return true;
+}
+
+void AccessRecorder::clear() noexcept
+{
+    m_accounts_set.clear();
+    m_storage_keys_set.clear();
+    m_accounts.clear();
+    m_storage_keys.clear();
+    m_writes.clear();
+}
+
+bool RecordingHost::account_exists(const evmc::address& addr) const noexcept
+{
+    return m_recorder.record_account(addr) && m_host.account_exists(addr);
+}
+
+evmc::bytes32 RecordingHost::get_storage(
+    const evmc::address& addr, const evmc::bytes32& key) const noexcept
+{
+    if (const auto it = m_recorder.m_writes.find({addr, key}); it != m_recorder.m_writes.end())
+        return it->second.current;
+    return m_recorder.record_storage(addr, key) ? m_host.get_storage(addr, key) : evmc::bytes32{};
+}
+
+evmc_storage_status RecordingHost::set_storage(
+    const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) noexcept
+{
+    auto it = m_recorder.m_writes.find({addr, key});
+    if (it == m_recorder.m_writes.end())
+    {
+        const auto original = get_storage(addr, key);
+        const auto value_pair = AccessRecorder::StorageValue{original, original};
+        it = m_recorder.m_writes.try_emplace(StorageKey{addr, key}, value_pair).first;
+    }
+    auto& v = it->second;
+    const auto status = get_storage_status(v.original, v.current, value);
+    v.current = value;
+    return status;
+}
+
+evmc::uint256be RecordingHost::get_balance(const evmc::address& addr) const noexcept
+{
+    return m_recorder.record_account(addr) ? m_host.get_balance(addr) : evmc::uint256be{};
+}
+
+size_t RecordingHost::get_code_size(const evmc::address& addr) const noexcept
+{
+    return m_recorder.record_account(addr) ? m_host.get_code_size(addr) : 0;
+}
+
+evmc::bytes32 RecordingHost::get_code_hash(const evmc::address& addr) const noexcept
+{
+    return m_recorder.record_account(addr) ? m_host.get_code_hash(addr) : evmc::bytes32{};
+}
+
+size_t RecordingHost::copy_code(const evmc::address& addr, size_t code_offset,
+    uint8_t* buffer_data, size_t buffer_size) const noexcept
+{
+    if (!m_recorder.record_account(addr))
+        return 0;
+    return m_host.copy_code(addr, code_offset, buffer_data, buffer_size);
+}
+
+bool RecordingHost::selfdestruct(
+    const evmc::address& /*addr*/, const evmc::address& beneficiary) noexcept
+{
+    m_recorder.record_account(beneficiary);
+    return false;
+}
+
+evmc::Result RecordingHost::call(const evmc_message& msg) noexcept
+{
+    // The address of a new account depends on the sender nonce, which is not tracked.
+    if (msg.kind == EVMC_CREATE || msg.kind == EVMC_CREATE2)
+        return evmc::Result{EVMC_REVERT, msg.gas, 0, nullptr, 0};
+
+    if (!m_recorder.record_account(msg.code_address))
+        return evmc::Result{EVMC_REJECTED, 0, 0, nullptr, 0};
+
+    std::vector<uint8_t> code(m_host.get_code_size(msg.code_address));
+    code.resize(m_host.copy_code(msg.code_address, 0, code.data(), code.size()));
+    return evmc::Result{
+        m_execute(m_vm, &get_interface(), to_context(), m_rev, &msg, code.data(), code.size())};
+}
+
+evmc_tx_context RecordingHost::get_tx_context() const noexcept
+{
+    return m_host.get_tx_context();
+}
+
+evmc::bytes32 RecordingHost::get_block_hash(int64_t block_number) const noexcept
+{
+    return m_host.get_block_hash(block_number);
+}
+
+void RecordingHost::emit_log(const evmc::address& /*addr*/, const uint8_t* /*data*/,
+    size_t /*data_size*/, const evmc::bytes32 /*topics*/[], size_t /*num_topics*/) noexcept
+{}
+
+evmc_access_status RecordingHost::access_account(const evmc::address& addr) noexcept
+{
+    if (m_recorder.m_accounts_set.contains(addr))
+        return EVMC_ACCESS_WARM;
+    m_recorder.record_account(addr);
+    return EVMC_ACCESS_COLD;
+}
+
+evmc_access_status RecordingHost::access_storage(
+    const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    if (m_recorder.m_storage_keys_set.contains({addr, key}))
+        return EVMC_ACCESS_WARM;
+    m_recorder.record_storage(addr, key);
+    return EVMC_ACCESS_COLD;
+}
+
+evmc_result preexecute(evmc_vm* c_vm, const evmc_host_interface* host, evmc_host_context* ctx,
+    evmc_revision rev, const evmc_message* msg, const uint8_t* code, size_t code_size) noexcept
+{
+    auto& vm = *static_cast<VM*>(c_vm);
+    auto& recorder = *vm.get_access_recorder();
+    if (msg->depth == 0)
+        recorder.clear();
+
+    RecordingHost recording_host{*host, ctx, recorder, c_vm, vm.preexecution_target, rev};
+    auto result = vm.preexecution_target(c_vm, &evmc::Host::get_interface(),
+        recording_host.to_context(), rev, msg, code, code_size);
+    if (recorder.full())
+        result.status_code = EVMC_REJECTED;
+    return result;
+}
+}  // namespace evm
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "hash_set.hpp"
+#include <evmc/evmc.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace evm
+{
+/// Records the accounts and storage keys touched by a speculative pre-execution,
+/// in the order of first access, up to a limit.
+class AccessRecorder
+{
+    struct StorageValue
+    {
+        evmc::bytes32 original;
+        evmc::bytes32 current;
+    };
+
+    size_t m_limit;
+    FlatHashSet<evmc::address, AddressHash> m_accounts_set;
+    FlatHashSet<StorageKey, StorageKeyHash> m_storage_keys_set;
+    std::vector<evmc::address> m_accounts;
+    std::vector<StorageKey> m_storage_keys;
+
+    /// Storage writes of the pre-execution, never passed to the host.
+    std::unordered_map<StorageKey, StorageValue, StorageKeyHash> m_writes;
+
+    friend class RecordingHost;
+
+public:
+    explicit AccessRecorder(size_t limit) noexcept : m_limit{limit} {}
+
+    [[nodiscard]] bool full() const noexcept
+    {
+        return m_accounts.size() + m_storage_keys.size() >= m_limit;
+    }
+
+    [[nodiscard]] const std::vector<evmc::address>& accounts() const noexcept
+    {
+        return m_accounts;
+    }
+
+    [[nodiscard]] const std::vector<StorageKey>& storage_keys() const noexcept
+    {
+        return m_storage_keys;
+    }
+
+    /// Returns false if the account is new and the limit has been reached.
+    bool record_account(const evmc::address& addr) noexcept;
+
+    /// Returns false if the storage key is new and the limit has been reached.
+    bool record_storage(const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+    void clear() noexcept;
+};
+
+/// Host wrapper for pre-execution.
+///
+/// Records state accesses and forwards reads to the wrapped host until the recorder is full;
+/// afterwards new items read as empty and nested calls are rejected so the execution ends
+/// quickly without further I/O. Writes, logs and selfdestructs are not passed to the host.
+/// Nested calls are executed against the RecordingHost itself, without value transfers;
+/// creations are not executed and end as reverted.
+class RecordingHost : public evmc::Host
+{
+    evmc::HostContext m_host;
+    evmc_host_context* m_host_ctx;
+    AccessRecorder& m_recorder;
+    evmc_vm* m_vm;
+    evmc_execute_fn m_execute;
+    evmc_revision m_rev;
+
+public:
+    RecordingHost(const evmc_host_interface& host_interface, evmc_host_context* host_ctx,
+        AccessRecorder& recorder, evmc_vm* vm, evmc_execute_fn execute,
+        evmc_revision rev) noexcept
+      : m_host{host_interface, host_ctx},
+        m_host_ctx{host_ctx},
+        m_recorder{recorder},
+        m_vm{vm},
+        m_execute{execute},
+        m_rev{rev}
+    {}
+
+    /// Returns the context of the wrapped host given the context of a RecordingHost,
+    /// for the host extensions.
+    [[nodiscard]] static evmc_host_context* get_wrapped_context(evmc_host_context* ctx) noexcept
+    {
+        return static_cast<RecordingHost*>(reinterpret_cast<evmc::Host*>(ctx))->m_host_ctx;
+    }
+
+    bool account_exists(const evmc::address& addr) const noexcept override;
+    evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) const noexcept override;
+    evmc_storage_status set_storage(const evmc::address& addr, const evmc::bytes32& key,
+        const evmc::bytes32& value) noexcept override;
+    evmc::uint256be get_balance(const evmc::address& addr) const noexcept override;
+    size_t get_code_size(const evmc::address& addr) const noexcept override;
+    evmc::bytes32 get_code_hash(const evmc::address& addr) const noexcept override;
+    size_t copy_code(const evmc::address& addr, size_t code_offset, uint8_t* buffer_data,
+        size_t buffer_size) const noexcept override;
+    bool selfdestruct(
+        const evmc::address& addr, const evmc::address& beneficiary) noexcept override;
+    evmc::Result call(const evmc_message& msg) noexcept override;
+    evmc_tx_context get_tx_context() const noexcept override;
+    evmc::bytes32 get_block_hash(int64_t block_number) const noexcept override;
+    void emit_log(const evmc::address& addr, const uint8_t* data, size_t data_size,
+        const evmc::bytes32 topics[], size_t num_topics) noexcept override;
+    evmc_access_status access_account(const evmc::address& addr) noexcept override;
+    evmc_access_status access_storage(
+        const evmc::address& addr, const evmc::bytes32& key) noexcept override;
+};
+
+/// The evmc execute function used in pre-execution mode. Wraps the host in RecordingHost
+/// and runs the configured interpreter. Returns EVMC_REJECTED if the recorder is full.
+evmc_result preexecute(evmc_vm* vm, const evmc_host_interface* host, evmc_host_context* ctx,
+    evmc_revision rev, const evmc_message* msg, const uint8_t* code, size_t code_size) noexcept;
+}  // namespace evm
@@ -0,0 +1,356 @@
+#include "block_executor.hpp"
+#include "scheduler.hpp"
+#include <thread>
+
+namespace evm::state
+{
+namespace
+{
+/// The account fields as written by a transaction.
+struct AccountValue
+{
+    bool exists = false;
+    uint64_t nonce = 0;
+    intx::uint256 balance;
+    std::shared_ptr<const bytes> code;
+    evmc::bytes32 code_hash = empty_code_hash;
+
+    /// The index + 1 of the latest transaction, up to the writer, removing the account.
+    /// Its storage written before, or in the base state, is gone.
+    uint32_t storage_epoch = 0;
+};
+
+struct MultiVersionMemory
+{
+    VersionedMap<evmc::address, AccountValue, AddressHash> accounts;
+    VersionedMap<StorageKey, evmc::bytes32, StorageKeyHash> slots;
+};
+
+struct ReadSet
+{
+    std::vector<std::pair<evmc::address, Version>> accounts;
+    std::vector<std::pair<StorageKey, Version>> slots;
+};
+
+struct WriteSet
+{
+    std::vector<evmc::address> accounts;
+    std::vector<StorageKey> slots;
+};
+
+/// The results of the latest incarnation of a transaction.
+struct TxResults
+{
+    std::mutex mutex;
+    std::shared_ptr<const ReadSet> reads;
+    WriteSet writes;
+    TransactionReceipt receipt;
+};
+
+/// The view of the state by an incarnation: the latest writes of the lower transactions
+/// over the base state. Records the versions read. Reading an estimate stops the reads:
+/// the incarnation is then discarded and re-executed after the blocking transaction.
+class VersionedView : public StateView
+{
+    MultiVersionMemory& m_memory;
+    const State& m_base;
+    const uint32_t m_tx_index;
+    FlatHashMap<evmc::address, uint32_t, AddressHash> m_storage_epochs;
+
+public:
+    ReadSet reads;
+    std::optional<uint32_t> blocking_tx_index;
+
+    VersionedView(MultiVersionMemory& memory, const State& base, uint32_t tx_index) noexcept
+      : m_memory{memory}, m_base{base}, m_tx_index{tx_index}
+    {}
+
+    [[nodiscard]] uint32_t storage_epoch(const evmc::address& addr) const noexcept
+    {
+        const auto* epoch = m_storage_epochs.find(addr);
+        return epoch != nullptr ? *epoch : 0;
+    }
+
+    std::optional<Account> get_account(const evmc::address& addr) noexcept override
+    {
+        if (blocking_tx_index.has_value())
+            return std::nullopt;
+        const auto r = m_memory.accounts.read(addr, m_tx_index);
+        using Status = decltype(r.status);
+        if (r.status == Status::estimate)
+        {
+            blocking_tx_index = r.version.tx_index;
+            return std::nullopt;
+        }
+        reads.accounts.emplace_back(addr, r.version);
+
+        Account account;
+        if (r.status == Status::base)
+        {
+            const auto* a = m_base.find(addr);
+            if (a == nullptr)
+                return std::nullopt;
+            account.nonce = a->nonce;
+            account.balance = a->balance;
+            account.code = a->code;
+            account.code_hash = a->code_hash;
+            return account;
+        }
+
+        m_storage_epochs.try_emplace(addr).first = r.value.storage_epoch;
+        if (!r.value.exists)
+            return std::nullopt;
+        account.nonce = r.value.nonce;
+        account.balance = r.value.balance;
+        account.code = r.value.code;
+        account.code_hash = r.value.code_hash;
+        return account;
+    }
+
+    evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) noexcept override
+    {
+        if (blocking_tx_index.has_value())
+            return {};
+        const auto r = m_memory.slots.read({addr, key}, m_tx_index);
+        using Status = decltype(r.status);
+        if (r.status == Status::estimate)
+        {
+            blocking_tx_index = r.version.tx_index;
+            return {};
+        }
+        reads.slots.emplace_back(StorageKey{addr, key}, r.version);
+
+        if (const auto epoch = storage_epoch(addr);
+            epoch != 0 && (r.status == Status::base || epoch - 1 > r.version.tx_index))
+            return {};
+        if (r.status == Status::value)
+            return r.value;
+        const auto* account = m_base.find(addr);
+        const auto* value = account != nullptr ? account->storage.find(key) : nullptr;
+        return value != nullptr ? value->current : evmc::bytes32{};
+    }
+};
+
+class BlockExecutor
+{
+    const State& m_base;
+    evmc_revision m_rev;
+    const evmc_tx_context& m_tx_context;
+    const std::vector<Transaction>& m_txs;
+    MultiVersionMemory m_memory;
+    Scheduler m_scheduler;
+    std::unique_ptr<TxResults[]> m_results;
+
+    /// Stores the writes of the incarnation, removing those of the previous one.
+    /// Returns true if a location not written by the previous incarnation is written.
+    bool record(Version version, const State& state, const VersionedView& view) noexcept;
+
+    Task try_execute(evmc_vm* vm, Version version) noexcept;
+
+    Task validate(Version version) noexcept;
+
+public:
+    BlockExecutor(const State& base, evmc_revision rev, const evmc_tx_context& tx_context,
+        const std::vector<Transaction>& txs) noexcept
+      : m_base{base},
+        m_rev{rev},
+        m_tx_context{tx_context},
+        m_txs{txs},
+        m_scheduler{static_cast<uint32_t>(txs.size())},
+        m_results{std::make_unique<TxResults[]>(txs.size())}
+    {}
+
+    void run(evmc_vm* vm) noexcept;
+
+    /// Applies the writes to the base state in transaction order and returns the receipts.
+    std::vector<TransactionReceipt> commit(State& state) noexcept;
+};
+
+bool BlockExecutor::record(Version version, const State& state, const VersionedView& view) noexcept
+{
+    const auto tx_index = version.tx_index;
+    FlatHashMap<evmc::address, AccountValue, AddressHash> accounts;
+    FlatHashMap<StorageKey, evmc::bytes32, StorageKeyHash> slots;
+    state.for_each_modified(
+        [&](const evmc::address& addr, const Account& account) {
+            auto& value = accounts.try_emplace(addr).first;
+            if (account.destructed)
+                value = {false, 0, 0, nullptr, empty_code_hash, tx_index + 1};
+            else
+            {
+                value = {true, account.nonce, account.balance, account.code, account.code_hash,
+                    view.storage_epoch(addr)};
+            }
+        },
+        [&](const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) {
+            slots.try_emplace({addr, key}).first = value;
+        });
+
+    WriteSet writes;
+    accounts.for_each([&](const evmc::address& addr, const AccountValue& value) {
+        writes.accounts.push_back(addr);
+        m_memory.accounts.write(addr, version, value);
+    });
+    slots.for_each([&](const StorageKey& slot, const evmc::bytes32& value) {
+        // The storage of a removed account is dropped with it.
+        if (const auto* account = accounts.find(slot.addr); account != nullptr && !account->exists)
+            return;
+        writes.slots.push_back(slot);
+        m_memory.slots.write(slot, version, value);
+    });
+
+    auto& results = m_results[tx_index];
+    const std::lock_guard lock{results.mutex};
+    FlatHashSet<evmc::address, AddressHash> prev_accounts;
+    FlatHashSet<StorageKey, StorageKeyHash> prev_slots;
+    for (const auto& addr : results.writes.accounts)
+    {
+        prev_accounts.insert(addr);
+        if (accounts.find(addr) == nullptr)
+            m_memory.accounts.erase(addr, tx_index);
+    }
+    for (const auto& slot : results.writes.slots)
+    {
+        prev_slots.insert(slot);
+        if (slots.find(slot) == nullptr)
+            m_memory.slots.erase(slot, tx_index);
+    }
+    auto wrote_new_location = false;
+    for (const auto& addr : writes.accounts)
+        wrote_new_location = wrote_new_location || !prev_accounts.contains(addr);
+    for (const auto& slot : writes.slots)
+        wrote_new_location = wrote_new_location || !prev_slots.contains(slot);
+    results.writes = std::move(writes);
+    return wrote_new_location;
+}
+
+Task BlockExecutor::try_execute(evmc_vm* vm, Version version) noexcept
+{
+    const auto tx_index = version.tx_index;
+    VersionedView view{m_memory, m_base, tx_index};
+    State state{view};
+    auto receipt = transition(vm, state, m_rev, m_tx_context, m_txs[tx_index]);
+
+    if (view.blocking_tx_index.has_value())
+    {
+        if (m_scheduler.add_dependency(tx_index, *view.blocking_tx_index))
+            return {};
+        return {Task::Kind::execution, version};
+    }
+
+    const auto wrote_new_location = record(version, state, view);
+    {
+        auto& results = m_results[tx_index];
+        const std::lock_guard lock{results.mutex};
+        results.reads = std::make_shared<const ReadSet>(std::move(view.reads));
+        results.receipt = std::move(receipt);
+    }
+    return m_scheduler.finish_execution(version, wrote_new_location);
+}
+
+Task BlockExecutor::validate(Version version) noexcept
+{
+    const auto tx_index = version.tx_index;
+    auto& results = m_results[tx_index];
+    std::shared_ptr<const ReadSet> reads;
+    {
+        const std::lock_guard lock{results.mutex};
+        reads = results.reads;
+    }
+
+    // A read is still valid if the same version would be read.
+    const auto is_current = [](const auto& r, const Version& read_version) noexcept {
+        using Status = decltype(r.status);
+        return r.status != Status::estimate && r.version == read_version;
+    };
+    auto valid = true;
+    for (const auto& [addr, read_version] : reads->accounts)
+        valid = valid && is_current(m_memory.accounts.read(addr, tx_index), read_version);
+    for (const auto& [slot, read_version] : reads->slots)
+        valid = valid && is_current(m_memory.slots.read(slot, tx_index), read_version);
+
+    const auto aborted = !valid && m_scheduler.try_validation_abort(version);
+    if (aborted)
+    {
+        const std::lock_guard lock{results.mutex};
+        for (const auto& addr : results.writes.accounts)
+            m_memory.accounts.mark_estimate(addr, tx_index);
+        for (const auto& slot : results.writes.slots)
+            m_memory.slots.mark_estimate(slot, tx_index);
+    }
+    return m_scheduler.finish_validation(tx_index, aborted);
+}
+
+void BlockExecutor::run(evmc_vm* vm) noexcept
+{
+    Task task;
+    while (!m_scheduler.done())
+    {
+        if (task.kind == Task::Kind::execution)
+            task = try_execute(vm, task.version);
+        else if (task.kind == Task::Kind::validation)
+            task = validate(task.version);
+        else
+        {
+            task = m_scheduler.next_task();
+            if (task.kind == Task::Kind::none)
+                std::this_thread::yield();
+        }
+    }
+}
+
+std::vector<TransactionReceipt> BlockExecutor::commit(State& state) noexcept
+{
+    std::vector<TransactionReceipt> receipts;
+    receipts.reserve(m_txs.size());
+    for (uint32_t i = 0; i < m_txs.size(); ++i)
+    {
+        auto& results = m_results[i];
+        for (const auto& addr : results.writes.accounts)
+        {
+            const auto value = m_memory.accounts.get(addr, i);
+            if (!value.exists)
+            {
+                state.erase(addr);
+                continue;
+            }
+            auto* account = state.find(addr);
+            if (account == nullptr)
+                account = &state.insert(addr, {});
+            account->nonce = value.nonce;
+            account->balance = value.balance;
+            account->code = value.code;
+            account->code_hash = value.code_hash;
+        }
+        for (const auto& slot : results.writes.slots)
+        {
+            const auto value = m_memory.slots.get(slot, i);
+            if (auto* account = state.find(slot.addr); account != nullptr)
+                account->storage.try_emplace(slot.key).first = {value, value};
+        }
+        receipts.push_back(std::move(results.receipt));
+    }
+    return receipts;
+}
+}  // namespace
+
+std::vector<TransactionReceipt> execute_block(const std::vector<evmc_vm*>& vms, State& state,
+    evmc_revision rev, const evmc_tx_context& tx_context,
+    const std::vector<Transaction>& txs) noexcept
+{
+    assert(!vms.empty());
+    if (txs.empty())
+        return {};
+
+    BlockExecutor executor{state, rev, tx_context, txs};
+    std::vector<std::thread> workers;
+    workers.reserve(vms.size() - 1);
+    for (size_t i = 1; i < vms.size(); ++i)
+        workers.emplace_back([&executor, vm = vms[i]] { executor.run(vm); });
+    executor.run(vms[0]);
+    for (auto& worker : workers)
+        worker.join();
+    return executor.commit(state);
+}
+}  // namespace evm::state
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "transaction.hpp"
+#include <vector>
+
+namespace evm::state
+{
+/// Executes the transactions of a block in parallel and commits them to the state.
+///
+/// Transactions are executed optimistically (Block-STM): each incarnation runs against a
+/// multi-version store of the writes of the lower transactions, records the versions it reads
+/// and is validated, and re-executed, until no read is stale. The results, receipts and state,
+/// are identical to executing the transactions in order with execute_transaction().
+///
+/// Runs one worker per VM, the calling thread being the first one. The VMs must be distinct
+/// instances as they keep transaction-scoped state. The state must have no uncommitted changes.
+std::vector<TransactionReceipt> execute_block(const std::vector<evmc_vm*>& vms, State& state,
+    evmc_revision rev, const evmc_tx_context& tx_context,
+    const std::vector<Transaction>& txs) noexcept;
+}  // namespace evm::state
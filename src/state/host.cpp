@@ -0,0 +1,425 @@
+#include "host.hpp"
+#include "../precompiles/precompiles.hpp"
+#include <ethash/keccak.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace evm::state
+{
+namespace
+{
+constexpr auto max_code_size = 0x6000;
+constexpr auto code_deposit_cost = 200;
+
+evmc::address hash_to_address(const ethash::hash256& hash) noexcept
+{
+    evmc::address addr;
+    std::memcpy(addr.bytes, &hash.bytes[sizeof(hash) - sizeof(addr)], sizeof(addr));
+    return addr;
+}
+
+/// Checks if the address is of a precompiled contract, warm since Berlin.
+bool is_precompile(evmc_revision rev, const evmc::address& addr) noexcept
+{
+    const auto num_precompiles = rev >= EVMC_CANCUN ? 0x0a : 0x09;
+    if (!std::all_of(addr.bytes, &addr.bytes[sizeof(addr) - 1], [](uint8_t b) { return b == 0; }))
+        return false;
+    const auto id = addr.bytes[sizeof(addr) - 1];
+    return id != 0 && id <= num_precompiles;
+}
+
+/// Converts the evm_word, the least significant 64-bit word first, to big-endian bytes.
+evmc::bytes32 to_bytes32(const evm_word& word) noexcept
+{
+    evmc::bytes32 b;
+    for (size_t i = 0; i < sizeof(b); ++i)
+        b.bytes[sizeof(b) - 1 - i] = static_cast<uint8_t>(word.words[i / 8] >> (i % 8 * 8));
+    return b;
+}
+
+evm_word to_word(const evmc::bytes32& b) noexcept
+{
+    evm_word word{};
+    for (size_t i = 0; i < sizeof(b); ++i)
+        word.words[i / 8] |= uint64_t{b.bytes[sizeof(b) - 1 - i]} << (i % 8 * 8);
+    return word;
+}
+
+Host& to_host(evmc_host_context* ctx) noexcept
+{
+    return static_cast<Host&>(*reinterpret_cast<evmc::Host*>(ctx));
+}
+}  // namespace
+
+const evm_host_extensions Host::extensions = []() noexcept {
+    evm_host_extensions ext{};
+    ext.get_original_storage = [](evmc_host_context* ctx, const evmc_address* addr,
+                                   const evmc_bytes32* key) noexcept -> evmc_bytes32 {
+        return to_host(ctx).get_original_storage(*addr, *key);
+    };
+    ext.enter_call = [](evmc_host_context* ctx, evmc_message* msg, int32_t* snapshot,
+                         const uint8_t** code, size_t* code_size) noexcept {
+        bytes_view c;
+        if (!to_host(ctx).enter_call(*msg, *snapshot, c))
+            return false;
+        *code = c.data();
+        *code_size = c.size();
+        return true;
+    };
+    ext.leave_call = [](evmc_host_context* ctx, int32_t snapshot, evmc_result* result) noexcept {
+        to_host(ctx).leave_call(snapshot, *result);
+    };
+    ext.get_storage_word = [](evmc_host_context* ctx, const evmc_address* addr,
+                               const evm_word* key) noexcept {
+        return to_word(to_host(ctx).get_storage(*addr, to_bytes32(*key)));
+    };
+    ext.set_storage_word = [](evmc_host_context* ctx, const evmc_address* addr,
+                               const evm_word* key, const evm_word* value) noexcept {
+        return to_host(ctx).set_storage(*addr, to_bytes32(*key), to_bytes32(*value));
+    };
+    ext.get_balance_word = [](evmc_host_context* ctx, const evmc_address* addr) noexcept {
+        return to_word(to_host(ctx).get_balance(*addr));
+    };
+    ext.emit_log_words = [](evmc_host_context* ctx, const evmc_address* addr,
+                             const uint8_t* data, size_t data_size, const evm_word topics[],
+                             size_t num_topics) noexcept {
+        std::array<evmc::bytes32, 4> topic_bytes;
+        for (size_t i = 0; i < num_topics; ++i)
+            topic_bytes[i] = to_bytes32(topics[i]);
+        to_host(ctx).emit_log(*addr, data, data_size, topic_bytes.data(), num_topics);
+    };
+    ext.emit_logs = [](evmc_host_context* ctx, const evm_log* logs, size_t num_logs) noexcept {
+        auto& host = to_host(ctx);
+        for (size_t i = 0; i < num_logs; ++i)
+        {
+            const auto& log = logs[i];
+            host.emit_log(log.address, log.data, log.data_size,
+                static_cast<const evmc::bytes32*>(log.topics), log.num_topics);
+        }
+    };
+    return ext;
+}();
+
+evmc::address compute_create_address(const evmc::address& sender, uint64_t sender_nonce) noexcept
+{
+    // RLP list of the 20-byte sender address and the nonce.
+    uint8_t buffer[1 + 1 + sizeof(sender) + 1 + sizeof(sender_nonce)];
+    auto p = &buffer[1];
+    *p++ = 0x80 + sizeof(sender);
+    p = std::copy_n(sender.bytes, sizeof(sender), p);
+    if (sender_nonce == 0)
+        *p++ = 0x80;
+    else if (sender_nonce < 0x80)
+        *p++ = static_cast<uint8_t>(sender_nonce);
+    else
+    {
+        const auto num_bytes =
+            sizeof(sender_nonce) - static_cast<size_t>(intx::clz(sender_nonce)) / 8;
+        *p++ = static_cast<uint8_t>(0x80 + num_bytes);
+        for (auto i = num_bytes; i > 0; --i)
+            *p++ = static_cast<uint8_t>(sender_nonce >> ((i - 1) * 8));
+    }
+    const auto list_size = static_cast<size_t>(p - &buffer[1]);
+    buffer[0] = static_cast<uint8_t>(0xc0 + list_size);
+    return hash_to_address(ethash::keccak256(buffer, list_size + 1));
+}
+
+evmc::address compute_create2_address(
+    const evmc::address& sender, const evmc::bytes32& salt, bytes_view init_code) noexcept
+{
+    const auto init_code_hash = ethash::keccak256(init_code.data(), init_code.size());
+    uint8_t buffer[1 + sizeof(sender) + sizeof(salt) + sizeof(init_code_hash)];
+    buffer[0] = 0xff;
+    auto p = std::copy_n(sender.bytes, sizeof(sender), &buffer[1]);
+    p = std::copy_n(salt.bytes, sizeof(salt), p);
+    std::copy_n(init_code_hash.bytes, sizeof(init_code_hash), p);
+    return hash_to_address(ethash::keccak256(buffer, sizeof(buffer)));
+}
+
+bool Host::account_exists(const evmc::address& addr) const noexcept
+{
+    const auto* account = m_state.find(addr);
+    return account != nullptr && (m_rev < EVMC_SPURIOUS_DRAGON || !account->is_empty());
+}
+
+evmc::bytes32 Host::get_storage(
+    const evmc::address& addr, const evmc::bytes32& key) const noexcept
+{
+    return m_state.get_storage(addr, key);
+}
+
+evmc_storage_status Host::set_storage(
+    const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) noexcept
+{
+    return m_state.set_storage(addr, key, value);
+}
+
+evmc::bytes32 Host::get_original_storage(
+    const evmc::address& addr, const evmc::bytes32& key) const noexcept
+{
+    return m_state.get_original_storage(addr, key);
+}
+
+evmc::uint256be Host::get_balance(const evmc::address& addr) const noexcept
+{
+    const auto* account = m_state.find(addr);
+    return account != nullptr ? intx::be::store<evmc::uint256be>(account->balance) :
+                                evmc::uint256be{};
+}
+
+size_t Host::get_code_size(const evmc::address& addr) const noexcept
+{
+    const auto* account = m_state.find(addr);
+    return account != nullptr ? account->get_code().size() : 0;
+}
+
+evmc::bytes32 Host::get_code_hash(const evmc::address& addr) const noexcept
+{
+    const auto* account = m_state.find(addr);
+    return (account != nullptr && !account->is_empty()) ? account->code_hash : evmc::bytes32{};
+}
+
+size_t Host::copy_code(const evmc::address& addr, size_t code_offset, uint8_t* buffer_data,
+    size_t buffer_size) const noexcept
+{
+    const auto* account = m_state.find(addr);
+    const auto code = account != nullptr ? account->get_code() : bytes_view{};
+    if (code_offset >= code.size())
+        return 0;
+    const auto n = std::min(buffer_size, code.size() - code_offset);
+    std::copy_n(&code[code_offset], n, buffer_data);
+    return n;
+}
+
+bool Host::selfdestruct(const evmc::address& addr, const evmc::address& beneficiary) noexcept
+{
+    const auto* account = m_state.find(addr);
+    if (account == nullptr)
+        return false;
+    const auto balance = account->balance;
+
+    // Since Cancun (EIP-6780) only accounts created in the same transaction are removed.
+    const auto removed = m_rev < EVMC_CANCUN || account->created;
+    if (beneficiary != addr)
+    {
+        m_state.set_balance(beneficiary, m_state.touch(beneficiary).balance + balance);
+        m_state.set_balance(addr, 0);
+    }
+    else if (removed)
+        m_state.set_balance(addr, 0);
+
+    return removed && m_state.destruct(addr);
+}
+
+evmc::Result Host::call(const evmc_message& msg) noexcept
+{
+    if (msg.kind == EVMC_CREATE || msg.kind == EVMC_CREATE2)
+        return execute_create(msg);
+
+    const auto checkpoint = m_state.checkpoint();
+    auto result = execute_call(msg);
+    if (result.status_code != EVMC_SUCCESS)
+        m_state.rollback(checkpoint);
+    return result;
+}
+
+evmc_tx_context Host::get_tx_context() const noexcept
+{
+    return m_tx_context;
+}
+
+evmc::bytes32 Host::get_block_hash(int64_t block_number) const noexcept
+{
+    const auto it = block_hashes.find(block_number);
+    return it != block_hashes.end() ? it->second : evmc::bytes32{};
+}
+
+void Host::emit_log(const evmc::address& addr, const uint8_t* data, size_t data_size,
+    const evmc::bytes32 topics[], size_t num_topics) noexcept
+{
+    m_state.emit_log(addr, data, data_size, topics, num_topics);
+}
+
+evmc_access_status Host::access_account(const evmc::address& addr) noexcept
+{
+    if (m_rev >= EVMC_BERLIN && is_precompile(m_rev, addr))
+        return EVMC_ACCESS_WARM;
+    return m_state.access_account(addr);
+}
+
+evmc_access_status Host::access_storage(
+    const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    return m_state.access_storage(addr, key);
+}
+
+bool Host::transfer(
+    const evmc::address& from, const evmc::address& to, const intx::uint256& value) noexcept
+{
+    const auto* sender = m_state.find(from);
+    if (sender == nullptr || sender->balance < value)
+        return false;
+    const auto sender_balance = sender->balance;
+    m_state.set_balance(from, sender_balance - value);
+    m_state.set_balance(to, m_state.touch(to).balance + value);
+    return true;
+}
+
+evmc::Result Host::execute_call(const evmc_message& msg) noexcept
+{
+    if (const auto value = intx::be::load<intx::uint256>(msg.value);
+        msg.kind == EVMC_CALL && value != 0 && !transfer(msg.sender, msg.recipient, value))
+        return evmc::Result{EVMC_INSUFFICIENT_BALANCE, msg.gas, 0, nullptr, 0};
+
+    bytes output;
+    if (const auto result = precompiles::execute(
+            m_rev, msg.code_address, {msg.input_data, msg.input_size}, msg.gas, output);
+        result.has_value())
+        return evmc::Result{result->status_code, result->gas_left, 0, output.data(), output.size()};
+
+    const auto* account = m_state.find(msg.code_address);
+    if (account == nullptr || account->code == nullptr)
+        return evmc::Result{EVMC_SUCCESS, msg.gas, 0, nullptr, 0};
+
+    // Keep the code alive even if the account is removed during the execution.
+    const auto code = account->code;
+    return evmc::Result{m_vm->execute(
+        m_vm, &get_interface(), to_context(), m_rev, &msg, code->data(), code->size())};
+}
+
+evmc::Result Host::execute_create(const evmc_message& msg) noexcept
+{
+    const auto addr = create_address(msg);
+    if (!addr.has_value())
+        return evmc::Result{EVMC_FAILURE, msg.gas, 0, nullptr, 0};
+
+    // The sender nonce stays incremented even if the creation fails.
+    const auto checkpoint = m_state.checkpoint();
+    auto result = deploy(msg, *addr);
+    if (result.status_code != EVMC_SUCCESS)
+        m_state.rollback(checkpoint);
+    return result;
+}
+
+std::optional<evmc::address> Host::create_address(const evmc_message& msg) noexcept
+{
+    const auto* sender = m_state.find(msg.sender);
+    if (sender == nullptr || sender->nonce == std::numeric_limits<uint64_t>::max())
+        return std::nullopt;
+
+    const auto nonce = sender->nonce;
+    const auto init_code = bytes_view{msg.input_data, msg.input_size};
+    const auto addr = (msg.kind == EVMC_CREATE) ?
+                          compute_create_address(msg.sender, nonce) :
+                          compute_create2_address(msg.sender, msg.create2_salt, init_code);
+    m_state.set_nonce(msg.sender, nonce + 1);
+    m_state.access_account(addr);
+    return addr;
+}
+
+evmc_status_code Host::begin_deploy(const evmc_message& msg, const evmc::address& addr) noexcept
+{
+    if (const auto* existing = m_state.find(addr);
+        existing != nullptr && (existing->nonce != 0 || existing->code != nullptr))
+        return EVMC_FAILURE;
+
+    m_state.mark_created(addr);
+    if (m_rev >= EVMC_SPURIOUS_DRAGON)
+        m_state.set_nonce(addr, 1);
+    if (const auto value = intx::be::load<intx::uint256>(msg.value);
+        value != 0 && !transfer(msg.sender, addr, value))
+        return EVMC_INSUFFICIENT_BALANCE;
+    return EVMC_SUCCESS;
+}
+
+evmc::Result Host::deploy(const evmc_message& msg, const evmc::address& addr) noexcept
+{
+    if (const auto status = begin_deploy(msg, addr); status != EVMC_SUCCESS)
+    {
+        // A collision consumes all gas.
+        const auto gas_left = (status == EVMC_FAILURE) ? 0 : msg.gas;
+        return evmc::Result{status, gas_left, 0, nullptr, 0};
+    }
+
+    auto create_msg = msg;
+    create_msg.recipient = addr;
+    create_msg.input_data = nullptr;
+    create_msg.input_size = 0;
+    return deposit_code(addr, evmc::Result{m_vm->execute(m_vm, &get_interface(), to_context(),
+                                  m_rev, &create_msg, msg.input_data, msg.input_size)});
+}
+
+evmc::Result Host::deposit_code(const evmc::address& addr, evmc::Result result) noexcept
+{
+    if (result.status_code != EVMC_SUCCESS)
+        return result;
+
+    auto code = bytes_view{result.output_data, result.output_size};
+    if (m_rev >= EVMC_SPURIOUS_DRAGON && code.size() > max_code_size)
+        return evmc::Result{EVMC_FAILURE, 0, 0, nullptr, 0};
+    if (m_rev >= EVMC_LONDON && !code.empty() && code[0] == 0xef)
+        return evmc::Result{EVMC_CONTRACT_VALIDATION_FAILURE, 0, 0, nullptr, 0};
+
+    auto gas_left = result.gas_left - static_cast<int64_t>(code.size()) * code_deposit_cost;
+    if (gas_left < 0)
+    {
+        if (m_rev >= EVMC_HOMESTEAD)
+            return evmc::Result{EVMC_OUT_OF_GAS, 0, 0, nullptr, 0};
+        gas_left = result.gas_left;
+        code = {};
+    }
+    m_state.set_code(addr, code);
+    return evmc::Result{EVMC_SUCCESS, gas_left, result.gas_refund, addr};
+}
+
+bool Host::enter_call(evmc_message& msg, int32_t& snapshot, bytes_view& code) noexcept
+{
+    // Messages failing in the prologue are left to call(), reverted to this checkpoint.
+    const auto checkpoint = m_state.checkpoint();
+    if (msg.kind == EVMC_CREATE || msg.kind == EVMC_CREATE2)
+    {
+        const auto addr = create_address(msg);
+        if (!addr.has_value())
+            return false;
+        const auto create_checkpoint = m_state.checkpoint();
+        if (begin_deploy(msg, *addr) != EVMC_SUCCESS)
+        {
+            m_state.rollback(checkpoint);
+            return false;
+        }
+        m_frames.push_back({create_checkpoint, nullptr, addr});
+        code = {msg.input_data, msg.input_size};
+        msg.recipient = *addr;
+        msg.input_data = nullptr;
+        msg.input_size = 0;
+    }
+    else
+    {
+        if (is_precompile(m_rev, msg.code_address))
+            return false;
+        if (const auto value = intx::be::load<intx::uint256>(msg.value);
+            msg.kind == EVMC_CALL && value != 0 && !transfer(msg.sender, msg.recipient, value))
+            return false;
+        const auto* account = m_state.find(msg.code_address);
+        auto& frame = m_frames.emplace_back(
+            Frame{checkpoint, account != nullptr ? account->code : nullptr, std::nullopt});
+        code = frame.code != nullptr ? bytes_view{*frame.code} : bytes_view{};
+    }
+    snapshot = static_cast<int32_t>(m_frames.size() - 1);
+    return true;
+}
+
+void Host::leave_call(int32_t snapshot, evmc_result& result) noexcept
+{
+    assert(static_cast<size_t>(snapshot) + 1 == m_frames.size());
+    const auto frame = std::move(m_frames[static_cast<size_t>(snapshot)]);
+    m_frames.pop_back();
+    if (frame.created.has_value())
+        result = deposit_code(*frame.created, evmc::Result{result}).release_raw();
+    if (result.status_code != EVMC_SUCCESS)
+        m_state.rollback(frame.checkpoint);
+}
+}  // namespace evm::state
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "state.hpp"
+#include <evm/evm.h>
+#include <evmc/evmc.hpp>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace evm::state
+{
+/// The evmc::Host executing messages against an in-memory State.
+///
+/// Executes nested calls and creations with the given VM, including value transfers, address
+/// derivation and code deposit, and reverts the state of failed messages. Transaction-level
+/// rules (nonce and balance checks, intrinsic gas, fees and refunds, pre-warming the EIP-2929
+/// access lists) are left to the caller, as is State::commit() after the transaction.
+/// A top-level creation increments the sender nonce like a nested one. Precompiled contracts
+/// run the VM's native implementations; the ones it leaves to the host execute no code.
+class Host : public evmc::Host
+{
+    /// A nested message started with enter_call().
+    struct Frame
+    {
+        State::Checkpoint checkpoint;
+        std::shared_ptr<const bytes> code;  ///< Keeps the code alive until leave_call().
+        std::optional<evmc::address> created;
+    };
+
+    std::vector<Frame> m_frames;
+
+protected:
+    evmc_vm* m_vm;
+    State& m_state;
+    evmc_revision m_rev;
+    evmc_tx_context m_tx_context;
+
+public:
+    /// The host extensions implemented by the Host, to be installed in the VM.
+    static const evm_host_extensions extensions;
+
+    /// Block hashes returned by BLOCKHASH, zero if missing.
+    std::unordered_map<int64_t, evmc::bytes32> block_hashes;
+
+    Host(evmc_vm* vm, State& state, evmc_revision rev, const evmc_tx_context& tx_context) noexcept
+      : m_vm{vm}, m_state{state}, m_rev{rev}, m_tx_context{tx_context}
+    {}
+
+    bool account_exists(const evmc::address& addr) const noexcept override;
+
+    evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) const noexcept override;
+
+    evmc_storage_status set_storage(const evmc::address& addr, const evmc::bytes32& key,
+        const evmc::bytes32& value) noexcept override;
+
+    [[nodiscard]] evmc::bytes32 get_original_storage(
+        const evmc::address& addr, const evmc::bytes32& key) const noexcept;
+
+    evmc::uint256be get_balance(const evmc::address& addr) const noexcept override;
+
+    size_t get_code_size(const evmc::address& addr) const noexcept override;
+
+    evmc::bytes32 get_code_hash(const evmc::address& addr) const noexcept override;
+
+    size_t copy_code(const evmc::address& addr, size_t code_offset, uint8_t* buffer_data,
+        size_t buffer_size) const noexcept override;
+
+    bool selfdestruct(
+        const evmc::address& addr, const evmc::address& beneficiary) noexcept override;
+
+    evmc::Result call(const evmc_message& msg) noexcept override;
+
+    /// Applies the prologue of a nested message executed by the VM in its own frame and
+    /// returns the code to execute. Returns false if the message must be passed to call().
+    bool enter_call(evmc_message& msg, int32_t& snapshot, bytes_view& code) noexcept;
+
+    /// Completes a message started with enter_call(), depositing the code of a creation.
+    void leave_call(int32_t snapshot, evmc_result& result) noexcept;
+
+    evmc_tx_context get_tx_context() const noexcept override;
+
+    evmc::bytes32 get_block_hash(int64_t block_number) const noexcept override;
+
+    void emit_log(const evmc::address& addr, const uint8_t* data, size_t data_size,
+        const evmc::bytes32 topics[], size_t num_topics) noexcept override;
+
+    evmc_access_status access_account(const evmc::address& addr) noexcept override;
+
+    evmc_access_status access_storage(
+        const evmc::address& addr, const evmc::bytes32& key) noexcept override;
+
+private:
+    bool transfer(
+        const evmc::address& from, const evmc::address& to, const intx::uint256& value) noexcept;
+
+    evmc::Result execute_call(const evmc_message& msg) noexcept;
+
+    evmc::Result execute_create(const evmc_message& msg) noexcept;
+
+    evmc::Result deploy(const evmc_message& msg, const evmc::address& addr) noexcept;
+
+    /// Derives the address of a creation and increments the sender nonce.
+    std::optional<evmc::address> create_address(const evmc_message& msg) noexcept;
+
+    /// Creates the account and transfers the value, or returns the failure status.
+    evmc_status_code begin_deploy(const evmc_message& msg, const evmc::address& addr) noexcept;
+
+    /// Deposits the code returned by the init code of a creation.
+    evmc::Result deposit_code(const evmc::address& addr, evmc::Result result) noexcept;
+};
+
+/// Computes the address of an account created with CREATE.
+evmc::address compute_create_address(const evmc::address& sender, uint64_t sender_nonce) noexcept;
+
+/// Computes the address of an account created with CREATE2.
+evmc::address compute_create2_address(
+    const evmc::address& sender, const evmc::bytes32& salt, bytes_view init_code) noexcept;
+}  // namespace evm::state
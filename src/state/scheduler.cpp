@@ -0,0 +1,170 @@
+#include "scheduler.hpp"
+#include <algorithm>
+
+namespace evm::state
+{
+void Scheduler::decrease_execution_idx(uint32_t target) noexcept
+{
+    auto idx = m_execution_idx.load();
+    while (idx > target && !m_execution_idx.compare_exchange_weak(idx, target))
+    {
+    }
+    ++m_decrease_cnt;
+}
+
+void Scheduler::decrease_validation_idx(uint32_t target) noexcept
+{
+    auto idx = m_validation_idx.load();
+    while (idx > target && !m_validation_idx.compare_exchange_weak(idx, target))
+    {
+    }
+    ++m_decrease_cnt;
+}
+
+void Scheduler::check_done() noexcept
+{
+    // The decrease counter detects indices decreased between the loads.
+    const auto observed_cnt = m_decrease_cnt.load();
+    if (std::min(m_execution_idx.load(), m_validation_idx.load()) >= m_num_txs &&
+        m_num_active_tasks.load() == 0 && observed_cnt == m_decrease_cnt.load())
+        m_done = true;
+}
+
+Task Scheduler::try_incarnate(uint32_t tx_index) noexcept
+{
+    if (tx_index < m_num_txs)
+    {
+        auto& tx = m_txs[tx_index];
+        const std::lock_guard lock{tx.mutex};
+        if (tx.status == Status::ready_to_execute)
+        {
+            tx.status = Status::executing;
+            return {Task::Kind::execution, {tx_index, tx.incarnation}};
+        }
+    }
+    return {};
+}
+
+Task Scheduler::next_version_to_execute() noexcept
+{
+    if (m_execution_idx.load() >= m_num_txs)
+    {
+        check_done();
+        return {};
+    }
+    ++m_num_active_tasks;
+    const auto task = try_incarnate(m_execution_idx++);
+    if (task.kind == Task::Kind::none)
+        --m_num_active_tasks;
+    return task;
+}
+
+Task Scheduler::next_version_to_validate() noexcept
+{
+    if (m_validation_idx.load() >= m_num_txs)
+    {
+        check_done();
+        return {};
+    }
+    ++m_num_active_tasks;
+    if (const auto tx_index = m_validation_idx++; tx_index < m_num_txs)
+    {
+        auto& tx = m_txs[tx_index];
+        const std::lock_guard lock{tx.mutex};
+        if (tx.status == Status::executed)
+            return {Task::Kind::validation, {tx_index, tx.incarnation}};
+    }
+    --m_num_active_tasks;
+    return {};
+}
+
+void Scheduler::set_ready_status(uint32_t tx_index) noexcept
+{
+    auto& tx = m_txs[tx_index];
+    const std::lock_guard lock{tx.mutex};
+    ++tx.incarnation;
+    tx.status = Status::ready_to_execute;
+}
+
+Task Scheduler::next_task() noexcept
+{
+    return m_validation_idx.load() < m_execution_idx.load() ? next_version_to_validate() :
+                                                              next_version_to_execute();
+}
+
+bool Scheduler::add_dependency(uint32_t tx_index, uint32_t blocking_tx_index) noexcept
+{
+    auto& blocking = m_txs[blocking_tx_index];
+    const std::lock_guard dependencies_lock{blocking.dependencies_mutex};
+    {
+        const std::lock_guard lock{blocking.mutex};
+        if (blocking.status == Status::executed)
+            return false;
+    }
+    {
+        auto& tx = m_txs[tx_index];
+        const std::lock_guard lock{tx.mutex};
+        tx.status = Status::aborting;
+    }
+    blocking.dependencies.push_back(tx_index);
+    --m_num_active_tasks;
+    return true;
+}
+
+Task Scheduler::finish_execution(Version version, bool wrote_new_location) noexcept
+{
+    auto& tx = m_txs[version.tx_index];
+    {
+        const std::lock_guard lock{tx.mutex};
+        tx.status = Status::executed;
+    }
+    std::vector<uint32_t> dependencies;
+    {
+        const std::lock_guard lock{tx.dependencies_mutex};
+        dependencies.swap(tx.dependencies);
+    }
+    if (!dependencies.empty())
+    {
+        for (const auto d : dependencies)
+            set_ready_status(d);
+        decrease_execution_idx(*std::min_element(dependencies.begin(), dependencies.end()));
+    }
+
+    if (m_validation_idx.load() > version.tx_index)
+    {
+        // A new location may invalidate higher transactions, otherwise only this one
+        // needs the validation it has missed.
+        if (!wrote_new_location)
+            return {Task::Kind::validation, version};
+        decrease_validation_idx(version.tx_index);
+    }
+    --m_num_active_tasks;
+    return {};
+}
+
+bool Scheduler::try_validation_abort(Version version) noexcept
+{
+    auto& tx = m_txs[version.tx_index];
+    const std::lock_guard lock{tx.mutex};
+    if (tx.incarnation != version.incarnation || tx.status != Status::executed)
+        return false;
+    tx.status = Status::aborting;
+    return true;
+}
+
+Task Scheduler::finish_validation(uint32_t tx_index, bool aborted) noexcept
+{
+    if (aborted)
+    {
+        set_ready_status(tx_index);
+        decrease_validation_idx(tx_index + 1);
+        if (m_execution_idx.load() > tx_index)
+        {
+            if (const auto task = try_incarnate(tx_index); task.kind != Task::Kind::none)
+                return task;
+        }
+    }
+    --m_num_active_tasks;
+    return {};
+}
+}  // namespace evm::state
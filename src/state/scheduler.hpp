@@ -0,0 +1,93 @@
+#pragma once
+
+#include "versioned_map.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace evm::state
+{
+/// A task of the parallel block execution.
+struct Task
+{
+    enum class Kind : uint8_t
+    {
+        none,
+        execution,
+        validation,
+    };
+
+    Kind kind = Kind::none;
+    Version version;
+};
+
+/// The Block-STM collaborative scheduler.
+///
+/// Workers pull execution and validation tasks in transaction order from two shared indices,
+/// so the lowest pending transactions are always handled first. An incarnation whose
+/// validation fails is re-executed and the validation of all higher transactions restarts.
+/// A transaction reading an estimate is suspended until its blocking transaction is
+/// re-executed. Every task taken must be passed back through one of the finish_* or
+/// add_dependency() calls, which may return the next task for the same transaction.
+class Scheduler
+{
+    enum class Status : uint8_t
+    {
+        ready_to_execute,
+        executing,
+        executed,
+        aborting,
+    };
+
+    struct TxState
+    {
+        std::mutex mutex;
+        uint32_t incarnation = 0;
+        Status status = Status::ready_to_execute;
+
+        std::mutex dependencies_mutex;
+        std::vector<uint32_t> dependencies;  ///< The transactions waiting for this one.
+    };
+
+    const uint32_t m_num_txs;
+    std::unique_ptr<TxState[]> m_txs;
+    std::atomic<uint32_t> m_execution_idx{0};
+    std::atomic<uint32_t> m_validation_idx{0};
+    std::atomic<uint32_t> m_decrease_cnt{0};
+    std::atomic<int32_t> m_num_active_tasks{0};
+    std::atomic<bool> m_done{false};
+
+    void decrease_execution_idx(uint32_t target) noexcept;
+    void decrease_validation_idx(uint32_t target) noexcept;
+    void check_done() noexcept;
+    Task try_incarnate(uint32_t tx_index) noexcept;
+    Task next_version_to_execute() noexcept;
+    Task next_version_to_validate() noexcept;
+    void set_ready_status(uint32_t tx_index) noexcept;
+
+public:
+    explicit Scheduler(uint32_t num_txs) noexcept
+      : m_num_txs{num_txs}, m_txs{std::make_unique<TxState[]>(num_txs)}
+    {}
+
+    /// Returns true when all transactions are executed and validated.
+    [[nodiscard]] bool done() const noexcept { return m_done.load(); }
+
+    /// Returns the next task, or a none task if there is nothing to do currently.
+    Task next_task() noexcept;
+
+    /// Suspends the transaction until the blocking transaction is executed.
+    /// Returns false if it already is: the transaction should be re-executed right away.
+    bool add_dependency(uint32_t tx_index, uint32_t blocking_tx_index) noexcept;
+
+    /// Marks the incarnation as executed and resumes the transactions waiting for it.
+    Task finish_execution(Version version, bool wrote_new_location) noexcept;
+
+    /// Returns true if the validation failure aborts the incarnation: its writes must be
+    /// marked as estimates before finish_validation().
+    bool try_validation_abort(Version version) noexcept;
+
+    Task finish_validation(uint32_t tx_index, bool aborted) noexcept;
+};
+}  // namespace evm::state
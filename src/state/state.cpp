@@ -0,0 +1,222 @@
+#include "state.hpp"
+#include "../storage_journal.hpp"
+#include <ethash/keccak.hpp>
+#include <cstring>
+
+namespace evm::state
+{
+Account* State::find(const evmc::address& addr) noexcept
+{
+    if (auto* account = m_accounts.find(addr); account != nullptr || m_view == nullptr)
+        return account;
+    if (m_removed.contains(addr))
+        return nullptr;
+    auto account = m_view->get_account(addr);
+    return account.has_value() ? &insert(addr, std::move(*account)) : nullptr;
+}
+
+Account& State::insert(const evmc::address& addr, Account account) noexcept
+{
+    auto& a = m_accounts.try_emplace(addr).first;
+    a = std::move(account);
+    return a;
+}
+
+void State::erase(const evmc::address& addr) noexcept
+{
+    m_accounts.erase(addr);
+    if (m_view != nullptr)
+        m_removed.insert(addr);
+}
+
+Account& State::touch(const evmc::address& addr) noexcept
+{
+    if (auto* account = find(addr); account != nullptr)
+        return *account;
+    m_journal.push_back({JournalEntry::Kind::create, addr, {}, 0});
+    return m_accounts.try_emplace(addr).first;
+}
+
+void State::set_balance(const evmc::address& addr, const intx::uint256& balance) noexcept
+{
+    auto& account = touch(addr);
+    m_journal.push_back({JournalEntry::Kind::balance, addr, {}, account.balance});
+    account.balance = balance;
+}
+
+void State::set_nonce(const evmc::address& addr, uint64_t nonce) noexcept
+{
+    auto& account = touch(addr);
+    m_journal.push_back({JournalEntry::Kind::nonce, addr, {}, account.nonce});
+    account.nonce = nonce;
+}
+
+void State::set_code(const evmc::address& addr, bytes_view code) noexcept
+{
+    if (code.empty())
+        return;
+    auto& account = touch(addr);
+    assert(account.code == nullptr);
+    m_journal.push_back({JournalEntry::Kind::code, addr, {}, 0});
+    account.code = std::make_shared<const bytes>(code);
+    const auto hash = ethash::keccak256(code.data(), code.size());
+    std::memcpy(account.code_hash.bytes, hash.bytes, sizeof(account.code_hash.bytes));
+}
+
+StorageValue& State::load_storage(
+    Account& account, const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    auto [slot, inserted] = account.storage.try_emplace(key);
+    if (inserted && m_view != nullptr && !m_removed.contains(addr))
+    {
+        const auto value = m_view->get_storage(addr, key);
+        slot = {value, value};
+    }
+    return slot;
+}
+
+evmc::bytes32 State::get_storage(const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    auto* account = find(addr);
+    if (account == nullptr)
+        return {};
+    if (const auto* value = account->storage.find(key); value != nullptr)
+        return value->current;
+    return m_view != nullptr ? load_storage(*account, addr, key).current : evmc::bytes32{};
+}
+
+evmc::bytes32 State::get_original_storage(
+    const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    auto* account = find(addr);
+    if (account == nullptr)
+        return {};
+    if (const auto* value = account->storage.find(key); value != nullptr)
+        return value->original;
+    return m_view != nullptr ? load_storage(*account, addr, key).original : evmc::bytes32{};
+}
+
+evmc_storage_status State::set_storage(
+    const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) noexcept
+{
+    auto& slot = load_storage(touch(addr), addr, key);
+    m_journal.push_back(
+        {JournalEntry::Kind::storage, addr, key, intx::be::load<intx::uint256>(slot.current)});
+    const auto status = get_storage_status(slot.original, slot.current, value);
+    slot.current = value;
+    return status;
+}
+
+void State::mark_created(const evmc::address& addr) noexcept
+{
+    auto& account = touch(addr);
+    if (account.created)
+        return;
+    m_journal.push_back({JournalEntry::Kind::created, addr, {}, 0});
+    account.created = true;
+}
+
+bool State::destruct(const evmc::address& addr) noexcept
+{
+    auto& account = touch(addr);
+    if (account.destructed)
+        return false;
+    m_journal.push_back({JournalEntry::Kind::destruct, addr, {}, 0});
+    account.destructed = true;
+    return true;
+}
+
+evmc_access_status State::access_account(const evmc::address& addr) noexcept
+{
+    if (!m_warm_accounts.insert(addr))
+        return EVMC_ACCESS_WARM;
+    m_journal.push_back({JournalEntry::Kind::warm_account, addr, {}, 0});
+    return EVMC_ACCESS_COLD;
+}
+
+evmc_access_status State::access_storage(
+    const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    if (!m_warm_slots.insert({addr, key}))
+        return EVMC_ACCESS_WARM;
+    m_journal.push_back({JournalEntry::Kind::warm_slot, addr, key, 0});
+    return EVMC_ACCESS_COLD;
+}
+
+void State::emit_log(const evmc::address& addr, const uint8_t* data, size_t data_size,
+    const evmc::bytes32 topics[], size_t num_topics) noexcept
+{
+    m_logs.push_back({addr, bytes{data, data_size}, {topics, topics + num_topics}});
+    m_journal.push_back({JournalEntry::Kind::log, addr, {}, 0});
+}
+
+void State::rollback(Checkpoint checkpoint) noexcept
+{
+    while (m_journal.size() > checkpoint)
+    {
+        const auto& e = m_journal.back();
+        auto* account = m_accounts.find(e.addr);
+        switch (e.kind)
+        {
+        case JournalEntry::Kind::create:
+            m_accounts.erase(e.addr);
+            break;
+        case JournalEntry::Kind::balance:
+            account->balance = e.value;
+            break;
+        case JournalEntry::Kind::nonce:
+            account->nonce = static_cast<uint64_t>(e.value);
+            break;
+        case JournalEntry::Kind::storage:
+            account->storage.find(e.key)->current = intx::be::store<evmc::bytes32>(e.value);
+            break;
+        case JournalEntry::Kind::code:
+            account->code.reset();
+            account->code_hash = empty_code_hash;
+            break;
+        case JournalEntry::Kind::destruct:
+            account->destructed = false;
+            break;
+        case JournalEntry::Kind::created:
+            account->created = false;
+            break;
+        case JournalEntry::Kind::warm_account:
+            m_warm_accounts.erase(e.addr);
+            break;
+        case JournalEntry::Kind::warm_slot:
+            m_warm_slots.erase({e.addr, e.key});
+            break;
+        case JournalEntry::Kind::log:
+            m_logs.pop_back();
+            break;
+        }
+        m_journal.pop_back();
+    }
+}
+
+void State::commit() noexcept
+{
+    for (const auto& e : m_journal)
+    {
+        auto* account = m_accounts.find(e.addr);
+        if (account == nullptr)
+            continue;
+        if (e.kind == JournalEntry::Kind::storage)
+        {
+            auto& slot = *account->storage.find(e.key);
+            slot.original = slot.current;
+        }
+        else if (e.kind == JournalEntry::Kind::created)
+            account->created = false;
+    }
+    for (const auto& e : m_journal)
+    {
+        if (e.kind == JournalEntry::Kind::destruct)
+            erase(e.addr);
+    }
+    m_journal.clear();
+    m_warm_accounts.clear();
+    m_warm_slots.clear();
+    m_logs.clear();
+}
+}  // namespace evm::state
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "../hash_set.hpp"
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace evm::state
+{
+using namespace evmc::literals;
+using bytes = std::basic_string<uint8_t>;
+using bytes_view = std::basic_string_view<uint8_t>;
+
+/// The Keccak-256 hash of the empty code.
+constexpr auto empty_code_hash =
+    0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470_bytes32;
+
+struct StorageValue
+{
+    evmc::bytes32 current;
+    evmc::bytes32 original;  ///< The value at the beginning of the transaction.
+};
+
+struct Account
+{
+    uint64_t nonce = 0;
+    intx::uint256 balance;
+
+    /// The code, null if empty. Shared so that it outlives the account during execution.
+    std::shared_ptr<const bytes> code;
+    evmc::bytes32 code_hash = empty_code_hash;
+
+    FlatHashMap<evmc::bytes32, StorageValue, Bytes32Hash> storage;
+
+    bool destructed = false;
+    bool created = false;  ///< Created in the current transaction.
+
+    [[nodiscard]] bool is_empty() const noexcept
+    {
+        return nonce == 0 && balance == 0 && code == nullptr;
+    }
+
+    [[nodiscard]] bytes_view get_code() const noexcept
+    {
+        return code != nullptr ? bytes_view{*code} : bytes_view{};
+    }
+};
+
+struct Log
+{
+    evmc::address address;
+    bytes data;
+    std::vector<evmc::bytes32> topics;
+};
+
+/// Source of the accounts and storage slots missing from a State, loaded on first access.
+class StateView
+{
+public:
+    virtual ~StateView() = default;
+
+    /// Returns the account, with empty storage, or nullopt if it does not exist.
+    virtual std::optional<Account> get_account(const evmc::address& addr) noexcept = 0;
+
+    virtual evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) noexcept = 0;
+};
+
+/// In-memory world state for the execution of transactions.
+///
+/// All modifications made during a transaction, including the EIP-2929 access lists and
+/// the logs, are journaled so that they can be reverted to a checkpoint. commit() ends the
+/// transaction: it removes the destructed accounts and makes the current storage values
+/// the original ones.
+///
+/// A State with a StateView acts as an overlay: missing accounts and slots are loaded from
+/// the view, so the State only holds the data accessed by the transaction. Removed accounts
+/// are remembered, and are not loaded from the view again.
+class State
+{
+    struct JournalEntry
+    {
+        enum class Kind : uint8_t
+        {
+            create,
+            balance,
+            nonce,
+            storage,
+            code,
+            destruct,
+            created,
+            warm_account,
+            warm_slot,
+            log,
+        };
+
+        Kind kind;
+        evmc::address addr;
+        evmc::bytes32 key;
+        intx::uint256 value;  ///< The previous balance, nonce or storage value.
+    };
+
+    FlatHashMap<evmc::address, Account, AddressHash> m_accounts;
+
+    /// The accounts removed by commit(), not to be loaded from the view again.
+    FlatHashSet<evmc::address, AddressHash> m_removed;
+    FlatHashSet<evmc::address, AddressHash> m_warm_accounts;
+    FlatHashSet<StorageKey, StorageKeyHash> m_warm_slots;
+    std::vector<JournalEntry> m_journal;
+    std::vector<Log> m_logs;
+    StateView* m_view = nullptr;
+
+    StorageValue& load_storage(
+        Account& account, const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+public:
+    using Checkpoint = size_t;
+
+    State() noexcept = default;
+
+    explicit State(StateView& view) noexcept : m_view{&view} {}
+
+    /// Returns the account, loading it from the view if needed, or null if it does not exist.
+    [[nodiscard]] Account* find(const evmc::address& addr) noexcept;
+
+    /// Returns the account if it is present, without consulting the view.
+    [[nodiscard]] const Account* find(const evmc::address& addr) const noexcept
+    {
+        return m_accounts.find(addr);
+    }
+
+    /// Inserts an account outside of any transaction, e.g. for the genesis state.
+    Account& insert(const evmc::address& addr, Account account) noexcept;
+
+    /// Removes an account outside of any transaction.
+    void erase(const evmc::address& addr) noexcept;
+
+    /// Returns the account, creating an empty one if it does not exist.
+    Account& touch(const evmc::address& addr) noexcept;
+
+    void set_balance(const evmc::address& addr, const intx::uint256& balance) noexcept;
+
+    void set_nonce(const evmc::address& addr, uint64_t nonce) noexcept;
+
+    /// Sets the code of an account which has no code.
+    void set_code(const evmc::address& addr, bytes_view code) noexcept;
+
+    [[nodiscard]] evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+    /// Returns the value of the storage slot at the beginning of the transaction.
+    [[nodiscard]] evmc::bytes32 get_original_storage(
+        const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+    evmc_storage_status set_storage(
+        const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) noexcept;
+
+    /// Marks the account as created in the current transaction, creating it if needed.
+    void mark_created(const evmc::address& addr) noexcept;
+
+    /// Marks the account for removal at the end of the transaction.
+    /// Returns false if it was already marked.
+    bool destruct(const evmc::address& addr) noexcept;
+
+    evmc_access_status access_account(const evmc::address& addr) noexcept;
+
+    evmc_access_status access_storage(const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+    void emit_log(const evmc::address& addr, const uint8_t* data, size_t data_size,
+        const evmc::bytes32 topics[], size_t num_topics) noexcept;
+
+    /// The logs of the current transaction.
+    [[nodiscard]] const std::vector<Log>& get_logs() const noexcept { return m_logs; }
+
+    [[nodiscard]] Checkpoint checkpoint() const noexcept { return m_journal.size(); }
+
+    /// Reverts all modifications made after the checkpoint.
+    void rollback(Checkpoint checkpoint) noexcept;
+
+    /// Ends the transaction. Clears the journal, the access lists and the logs.
+    void commit() noexcept;
+
+    /// Calls account_fn(addr, account) for each account and slot_fn(addr, key, value) for each
+    /// storage slot modified in the current transaction. Entries may be visited repeatedly.
+    template <typename AccountFn, typename SlotFn>
+    void for_each_modified(AccountFn&& account_fn, SlotFn&& slot_fn) const
+    {
+        for (const auto& e : m_journal)
+        {
+            const auto* account = m_accounts.find(e.addr);
+            if (account == nullptr)
+                continue;
+            switch (e.kind)
+            {
+            case JournalEntry::Kind::create:
+            case JournalEntry::Kind::balance:
+            case JournalEntry::Kind::nonce:
+            case JournalEntry::Kind::code:
+            case JournalEntry::Kind::destruct:
+            case JournalEntry::Kind::created:
+                account_fn(e.addr, *account);
+                break;
+            case JournalEntry::Kind::storage:
+                slot_fn(e.addr, e.key, account->storage.find(e.key)->current);
+                break;
+            case JournalEntry::Kind::warm_account:
+            case JournalEntry::Kind::warm_slot:
+            case JournalEntry::Kind::log:
+                break;
+            }
+        }
+    }
+};
+}  // namespace evm::state
@@ -0,0 +1,96 @@
+#include "transaction.hpp"
+#include "host.hpp"
+#include <algorithm>
+
+namespace evm::state
+{
+namespace
+{
+int64_t compute_intrinsic_gas(evmc_revision rev, const Transaction& tx) noexcept
+{
+    int64_t gas = 21000;
+    if (tx.kind == EVMC_CREATE && rev >= EVMC_HOMESTEAD)
+        gas += 32000;
+    const auto nonzero_byte_cost = rev >= EVMC_ISTANBUL ? 16 : 68;
+    for (const auto b : tx.data)
+        gas += (b != 0) ? nonzero_byte_cost : 4;
+    // EIP-3860: the init code is charged per word.
+    if (tx.kind == EVMC_CREATE && rev >= EVMC_SHANGHAI)
+        gas += 2 * static_cast<int64_t>((tx.data.size() + 31) / 32);
+    return gas;
+}
+}  // namespace
+
+TransactionReceipt transition(evmc_vm* vm, State& state, evmc_revision rev,
+    const evmc_tx_context& tx_context, const Transaction& tx) noexcept
+{
+    const auto base_fee =
+        rev >= EVMC_LONDON ? intx::be::load<intx::uint256>(tx_context.block_base_fee) : 0;
+    const auto intrinsic_gas = compute_intrinsic_gas(rev, tx);
+    if (tx.gas_limit < intrinsic_gas || tx.gas_price < base_fee)
+        return {EVMC_REJECTED, 0, {}};
+    // A cost above 2^256 - 1 cannot be paid and must not wrap around.
+    const auto gas_limit = static_cast<uint64_t>(tx.gas_limit);
+    if (tx.gas_price > ~intx::uint256{0} / gas_limit)
+        return {EVMC_REJECTED, 0, {}};
+    const auto gas_cost = tx.gas_price * gas_limit;
+    const auto total_cost = gas_cost + tx.value;
+    const auto* sender = state.find(tx.sender);
+    if (total_cost < gas_cost || sender == nullptr || sender->balance < total_cost)
+        return {EVMC_REJECTED, 0, {}};
+    state.set_balance(tx.sender, sender->balance - gas_cost);
+
+    if (rev >= EVMC_BERLIN)
+    {
+        state.access_account(tx.sender);
+        if (tx.kind == EVMC_CALL)
+            state.access_account(tx.recipient);
+    }
+    if (rev >= EVMC_SHANGHAI)
+        state.access_account(tx_context.block_coinbase);
+
+    // The nonce of a creation is incremented by the host, after the address is derived.
+    if (tx.kind == EVMC_CALL)
+        state.set_nonce(tx.sender, state.touch(tx.sender).nonce + 1);
+
+    evmc_message msg{};
+    msg.kind = tx.kind;
+    msg.gas = tx.gas_limit - intrinsic_gas;
+    msg.recipient = tx.recipient;
+    msg.sender = tx.sender;
+    msg.input_data = tx.data.data();
+    msg.input_size = tx.data.size();
+    msg.value = intx::be::store<evmc::uint256be>(tx.value);
+    msg.code_address = tx.recipient;
+
+    auto tx_ctx = tx_context;
+    tx_ctx.tx_origin = tx.sender;
+    tx_ctx.tx_gas_price = intx::be::store<evmc::uint256be>(tx.gas_price);
+    Host host{vm, state, rev, tx_ctx};
+    const auto result = host.call(msg);
+
+    // EIP-3529: the refund is capped at a fifth of the gas used, half before London.
+    auto gas_used = tx.gas_limit - result.gas_left;
+    const auto max_refund = gas_used / (rev >= EVMC_LONDON ? 5 : 2);
+    if (result.status_code == EVMC_SUCCESS)
+        gas_used -= std::min(result.gas_refund, max_refund);
+
+    const auto gas_left = static_cast<uint64_t>(tx.gas_limit - gas_used);
+    state.set_balance(tx.sender, state.touch(tx.sender).balance + tx.gas_price * gas_left);
+    if (const auto priority_fee = (tx.gas_price - base_fee) * static_cast<uint64_t>(gas_used);
+        priority_fee != 0)
+    {
+        const auto& coinbase = tx_context.block_coinbase;
+        state.set_balance(coinbase, state.touch(coinbase).balance + priority_fee);
+    }
+    return {result.status_code, gas_used, state.get_logs()};
+}
+
+TransactionReceipt execute_transaction(evmc_vm* vm, State& state, evmc_revision rev,
+    const evmc_tx_context& tx_context, const Transaction& tx) noexcept
+{
+    auto receipt = transition(vm, state, rev, tx_context, tx);
+    state.commit();
+    return receipt;
+}
+}  // namespace evm::state
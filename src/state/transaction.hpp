@@ -0,0 +1,40 @@
+#pragma once
+
+#include "state.hpp"
+
+namespace evm::state
+{
+/// A transaction reduced to its top-level message.
+struct Transaction
+{
+    evmc_call_kind kind = EVMC_CALL;  ///< EVMC_CALL or EVMC_CREATE.
+    evmc::address sender;
+    evmc::address recipient;  ///< Ignored for EVMC_CREATE.
+    intx::uint256 value;
+    int64_t gas_limit = 0;
+    intx::uint256 gas_price;  ///< The effective gas price, not below the block base fee.
+    bytes data;
+};
+
+struct TransactionReceipt
+{
+    evmc_status_code status = EVMC_SUCCESS;
+    int64_t gas_used = 0;
+    std::vector<Log> logs;
+};
+
+/// Executes the transaction, leaving its changes uncommitted in the state.
+///
+/// Buys the gas from the sender, increments its nonce, warms the sender and the recipient and
+/// executes the top-level message with the given VM, with the gas left after the intrinsic gas.
+/// The unused gas and the capped refund are then returned to the sender and the priority fee
+/// of the gas used is paid to the coinbase. A transaction which cannot pay for its gas limit and
+/// value, whose gas limit is below the intrinsic gas or whose gas price is below the base fee
+/// is not executed: the state is left unchanged and the receipt has the EVMC_REJECTED status.
+TransactionReceipt transition(evmc_vm* vm, State& state, evmc_revision rev,
+    const evmc_tx_context& tx_context, const Transaction& tx) noexcept;
+
+/// Executes the transaction and commits it to the state.
+TransactionReceipt execute_transaction(evmc_vm* vm, State& state, evmc_revision rev,
+    const evmc_tx_context& tx_context, const Transaction& tx) noexcept;
+}  // namespace evm::state
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace evm::state
+{
+/// The version of a value: the index of the transaction which wrote it and the incarnation,
+/// i.e. the execution attempt, of that transaction.
+struct Version
+{
+    /// The transaction index of the values read from the base state.
+    static constexpr auto base = std::numeric_limits<uint32_t>::max();
+
+    uint32_t tx_index = base;
+    uint32_t incarnation = 0;
+
+    friend bool operator==(const Version& a, const Version& b) noexcept
+    {
+        return a.tx_index == b.tx_index && a.incarnation == b.incarnation;
+    }
+};
+
+/// Multi-version store of the values written by the transactions of a block.
+///
+/// A location keeps the value written by each transaction, so that a transaction reads the
+/// value of the highest lower transaction writing it. The values of an aborted incarnation
+/// are marked as estimates: they are likely to be written again, so a reader should wait
+/// for the re-execution instead of reading them. Locations are sharded between mutexes.
+template <typename Key, typename Value, typename Hash>
+class VersionedMap
+{
+    struct Entry
+    {
+        uint32_t incarnation = 0;
+        bool estimate = false;
+        Value value{};
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<Key, std::map<uint32_t, Entry>, Hash> locations;
+    };
+
+    static constexpr size_t num_shards = 64;
+
+    std::array<Shard, num_shards> m_shards;
+
+    [[nodiscard]] Shard& shard(const Key& key) noexcept
+    {
+        return m_shards[Hash{}(key) % num_shards];
+    }
+
+public:
+    enum class ReadStatus : uint8_t
+    {
+        base,      ///< No lower transaction writes the location.
+        value,     ///< The value and version are set.
+        estimate,  ///< The writer, the version's transaction, is being re-executed.
+    };
+
+    struct ReadResult
+    {
+        ReadStatus status = ReadStatus::base;
+        Version version;
+        Value value{};
+    };
+
+    /// Reads the location as seen by the transaction.
+    [[nodiscard]] ReadResult read(const Key& key, uint32_t tx_index) noexcept
+    {
+        auto& s = shard(key);
+        const std::lock_guard lock{s.mutex};
+        const auto location = s.locations.find(key);
+        if (location == s.locations.end())
+            return {};
+        auto it = location->second.lower_bound(tx_index);
+        if (it == location->second.begin())
+            return {};
+        --it;
+        const Version version{it->first, it->second.incarnation};
+        if (it->second.estimate)
+            return {ReadStatus::estimate, version, {}};
+        return {ReadStatus::value, version, it->second.value};
+    }
+
+    /// Returns the value written by the transaction, which must exist.
+    [[nodiscard]] Value get(const Key& key, uint32_t tx_index) noexcept
+    {
+        auto& s = shard(key);
+        const std::lock_guard lock{s.mutex};
+        return s.locations.find(key)->second.find(tx_index)->second.value;
+    }
+
+    void write(const Key& key, Version version, Value value) noexcept
+    {
+        auto& s = shard(key);
+        const std::lock_guard lock{s.mutex};
+        s.locations[key][version.tx_index] = {version.incarnation, false, std::move(value)};
+    }
+
+    void mark_estimate(const Key& key, uint32_t tx_index) noexcept
+    {
+        auto& s = shard(key);
+        const std::lock_guard lock{s.mutex};
+        s.locations.find(key)->second.find(tx_index)->second.estimate = true;
+    }
+
+    void erase(const Key& key, uint32_t tx_index) noexcept
+    {
+        auto& s = shard(key);
+        const std::lock_guard lock{s.mutex};
+        s.locations.find(key)->second.erase(tx_index);
+    }
+};
+}  // namespace evm::state
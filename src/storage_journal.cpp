@@ -0,0 +1,96 @@
+#include "storage_journal.hpp"
+
+namespace evm
+{
+evmc_storage_status get_storage_status(const evmc::bytes32& original,
+    const evmc::bytes32& current, const evmc::bytes32& value) noexcept
+{
+    constexpr auto zero = evmc::bytes32{};
+
+    if (current == value)
+        return EVMC_STORAGE_ASSIGNED;
+
+    if (original == current)
+    {
+        if (original == zero)
+            return EVMC_STORAGE_ADDED;
+        return value == zero ? EVMC_STORAGE_DELETED : EVMC_STORAGE_MODIFIED;
+    }
+
+    if (original == value)
+    {
+        if (original == zero)
+            return EVMC_STORAGE_ADDED_DELETED;
+        return current == zero ? EVMC_STORAGE_DELETED_RESTORED : EVMC_STORAGE_MODIFIED_RESTORED;
+    }
+
+    if (original != zero)
+    {
+        if (current == zero)
+            return EVMC_STORAGE_DELETED_ADDED;
+        if (value == zero)
+            return EVMC_STORAGE_MODIFIED_DELETED;
+    }
+    return EVMC_STORAGE_ASSIGNED;
+}
+
+StorageJournal::Slot& StorageJournal::get_slot(evmc::HostContext& host,
+    const HostExtensions& host_ext, const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    const auto [it, inserted] = m_slots.try_emplace(StorageKey{addr, key});
+    auto& slot = it->second;
+    if (inserted)
+    {
+        slot.loaded = host.get_storage(addr, key);
+        slot.original = host_ext.get_original_storage(addr, key);
+        slot.current = slot.loaded;
+    }
+    return slot;
+}
+
+void StorageJournal::rollback(Checkpoint checkpoint) noexcept
+{
+    while (m_undo.size() > checkpoint)
+    {
+        const auto& e = m_undo.back();
+        e.slot->current = e.previous;
+        m_undo.pop_back();
+    }
+}
+
+evmc::bytes32 StorageJournal::load(evmc::HostContext& host, const HostExtensions& host_ext,
+    const evmc::address& addr, const evmc::bytes32& key) noexcept
+{
+    return get_slot(host, host_ext, addr, key).current;
+}
+
+evmc_storage_status StorageJournal::store(evmc::HostContext& host,
+    const HostExtensions& host_ext, const evmc::address& addr, const evmc::bytes32& key,
+    const evmc::bytes32& value) noexcept
+{
+    auto& slot = get_slot(host, host_ext, addr, key);
+    const auto status = get_storage_status(slot.original, slot.current, value);
+    if (slot.current != value)
+    {
+        m_undo.push_back({&slot, slot.current});
+        slot.current = value;
+    }
+    return status;
+}
+
+void StorageJournal::flush(evmc::HostContext& host) noexcept
+{
+    for (const auto& [k, slot] : m_slots)
+    {
+        if (slot.current != slot.loaded)
+            host.set_storage(k.addr, k.key, slot.current);
+    }
+    clear();
+}
+
+void StorageJournal::clear() noexcept
+{
+    m_slots.clear();
+    m_undo.clear();
+}
+}  // namespace evm
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "hash_set.hpp"
+#include "host_extensions.hpp"
+#include <evmc/evmc.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace evm
+{
+/// Classifies a storage write according to EIP-2200 / EIP-1283.
+[[nodiscard]] EVMC_EXPORT evmc_storage_status get_storage_status(
+    const evmc::bytes32& original, const evmc::bytes32& current,
+    const evmc::bytes32& value) noexcept;
+
+/// Transaction-scoped write-back cache of storage slots.
+///
+/// SSTORE only updates the journal and the storage status is computed locally from the
+/// original (transaction start) and current values. Frames record a checkpoint on entry
+/// and drop their writes on failure. The net changes are passed to the host once, when
+/// the top-level frame succeeds.
+class StorageJournal
+{
+    struct Slot
+    {
+        evmc::bytes32 original;  ///< The value at the beginning of the transaction.
+        evmc::bytes32 loaded;    ///< The value in the host when the slot was first accessed.
+        evmc::bytes32 current;   ///< The value including all journaled writes.
+    };
+
+    struct UndoEntry
+    {
+        Slot* slot;
+        evmc::bytes32 previous;
+    };
+
+    std::unordered_map<StorageKey, Slot, StorageKeyHash> m_slots;
+    std::vector<UndoEntry> m_undo;
+
+    Slot& get_slot(evmc::HostContext& host, const HostExtensions& host_ext,
+        const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+public:
+    using Checkpoint = size_t;
+
+    [[nodiscard]] Checkpoint checkpoint() const noexcept { return m_undo.size(); }
+
+    /// Reverts all writes made after the checkpoint.
+    void rollback(Checkpoint checkpoint) noexcept;
+
+    [[nodiscard]] evmc::bytes32 load(evmc::HostContext& host, const HostExtensions& host_ext,
+        const evmc::address& addr, const evmc::bytes32& key) noexcept;
+
+    evmc_storage_status store(evmc::HostContext& host, const HostExtensions& host_ext,
+        const evmc::address& addr, const evmc::bytes32& key,
+        const evmc::bytes32& value) noexcept;
+
+    /// Passes the net changes to the host and clears the journal.
+    void flush(evmc::HostContext& host) noexcept;
+
+    void clear() noexcept;
+};
+}  // namespace evm
@@ -1,8 +1,12 @@
 #include "vm.hpp"
 #include "advanced_execution.hpp"
 #include "baseline.hpp"
+#include "execution_state.hpp"
 #include <evm/evm.h>
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstddef>
 #include <iostream>
 
 namespace evm
@@ -27,7 +31,10 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
     auto& vm = *static_cast<VM*>(c_vm);
     if (name == "advanced")
     {
-        c_vm->execute = evm::advanced::execute;
+        if (vm.get_access_recorder() != nullptr)
+            vm.preexecution_target = evm::advanced::execute;
+        else
+            c_vm->execute = evm::advanced::execute;
         return EVMC_SET_OPTION_SUCCESS;
     }
     else if (name == "cgoto")
@@ -43,6 +50,120 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
         return EVMC_SET_OPTION_INVALID_NAME;
 #endif
     }
+    else if (name == "storage_journal")
+    {
+        if (value == "no")
+        {
+            vm.set_storage_journal(false);
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value != "yes" || vm.host_extensions == nullptr ||
+            vm.host_extensions->get_original_storage == nullptr)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.set_storage_journal(true);
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "prefetch")
+    {
+        if (value == "no")
+        {
+            vm.prefetch = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        // The storage keys are found by the code analysis of the advanced interpreter only.
+        const evmc_execute_fn advanced = evm::advanced::execute;
+        const auto interpreter = (vm.get_access_recorder() != nullptr) ? vm.preexecution_target :
+                                                                         c_vm->execute;
+        if (value != "yes" || interpreter != advanced ||
+            vm.host_extensions == nullptr || vm.host_extensions->prefetch_storage == nullptr)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.prefetch = true;
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "call_frames")
+    {
+        if (value == "no")
+        {
+            vm.call_frames = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value != "yes" || vm.host_extensions == nullptr ||
+            vm.host_extensions->enter_call == nullptr || vm.host_extensions->leave_call == nullptr)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.call_frames = true;
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "native_words")
+    {
+        if (value == "no")
+        {
+            vm.native_words = false;
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        const auto* ext = vm.host_extensions;
+        if (value != "yes" || ext == nullptr || ext->get_storage_word == nullptr ||
+            ext->set_storage_word == nullptr || ext->get_balance_word == nullptr ||
+            ext->emit_log_words == nullptr)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.native_words = true;
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "log_batching")
+    {
+        if (value == "no")
+        {
+            vm.set_log_batching(false);
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        if (value != "yes" || vm.host_extensions == nullptr ||
+            vm.host_extensions->emit_logs == nullptr)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.set_log_batching(true);
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "precompiles")
+    {
+        if (value != "yes" && value != "no")
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.precompiles = value == "yes";
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "unmetered")
+    {
+        if (value != "yes" && value != "no")
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.unmetered = value == "yes";
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "gas_estimation")
+    {
+        if (value != "yes" && value != "no")
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.set_gas_estimation(value == "yes");
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "access_tracking")
+    {
+        if (value != "yes" && value != "no")
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.set_access_tracking(value == "yes");
+        return EVMC_SET_OPTION_SUCCESS;
+    }
+    else if (name == "preexecution")
+    {
+        if (value == "no")
+        {
+            vm.disable_preexecution();
+            return EVMC_SET_OPTION_SUCCESS;
+        }
+        size_t max_items = 0;
+        const auto value_end = value.data() + value.size();
+        const auto [end, ec] = std::from_chars(value.data(), value_end, max_items);
+        if (ec != std::errc{} || end != value_end || max_items == 0)
+            return EVMC_SET_OPTION_INVALID_VALUE;
+        vm.enable_preexecution(max_items);
+        return EVMC_SET_OPTION_SUCCESS;
+    }
     else if (name == "trace")
     {
         vm.add_tracer(create_instruction_tracer(std::cerr));
@@ -57,6 +178,90 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
 }
 }
 
+void VM::begin_frame(ExecutionState& state, evmc_host_context* ctx) const noexcept
+{
+    // Pre-executed frames run against the RecordingHost, unknown to the host extensions.
+    state.host_ext = {host_extensions,
+        (m_access_recorder != nullptr) ? RecordingHost::get_wrapped_context(ctx) : ctx};
+    // Pre-execution must see all state accesses through its recording host.
+    state.native_words = native_words && m_access_recorder == nullptr;
+    state.precompiles = precompiles;
+    if (const auto* tx_context = get_tx_context(); tx_context != nullptr)
+        state.set_tx_context(*tx_context);
+    // Nested frames executed by the host keep the cancellation of their caller.
+    state.set_cancellation(
+        host_caller_cancellation != nullptr ? *host_caller_cancellation : m_cancellation);
+    state.storage_journal = m_storage_journal.get();
+    if (state.storage_journal != nullptr)
+    {
+        if (state.msg->depth == 0)
+            state.storage_journal->clear();
+        state.storage_checkpoint = state.storage_journal->checkpoint();
+    }
+    state.access_tracker = m_access_tracker.get();
+    if (state.access_tracker != nullptr)
+    {
+        if (state.msg->depth == 0)
+            state.access_tracker->clear();
+        state.access_checkpoint = state.access_tracker->checkpoint();
+    }
+    state.log_arena = (m_access_recorder == nullptr) ? m_log_arena.get() : nullptr;
+    if (state.log_arena != nullptr)
+    {
+        if (state.msg->depth == 0)
+            state.log_arena->clear();
+        state.log_checkpoint = state.log_arena->checkpoint();
+    }
+    state.gas_estimator = m_gas_estimator.get();
+    state.gas_required = 0;
+}
+
+void VM::end_frame(ExecutionState& state, evmc_status_code status) const noexcept
+{
+    if (auto* journal = state.storage_journal; journal != nullptr)
+    {
+        if (state.msg->depth == 0)
+        {
+            if (status == EVMC_SUCCESS)
+                journal->flush(state.host);
+            else
+                journal->clear();
+        }
+        else if (status != EVMC_SUCCESS)
+            journal->rollback(state.storage_checkpoint);
+    }
+    if (auto* tracker = state.access_tracker; tracker != nullptr)
+    {
+        if (state.msg->depth == 0)
+            tracker->clear();
+        else if (status != EVMC_SUCCESS)
+            tracker->rollback(state.access_checkpoint);
+    }
+    if (auto* arena = state.log_arena; arena != nullptr)
+    {
+        if (state.msg->depth == 0)
+        {
+            if (status == EVMC_SUCCESS)
+                arena->flush(state.host_ext);
+            else
+                arena->clear();
+        }
+        else if (status != EVMC_SUCCESS)
+            arena->rollback(state.log_checkpoint);
+    }
+    if (auto* estimator = state.gas_estimator; estimator != nullptr)
+    {
+        // A failed frame uses all its gas, so it needs all of it to fail the same way.
+        // A creation also needs the gas of its code deposit, charged afterwards by the host.
+        const auto ok = status == EVMC_SUCCESS || status == EVMC_REVERT;
+        const auto is_create = state.msg->kind == EVMC_CREATE || state.msg->kind == EVMC_CREATE2;
+        const auto code_size = (status == EVMC_SUCCESS && is_create) ? state.output_size : 0;
+        const auto gas_used = state.msg->gas - state.gas_left +
+                              static_cast<int64_t>(code_size) * GasEstimator::code_deposit_cost;
+        estimator->end_frame(ok ? std::max(state.gas_required, gas_used) : state.msg->gas);
+    }
+}
+
 inline constexpr VM::VM() noexcept
   : evmc_vm{
         EVMC_ABI_VERSION,
@@ -65,7 +270,7 @@ inline constexpr VM::VM() noexcept
         evm::destroy,
         evm::baseline::execute,
         evm::get_capabilities,
-        evmo::set_option,
+        evm::set_option,
     }
 {}
 }
@@ -75,4 +280,81 @@ EVMC_EXPORT evmc_vm* evmc_create_evm() noexcept
 {
     return new evm::VM{};
 }
+
+EVMC_EXPORT void evm_set_host_extensions(
+    evmc_vm* vm, const evm_host_extensions* extensions) noexcept
+{
+    static_cast<evm::VM*>(vm)->host_extensions = extensions;
+}
+
+EVMC_EXPORT size_t evm_get_preexecution_accounts(
+    evmc_vm* vm, const evmc_address** accounts) noexcept
+{
+    const auto* recorder = static_cast<evm::VM*>(vm)->get_access_recorder();
+    if (recorder == nullptr)
+        return 0;
+    *accounts = recorder->accounts().data();
+    return recorder->accounts().size();
+}
+
+EVMC_EXPORT size_t evm_get_preexecution_storage_keys(
+    evmc_vm* vm, const evm_storage_key** keys) noexcept
+{
+    static_assert(sizeof(evm::StorageKey) == sizeof(evm_storage_key));
+    static_assert(offsetof(evm::StorageKey, key) == offsetof(evm_storage_key, key));
+    const auto* recorder = static_cast<evm::VM*>(vm)->get_access_recorder();
+    if (recorder == nullptr)
+        return 0;
+    *keys = reinterpret_cast<const evm_storage_key*>(recorder->storage_keys().data());
+    return recorder->storage_keys().size();
+}
+
+EVMC_EXPORT int64_t evm_get_gas_estimate(evmc_vm* vm) noexcept
+{
+    const auto* estimator = static_cast<evm::VM*>(vm)->get_gas_estimator();
+    return (estimator != nullptr) ? estimator->estimate() : -1;
+}
+
+EVMC_EXPORT void evm_set_block_context(evmc_vm* vm, const evmc_tx_context* block) noexcept
+{
+    auto& evm = *static_cast<evm::VM*>(vm);
+    if (block != nullptr)
+        evm.set_block_context(*block);
+    else
+        evm.clear_block_context();
+}
+
+EVMC_EXPORT void evm_set_tx_context(evmc_vm* vm, const evmc_tx_context* tx) noexcept
+{
+    auto& evm = *static_cast<evm::VM*>(vm);
+    if (tx != nullptr)
+        evm.set_tx_context(*tx);
+    else
+        evm.clear_tx_context();
+}
+
+EVMC_EXPORT evm_cancellation_token* evm_create_cancellation_token() noexcept
+{
+    return new evm_cancellation_token{};
+}
+
+EVMC_EXPORT void evm_cancel(evm_cancellation_token* token) noexcept
+{
+    token->cancelled.store(true, std::memory_order_relaxed);
+}
+
+EVMC_EXPORT void evm_destroy_cancellation_token(evm_cancellation_token* token) noexcept
+{
+    delete token;
+}
+
+EVMC_EXPORT void evm_set_cancellation(
+    evmc_vm* vm, const evm_cancellation_token* token, uint64_t timeout_ns) noexcept
+{
+    using evm::Cancellation;
+    auto deadline = Cancellation::Clock::time_point::max();
+    if (timeout_ns != 0)
+        deadline = Cancellation::Clock::now() + std::chrono::nanoseconds{timeout_ns};
+    static_cast<evm::VM*>(vm)->set_cancellation({token, deadline});
+}
 }
\ No newline at end of file
@@ -1,7 +1,15 @@
 #pragma once
 
+#include "access_tracker.hpp"
+#include "cancellation.hpp"
+#include "gas_estimator.hpp"
+#include "log_arena.hpp"
+#include "preexecution.hpp"
+#include "storage_journal.hpp"
 #include "tracing.hpp"
+#include <evm/evm.h>
 #include <evmc/evmc.h>
+#include <memory>
 
 #if defined(_MSC_VER) && !defined(__clang__)
 #define EVM_CGOTO_SUPPORTED 0
@@ -11,12 +19,34 @@
 
 namespace evm
 {
+class ExecutionState;
+
 class VM : public evmc_vm
 {
 public:
     bool cgoto = EVM_CGOTO_SUPPORTED;
+    bool prefetch = false;
+    bool call_frames = false;
+    bool native_words = false;
+    bool precompiles = false;
+
+    /// Skip the gas accounting of the baseline interpreter, for trusted simulations.
+    bool unmetered = false;
+    const evm_host_extensions* host_extensions = nullptr;
+
+    /// The interpreter wrapped by preexecute() when pre-execution is enabled.
+    evmc_execute_fn preexecution_target = nullptr;
 private:
     std::unique_ptr<Tracer> m_first_tracer;
+    std::unique_ptr<StorageJournal> m_storage_journal;
+    std::unique_ptr<AccessTracker> m_access_tracker;
+    std::unique_ptr<LogArena> m_log_arena;
+    std::unique_ptr<AccessRecorder> m_access_recorder;
+    std::unique_ptr<GasEstimator> m_gas_estimator;
+    evmc_tx_context m_tx_context{};
+    Cancellation m_cancellation;
+    bool m_has_block_context = false;
+    bool m_has_tx_context = false;
 public:
     inline constexpr VM() noexcept;
     void add_tracer(std::unique_ptr<Tracer> tracer) noexcept
@@ -27,5 +57,124 @@ public:
         *end = std::move(tracer);
     }
     [[nodiscard]] Tracer* get_tracer() const noexcept { return m_first_tracer.get(); }
+
+    void set_storage_journal(bool enabled) noexcept
+    {
+        m_storage_journal = enabled ? std::make_unique<StorageJournal>() : nullptr;
+    }
+    [[nodiscard]] StorageJournal* get_storage_journal() const noexcept
+    {
+        return m_storage_journal.get();
+    }
+
+    void set_access_tracking(bool enabled) noexcept
+    {
+        m_access_tracker = enabled ? std::make_unique<AccessTracker>() : nullptr;
+    }
+
+    void set_log_batching(bool enabled) noexcept
+    {
+        m_log_arena = enabled ? std::make_unique<LogArena>() : nullptr;
+    }
+
+    void set_gas_estimation(bool enabled) noexcept
+    {
+        m_gas_estimator = enabled ? std::make_unique<GasEstimator>() : nullptr;
+    }
+
+    /// Returns the gas estimation of the last execution, null if not enabled.
+    [[nodiscard]] const GasEstimator* get_gas_estimator() const noexcept
+    {
+        return m_gas_estimator.get();
+    }
+
+    /// Switches to speculative pre-execution recording up to max_items accessed items.
+    void enable_preexecution(size_t max_items) noexcept
+    {
+        if (m_access_recorder == nullptr)
+        {
+            preexecution_target = execute;
+            execute = preexecute;
+        }
+        m_access_recorder = std::make_unique<AccessRecorder>(max_items);
+    }
+
+    void disable_preexecution() noexcept
+    {
+        if (m_access_recorder == nullptr)
+            return;
+        execute = preexecution_target;
+        preexecution_target = nullptr;
+        m_access_recorder.reset();
+    }
+
+    /// Returns the items recorded by the last pre-execution, null if not enabled.
+    [[nodiscard]] AccessRecorder* get_access_recorder() const noexcept
+    {
+        return m_access_recorder.get();
+    }
+
+    /// Installs the block part (block_* members and chain_id) of the context shared by
+    /// all frames. Invalidates the transaction part.
+    void set_block_context(const evmc_tx_context& block) noexcept
+    {
+        m_tx_context.block_coinbase = block.block_coinbase;
+        m_tx_context.block_number = block.block_number;
+        m_tx_context.block_timestamp = block.block_timestamp;
+        m_tx_context.block_gas_limit = block.block_gas_limit;
+        m_tx_context.block_prev_randao = block.block_prev_randao;
+        m_tx_context.chain_id = block.chain_id;
+        m_tx_context.block_base_fee = block.block_base_fee;
+        m_has_block_context = true;
+        m_has_tx_context = false;
+    }
+
+    /// Installs the transaction part (tx_* members) of the context shared by all frames.
+    void set_tx_context(const evmc_tx_context& tx) noexcept
+    {
+        m_tx_context.tx_gas_price = tx.tx_gas_price;
+        m_tx_context.tx_origin = tx.tx_origin;
+        m_has_tx_context = true;
+    }
+
+    /// Removes the shared context, both parts.
+    void clear_block_context() noexcept
+    {
+        m_has_block_context = false;
+        m_has_tx_context = false;
+    }
+
+    /// Removes the transaction part of the shared context.
+    void clear_tx_context() noexcept { m_has_tx_context = false; }
+
+    /// Returns the shared context if both parts are installed, null otherwise.
+    [[nodiscard]] const evmc_tx_context* get_tx_context() const noexcept
+    {
+        return (m_has_block_context && m_has_tx_context) ? &m_tx_context : nullptr;
+    }
+
+    /// Installs the cancellation token and the deadline of the next executions.
+    void set_cancellation(const Cancellation& cancellation) noexcept
+    {
+        m_cancellation = cancellation;
+    }
+
+    /// Returns the installed cancellation, to be copied by the executions starting.
+    [[nodiscard]] const Cancellation& get_cancellation() const noexcept { return m_cancellation; }
+
+    /// Returns true if no transaction-scoped feature is enabled, so that independent
+    /// messages can be executed concurrently.
+    [[nodiscard]] bool is_stateless() const noexcept
+    {
+        return m_first_tracer == nullptr && m_storage_journal == nullptr &&
+               m_access_tracker == nullptr && m_log_arena == nullptr &&
+               m_access_recorder == nullptr && m_gas_estimator == nullptr;
+    }
+
+    /// Attaches the transaction-scoped VM state to a new frame.
+    void begin_frame(ExecutionState& state, evmc_host_context* ctx) const noexcept;
+
+    /// Commits or drops the frame's changes to the transaction-scoped VM state.
+    void end_frame(ExecutionState& state, evmc_status_code status) const noexcept;
 };
 }
\ No newline at end of file
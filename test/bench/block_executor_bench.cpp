@@ -0,0 +1,120 @@
+#include "utils/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+#include <state/block_executor.hpp>
+
+using namespace evm::test;
+using evm::state::State;
+using evm::state::Transaction;
+
+namespace
+{
+constexpr size_t num_txs = 256;
+constexpr size_t num_pools = 16;
+constexpr evmc::address coinbase{0xc0b};
+constexpr evmc::address counter{0xc0};
+constexpr uint64_t base_fee = 7;
+
+evmc::address sender(size_t i) noexcept
+{
+    return evmc::address{0x10000 + i};
+}
+
+evmc::address pool(size_t i) noexcept
+{
+    return evmc::address{0x20000 + i};
+}
+
+void init(State& state)
+{
+    for (size_t i = 0; i < num_txs; ++i)
+        state.touch(sender(i)).balance = 1'000'000'000'000;
+    // SSTORE(0, SLOAD(0) + 1)
+    state.set_code(counter, "6000 54 6001 01 6000 55"_hex);
+    // A swap: SSTORE(0, SLOAD(0) + CALLVALUE) SSTORE(1, SLOAD(1) - 1), with some arithmetic.
+    for (size_t i = 0; i < num_pools; ++i)
+    {
+        state.set_code(pool(i), "6000 54 34 01 6000 55  6001 54 6001 90 03 6001 55"
+                                "6020 6000 20 6020 6000 20 18 50"_hex);
+        state.set_storage(pool(i), evmc::bytes32{1}, evmc::bytes32{1'000'000});
+    }
+    state.commit();
+}
+
+Transaction make_tx(size_t i, const evmc::address& recipient, uint64_t value, uint64_t tip)
+{
+    Transaction tx;
+    tx.sender = sender(i);
+    tx.recipient = recipient;
+    tx.value = value;
+    tx.gas_limit = 100'000;
+    tx.gas_price = base_fee + tip;
+    return tx;
+}
+
+/// Independent transfers, without or with a priority fee paid to the coinbase.
+std::vector<Transaction> transfers(uint64_t tip)
+{
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < num_txs; ++i)
+        txs.push_back(make_tx(i, evmc::address{0x30000 + i}, 1, tip));
+    return txs;
+}
+
+/// Swaps spread over a few pools.
+std::vector<Transaction> swaps(uint64_t tip)
+{
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < num_txs; ++i)
+        txs.push_back(make_tx(i, pool(i % num_pools), 1, tip));
+    return txs;
+}
+
+/// All transactions increment the same storage slot.
+std::vector<Transaction> contention(uint64_t tip)
+{
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < num_txs; ++i)
+        txs.push_back(make_tx(i, counter, 0, tip));
+    return txs;
+}
+
+/// Executes the block with the number of workers given by the argument.
+void execute_block(benchmark::State& bench_state,
+    std::vector<Transaction> (*workload)(uint64_t), uint64_t tip)
+{
+    const auto txs = workload(tip);
+    std::vector<evmc_vm*> vms;
+    for (int64_t i = 0; i < bench_state.range(0); ++i)
+        vms.push_back(evmc_create_evm());
+    evmc_tx_context tx_context{};
+    tx_context.block_coinbase = coinbase;
+    tx_context.block_base_fee = evmc::bytes32{base_fee};
+
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        bench_state.PauseTiming();
+        State state;
+        init(state);
+        bench_state.ResumeTiming();
+        const auto receipts =
+            evm::state::execute_block(vms, state, EVMC_SHANGHAI, tx_context, txs);
+        benchmark::DoNotOptimize(receipts.data());
+    }
+    bench_state.SetItemsProcessed(bench_state.iterations() * static_cast<int64_t>(num_txs));
+    for (auto* vm : vms)
+        vm->destroy(vm);
+}
+
+void worker_counts(benchmark::internal::Benchmark* bench)
+{
+    for (int64_t n = 1; n <= 8; n *= 2)
+        bench->Arg(n);
+    bench->UseRealTime()->Unit(benchmark::kMicrosecond);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(execute_block, transfers, transfers, 0)->Apply(worker_counts);
+BENCHMARK_CAPTURE(execute_block, transfers_tipped, transfers, 2)->Apply(worker_counts);
+BENCHMARK_CAPTURE(execute_block, swaps, swaps, 0)->Apply(worker_counts);
+BENCHMARK_CAPTURE(execute_block, contention, contention, 0)->Apply(worker_counts);
@@ -0,0 +1,63 @@
+#include "utils/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+#include <evmc/instructions.h>
+#include <state/host.hpp>
+#include <algorithm>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address caller{0xc0de};
+constexpr evmc::address callee{0xca11};
+
+/// Executes a contract calling a trivial callee the number of times given by the first argument,
+/// with nested calls run by the host recursively or by the VM on its frame stack. The code of
+/// the callee is padded to the size given by the second argument, which its analysis scans.
+void execute_calls(benchmark::State& bench_state, const char* call_frames)
+{
+    // i = n; do { CALL(GAS, callee, 0, 0, 0, 0, 0) POP; i -= 1 } while (i != 0)
+    const auto num_calls = static_cast<uint16_t>(bench_state.range(0));
+    auto code = "61"_hex + bytes{static_cast<uint8_t>(num_calls >> 8),
+                               static_cast<uint8_t>(num_calls)};
+    code += "5b 6000 6000 6000 6000 6000 61ca11 5a f1 50  6001 90 03  80 6003 57"_hex;
+
+    evm::state::State state;
+    state.set_code(caller, code);
+    auto callee_code = "6001 6000 52 00"_hex;  // MSTORE(0, 1) STOP
+    callee_code.resize(std::max(callee_code.size(), static_cast<size_t>(bench_state.range(1))),
+        OP_JUMPDEST);
+    state.set_code(callee, callee_code);
+    state.commit();
+
+    auto* vm = evmc_create_evm();
+    evm_set_host_extensions(vm, &evm::state::Host::extensions);
+    vm->set_option(vm, "call_frames", call_frames);
+
+    evmc_message msg{};
+    msg.gas = 100'000'000;
+    msg.recipient = caller;
+    msg.code_address = caller;
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::state::Host host{vm, state, EVMC_SHANGHAI, {}};
+        const auto result = host.call(msg);
+        if (result.status_code != EVMC_SUCCESS)
+            bench_state.SkipWithError("execution failed");
+        state.commit();
+    }
+    vm->destroy(vm);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(execute_calls, host, "no")
+    ->Args({100, 0})
+    ->Args({1000, 0})
+    ->Args({1000, 4096})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_calls, call_frames, "yes")
+    ->Args({100, 0})
+    ->Args({1000, 0})
+    ->Args({1000, 4096})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,154 @@
+#include "utils/utils.hpp"
+#include <baseline_dispatch.hpp>
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+#include <state/host.hpp>
+#include <vm.hpp>
+#include <array>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address contract{0xc0de};
+
+// i = 1000; do { k = i & 7; SSTORE(k, SLOAD(k) + i); BALANCE(i) POP; i -= 1 } while (i != 0)
+const auto host_loop_code =
+    "6103e8  5b 80 6007 16 80 54 82 01 90 55  80 31 50  6001 90 03  80 6003 57 00"_hex;
+
+/// A host of a single contract with 256 storage slots, keyed by the last byte of the key,
+/// and no other accounts. Its methods are defined inline, so that the interpreter calling it
+/// directly can inline them.
+class InlineHost final : public evmc::Host
+{
+    std::array<evmc::bytes32, 256> m_storage{};
+
+public:
+    bool account_exists(const evmc::address& /*addr*/) const noexcept override { return false; }
+
+    evmc::bytes32 get_storage(
+        const evmc::address& /*addr*/, const evmc::bytes32& key) const noexcept override
+    {
+        return m_storage[key.bytes[31]];
+    }
+
+    evmc_storage_status set_storage(const evmc::address& /*addr*/, const evmc::bytes32& key,
+        const evmc::bytes32& value) noexcept override
+    {
+        m_storage[key.bytes[31]] = value;
+        return EVMC_STORAGE_ASSIGNED;
+    }
+
+    evmc::uint256be get_balance(const evmc::address& /*addr*/) const noexcept override
+    {
+        return {};
+    }
+
+    size_t get_code_size(const evmc::address& /*addr*/) const noexcept override { return 0; }
+
+    evmc::bytes32 get_code_hash(const evmc::address& /*addr*/) const noexcept override
+    {
+        return {};
+    }
+
+    size_t copy_code(const evmc::address& /*addr*/, size_t /*code_offset*/,
+        uint8_t* /*buffer_data*/, size_t /*buffer_size*/) const noexcept override
+    {
+        return 0;
+    }
+
+    bool selfdestruct(
+        const evmc::address& /*addr*/, const evmc::address& /*beneficiary*/) noexcept override
+    {
+        return false;
+    }
+
+    evmc::Result call(const evmc_message& /*msg*/) noexcept override
+    {
+        return evmc::Result{EVMC_REVERT};
+    }
+
+    evmc_tx_context get_tx_context() const noexcept override { return {}; }
+
+    evmc::bytes32 get_block_hash(int64_t /*block_number*/) const noexcept override { return {}; }
+
+    void emit_log(const evmc::address& /*addr*/, const uint8_t* /*data*/, size_t /*data_size*/,
+        const evmc::bytes32 /*topics*/[], size_t /*num_topics*/) noexcept override
+    {}
+
+    evmc_access_status access_account(const evmc::address& /*addr*/) noexcept override
+    {
+        return EVMC_ACCESS_WARM;
+    }
+
+    evmc_access_status access_storage(
+        const evmc::address& /*addr*/, const evmc::bytes32& /*key*/) noexcept override
+    {
+        return EVMC_ACCESS_WARM;
+    }
+};
+
+/// The host of an in-memory state, called directly by the interpreter.
+class StateHost final : public evm::state::Host
+{
+public:
+    using Host::Host;
+};
+
+/// Executes the host loop through the evmc C ABI or with the host called directly
+/// by the interpreter instantiated for HostT. Both analyze the code on every execution.
+template <typename HostT>
+void execute_host_loop(benchmark::State& bench_state, HostT& host, evmc_vm* vm, bool direct)
+{
+    constexpr auto rev = EVMC_SHANGHAI;
+    const auto& code = host_loop_code;
+    evmc_message msg{};
+    msg.gas = 10'000'000;
+    msg.recipient = contract;
+    msg.code_address = contract;
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evmc::Result result;
+        if (direct)
+        {
+            const auto analysis = evm::baseline::analyze(rev, code);
+            const auto state = std::make_unique<evm::ExecutionState>(
+                msg, rev, host.get_interface(), host.to_context(), code);
+            result = evmc::Result{evm::baseline::execute<HostT>(
+                *static_cast<evm::VM*>(vm), *state, analysis)};
+        }
+        else
+        {
+            result = evmc::Result{vm->execute(vm, &host.get_interface(), host.to_context(), rev,
+                &msg, code.data(), code.size())};
+        }
+        if (result.status_code != EVMC_SUCCESS)
+            bench_state.SkipWithError("execution failed");
+    }
+}
+
+void inline_host(benchmark::State& bench_state, bool direct)
+{
+    auto* vm = evmc_create_evm();
+    InlineHost host;
+    execute_host_loop(bench_state, host, vm, direct);
+    vm->destroy(vm);
+}
+
+void state_host(benchmark::State& bench_state, bool direct)
+{
+    evm::state::State state;
+    state.set_code(contract, host_loop_code);
+    state.commit();
+
+    auto* vm = evmc_create_evm();
+    StateHost host{vm, state, EVMC_SHANGHAI, {}};
+    execute_host_loop(bench_state, host, vm, direct);
+    vm->destroy(vm);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(inline_host, c_abi, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(inline_host, direct, true)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(state_host, c_abi, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(state_host, direct, true)->Unit(benchmark::kMicrosecond);
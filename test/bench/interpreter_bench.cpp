@@ -0,0 +1,91 @@
+#include "utils/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+#include <state/host.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address contract{0xc0de};
+
+/// Executes an arithmetic loop of 10000 iterations in the revision, with the interpreter loop
+/// specialized for it or the one taking the costs from the revision's table at run time,
+/// metered or not.
+void execute_loop(
+    benchmark::State& bench_state, evmc_revision rev, const char* cgoto, const char* unmetered)
+{
+    // i = 10000; x = 1; do { x = x * 3 + i; x ^= i << 2; i -= 1 } while (i != 0)
+    const auto code =
+        "612710 6001  5b 6003 02 81 01 81 6002 1b 18  90 6001 90 03 90  81 6005 57 00"_hex;
+
+    evm::state::State state;
+    state.set_code(contract, code);
+    state.commit();
+
+    auto* vm = evmc_create_evm();
+    vm->set_option(vm, "cgoto", cgoto);
+    vm->set_option(vm, "unmetered", unmetered);
+
+    evmc_message msg{};
+    msg.gas = 10'000'000;
+    msg.recipient = contract;
+    msg.code_address = contract;
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::state::Host host{vm, state, rev, {}};
+        const auto result = evmc::Result{vm->execute(vm, &host.get_interface(),
+            host.to_context(), rev, &msg, code.data(), code.size())};
+        if (result.status_code != EVMC_SUCCESS)
+            bench_state.SkipWithError("execution failed");
+    }
+    vm->destroy(vm);
+}
+
+/// Executes a loop of 10000 iterations of 32 JUMPDESTs, with or without a cancellation token
+/// checked at every JUMPDEST.
+void execute_jumpdests(benchmark::State& bench_state, bool cancellable)
+{
+    // i = 10000; do { JUMPDEST x 32; i -= 1 } while (i != 0)
+    const auto code = "612710  5b"_hex + bytes(32, 0x5b) + "6001 90 03  80 6003 57 00"_hex;
+
+    evm::state::State state;
+    state.set_code(contract, code);
+    state.commit();
+
+    auto* vm = evmc_create_evm();
+    auto* token = evm_create_cancellation_token();
+    if (cancellable)
+        evm_set_cancellation(vm, token, 0);
+
+    evmc_message msg{};
+    msg.gas = 10'000'000;
+    msg.recipient = contract;
+    msg.code_address = contract;
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::state::Host host{vm, state, EVMC_SHANGHAI, {}};
+        const auto result = evmc::Result{vm->execute(vm, &host.get_interface(),
+            host.to_context(), EVMC_SHANGHAI, &msg, code.data(), code.size())};
+        if (result.status_code != EVMC_SUCCESS)
+            bench_state.SkipWithError("execution failed");
+    }
+    vm->destroy(vm);
+    evm_destroy_cancellation_token(token);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(execute_loop, shanghai_switch, EVMC_SHANGHAI, "no", "no")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_loop, shanghai_cgoto, EVMC_SHANGHAI, "yes", "no")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_loop, london_switch, EVMC_LONDON, "no", "no")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_loop, london_cgoto, EVMC_LONDON, "yes", "no")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_loop, unmetered_switch, EVMC_SHANGHAI, "no", "yes")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_loop, unmetered_cgoto, EVMC_SHANGHAI, "yes", "yes")
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_jumpdests, plain, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(execute_jumpdests, cancellable, true)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,227 @@
+#include "utils/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+#include <intx/intx.hpp>
+#include <precompiles/blake2b.hpp>
+#include <precompiles/bn254.hpp>
+#include <precompiles/modexp.hpp>
+#include <precompiles/precompiles.hpp>
+#include <precompiles/ripemd160.hpp>
+#include <precompiles/sha256.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+void input_sizes(benchmark::internal::Benchmark* bench)
+{
+    for (int64_t size = 32; size <= 16384; size *= 8)
+        bench->Arg(size);
+}
+
+/// Hashes an input of the size given by the argument, with the SHA extensions or not.
+void sha256(benchmark::State& bench_state, bool sha_ni)
+{
+    if (evm::precompiles::sha256_use_sha_ni(sha_ni) != sha_ni)
+    {
+        bench_state.SkipWithError("no SHA extensions");
+        return;
+    }
+    const bytes input(static_cast<size_t>(bench_state.range(0)), 0xa5);
+    uint8_t hash[32];
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::precompiles::sha256(hash, input.data(), input.size());
+        benchmark::DoNotOptimize(hash);
+    }
+    bench_state.SetBytesProcessed(bench_state.iterations() * bench_state.range(0));
+    evm::precompiles::sha256_use_sha_ni(true);
+}
+
+void ripemd160(benchmark::State& bench_state)
+{
+    const bytes input(static_cast<size_t>(bench_state.range(0)), 0xa5);
+    uint8_t hash[20];
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::precompiles::ripemd160(hash, input.data(), input.size());
+        benchmark::DoNotOptimize(hash);
+    }
+    bench_state.SetBytesProcessed(bench_state.iterations() * bench_state.range(0));
+}
+
+/// Computes base^exp mod mod with the 32-byte exponent and the operands of the size given by
+/// the argument, for an odd modulus or an even one, split by the CRT.
+void modexp(benchmark::State& bench_state, bool odd)
+{
+    const auto size = static_cast<size_t>(bench_state.range(0));
+    const bytes base(size, 0xa5);
+    const bytes exp(32, 0x5a);
+    bytes mod(size, 0xc3);
+    mod[size - 1] = odd ? 0x01 : 0x10;
+    bytes result(size, 0);
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::precompiles::modexp(result.data(), base, exp, 0, mod);
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+/// Applies BLAKE2F with the number of rounds given by the argument, with AVX2 or not.
+void blake2b(benchmark::State& bench_state, bool avx2)
+{
+    if (evm::precompiles::blake2b_use_avx2(avx2) != avx2)
+    {
+        bench_state.SkipWithError("no AVX2");
+        return;
+    }
+    const auto rounds = static_cast<uint32_t>(bench_state.range(0));
+    uint64_t h[8]{};
+    uint64_t m[16]{};
+    const uint64_t t[2]{128, 0};
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::precompiles::blake2b_compress(rounds, h, m, t, true);
+        benchmark::DoNotOptimize(h);
+    }
+    bench_state.SetItemsProcessed(bench_state.iterations() * bench_state.range(0));
+    evm::precompiles::blake2b_use_avx2(true);
+}
+
+/// Recovers the signers of 256 signatures with the number of threads given by the argument.
+void ecrecover_batch(benchmark::State& bench_state)
+{
+    // keccak256("message 0") signed by the private key 1.
+    evm_ecdsa_signature sig{};
+    const auto hash = "06eaaa302366a2b8e60080fe649cb019814b843b9bd681df41d60bde4badd379"_hex;
+    const auto r = "0b5de7a00c0f71e9d9611e3f11a2470e17b3b5afa5f277391796804175964819"_hex;
+    const auto s = "00cf1aef568eff65c6324e31e3492343fd9a721cb6be2db64f6274251fede285"_hex;
+    std::copy(hash.begin(), hash.end(), sig.hash.bytes);
+    std::copy(r.begin(), r.end(), sig.r.bytes);
+    std::copy(s.begin(), s.end(), sig.s.bytes);
+    const std::vector<evm_ecdsa_signature> signatures(256, sig);
+    std::vector<evmc_address> addresses(signatures.size());
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        if (evm_ecrecover_batch(signatures.data(), signatures.size(),
+                static_cast<size_t>(bench_state.range(0)),
+                addresses.data()) != signatures.size())
+            bench_state.SkipWithError("invalid signature");
+    }
+    bench_state.SetItemsProcessed(
+        bench_state.iterations() * static_cast<int64_t>(signatures.size()));
+}
+
+#if EVM_BN254_SUPPORTED
+/// A Groth16 verifying key with 2 public inputs and a proof, as passed to the precompiles by
+/// a Solidity verifier. Generated with py_ecc from known scalars.
+namespace groth16
+{
+const auto ic0 =
+    "02c36e209cc1933e1f70ba705a4a1c5cfe53f1694830067a7977b901102e8352"
+    "019c23ecb653dc261b5f825294a2d22cdce3dc70696aebf5d0f42fb46f76667a"_hex;
+const bytes ic[] = {
+    "250dd705efec189ef8c1d5f7d7581fe4b9c097b652c9989dc00f87cc85f95c92"
+    "1ba05287b0eed37a06c24bdb25d4c795629cb714872e726de79e4bcbc98d6ac1"_hex,
+    "12095f348b250f7c1a62fc60c1863aacaf364d6a84f8fe91905848cca36a9cb4"
+    "1618789b7534b4c29a1006ea1d921b485cc9923deaee54fb49f52d6ac778049a"_hex,
+};
+const bytes inputs[] = {
+    "0000000000000000000000000000000000000000000000000000000000bc614e"_hex,
+    "0000000000000000000000000000000000000000000000000000000005397fb1"_hex,
+};
+const auto a =
+    "0a075562da36db1c17df8514aca09f45f95bc7f8c8800e6502d11d814df32ecf"
+    "035434641ca6c6e05ca3c643e6ca8ab8e3178dcd956bd8ea4ac6370b1b8537ec"_hex;
+const auto b =
+    "2b50fe43717ea3e4e94c9f19f5a5728036ec8b3b54c5b44278d39a42f5f56fe6"
+    "162d36215bc76a30d8ebe0f924da8338805c03c704911278e685ae2662988362"
+    "1e50ccfd24b4a7ba5c9f084d5eee06758cc2d4391db8568afb5107c5a3b3127e"
+    "0a2aca730a4b5db7ed655702635352bf149be82be7d5f0b53db1e26328d80115"_hex;
+const auto alpha_neg =
+    "12d4ad67815bdc07c0e4de757c967e515c5faf94ac03b51e0baa6a4e717e90e0"
+    "2170b87fbdb5a3c35b8c1d07a1d106ee9d1af2156c1d6e320ea48fdb96e5c243"_hex;
+const auto beta =
+    "12a846d8dcf374008e596fea1e9c7f852c2ba937a071c52a5c66b6bb316a4b07"
+    "224cfdd7f57c4091a9f9460833cd3f5d09612627950ddc0d145d90e5b0837834"
+    "19b5ce9792350356a0492107213dc6a88fa35f88ee5cb798c5c0bac5fd6d851a"
+    "0286894e80b1f069fb37fb472719f663c719e0f6f062b2a6a3c9ea1882626588"_hex;
+const auto gamma =
+    "09f8c4289d7d895ae3ad80b6552993f0fcc93c716aa555e08a2ca00dfee0728f"
+    "2959604ad69d88a344a0d26a71ef174ba86f60b66f7c4f7e97cd91d1e3b12b62"
+    "0efa17a8bab1c0c29ed8ad6657a10e2edad7f7accc376267ff22ced71b563802"
+    "04a769ad65790669a960819ea35088977b9639277dda24a5114bd75d3f595666"_hex;
+const auto c_neg =
+    "1da5e88880950dfd32d466e7ea0c809cfc8ecd48f4a8a171528cf04979ec71f3"
+    "12fe48a68bd9caad06696042da1f576a88b86f91b8fe52e43bcf7187c6646cea"_hex;
+const auto delta =
+    "032da4f4e25341ffd1e4d0d0229992193d8bf16c9afb24a75688629d73b7762d"
+    "26a4123c0faf74907f48037516c4876eeea3b6f95d0bb14218e6b884f347ac0a"
+    "09c95ee6188a74fdfc8b64a6424e4eaaab8cdab671707bc0849ee5bf60ea8a79"
+    "253a75545516a6240786afda50727d63478d16df8b682de50971325b2aad268d"_hex;
+const auto field_modulus = intx::be::unsafe::load<intx::uint256>(
+    "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47"_hex.data());
+
+/// Verifies the proof as the verifier contract: vk_x = IC0 + sum(input_i IC_i), then
+/// e(A, B) e(-alpha, beta) e(-vk_x, gamma) e(-C, delta) == 1.
+bool verify() noexcept
+{
+    const auto call = [](uint8_t id, const bytes& input, bytes& output) noexcept {
+        return evm::precompiles::execute(EVMC_SHANGHAI, evmc::address{id}, input, 1'000'000,
+                   output)
+                   ->status_code == EVMC_SUCCESS;
+    };
+    auto vk_x = ic0;
+    bytes product;
+    for (size_t i = 0; i < std::size(ic); ++i)
+    {
+        if (!call(0x07, ic[i] + inputs[i], product) || !call(0x06, vk_x + product, vk_x))
+            return false;
+    }
+    const auto y = intx::be::unsafe::load<intx::uint256>(&vk_x[32]);
+    intx::be::unsafe::store(&vk_x[32], field_modulus - y);
+
+    bytes result;
+    return call(0x08, a + b + alpha_neg + beta + vk_x + gamma + c_neg + delta, result) &&
+           result.back() == 1;
+}
+}  // namespace groth16
+
+/// Verifies a Groth16 proof with the ADX or the generic implementation.
+void groth16_verify(benchmark::State& bench_state, bool adx)
+{
+    if (evm::precompiles::bn254_use_adx(adx) != adx)
+    {
+        bench_state.SkipWithError("no BMI2 and ADX");
+        return;
+    }
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        if (!groth16::verify())
+            bench_state.SkipWithError("verification failed");
+    }
+    evm::precompiles::bn254_use_adx(true);
+}
+#endif
+}  // namespace
+
+BENCHMARK_CAPTURE(sha256, sha_ni, true)->Apply(input_sizes);
+BENCHMARK_CAPTURE(sha256, portable, false)->Apply(input_sizes);
+BENCHMARK(ripemd160)->Apply(input_sizes);
+BENCHMARK_CAPTURE(modexp, odd, true)
+    ->RangeMultiplier(2)
+    ->Range(32, 512)
+    ->Arg(520)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(modexp, even, false)
+    ->RangeMultiplier(2)
+    ->Range(32, 512)
+    ->Arg(520)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(blake2b, avx2, true)->Arg(12)->Arg(1000);
+BENCHMARK_CAPTURE(blake2b, generic, false)->Arg(12)->Arg(1000);
+BENCHMARK(ecrecover_batch)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMicrosecond);
+#if EVM_BN254_SUPPORTED
+BENCHMARK_CAPTURE(groth16_verify, adx, true)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(groth16_verify, generic, false)->Unit(benchmark::kMicrosecond);
+#endif
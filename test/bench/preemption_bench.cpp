@@ -0,0 +1,90 @@
+#include "utils/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+#include <state/host.hpp>
+#include <chrono>
+#include <deque>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address router{0x7007e7};
+constexpr evmc::address pool{0x9001};
+constexpr evmc::address getter{0x6e77e7};
+constexpr size_t num_short_calls = 16;
+
+evmc_message make_message(const evmc::address& recipient) noexcept
+{
+    evmc_message msg{};
+    msg.gas = 10'000'000;
+    msg.recipient = recipient;
+    msg.code_address = recipient;
+    return msg;
+}
+
+/// Schedules a heavy view call, whose loop runs in a callee of a router, and short calls
+/// queued behind it round-robin on one thread, with the gas slice given by the argument.
+/// Reports the mean latency of the short calls.
+void schedule_round_robin(benchmark::State& bench_state)
+{
+    evm::state::State state;
+    // i = 100000; do { i -= 1 } while (i != 0)
+    state.set_code(pool, "62 0186a0 5b 6001 90 03 80 6004 57 50"_hex);
+    // CALL(GAS, pool, 0, 0, 0, 0, 0)
+    state.set_code(router, "6000 6000 6000 6000 6000 619001 5a f1"_hex);
+    state.set_code(getter, "6001 6000 52 6020 6000 f3"_hex);  // MSTORE(0, 1) RETURN(0, 32)
+    state.commit();
+
+    auto* vm = evmc_create_evm();
+    evm_set_host_extensions(vm, &evm::state::Host::extensions);
+    vm->set_option(vm, "call_frames", "yes");
+    const auto router_code = state.find(router)->get_code();
+    const auto getter_code = state.find(getter)->get_code();
+    const auto router_msg = make_message(router);
+    const auto getter_msg = make_message(getter);
+
+    double total_latency = 0;
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::state::Host host{vm, state, EVMC_SHANGHAI, {}};
+        const auto start = std::chrono::steady_clock::now();
+        const auto create = [&](const evmc_message& msg, bytes_view code) noexcept {
+            auto* execution = evm_create_execution(vm, &host.get_interface(), host.to_context(),
+                EVMC_SHANGHAI, &msg, code.data(), code.size());
+            evm_set_execution_slice(execution, bench_state.range(0));
+            return execution;
+        };
+        std::deque<std::pair<evm_execution*, bool>> queue;  // The executions, is short.
+        queue.emplace_back(create(router_msg, router_code), false);
+        for (size_t i = 0; i < num_short_calls; ++i)
+            queue.emplace_back(create(getter_msg, getter_code), true);
+
+        while (!queue.empty())
+        {
+            const auto [execution, is_short] = queue.front();
+            queue.pop_front();
+            evmc_result raw_result{};
+            if (evm_run_execution(execution, &raw_result) != EVM_EXECUTION_DONE)
+            {
+                queue.emplace_back(execution, is_short);
+                continue;
+            }
+            const evmc::Result result{raw_result};
+            if (result.status_code != EVMC_SUCCESS)
+                bench_state.SkipWithError("execution failed");
+            if (is_short)
+            {
+                const auto latency = std::chrono::steady_clock::now() - start;
+                total_latency += std::chrono::duration<double, std::micro>(latency).count();
+            }
+            evm_destroy_execution(execution);
+        }
+    }
+    bench_state.counters["short_latency_us"] =
+        total_latency / static_cast<double>(bench_state.iterations() * num_short_calls);
+    vm->destroy(vm);
+}
+}  // namespace
+
+BENCHMARK(schedule_round_robin)->Arg(0)->Arg(100'000)->Arg(10'000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,98 @@
+#include "utils/latent_host.hpp"
+#include "utils/utils.hpp"
+#include <benchmark/benchmark.h>
+#include <evm/evm.h>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address contract{0xc0de};
+constexpr auto latency = std::chrono::microseconds{100};
+
+/// Creates a state with the contract SLOADing the num_slots slots.
+evm::state::State make_state(size_t num_slots)
+{
+    bytes code;
+    for (size_t i = 0; i < num_slots; ++i)
+        code += bytes{0x60, static_cast<uint8_t>(i), 0x54, 0x50};  // SLOAD(i)
+    evm::state::State state;
+    state.set_code(contract, code);
+    for (size_t i = 0; i < num_slots; ++i)
+        state.set_storage(contract, evmc::bytes32{i}, evmc::bytes32{i + 1});
+    state.commit();
+    return state;
+}
+
+evmc_message make_message() noexcept
+{
+    evmc_message msg{};
+    msg.gas = 10'000'000;
+    msg.recipient = contract;
+    msg.code_address = contract;
+    return msg;
+}
+
+evmc::Result execute(evmc_vm* vm, evmc::Host& host, evm::state::State& state,
+    const evmc_message& msg) noexcept
+{
+    const auto code = state.find(contract)->get_code();
+    return evmc::Result{vm->execute(vm, &host.get_interface(), host.to_context(), EVMC_SHANGHAI,
+        &msg, code.data(), code.size())};
+}
+
+/// Executes the message against the latent host, blocking on every cold state item.
+void execute_blocking(benchmark::State& bench_state)
+{
+    auto state = make_state(static_cast<size_t>(bench_state.range(0)));
+    auto* vm = evmc_create_evm();
+    const auto msg = make_message();
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        LatentHost host{vm, state, EVMC_SHANGHAI, {}, latency};
+        if (execute(vm, host, state, msg).status_code != EVMC_SUCCESS)
+            bench_state.SkipWithError("execution failed");
+    }
+    vm->destroy(vm);
+}
+
+/// Pre-executes the message against an in-memory snapshot, starts the loads of the recorded
+/// items concurrently and then executes the message against the latent host.
+void execute_preexecuted(benchmark::State& bench_state)
+{
+    auto state = make_state(static_cast<size_t>(bench_state.range(0)));
+    auto snapshot = make_state(static_cast<size_t>(bench_state.range(0)));
+    auto* vm = evmc_create_evm();
+    auto* prevm = evmc_create_evm();
+    prevm->set_option(prevm, "preexecution", "1024");
+    const auto msg = make_message();
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        evm::state::Host snapshot_host{prevm, snapshot, EVMC_SHANGHAI, {}};
+        execute(prevm, snapshot_host, snapshot, msg);
+
+        LatentHost host{vm, state, EVMC_SHANGHAI, {}, latency};
+        const evmc_address* accounts = nullptr;
+        const auto num_accounts = evm_get_preexecution_accounts(prevm, &accounts);
+        for (size_t i = 0; i < num_accounts; ++i)
+            host.request_state(EVM_STATE_BALANCE, accounts[i], nullptr);
+        const evm_storage_key* keys = nullptr;
+        const auto num_keys = evm_get_preexecution_storage_keys(prevm, &keys);
+        for (size_t i = 0; i < num_keys; ++i)
+        {
+            host.request_state(EVM_STATE_STORAGE, keys[i].address,
+                static_cast<const evmc::bytes32*>(&keys[i].key));
+        }
+        while (host.has_pending_loads())
+            host.complete_next_load();
+
+        if (execute(vm, host, state, msg).status_code != EVMC_SUCCESS)
+            bench_state.SkipWithError("execution failed");
+    }
+    prevm->destroy(prevm);
+    vm->destroy(vm);
+}
+}  // namespace
+
+BENCHMARK(execute_blocking)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+BENCHMARK(execute_preexecuted)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,48 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class access_tracking : public vm_fixture
+{
+protected:
+    /// Executes the code with and without access tracking and checks the gas used is the same.
+    void expect_same_gas(bytes_view code)
+    {
+        constexpr evmc::address untracked{0x1001};
+        constexpr evmc::address tracked{0x1002};
+        deploy(untracked, code);
+        deploy(tracked, code);
+
+        set_option("access_tracking", "no");
+        const auto expected = transact(untracked);
+        set_option("access_tracking");
+        const auto receipt = transact(tracked);
+        EXPECT_EQ(receipt.status, expected.status);
+        EXPECT_EQ(receipt.gas_used, expected.gas_used);
+    }
+};
+}  // namespace
+
+TEST_F(access_tracking, repeated_accesses)
+{
+    // BALANCE(0xbeef) twice, SLOAD(1) twice, EXTCODESIZE(0xbeef).
+    expect_same_gas("61beef 31 50  61beef 31 50  6001 54 50  6001 54 50  61beef 3b 50"_hex);
+}
+
+TEST_F(access_tracking, accesses_of_reverted_call_are_cold)
+{
+    // BALANCE(0xbeef) REVERT(0, 0)
+    deploy(evmc::address{0xca11}, "61beef 31 50  6000 6000 fd"_hex);
+    // CALL(GAS, 0xca11, 0, 0, 0, 0, 0) BALANCE(0xbeef)
+    expect_same_gas("6000 6000 6000 6000 6000 61ca11 5a f1 50  61beef 31 50"_hex);
+}
+
+TEST_F(access_tracking, accesses_of_failed_deployment_are_cold)
+{
+    // Init code: BALANCE(0xbeef) MSTORE8(0, 0xef) RETURN(0, 1), rejected by EIP-3541.
+    // Caller: MSTORE(0, init code) CREATE(0, 32 - 15, 15) BALANCE(0xbeef)
+    expect_same_gas(
+        "6e 61beef3150 60ef600053 60016000f3  6000 52  600f 6011 6000 f0 50  61beef 31 50"_hex);
+}
@@ -0,0 +1,66 @@
+#include "utils/utils.hpp"
+#include <evm/evm.h>
+#include <gtest/gtest.h>
+#include <state/host.hpp>
+#include <thread>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr size_t num_messages = 256;
+
+/// Executes the messages, each hashing its input, in a batch and returns the outputs.
+std::vector<bytes> execute_batch(evmc_vm* vm, size_t num_threads)
+{
+    // CALLDATACOPY(0, 0, CALLDATASIZE) MSTORE(0, KECCAK256(0, CALLDATASIZE)) RETURN(0, 32)
+    static const auto code = "36 6000 6000 37  36 6000 20 6000 52  6020 6000 f3"_hex;
+    std::vector<bytes> inputs(num_messages);
+    std::vector<evmc_message> msgs(num_messages);
+    std::vector<evm_batch_message> batch(num_messages);
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        inputs[i] = bytes(i % 100 + 1, static_cast<uint8_t>(i));
+        msgs[i].gas = 100'000;
+        msgs[i].input_data = inputs[i].data();
+        msgs[i].input_size = inputs[i].size();
+        batch[i] = {&msgs[i], code.data(), code.size()};
+    }
+
+    evm::state::State state;
+    evm::state::Host host{vm, state, EVMC_SHANGHAI, {}};
+    std::vector<evmc_result> results(num_messages);
+    EXPECT_TRUE(evm_execute_batch(vm, &host.get_interface(), host.to_context(), EVMC_SHANGHAI,
+        batch.data(), num_messages, num_threads, results.data(), nullptr));
+
+    std::vector<bytes> outputs;
+    for (auto& r : results)
+    {
+        const evmc::Result result{r};
+        EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+        outputs.emplace_back(result.output_data, result.output_size);
+    }
+    return outputs;
+}
+}  // namespace
+
+TEST(batch, concurrent_batches_on_one_vm)
+{
+    auto* vm = evmc_create_evm();
+    const auto expected = execute_batch(vm, 1);
+
+    // The batches run with different numbers of workers, so that each one would grow
+    // worker states shared by the VM.
+    for (int i = 0; i < 20; ++i)
+    {
+        std::vector<bytes> outputs[4];
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; ++t)
+            threads.emplace_back([&, t] { outputs[t] = execute_batch(vm, t + 2); });
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& o : outputs)
+            EXPECT_EQ(o, expected);
+    }
+    vm->destroy(vm);
+}
@@ -0,0 +1,153 @@
+#include "utils/utils.hpp"
+#include <gtest/gtest.h>
+#include <precompiles/blake2b.hpp>
+#include <precompiles/precompiles.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+/// The state h of the first block of BLAKE2b-512, from EIP-152.
+const auto h =
+    "48c9bdf267e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5"
+    "d182e6ad7f520e511f6c3e2b8c68059b6bbd41fbabd9831f79217e1319cde05b"_hex;
+
+/// The results of F with the numbers of rounds around the permutation schedule of 10 rounds,
+/// for the message of bytes i * 7 + 1 and the offset 128, from a Python implementation.
+struct
+{
+    uint32_t rounds;
+    bool last;
+    const char* h;
+} constexpr vectors[] = {
+    {0, true,
+        "08c9bcf367e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5"
+        "5182e6ad7f520e511f6c3e2b8c68059b9442be0454267ce079217e1319cde05b"},
+    {0, false,
+        "08c9bcf367e6096a3ba7ca8485ae67bb2bf894fe72f36e3cf1361d5f3af54fa5"
+        "5182e6ad7f520e511f6c3e2b8c68059b6bbd41fbabd9831f79217e1319cde05b"},
+    {1, true,
+        "bfe59c102c73bb5bdf0bbb9f99b18cf761cf69f263230c86ba921bedd5470cce"
+        "441b070db86af1362ffe272bd74ff20b275aebd487f5b4af3c08cd28cafa8957"},
+    {1, false,
+        "6a14fefc55b9f245152e50f6d1c8747c0e7fb27ad861fcbd482b432f74eb752c"
+        "bab88c7353dc28b8a179a84d7b118e2947c70d84b2904aa5e519768670926cee"},
+    {2, true,
+        "a5dc345dfe6605a2974135f5adc65ac40f4eb9a5494679c1d8d44e22863fe029"
+        "547639347ec316c3f3423322ddc0964539df32bc04fcd266674a57c11706ce06"},
+    {9, true,
+        "891454278392968ca07f36e46f7175dbd3fc39bf4dcc94544edda93b4c34a45a"
+        "65c44bc71c14a28356ea12f7fe29703616d38189f69f844ca2032a58f7909395"},
+    {10, true,
+        "a257553e37ec0f982645179cc6aa6ef3f6c4ab9675d5bf6b886935d7d2ee0d16"
+        "d4dd0529a9844ea098a018d4e7572d69099e5908a1bf9c7e1f9bc64635c49ebd"},
+    {11, true,
+        "6d67bfbe42fdb9791e3c6870251c94ec25b4b1b6f3b46bf6cad9eeed11dcdd30"
+        "5866bcaae261a56880005f889c7cb272c540f627555a0ab137427e8124345fdf"},
+    {12, true,
+        "c6d375fd4421510489194b8ccd9b1fc9e96dd25eab56f33bd698266fb38d8fbd"
+        "e447b617cdb5779c5fbeafe53fae640c85c457f6449ce307a11d88d18788d7f0"},
+    {12, false,
+        "20750dfb2eac8ff41bf4dcb97ec48e4f163c7fef3211a0fa0ad00f8481d55102"
+        "55a2d79f73d26b9896664adebd1be94a96547649af22895b59749e1766a93fa5"},
+    {13, true,
+        "e9676e95ed1a2dc7e43bf570595ec4731e5261461e870bb7719b5de7f5872bea"
+        "696b181356ffbd4047e287103258333c5de8de04b6ca2bf4e9ff1b0eca4c62f3"},
+    {20, true,
+        "c10e12e7ef27c3452f1c4975b047f772cd7b3016fc4d5746185a9f4352708f1b"
+        "db45301a8ad3a44ddd9008e2980906f78366e2ede52ae5b79de2f93c2fadf224"},
+    {25, false,
+        "9e1e475125bd54176ecdb8e113d030c6c1971d8dde2736e730ab2b2d3ebc5e8d"
+        "47b27ac8829c31bb72bf96d87c4ee00d7246f980ad1b4e13f6e6d9e324804622"},
+};
+
+/// The precompile input: the rounds, h, the message m, the offset t and the flag f.
+bytes make_input(uint32_t rounds, bytes_view m, uint64_t t0, uint8_t f)
+{
+    bytes input(4, 0);
+    for (size_t i = 0; i < 4; ++i)
+        input[i] = static_cast<uint8_t>(rounds >> (24 - 8 * i));
+    input += h;
+    input += m;
+    for (size_t i = 0; i < 16; ++i)
+        input.push_back(static_cast<uint8_t>(i < 8 ? t0 >> (8 * i) : 0));
+    input.push_back(f);
+    return input;
+}
+
+bytes make_message()
+{
+    bytes m(128, 0);
+    for (size_t i = 0; i < m.size(); ++i)
+        m[i] = static_cast<uint8_t>(i * 7 + 1);
+    return m;
+}
+
+/// Runs the tests with AVX2 (true) and with the generic implementation (false).
+class blake2b : public testing::TestWithParam<bool>
+{
+protected:
+    void SetUp() override
+    {
+        if (evm::precompiles::blake2b_use_avx2(GetParam()) != GetParam())
+            GTEST_SKIP() << "no AVX2";
+    }
+
+    void TearDown() override { evm::precompiles::blake2b_use_avx2(true); }
+};
+}  // namespace
+
+TEST_P(blake2b, eip152_vector)
+{
+    // EIP-152 test vector 5: the BLAKE2b-512 hash of "abc".
+    auto m = "616263"_hex;
+    m.resize(128, 0);
+    bytes output;
+    const auto result = evm::precompiles::execute(
+        EVMC_ISTANBUL, evmc::address{0x09}, make_input(12, m, 3, 1), 12, output);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result->gas_left, 0);
+    EXPECT_EQ(to_hex(output),
+        "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+        "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923");
+}
+
+TEST_P(blake2b, rounds)
+{
+    const auto m = make_message();
+    for (const auto& [rounds, last, expected] : vectors)
+    {
+        SCOPED_TRACE(testing::Message() << rounds << (last ? " last" : ""));
+        bytes output;
+        const auto result = evm::precompiles::execute(EVMC_CANCUN, evmc::address{0x09},
+            make_input(rounds, m, 128, last), 1000, output);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(result->status_code, EVMC_SUCCESS);
+        EXPECT_EQ(result->gas_left, 1000 - rounds);
+        EXPECT_EQ(to_hex(output), expected);
+    }
+}
+
+TEST_P(blake2b, invalid_input)
+{
+    const auto m = make_message();
+    bytes output;
+    // The final block flag other than 0 or 1.
+    auto result = evm::precompiles::execute(
+        EVMC_CANCUN, evmc::address{0x09}, make_input(12, m, 128, 2), 1000, output);
+    EXPECT_EQ(result->status_code, EVMC_PRECOMPILE_FAILURE);
+    EXPECT_EQ(result->gas_left, 0);
+    // A byte short.
+    auto input = make_input(12, m, 128, 1);
+    input.pop_back();
+    result = evm::precompiles::execute(EVMC_CANCUN, evmc::address{0x09}, input, 1000, output);
+    EXPECT_EQ(result->status_code, EVMC_PRECOMPILE_FAILURE);
+    // Not enough gas for the rounds.
+    result = evm::precompiles::execute(
+        EVMC_CANCUN, evmc::address{0x09}, make_input(12, m, 128, 1), 11, output);
+    EXPECT_EQ(result->status_code, EVMC_OUT_OF_GAS);
+}
+
+INSTANTIATE_TEST_SUITE_P(blake2b, blake2b, testing::Values(true, false),
+    [](const testing::TestParamInfo<bool>& info) { return info.param ? "avx2" : "generic"; });
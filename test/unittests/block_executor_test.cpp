@@ -0,0 +1,208 @@
+#include "utils/utils.hpp"
+#include <evm/evm.h>
+#include <gtest/gtest.h>
+#include <state/block_executor.hpp>
+#include <state/host.hpp>
+#include <algorithm>
+
+using namespace evm::test;
+using evm::state::State;
+using evm::state::Transaction;
+
+namespace
+{
+constexpr evmc::address coinbase{0xc0b};
+constexpr evmc::address counter{0xc0};          ///< SSTORE(0, SLOAD(0) + 1)
+constexpr evmc::address coinbase_reader{0xc1};  ///< SSTORE(CALLER, BALANCE(COINBASE))
+constexpr evmc::address clearer{0xc2};          ///< SSTORE(CALLER, 0), refunded
+constexpr evmc::address poor_sender{0x1009};
+const evmc::address senders[] = {
+    evmc::address{0x1001}, evmc::address{0x1002}, evmc::address{0x1003}, evmc::address{0x1004}};
+
+/// The storage key of an address, as pushed by CALLER.
+evmc::bytes32 to_key(const evmc::address& addr) noexcept
+{
+    evmc::bytes32 key;
+    std::copy_n(addr.bytes, sizeof(addr), &key.bytes[sizeof(key) - sizeof(addr)]);
+    return key;
+}
+
+class block_executor : public testing::Test
+{
+protected:
+    evmc_revision rev = EVMC_SHANGHAI;
+    evmc_tx_context tx_context{};
+    std::vector<evmc_vm*> vms;
+
+    block_executor()
+    {
+        tx_context.block_coinbase = coinbase;
+        tx_context.block_base_fee = evmc::bytes32{7};
+        for (int i = 0; i < 4; ++i)
+            vms.push_back(evmc_create_evm());
+    }
+
+    ~block_executor() noexcept override
+    {
+        for (auto* vm : vms)
+            vm->destroy(vm);
+    }
+
+    static void init(State& state)
+    {
+        for (const auto& s : senders)
+        {
+            state.touch(s).balance = 1'000'000'000'000;
+            state.set_storage(clearer, to_key(s), evmc::bytes32{1});
+        }
+        state.touch(poor_sender).balance = 1000;
+        state.set_code(counter, "6000 54 6001 01 6000 55"_hex);
+        state.set_code(coinbase_reader, "41 31 33 55"_hex);
+        state.set_code(clearer, "6000 33 55"_hex);
+        state.commit();
+    }
+
+    /// Executes the block in parallel and serially and checks the results are the same.
+    void expect_same_as_serial(const std::vector<Transaction>& txs)
+    {
+        State serial;
+        init(serial);
+        std::vector<evm::state::TransactionReceipt> expected;
+        for (const auto& tx : txs)
+            expected.push_back(execute_transaction(vms[0], serial, rev, tx_context, tx));
+
+        State parallel;
+        init(parallel);
+        const auto receipts = execute_block(vms, parallel, rev, tx_context, txs);
+
+        ASSERT_EQ(receipts.size(), expected.size());
+        for (size_t i = 0; i < receipts.size(); ++i)
+        {
+            SCOPED_TRACE(i);
+            EXPECT_EQ(receipts[i].status, expected[i].status);
+            EXPECT_EQ(receipts[i].gas_used, expected[i].gas_used);
+            EXPECT_EQ(receipts[i].logs.size(), expected[i].logs.size());
+        }
+
+        std::vector<evmc::address> addrs{
+            coinbase, counter, coinbase_reader, clearer, poor_sender, evmc::address{0xdead}};
+        for (const auto& s : senders)
+        {
+            addrs.push_back(s);
+            addrs.push_back(evm::state::compute_create_address(s, 0));
+            addrs.push_back(evm::state::compute_create_address(s, 1));
+        }
+        for (const auto& addr : addrs)
+        {
+            SCOPED_TRACE(evm::test::to_hex({addr.bytes, sizeof(addr)}));
+            const auto* a = serial.find(addr);
+            const auto* b = parallel.find(addr);
+            ASSERT_EQ(b != nullptr, a != nullptr);
+            if (a == nullptr)
+                continue;
+            EXPECT_EQ(b->balance, a->balance);
+            EXPECT_EQ(b->nonce, a->nonce);
+            EXPECT_EQ(b->code_hash, a->code_hash);
+        }
+        EXPECT_EQ(parallel.get_storage(counter, {}), serial.get_storage(counter, {}));
+        for (const auto& s : senders)
+        {
+            const auto key = to_key(s);
+            EXPECT_EQ(parallel.get_storage(coinbase_reader, key),
+                serial.get_storage(coinbase_reader, key));
+            EXPECT_EQ(parallel.get_storage(clearer, key), serial.get_storage(clearer, key));
+        }
+    }
+};
+
+Transaction make_tx(const evmc::address& sender, const evmc::address& recipient,
+    const intx::uint256& value = 0, const intx::uint256& gas_price = 10)
+{
+    Transaction tx;
+    tx.sender = sender;
+    tx.recipient = recipient;
+    tx.value = value;
+    tx.gas_limit = 100'000;
+    tx.gas_price = gas_price;
+    return tx;
+}
+}  // namespace
+
+TEST_F(block_executor, transfers)
+{
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < 32; ++i)
+        txs.push_back(make_tx(senders[i % 4], senders[(i + 1) % 4], 1000 + i));
+    txs.push_back(make_tx(senders[0], evmc::address{0xdead}, 1));
+    expect_same_as_serial(txs);
+}
+
+TEST_F(block_executor, contended_slot)
+{
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < 32; ++i)
+        txs.push_back(make_tx(senders[i % 4], counter));
+    expect_same_as_serial(txs);
+}
+
+TEST_F(block_executor, coinbase_reads)
+{
+    std::vector<Transaction> txs;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        txs.push_back(make_tx(senders[i % 4], senders[(i + 2) % 4], 5));
+        txs.push_back(make_tx(senders[i % 4], coinbase_reader));
+    }
+    expect_same_as_serial(txs);
+}
+
+TEST_F(block_executor, refunds_creations_and_rejections)
+{
+    std::vector<Transaction> txs;
+    for (const auto& s : senders)
+    {
+        txs.push_back(make_tx(s, clearer));
+        txs.push_back(make_tx(poor_sender, counter));  // Cannot pay for the gas limit.
+
+        // Init code: MSTORE8(0, 0xfe) RETURN(0, 1)
+        auto create = make_tx(s, {});
+        create.kind = EVMC_CREATE;
+        create.data = "60fe600053 60016000f3"_hex;
+        txs.push_back(create);
+    }
+    expect_same_as_serial(txs);
+}
+
+TEST_F(block_executor, transactions_pay_fees)
+{
+    State state;
+    init(state);
+    const auto receipts =
+        execute_block(vms, state, rev, tx_context, {make_tx(senders[0], senders[1], 100)});
+    ASSERT_EQ(receipts.size(), 1);
+    EXPECT_EQ(receipts[0].status, EVMC_SUCCESS);
+    EXPECT_EQ(receipts[0].gas_used, 21000);
+    EXPECT_EQ(state.find(senders[0])->balance, 1'000'000'000'000 - 100 - 21000 * 10);
+    EXPECT_EQ(state.find(senders[1])->balance, 1'000'000'000'000 + 100);
+    EXPECT_EQ(state.find(coinbase)->balance, 21000 * (10 - 7));
+}
+
+TEST_F(block_executor, rejects_overflowing_costs)
+{
+    constexpr auto max = ~intx::uint256{0};
+    State state;
+    init(state);
+    state.touch(senders[0]).balance = max;
+    // The gas cost of the gas limit of 100'000 wraps around to 0.
+    const auto wrapping_gas_cost = make_tx(senders[0], senders[1], 0, intx::uint256{1} << 255);
+    // The gas cost plus the value wraps around to 9.
+    const auto wrapping_total = make_tx(senders[0], senders[1], max, 10);
+
+    const auto receipts =
+        execute_block(vms, state, rev, tx_context, {wrapping_gas_cost, wrapping_total});
+    ASSERT_EQ(receipts.size(), 2);
+    EXPECT_EQ(receipts[0].status, EVMC_REJECTED);
+    EXPECT_EQ(receipts[1].status, EVMC_REJECTED);
+    EXPECT_EQ(state.find(senders[0])->balance, max);
+    EXPECT_EQ(state.find(senders[1])->balance, 1'000'000'000'000);
+}
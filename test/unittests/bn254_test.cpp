@@ -0,0 +1,153 @@
+#include "utils/utils.hpp"
+#include <gtest/gtest.h>
+#include <precompiles/bn254.hpp>
+#include <precompiles/precompiles.hpp>
+
+#if EVM_BN254_SUPPORTED
+
+using namespace evm::test;
+
+namespace
+{
+// The vectors are computed with py_ecc.
+const auto g1 =
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "0000000000000000000000000000000000000000000000000000000000000002"_hex;
+const auto g1_neg =
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd45"_hex;
+const auto g1_double =
+    "030644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd3"
+    "15ed738c0e0a7c92e7845f96b2ae9c0a68a6a449e3538fc7ff3ebf7a5a18a2c4"_hex;
+const auto p = /* 12345 G1 */
+    "1936f7b07be20ac4b7faac53aba252c44112b369f437c12d75b8157882b390aa"
+    "055c38c27b1dc7fbbdfbb7b4795e92d0d838126c25b6771908f9a23c35c8921a"_hex;
+const auto p_neg =
+    "1936f7b07be20ac4b7faac53aba252c44112b369f437c12d75b8157882b390aa"
+    "2b0815b06613d82dfa548e020822c58cbf49582542bb53743326e9daa2b46b2d"_hex;
+const auto q = /* 67890 G1 */
+    "0c6378a07fa51d94ac9bc123c54082101dc408e01c11095c1398118a58539063"
+    "1caac57bf354370552e63f735af873b026ba610b517e46ab45df26c2dd21ac00"_hex;
+const auto infinity = bytes(64, 0);
+const auto g2 =
+    "198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c2"
+    "1800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed"
+    "090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b"
+    "12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa"_hex;
+const auto g2_7 = /* 7 G2 */
+    "2903ba015a9abde26a5d081e84551e63be0fd4516e46ee6d593edeba46362455"
+    "224bdc5d4327fcf8ed702e01de1c2f1657a253ba75e32a89c390142aaa28b308"
+    "03c8b7cda6b2dedb7aeeaf5fda464ad17036bea1c4e6f7adbaed1ebe0335e0d8"
+    "1d92fff52a265017eeccb372e37d7a7bd431800eca28dfd82e21e8054114233f"_hex;
+const auto g1_5 = /* 5 G1 */
+    "17c139df0efee0f766bc0204762b774362e4ded88953a39ce849a8a7fa163fa9"
+    "01e0559bacb160664764a357af8a9fe70baa9258e0b959273ffc5718c6d4cc7c"_hex;
+const auto g1_35_neg = /* -35 G1 */
+    "2b56f9424c10465ac72494e481e705c8938d4144b2858a3a7d0fe5e1659a124e"
+    "07b82ce58d1cd8c6508b2b534faa3565a09a7dc4b13c4b117d33b5b2059813aa"_hex;
+/// A point of the twist curve out of the G2 subgroup.
+const auto g2_outside =
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "0000000000000000000000000000000000000000000000000000000000000002"
+    "2b76c179599bb92a963dac85546a005a777f7c13f6a7b75d5918b6b5808f5fde"
+    "101f7278419308b95099eca02dcee0c5381f4d26d1d62313f057167f064101ce"_hex;
+
+const auto one = bytes(31, 0) + bytes{1};
+const auto zero = bytes(32, 0);
+
+/// Runs the tests with the BMI2 and ADX implementation (true) and the generic one (false).
+class bn254 : public testing::TestWithParam<bool>
+{
+protected:
+    void SetUp() override
+    {
+        if (evm::precompiles::bn254_use_adx(GetParam()) != GetParam())
+            GTEST_SKIP() << "no BMI2 and ADX";
+    }
+
+    void TearDown() override { evm::precompiles::bn254_use_adx(true); }
+
+    /// Executes the precompile with enough gas and returns its output, nullopt if it fails.
+    static std::optional<bytes> execute(uint8_t id, const bytes& input)
+    {
+        bytes output;
+        const auto result = evm::precompiles::execute(
+            EVMC_SHANGHAI, evmc::address{id}, input, 10'000'000, output);
+        EXPECT_TRUE(result.has_value());
+        if (result->status_code != EVMC_SUCCESS)
+            return std::nullopt;
+        return output;
+    }
+};
+}  // namespace
+
+TEST_P(bn254, add)
+{
+    EXPECT_EQ(execute(0x06, g1 + g1), g1_double);
+    EXPECT_EQ(execute(0x06, p + q),
+        "2f8541d66f60e2b04d999ad3b3ab201e6246d33561881993af8c7db1927d7dbb"
+        "0abf55af96dff94fce2152d908f92e5823467c3e0e9878a56917c433fbcb0219"_hex);
+    EXPECT_EQ(execute(0x06, p + p_neg), infinity);
+    EXPECT_EQ(execute(0x06, p + infinity), p);
+    EXPECT_EQ(execute(0x06, infinity + infinity), infinity);
+    // The input is padded with zeros.
+    EXPECT_EQ(execute(0x06, p), p);
+    EXPECT_EQ(execute(0x06, {}), infinity);
+    // Invalid points: (1, 3) and G1 with x + the field modulus.
+    EXPECT_EQ(execute(0x06, g1 + bytes(31, 0) + bytes{1} + bytes(31, 0) + bytes{3}), std::nullopt);
+    EXPECT_EQ(execute(0x06, "30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd48"_hex +
+                                g1.substr(32) + g1),
+        std::nullopt);
+}
+
+TEST_P(bn254, mul)
+{
+    EXPECT_EQ(execute(0x07, g1 + bytes(31, 0) + bytes{2}), g1_double);
+    EXPECT_EQ(execute(0x07,
+                  p + "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000000"_hex),
+        p_neg);
+    EXPECT_EQ(execute(0x07, g1 + bytes(32, 0xff)),
+        "2f588cffe99db877a4434b598ab28f81e0522910ea52b45f0adaa772b2d5d352"
+        "12f42fa8fd34fb1b33d8c6a718b6590198389b26fc9d8808d971f8b009777a97"_hex);
+    EXPECT_EQ(execute(0x07,
+                  p + "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001"_hex),
+        infinity);
+    EXPECT_EQ(execute(0x07, p + zero), infinity);
+    EXPECT_EQ(execute(0x07, infinity + one), infinity);
+    EXPECT_EQ(execute(0x07, p), infinity);
+    EXPECT_EQ(execute(0x07, g1.substr(0, 63) + bytes{3} + one), std::nullopt);
+}
+
+TEST_P(bn254, pairing)
+{
+    EXPECT_EQ(execute(0x08, {}), one);
+    EXPECT_EQ(execute(0x08, g1 + g2), zero);
+    EXPECT_EQ(execute(0x08, g1 + g2 + g1_neg + g2), one);
+    EXPECT_EQ(execute(0x08, g1_5 + g2_7 + g1_35_neg + g2), one);
+    EXPECT_EQ(execute(0x08, g1_5 + g2_7 + g1_neg + g2), zero);
+    EXPECT_EQ(execute(0x08, infinity + g2), one);
+    EXPECT_EQ(execute(0x08, g1 + bytes(128, 0)), one);
+    // Invalid inputs.
+    EXPECT_EQ(execute(0x08, g1 + g2_outside), std::nullopt);
+    EXPECT_EQ(execute(0x08, g1 + g2.substr(0, 127) + bytes{1}), std::nullopt);
+    EXPECT_EQ(execute(0x08, g1 + g2 + g1), std::nullopt);
+}
+
+TEST_P(bn254, gas)
+{
+    bytes output;
+    const auto pairing = evm::precompiles::execute(
+        EVMC_SHANGHAI, evmc::address{0x08}, g1 + g2 + g1_neg + g2, 1'000'000, output);
+    EXPECT_EQ(pairing->gas_left, 1'000'000 - (45000 + 2 * 34000));
+    const auto add =
+        evm::precompiles::execute(EVMC_SHANGHAI, evmc::address{0x06}, g1 + g1, 1000, output);
+    EXPECT_EQ(add->gas_left, 1000 - 150);
+    const auto mul = evm::precompiles::execute(
+        EVMC_SHANGHAI, evmc::address{0x07}, g1 + one, 5999, output);
+    EXPECT_EQ(mul->status_code, EVMC_OUT_OF_GAS);
+}
+
+INSTANTIATE_TEST_SUITE_P(bn254, bn254, testing::Values(true, false),
+    [](const testing::TestParamInfo<bool>& info) { return info.param ? "adx" : "generic"; });
+
+#endif
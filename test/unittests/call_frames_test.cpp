@@ -0,0 +1,105 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class call_frames : public vm_fixture
+{
+protected:
+    /// Executes the code with and without call frames and checks the results are the same.
+    void expect_same_result(bytes_view code, const intx::uint256& value = 0)
+    {
+        constexpr evmc::address recursive{0x1001};
+        constexpr evmc::address framed{0x2001};
+        deploy(recursive, code);
+        deploy(framed, code);
+
+        set_option("call_frames", "no");
+        const auto expected = transact(recursive, {}, 1'000'000, value);
+        set_option("call_frames");
+        const auto receipt = transact(framed, {}, 1'000'000, value);
+        EXPECT_EQ(receipt.status, expected.status);
+        EXPECT_EQ(receipt.gas_used, expected.gas_used);
+        EXPECT_EQ(state.get_storage(framed, evmc::bytes32{}),
+            state.get_storage(recursive, evmc::bytes32{}));
+        EXPECT_EQ(state.get_storage(framed, evmc::bytes32{1}),
+            state.get_storage(recursive, evmc::bytes32{1}));
+    }
+};
+}  // namespace
+
+TEST_F(call_frames, nested_call_with_value)
+{
+    constexpr evmc::address callee{0xca11};
+    // SSTORE(CALLER, CALLVALUE)
+    deploy(callee, "34 33 55"_hex);
+    // SSTORE(0, CALL(GAS, callee, 5, 0, 0, 0, 0))
+    expect_same_result("6000 6000 6000 6000 6005 61ca11 5a f1 6000 55"_hex, 10);
+    EXPECT_EQ(state.get_storage(callee, evmc::bytes32{0x2001}), evmc::bytes32{5});
+    EXPECT_EQ(state.find(callee)->balance, 10);
+}
+
+TEST_F(call_frames, insufficient_balance_is_left_to_host)
+{
+    constexpr evmc::address callee{0xca11};
+    deploy(callee, "34 33 55"_hex);
+    // SSTORE(0, CALL(GAS, callee, 5, 0, 0, 0, 0))
+    expect_same_result("6000 6000 6000 6000 6005 61ca11 5a f1 6000 55"_hex);
+    EXPECT_EQ(state.find(callee)->balance, 0);
+}
+
+TEST_F(call_frames, creation_deposits_code)
+{
+    // Init code: MSTORE8(0, 0xfe) RETURN(0, 1)
+    // Caller: MSTORE(0, init code) SSTORE(0, EXTCODESIZE(CREATE(0, 32 - 10, 10)))
+    expect_same_result("69 60fe600053 60016000f3  6000 52  600a 6016 6000 f0 3b 6000 55"_hex);
+    const auto created = evm::state::compute_create_address(evmc::address{0x2001}, 0);
+    ASSERT_NE(state.find(created), nullptr);
+    EXPECT_EQ(state.find(created)->get_code(), "fe"_hex);
+}
+
+TEST_F(call_frames, failed_code_deposit_drops_init_code_writes)
+{
+    // Init code: SSTORE(1, 1) MSTORE8(0, 0xef) RETURN(0, 1), rejected by EIP-3541.
+    // Caller: MSTORE(0, init code) CREATE(0, 32 - 15, 15) SSTORE(0, result)
+    deploy(to, "6e 6001600155 60ef600053 60016000f3  6000 52  600f 6011 6000 f0  6000 55"_hex);
+    const auto created = evm::state::compute_create_address(to, 0);
+
+    set_option("call_frames");
+    set_option("storage_journal");
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{}), evmc::bytes32{});
+    EXPECT_EQ(state.find(created), nullptr);
+}
+
+TEST_F(call_frames, accesses_of_failed_code_deposit_are_cold)
+{
+    // Init code: BALANCE(0xbeef) MSTORE8(0, 0xef) RETURN(0, 1), rejected by EIP-3541.
+    // Caller: MSTORE(0, init code) CREATE(0, 32 - 15, 15) BALANCE(0xbeef)
+    const auto code =
+        "6e 61beef3150 60ef600053 60016000f3  6000 52  600f 6011 6000 f0 50  61beef 31 50"_hex;
+    set_option("access_tracking");
+    expect_same_result(code);
+}
+
+TEST_F(call_frames, deep_recursion)
+{
+    // if CALLDATASIZE < 64 { CALL(GAS, ADDRESS, 0, 0, CALLDATASIZE + 1, 0, 0) }
+    // SSTORE(0, CALLDATASIZE)
+    expect_same_result(
+        "6040 36 10 15 6018 57  6000 6000 36 6001 01 6000 6000 30 5a f1 50  5b 36 6000 55"_hex);
+}
+
+TEST_F(call_frames, state_of_previous_frame_is_not_reused)
+{
+    constexpr evmc::address callee{0xca11};
+    // SSTORE(CALLER + CALLDATASIZE, MSIZE + 1) MSTORE(0x40, 1)
+    deploy(callee, "59 6001 01 36 33 01 55  6001 6040 52"_hex);
+    // CALL(GAS, callee, 0, 0, 1, 0, 0) CALL(GAS, callee, 0, 0, 2, 0, 0)
+    // The second frame at depth 1 runs in the state of the first one.
+    expect_same_result(
+        "6000 6000 6001 6000 6000 61ca11 5a f1 50  6000 6000 6002 6000 6000 61ca11 5a f1 50"_hex);
+    EXPECT_EQ(state.get_storage(callee, evmc::bytes32{0x2001 + 1}), evmc::bytes32{1});
+    EXPECT_EQ(state.get_storage(callee, evmc::bytes32{0x2001 + 2}), evmc::bytes32{1});
+}
@@ -0,0 +1,168 @@
+#include "vm_fixture.hpp"
+#include <call_site_cache.hpp>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace evm::test;
+
+namespace
+{
+/// A stand-in for a code analysis.
+struct Analysis
+{
+    bytes code;
+};
+
+class call_site_cache : public vm_fixture
+{
+protected:
+    static constexpr evmc::address callee_a{0xaaaa};
+    static constexpr evmc::address callee_b{0xbbbb};
+
+    evm::CallSiteCache<Analysis> cache;
+    int num_analyses = 0;
+
+    const Analysis* get(const evmc::address& addr, evmc_revision r = EVMC_SHANGHAI)
+    {
+        evmc_message msg{};
+        msg.code_address = addr;
+        const auto* account = state.find(addr);
+        const auto code = account != nullptr ? account->get_code() : bytes_view{};
+        const evm::state::Host host{vm, state, r, tx_context};
+        return cache.get(host, r, msg, code, [this](evmc_revision, bytes_view c) {
+            ++num_analyses;
+            return Analysis{bytes{c}};
+        });
+    }
+
+    /// Executes the transaction to the caller with each of the interpreters and checks the
+    /// value it stores.
+    void expect_same_results(uint64_t expected_value)
+    {
+        std::optional<int64_t> gas_used;
+        for (const auto* option : {"", "call_frames", "advanced"})
+        {
+            SCOPED_TRACE(option);
+            set_storage(to, {}, {});
+            evmc_vm* const c_vm = evmc_create_evm();
+            evm_set_host_extensions(c_vm, &evm::state::Host::extensions);
+            if (*option != '\0')
+            {
+                ASSERT_EQ(c_vm->set_option(c_vm, option, "yes"), EVMC_SET_OPTION_SUCCESS);
+            }
+
+            evm::state::Transaction tx;
+            tx.sender = sender;
+            tx.recipient = to;
+            tx.gas_limit = 1'000'000;
+            const auto receipt = evm::state::execute_transaction(c_vm, state, rev, tx_context, tx);
+            c_vm->destroy(c_vm);
+            ASSERT_EQ(receipt.status, EVMC_SUCCESS);
+            EXPECT_EQ(state.get_storage(to, evmc::bytes32{}), evmc::bytes32{expected_value});
+            EXPECT_EQ(receipt.gas_used, gas_used.value_or(receipt.gas_used));
+            gas_used = receipt.gas_used;
+        }
+    }
+};
+}  // namespace
+
+TEST_F(call_site_cache, hit_keeps_analysis)
+{
+    deploy(callee_a, "6001"_hex);
+    const auto first = get(callee_a);
+    EXPECT_EQ(get(callee_a), first);
+    EXPECT_EQ(num_analyses, 1);
+    EXPECT_EQ(first->code, "6001"_hex);
+}
+
+TEST_F(call_site_cache, misses_on_other_callee_code_or_revision)
+{
+    deploy(callee_a, "6001"_hex);
+    deploy(callee_b, "6002"_hex);
+    const auto* a = get(callee_a);
+    EXPECT_EQ(get(callee_b)->code, "6002"_hex);
+    EXPECT_EQ(num_analyses, 2);
+    EXPECT_EQ(get(callee_a), a);
+
+    // Redeployed, e.g. by CREATE2 after SELFDESTRUCT.
+    state.erase(callee_b);
+    deploy(callee_b, "6003"_hex);
+    EXPECT_EQ(get(callee_b)->code, "6003"_hex);
+    EXPECT_EQ(num_analyses, 3);
+
+    EXPECT_NE(get(callee_b, EVMC_LONDON), nullptr);
+    EXPECT_EQ(num_analyses, 4);
+}
+
+TEST_F(call_site_cache, full_cache_is_not_replaced)
+{
+    for (uint64_t i = 0; i < evm::CallSiteCache<Analysis>::size; ++i)
+    {
+        deploy(evmc::address{i + 1}, "6001"_hex);
+        EXPECT_NE(get(evmc::address{i + 1}), nullptr);
+    }
+    deploy(callee_a, "6001"_hex);
+    EXPECT_EQ(get(callee_a), nullptr);
+    EXPECT_EQ(get(evmc::address{1})->code, "6001"_hex);
+}
+
+TEST_F(call_site_cache, shared_by_threads)
+{
+    deploy(callee_a, "6001"_hex);
+    deploy(callee_b, "6002"_hex);
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4);
+    for (size_t t = 0; t < mismatches.size(); ++t)
+    {
+        threads.emplace_back([this, t, &mismatches] {
+            evmc_message msg{};
+            for (int i = 0; i < 1000; ++i)
+            {
+                msg.code_address = (i + t) % 2 == 0 ? callee_a : callee_b;
+                const auto code = state.find(msg.code_address)->get_code();
+                const evm::state::Host host{vm, state, rev, tx_context};
+                const auto* analysis = cache.get(host, rev, msg, code,
+                    [](evmc_revision, bytes_view c) { return Analysis{bytes{c}}; });
+                mismatches[t] += analysis == nullptr || analysis->code != code;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (const auto m : mismatches)
+        EXPECT_EQ(m, 0);
+}
+
+TEST_F(call_site_cache, call_site_with_changing_callee)
+{
+    // MSTORE(0, 1) RETURN(0, 32) and MSTORE(0, 2) RETURN(0, 32)
+    deploy(callee_a, "6001 5f 52 6020 5f f3"_hex);
+    deploy(callee_b, "6002 5f 52 6020 5f f3"_hex);
+
+    // Calls a, a, b from the same CALL site and stores the sum of their outputs:
+    // sum = 0; for (t : {a, a, b}) { CALL(GAS, t, 0, 0, 0, 0, 32) POP sum += MLOAD(0) }
+    // SSTORE(0, sum)
+    deploy(to,
+        "5f 61bbbb 61aaaa 61aaaa 5f"
+        "5b 90 80 15 6023 57  6020 5f 5f 5f 5f 85 5a f1 50  50 5f 51 01  600b 56"
+        "5b 50 5f 55"_hex);
+    expect_same_results(4);
+}
+
+TEST_F(call_site_cache, minimal_proxy_call_site)
+{
+    // MSTORE(0, 7) RETURN(0, 32)
+    deploy(callee_a, "6007 5f 52 6020 5f f3"_hex);
+    // The EIP-1167 minimal proxy of callee_a.
+    deploy(callee_b,
+        "363d3d373d3d3d363d73000000000000000000000000000000000000aaaa"
+        "5af43d82803e903d91602b57fd5bf3"_hex);
+
+    // Calls the proxy twice: SSTORE(0, MLOAD(0) + MLOAD(0) after each call).
+    deploy(to,
+        "6020 5f 5f 5f 5f 61bbbb 5a f1 50 5f 51"
+        "6020 5f 5f 5f 5f 61bbbb 5a f1 50 5f 51 01  5f 55"_hex);
+    expect_same_results(14);
+}
@@ -0,0 +1,96 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address looper{0x1009};
+
+class cancellation : public vm_fixture
+{
+protected:
+    evm_cancellation_token* const token = evm_create_cancellation_token();
+
+    cancellation()
+    {
+        deploy(looper, "5b 6000 56"_hex);  // JUMPDEST JUMP(0)
+        // SSTORE(0, CALL(GAS, looper, 0, 0, 0, 0, 0))
+        deploy(to, "6000 6000 6000 6000 6000 611009 5a f1 6000 55"_hex);
+    }
+
+    ~cancellation() noexcept override { evm_destroy_cancellation_token(token); }
+
+    evmc::Result execute(const evmc::address& recipient) noexcept
+    {
+        evm::state::Host host{vm, state, rev, tx_context};
+        return host.call(make_message(recipient));
+    }
+};
+}  // namespace
+
+TEST_F(cancellation, cancelled_callee_ends_caller)
+{
+    evm_cancel(token);
+    evm_set_cancellation(vm, token, 0);
+    EXPECT_EQ(execute(to).status_code, EVM_CANCELLED);
+    EXPECT_EQ(state.get_storage(to, {}), evmc::bytes32{});
+}
+
+TEST_F(cancellation, cancelled_callee_ends_caller_with_call_frames)
+{
+    set_option("call_frames");
+    evm_cancel(token);
+    evm_set_cancellation(vm, token, 0);
+    EXPECT_EQ(execute(to).status_code, EVM_CANCELLED);
+}
+
+TEST_F(cancellation, deadline_ends_caller)
+{
+    evm_set_cancellation(vm, nullptr, 1);
+    EXPECT_EQ(execute(to).status_code, EVM_CANCELLED);
+}
+
+TEST_F(cancellation, minimal_proxy_is_cancelled)
+{
+    constexpr evmc::address proxy{0x1001};
+    deploy(proxy, "363d3d373d3d3d363d73 0000000000000000000000000000000000001009"
+                  "5af43d82803e903d91602b57fd5bf3"_hex);
+    evm_cancel(token);
+    evm_set_cancellation(vm, token, 0);
+    EXPECT_EQ(execute(proxy).status_code, EVM_CANCELLED);
+}
+
+TEST_F(cancellation, started_execution_keeps_its_cancellation)
+{
+    constexpr evmc::address counter{0x1002};
+    constexpr evmc::address caller{0x1003};
+    // i = 1000; do { i -= 1 } while (i != 0)
+    deploy(counter, "6103e8 5b 6001 90 03 80 6003 57"_hex);
+    // MSTORE(0, CALL(GAS, counter, 0, 0, 0, 0, 0)) RETURN(0, 32)
+    deploy(caller, "6000 6000 6000 6000 6000 611002 5a f1 6000 52 6020 6000 f3"_hex);
+    set_option("call_frames");
+
+    const auto msg = make_message(caller);
+    const auto code = state.find(caller)->get_code();
+    auto* const started_token = evm_create_cancellation_token();
+    evm_set_cancellation(vm, started_token, 0);
+    evm::state::Host host{vm, state, rev, tx_context};
+    auto* execution = evm_create_execution(
+        vm, &host.get_interface(), host.to_context(), rev, &msg, code.data(), code.size());
+    ASSERT_TRUE(evm_set_execution_slice(execution, 1000));
+    evmc_result raw_result{};
+    ASSERT_EQ(evm_run_execution(execution, &raw_result), EVM_EXECUTION_PREEMPTED);
+
+    // Installed for the next executions, while the callee's frame is preempted.
+    evm_cancel(token);
+    evm_set_cancellation(vm, token, 0);
+    while (evm_run_execution(execution, &raw_result) != EVM_EXECUTION_DONE)
+    {
+    }
+    evm_destroy_execution(execution);
+    evm_destroy_cancellation_token(started_token);
+    const evmc::Result result{raw_result};
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, 32);
+    EXPECT_EQ(result.output_data[31], 1);
+}
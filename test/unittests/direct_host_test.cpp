@@ -0,0 +1,109 @@
+#include "vm_fixture.hpp"
+#include <baseline_dispatch.hpp>
+#include <vm.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+/// The host of the state called directly by the interpreter.
+class DirectHost final : public evm::state::Host
+{
+public:
+    using Host::Host;
+};
+
+constexpr evmc::address other{0xaaaa};
+
+class direct_host : public vm_fixture
+{
+protected:
+    struct Result
+    {
+        evmc_status_code status;
+        int64_t gas_left;
+        int64_t gas_refund;
+        std::vector<evmc::bytes32> storage;
+        std::vector<evm::state::Log> logs;
+    };
+
+    bytes code;
+
+    /// Executes the code through the evmc::HostContext or with the host called directly,
+    /// and reverts its changes to the state.
+    Result execute(bool direct, int64_t gas)
+    {
+        const auto analysis = evm::baseline::analyze(rev, code);
+        const auto msg = make_message(to, gas);
+        DirectHost host{vm, state, rev, tx_context};
+        host.block_hashes[9] = evmc::bytes32{0x99};
+        const auto exec_state = std::make_unique<evm::ExecutionState>(
+            msg, rev, host.get_interface(), host.to_context(), code);
+        const auto& evm_vm = *static_cast<evm::VM*>(vm);
+        const auto result = evmc::Result{
+            direct ? evm::baseline::execute<DirectHost>(evm_vm, *exec_state, analysis) :
+                     evm::baseline::execute(evm_vm, *exec_state, analysis)};
+
+        Result r{result.status_code, result.gas_left, result.gas_refund, {}, state.get_logs()};
+        for (uint64_t key = 0; key < 4; ++key)
+            r.storage.push_back(state.get_storage(to, evmc::bytes32{key}));
+        state.rollback(0);
+        return r;
+    }
+
+    /// Expects the same results of the direct and the evmc::HostContext executions with the gas
+    /// limit of a successful execution, and with lower gas limits running out of gas at
+    /// different instructions.
+    void expect_same_results()
+    {
+        const auto expected = execute(false, 1'000'000);
+        ASSERT_EQ(expected.status, EVMC_SUCCESS);
+        EXPECT_EQ(expected.logs.size(), 1);
+        const auto gas_used = 1'000'000 - expected.gas_left;
+        for (auto gas = gas_used; gas >= 0 && !HasFailure(); gas -= 97)
+        {
+            SCOPED_TRACE(gas);
+            const auto direct = execute(true, gas);
+            const auto generic = execute(false, gas);
+            EXPECT_EQ(direct.status, generic.status);
+            EXPECT_EQ(direct.gas_left, generic.gas_left);
+            EXPECT_EQ(direct.gas_refund, generic.gas_refund);
+            EXPECT_EQ(direct.storage, generic.storage);
+            ASSERT_EQ(direct.logs.size(), generic.logs.size());
+            for (size_t i = 0; i < direct.logs.size(); ++i)
+            {
+                EXPECT_EQ(direct.logs[i].address, generic.logs[i].address);
+                EXPECT_EQ(direct.logs[i].data, generic.logs[i].data);
+                EXPECT_EQ(direct.logs[i].topics, generic.logs[i].topics);
+            }
+        }
+    }
+};
+}  // namespace
+
+TEST_F(direct_host, same_results)
+{
+    deploy(other, "6001 6002 01"_hex);
+    set_storage(to, evmc::bytes32{0}, evmc::bytes32{41});
+    tx_context.block_number = 10;
+
+    // SSTORE(1, SLOAD(0) + 1)
+    // BALANCE(sender) POP SELFBALANCE POP EXTCODESIZE(other) POP EXTCODEHASH(other) POP
+    // EXTCODECOPY(other, 0, 0, 32) SSTORE(2, BLOCKHASH(9)) LOG2(0, 32, 1, 2)
+    // SSTORE(3, MLOAD(0)) SSTORE(0, 0)
+    code = "6000 54 6001 01 6001 55"
+           "615e4d 31 50  47 50  61aaaa 3b 50  61aaaa 3f 50"
+           "6020 6000 6000 61aaaa 3c  6009 40 6002 55  6002 6001 6020 6000 a2"
+           "6000 51 6003 55  6000 6000 55 00"_hex;
+
+    for (const auto r : {EVMC_LONDON, EVMC_SHANGHAI, EVMC_MAX_REVISION})
+    {
+        SCOPED_TRACE(r);
+        rev = r;
+        expect_same_results();
+        const auto result = execute(true, 1'000'000);
+        EXPECT_EQ(result.storage[1], evmc::bytes32{42});
+        EXPECT_EQ(result.storage[2], evmc::bytes32{0x99});
+        EXPECT_EQ(bytes_view(result.storage[3].bytes, 5), "6001600201"_hex);
+    }
+}
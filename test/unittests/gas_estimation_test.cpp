@@ -0,0 +1,73 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+/// Init code: RETURN(0, 16), deploying 16 zero bytes.
+const auto init_code = "6010 6000 f3"_hex;
+
+class gas_estimation : public vm_fixture
+{
+protected:
+    static constexpr int64_t high_gas_limit = 10'000'000;
+
+    gas_estimation() { set_option("gas_estimation"); }
+
+    int64_t estimate() const noexcept { return evm_get_gas_estimate(vm); }
+};
+}  // namespace
+
+TEST_F(gas_estimation, call)
+{
+    constexpr evmc::address callee{0xca11};
+    // MSTORE(0, 1) RETURN(0, 32)
+    deploy(callee, "6001 6000 52 6020 6000 f3"_hex);
+    // CALL(GAS, callee, 0, 0, 0, 0, 0) POP
+    deploy(to, "6000 6000 6000 6000 6000 61ca11 5a f1 50"_hex);
+
+    ASSERT_EQ(transact(to, {}, high_gas_limit).status, EVMC_SUCCESS);
+    const auto gas = estimate();
+    EXPECT_GT(gas, 0);
+    EXPECT_EQ(transact(to, {}, 21000 + gas).status, EVMC_SUCCESS);
+    EXPECT_EQ(transact(to, {}, 21000 + gas - 1).status, EVMC_OUT_OF_GAS);
+}
+
+TEST_F(gas_estimation, creation_includes_code_deposit)
+{
+    // 53000, 4 nonzero and 1 zero byte of data, 1 word of init code.
+    constexpr int64_t intrinsic_gas = 53000 + 4 * 16 + 4 + 2;
+
+    ASSERT_EQ(transact_create(init_code, high_gas_limit).status, EVMC_SUCCESS);
+    // PUSH1 PUSH1 and one word of memory, then the deposit of 16 bytes.
+    EXPECT_EQ(estimate(), 3 + 3 + 3 + 16 * 200);
+    EXPECT_EQ(transact_create(init_code, intrinsic_gas + estimate()).status, EVMC_SUCCESS);
+    EXPECT_EQ(
+        transact_create(init_code, intrinsic_gas + estimate() - 1).status, EVMC_OUT_OF_GAS);
+}
+
+TEST_F(gas_estimation, nested_creation_includes_code_deposit)
+{
+    // MSTORE(0, init code) CREATE(0, 32 - 5, 5), the last instruction, so that the caller only
+    // keeps 1/64 of the gas the creation needs.
+    const auto code = "64 6010 6000 f3  6000 52  6005 601b 6000 f0 00"_hex;
+    const auto code_size = [this](const evmc::address& addr) noexcept {
+        const auto* account = state.find(addr);
+        return account != nullptr ? account->get_code().size() : 0;
+    };
+    uint64_t i = 0;
+    for (const auto* call_frames : {"no", "yes"})
+    {
+        SCOPED_TRACE(call_frames);
+        set_option("call_frames", call_frames);
+        const evmc::address creator{0xc1 + i++};
+        deploy(creator, code);
+
+        ASSERT_EQ(transact(creator, {}, high_gas_limit).status, EVMC_SUCCESS);
+        EXPECT_EQ(code_size(evm::state::compute_create_address(creator, 0)), 16);
+        const auto gas = estimate();
+
+        ASSERT_EQ(transact(creator, {}, 21000 + gas).status, EVMC_SUCCESS);
+        EXPECT_EQ(code_size(evm::state::compute_create_address(creator, 1)), 16);
+    }
+}
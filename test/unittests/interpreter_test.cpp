@@ -0,0 +1,44 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class interpreter : public vm_fixture
+{
+protected:
+    /// Executes the code and returns the status and the gas used.
+    std::pair<evmc_status_code, int64_t> execute_gas_used(bytes_view code) noexcept
+    {
+        const auto result = execute(code);
+        return {result.status_code, 1'000'000 - result.gas_left};
+    }
+};
+}  // namespace
+
+/// The revisions executed by the loops specialized for them and by the shared one.
+TEST_F(interpreter, revisions)
+{
+    // EXP(2, 0xff), 10 + 10 or 50 gas per exponent byte from Spurious Dragon.
+    const auto exp = "60ff 6002 0a 50 00"_hex;
+    // SELFBALANCE from Istanbul, PUSH0 from Shanghai.
+    const auto selfbalance = "47 50 00"_hex;
+    const auto push0 = "5f 50 00"_hex;
+
+    for (const auto cgoto : {true, false})
+    {
+        if (!cgoto)
+            vm->set_option(vm, "cgoto", "no");
+        for (int r = EVMC_FRONTIER; r <= EVMC_MAX_REVISION; ++r)
+        {
+            rev = static_cast<evmc_revision>(r);
+            SCOPED_TRACE(testing::Message() << rev << " cgoto " << cgoto);
+            const int64_t exp_cost = (rev >= EVMC_SPURIOUS_DRAGON) ? 50 : 10;
+            EXPECT_EQ(execute_gas_used(exp), std::pair(EVMC_SUCCESS, 3 + 3 + 10 + exp_cost + 2));
+            EXPECT_EQ(execute(selfbalance).status_code,
+                (rev >= EVMC_ISTANBUL) ? EVMC_SUCCESS : EVMC_UNDEFINED_INSTRUCTION);
+            EXPECT_EQ(execute(push0).status_code,
+                (rev >= EVMC_SHANGHAI) ? EVMC_SUCCESS : EVMC_UNDEFINED_INSTRUCTION);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class log_batching : public vm_fixture
+{
+protected:
+    /// Executes the code with and without log batching and checks the logs are the same.
+    void expect_same_logs(bytes_view code, size_t num_logs)
+    {
+        constexpr evmc::address unbatched{0x1001};
+        constexpr evmc::address batched{0x2001};
+        deploy(unbatched, code);
+        deploy(batched, code);
+
+        set_option("log_batching", "no");
+        const auto expected = transact(unbatched);
+        set_option("log_batching");
+        const auto receipt = transact(batched);
+        EXPECT_EQ(receipt.status, expected.status);
+        EXPECT_EQ(receipt.gas_used, expected.gas_used);
+        ASSERT_EQ(receipt.logs.size(), num_logs);
+        ASSERT_EQ(expected.logs.size(), num_logs);
+        for (size_t i = 0; i < num_logs; ++i)
+        {
+            EXPECT_EQ(receipt.logs[i].data, expected.logs[i].data);
+            EXPECT_EQ(receipt.logs[i].topics, expected.logs[i].topics);
+        }
+    }
+};
+}  // namespace
+
+TEST_F(log_batching, logs_match_host)
+{
+    // MSTORE(0, 0xaabb) LOG0(30, 2) LOG2(31, 1, 1, 2)
+    expect_same_logs("61aabb 6000 52  6002 601e a0  6002 6001 6001 601f a2"_hex, 2);
+}
+
+TEST_F(log_batching, reverted_call_drops_logs)
+{
+    // LOG1(0, 0, 1) REVERT(0, 0)
+    deploy(evmc::address{0xca11}, "6001 6000 6000 a1  6000 6000 fd"_hex);
+    // LOG0(0, 0) CALL(GAS, 0xca11, 0, 0, 0, 0, 0) LOG0(0, 0)
+    expect_same_logs("6000 6000 a0  6000 6000 6000 6000 6000 61ca11 5a f1 50  6000 6000 a0"_hex, 2);
+}
+
+TEST_F(log_batching, failed_code_deposit_drops_init_code_logs)
+{
+    // Init code: LOG0(0, 0) MSTORE8(0, 0xef) RETURN(0, 1), rejected by EIP-3541.
+    // Caller: MSTORE(0, init code) CREATE(0, 32 - 15, 15)
+    const auto code = "6e 60006000a0 60ef600053 60016000f3  6000 52  600f 6011 6000 f0 50"_hex;
+    expect_same_logs(code, 0);
+
+    set_option("call_frames");
+    deploy(to, code);
+    const auto receipt = transact(to);
+    EXPECT_EQ(receipt.status, EVMC_SUCCESS);
+    EXPECT_TRUE(receipt.logs.empty());
+}
@@ -0,0 +1,116 @@
+#include "vm_fixture.hpp"
+#include <baseline.hpp>
+#include <execution_state.hpp>
+#include <vm.hpp>
+#include <set>
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address proxy{0x1001};
+constexpr evmc::address target{0x1009};
+
+/// The EIP-1167 minimal proxy of the target.
+const auto proxy_code = "363d3d373d3d3d363d73 0000000000000000000000000000000000001009"
+                        "5af43d82803e903d91602b57fd5bf3"_hex;
+
+class minimal_proxy : public vm_fixture
+{
+protected:
+    struct Result
+    {
+        evmc_status_code status;
+        int64_t gas_left;
+        bytes output;
+        bytes return_data;
+    };
+
+    minimal_proxy() noexcept { deploy(proxy, proxy_code); }
+
+    /// Executes the proxy with the gas limit and the input, with the fast path of the baseline
+    /// interpreter or by interpreting its code.
+    Result execute(bool fast_path, int64_t gas, bytes_view input)
+    {
+        auto analysis = evm::baseline::analyze(rev, proxy_code);
+        EXPECT_TRUE(analysis.minimal_proxy_target.has_value());
+        if (!fast_path)
+            analysis.minimal_proxy_target.reset();
+
+        auto msg = make_message(proxy, gas);
+        msg.input_data = input.data();
+        msg.input_size = input.size();
+        evm::state::Host host{vm, state, rev, tx_context};
+        const auto exec_state = std::make_unique<evm::ExecutionState>(
+            msg, rev, host.get_interface(), host.to_context(), proxy_code);
+        const auto result = evmc::Result{
+            evm::baseline::execute(*static_cast<evm::VM*>(vm), *exec_state, analysis)};
+        state.commit();
+        return {result.status_code, result.gas_left, {result.output_data, result.output_size},
+            exec_state->return_data};
+    }
+
+    /// Executes the proxy with the fast path on and off with every gas limit up to the gas
+    /// a successful execution uses, so that the executions run out of gas at each charge point:
+    /// CALLDATACOPY, DELEGATECALL and RETURNDATACOPY. Returns the statuses seen.
+    std::set<evmc_status_code> expect_same_results(bytes_view input)
+    {
+        const auto gas_used = 1'000'000 - execute(false, 1'000'000, input).gas_left;
+        std::set<evmc_status_code> statuses;
+        for (int64_t gas = 0; gas <= gas_used; ++gas)
+        {
+            SCOPED_TRACE(gas);
+            const auto fast = execute(true, gas, input);
+            const auto interpreted = execute(false, gas, input);
+            EXPECT_EQ(fast.status, interpreted.status);
+            EXPECT_EQ(fast.gas_left, interpreted.gas_left);
+            EXPECT_EQ(to_hex(fast.output), to_hex(interpreted.output));
+            EXPECT_EQ(to_hex(fast.return_data), to_hex(interpreted.return_data));
+            statuses.insert(interpreted.status);
+            if (HasFailure())
+                break;
+        }
+        return statuses;
+    }
+};
+}  // namespace
+
+TEST_F(minimal_proxy, success)
+{
+    // CALLDATACOPY(0, 0, CALLDATASIZE) RETURN(0, CALLDATASIZE)
+    deploy(target, "36 5f 5f 37 36 5f f3"_hex);
+    const bytes input(1000, 0x11);
+    const auto result = execute(true, 1'000'000, input);
+    EXPECT_EQ(result.status, EVMC_SUCCESS);
+    EXPECT_EQ(result.output, input);
+    EXPECT_EQ(expect_same_results(input), (std::set{EVMC_SUCCESS, EVMC_OUT_OF_GAS}));
+}
+
+TEST_F(minimal_proxy, revert)
+{
+    // CALLDATACOPY(0, 0, CALLDATASIZE) REVERT(0, CALLDATASIZE)
+    deploy(target, "36 5f 5f 37 36 5f fd"_hex);
+    const bytes input(1000, 0x22);
+    const auto result = execute(true, 1'000'000, input);
+    EXPECT_EQ(result.status, EVMC_REVERT);
+    EXPECT_EQ(result.output, input);
+    EXPECT_EQ(expect_same_results(input), (std::set{EVMC_REVERT, EVMC_OUT_OF_GAS}));
+}
+
+TEST_F(minimal_proxy, empty_input_and_output)
+{
+    deploy(target, "00"_hex);
+    EXPECT_EQ(expect_same_results({}), (std::set{EVMC_SUCCESS, EVMC_OUT_OF_GAS}));
+}
+
+TEST_F(minimal_proxy, fast_path_is_off_before_byzantium)
+{
+    // RETURNDATASIZE is undefined before Byzantium.
+    rev = EVMC_SPURIOUS_DRAGON;
+    deploy(target, "00"_hex);
+    const auto fast = execute(true, 100'000, {});
+    const auto interpreted = execute(false, 100'000, {});
+    EXPECT_EQ(fast.status, EVMC_UNDEFINED_INSTRUCTION);
+    EXPECT_EQ(interpreted.status, EVMC_UNDEFINED_INSTRUCTION);
+    EXPECT_EQ(fast.gas_left, interpreted.gas_left);
+}
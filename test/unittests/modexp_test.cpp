@@ -0,0 +1,277 @@
+#include "utils/utils.hpp"
+#include <gtest/gtest.h>
+#include <precompiles/modexp.hpp>
+#include <precompiles/precompiles.hpp>
+#include <precompiles/sha256.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+/// The kinds of modulus, selecting the Montgomery kernel for odd moduli and the CRT split
+/// into an odd part and a power of two for even ones.
+enum class Modulus
+{
+    odd,
+    even,    ///< Divisible by 2^4.
+    even64,  ///< Divisible by 2^65, so the power of two spans more than a limb.
+    pow2,    ///< A power of two, without an odd part.
+};
+
+/// The digests of base^exp mod mod for the moduli of sizes around the kernel widths,
+/// from Python's pow().
+struct
+{
+    size_t base_len;
+    size_t exp_len;
+    size_t mod_len;
+    Modulus modulus;
+    const char* digest;
+} constexpr vectors[] = {
+    {4, 32, 1, Modulus::odd, "4bf5122f344554c53bde2ebb8cd2b7e3d1600ad631c385a5d7cce23c7785459a"},
+    {4, 32, 1, Modulus::even, "e4ff5e7d7a7f08e9800a3e25cb774533cb20040df30b6ba10f956f9acd0eb3f7"},
+    {4, 32, 1, Modulus::pow2, "4bf5122f344554c53bde2ebb8cd2b7e3d1600ad631c385a5d7cce23c7785459a"},
+    {11, 32, 8, Modulus::odd, "e55505decddef66b624da37b20b07c21da94a8a33305e2653af573f27975f04d"},
+    {11, 32, 8, Modulus::even, "a033505678524a19f253859085ced632b93e094937bc09222c7b13fb2b7ec2f6"},
+    {11, 32, 8, Modulus::pow2, "af5570f5a1810b7af78caf4bc70a660f0df51e42baf91d4de5b2328de0e83dfc"},
+    {35, 32, 32, Modulus::odd, "e46b9f5be765b53d4f613ee3da7e52f75f3dfefa0c4b88613a7b4aee66abe057"},
+    {35, 32, 32, Modulus::even,
+        "2ae06bbaaa64fa62f76f37826ce5c460f46b101b25dc0303109db65e59436bd9"},
+    {35, 32, 32, Modulus::even64,
+        "fddf3c7c985b517389c79dab8b278c2c53b92040008b0ec7758f25e84eabb7f4"},
+    {35, 32, 32, Modulus::pow2,
+        "66687aadf862bd776c8fc18b8e9f8e20089714856ee233b3902a591d0d5f2925"},
+    {36, 32, 33, Modulus::odd, "5275a5d2165d59e3cee568c4eadd40cd7c24426363e2bcee936339e558ae865c"},
+    {36, 32, 33, Modulus::even,
+        "4c66a4bbbb9f4cc9036ccbfeeeaf7de818de77f1c13db6696f3ce14b390baf6a"},
+    {36, 32, 33, Modulus::even64,
+        "dfa7571a0448c0907efa335ec46ed1b495027395851cb710560e44232729712a"},
+    {36, 32, 33, Modulus::pow2,
+        "7f9c9e31ac8256ca2f258583df262dbc7d6f68f2a03043d5c99a4ae5a7396ce9"},
+    {67, 32, 64, Modulus::odd, "b66313791de0e5d68c28797f3deb1ecfec6f911e69f525b3e6e68079764e5f73"},
+    {67, 32, 64, Modulus::even,
+        "30341348485bdc707995584ac0d63ce9ea93856d042405112edd84a7dfbc2425"},
+    {67, 32, 64, Modulus::even64,
+        "4eba5acfeca39ae43191ee871270938455301acef86491d7e4283e016698398a"},
+    {67, 32, 64, Modulus::pow2,
+        "f5a5fd42d16a20302798ef6ed309979b43003d2320d9f0e8ea9831a92759fb4b"},
+    {68, 32, 65, Modulus::odd, "28f04e969f4b7f9bb04ba09797b5fe1fd2e879ced22732e871ce6d0526b79b15"},
+    {68, 32, 65, Modulus::even,
+        "80d7ace7667f9ff9ebe138d582e15710b7370abfb58ed4cee79333d1bfd0f00a"},
+    {68, 32, 65, Modulus::even64,
+        "bb4cbcfaea88fc9dcee1112a3f0a01ff6f81de87ee19aa03590adadd5c1f2796"},
+    {68, 32, 65, Modulus::pow2,
+        "6b15af8042d8932b7ea86bcc8e2b11d5ce4f089b532b9f0017a6e598fd5d769e"},
+    {131, 32, 128, Modulus::odd,
+        "fff6d7c74098a20145afae2a3546d41e61e89fa67b9769354d4e6f0e28b34ad6"},
+    {131, 32, 128, Modulus::even,
+        "34cbe3ed4ebc89497544cbb62eac1bda31966b5d7725401fbf9cd03af557436f"},
+    {131, 32, 128, Modulus::even64,
+        "67a5152fce07822e167e1744d909f0e8921b0b107c42156f07482311c43bf3dc"},
+    {131, 32, 128, Modulus::pow2,
+        "38723a2e5e8a17aa7950dc008209944e898f69a7bd10a23c839d341e935fd5ca"},
+    {132, 8, 129, Modulus::odd, "ae3a17087fcf2f4c24e0a3053f47c446c3e6f2a9c674d4b8ffedb84ecee99ad1"},
+    {132, 8, 129, Modulus::even,
+        "94a654df23c0364028c24ffd24905d48b3518839a0ead93655e5969902fb2acf"},
+    {132, 8, 129, Modulus::even64,
+        "ffeb9b51b6bfbe4c40e2927b436d268e82d75cdf09517746fe07c45460514cfd"},
+    {132, 8, 129, Modulus::pow2,
+        "21d09a2d1c0a65abc9eb2c062cdf40f586cba4b5abf110ccbae8713e9bfd27f8"},
+    {259, 8, 256, Modulus::odd, "ffcd1f5e55b429e02b6b2c232d37521059510bfd9aee0aecd86a55e695c0286d"},
+    {259, 8, 256, Modulus::even,
+        "43145917d813a32d552d91a36ada1ed981fe4fd76019ad8940e6e288f1bc8043"},
+    {259, 8, 256, Modulus::even64,
+        "7ebd39912726b79a4c57a016a63fcff2c51fc43979ea94904a18d5e7e612626e"},
+    {259, 8, 256, Modulus::pow2,
+        "5341e6b2646979a70e57653007a1f310169421ec9bdd9f1a5648f75ade005af1"},
+    {260, 8, 257, Modulus::odd, "4818590288305c7ee621d03384f3d08a248d97f5f26432e41e3f8c5ebcca9e53"},
+    {260, 8, 257, Modulus::even,
+        "5f2da48ff20d21f1fb7598aa6fe909ac039a9640ca467a6ef31e29166bc210bf"},
+    {260, 8, 257, Modulus::even64,
+        "bb6d447c2dfa33544b5ad862424f1e89223ecee41cf3aa251d61ac27a1a18a9e"},
+    {260, 8, 257, Modulus::pow2,
+        "5bfd153b3e4d4acf68b5eeb1e5ba065c76248db5c1bde603df6bb684413620e0"},
+    {515, 8, 512, Modulus::odd, "39874bf4c56a87bed299a60eafe64cc5c24eeda656f21ae37a7dd438b1e7a3dd"},
+    {515, 8, 512, Modulus::even,
+        "9b4bb5d62dcb6b52141154c2598dd7a38fd545c26c6b2efad543fcc6c6440ddf"},
+    {515, 8, 512, Modulus::even64,
+        "eff33979a49a55f00d8884f2eb859b704593e5418716c52c9eef907e38bb0906"},
+    {515, 8, 512, Modulus::pow2,
+        "076a27c79e5ace2a3d47f9dd2e83e4ff6ea8872b3c2218f66c92b89b55f36560"},
+    {523, 8, 520, Modulus::odd, "8502dbe76af3c96ced9691c3675084a5b1f886f5af97304fe70dd5506de3b7c3"},
+    {523, 8, 520, Modulus::even,
+        "baeb13cf37ef437322fea44e99b21c6557c7bfba23cb7e1059e99d5902ce8c5b"},
+    {523, 8, 520, Modulus::even64,
+        "ee051a7f1d0c126836049726e043d768812b0e2528d67e592e6a42beb6fd8370"},
+    {523, 8, 520, Modulus::pow2,
+        "5eac85fbe7add8f981dc08635802c3de840e7c357a48a1a3cb40fbe92aa199da"},
+};
+
+/// Generates the pseudo-random bytes: the top bytes of a 64-bit LCG started from the seed.
+bytes generate(uint64_t seed, size_t size)
+{
+    bytes r(size, 0);
+    for (auto& b : r)
+    {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        b = static_cast<uint8_t>(seed >> 56);
+    }
+    return r;
+}
+
+bytes make_modulus(uint64_t seed, size_t size, Modulus kind)
+{
+    if (kind == Modulus::pow2)
+    {
+        bytes m(size, 0);
+        m[0] = 0x10;
+        return m;
+    }
+    auto m = generate(seed, size);
+    m[0] |= 0x80;
+    if (kind == Modulus::odd)
+        m[size - 1] |= 1;
+    else if (kind == Modulus::even)
+        m[size - 1] = static_cast<uint8_t>((m[size - 1] & 0xf0) | 0x10);
+    else
+    {
+        std::fill_n(&m[size - 8], 8, 0);
+        m[size - 9] = static_cast<uint8_t>((m[size - 9] & 0xfe) | 0x02);
+    }
+    return m;
+}
+
+/// Calls the precompile with the lengths and the data following them.
+evm::precompiles::ExecutionResult call_expmod(evmc_revision rev, uint64_t base_len,
+    uint64_t exp_len, uint64_t mod_len, bytes_view data, int64_t gas, bytes& output)
+{
+    bytes input(96, 0);
+    const uint64_t lens[] = {base_len, exp_len, mod_len};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+            input[32 * i + 31 - j] = static_cast<uint8_t>(lens[i] >> (8 * j));
+    }
+    input += data;
+    return *evm::precompiles::execute(rev, evmc::address{0x05}, input, gas, output);
+}
+}  // namespace
+
+TEST(modexp, kernel_widths_and_crt)
+{
+    for (const auto& [base_len, exp_len, mod_len, kind, digest] : vectors)
+    {
+        SCOPED_TRACE(testing::Message() << mod_len << " " << static_cast<int>(kind));
+        const auto seed = mod_len * 10 + static_cast<size_t>(kind);
+        const auto base = generate(seed + 1000, base_len);
+        const auto exp = generate(seed + 2000, exp_len);
+        const auto mod = make_modulus(seed, mod_len, kind);
+        bytes result(mod_len, 0);
+        evm::precompiles::modexp(result.data(), base, exp, 0, mod);
+        uint8_t hash[32];
+        evm::precompiles::sha256(hash, result.data(), result.size());
+        EXPECT_EQ(to_hex({hash, sizeof(hash)}), digest);
+    }
+}
+
+TEST(modexp, exponent_padding)
+{
+    // 3^(0x01 followed by a zero byte)
+    const auto base = "03"_hex;
+    const auto exp = "01"_hex;
+    uint8_t result[4];
+    evm::precompiles::modexp(result, base, exp, 1, "fffffffb"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "b5987d27");
+    evm::precompiles::modexp(result, base, exp, 1, "10000000"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "0730f401");
+    evm::precompiles::modexp(result, base, exp, 1, "fffffff0"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "7ede04d1");
+    evm::precompiles::modexp(result, base, exp, 40, "fffffffb"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "def911ac");
+}
+
+TEST(modexp, trivial_cases)
+{
+    uint8_t result[4];
+    // A zero exponent.
+    evm::precompiles::modexp(result, "03"_hex, {}, 0, "fffffffb"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "00000001");
+    evm::precompiles::modexp(result, "03"_hex, "0000"_hex, 0, "10000000"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "00000001");
+    // A zero base.
+    evm::precompiles::modexp(result, {}, "05"_hex, 0, "fffffff0"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "00000000");
+    // The moduli 1 and 0.
+    evm::precompiles::modexp(result, "03"_hex, {}, 0, "00000001"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "00000000");
+    evm::precompiles::modexp(result, "03"_hex, "05"_hex, 0, "00000000"_hex);
+    EXPECT_EQ(to_hex({result, 4}), "00000000");
+}
+
+TEST(modexp, precompile)
+{
+    bytes output;
+    // 2^5 mod 100, with the modulus truncated by the end of the input.
+    auto result = call_expmod(EVMC_SHANGHAI, 1, 1, 2, "02 05 00"_hex, 1000, output);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result.gas_left, 1000 - 200);
+    EXPECT_EQ(to_hex(output), "0000");
+    result = call_expmod(EVMC_SHANGHAI, 1, 1, 2, "02 05 0064"_hex, 1000, output);
+    EXPECT_EQ(to_hex(output), "0020");
+
+    // No modulus.
+    result = call_expmod(EVMC_SHANGHAI, 1, 1, 0, "02 05"_hex, 1000, output);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(modexp, gas)
+{
+    struct
+    {
+        evmc_revision rev;
+        uint64_t base_len;
+        uint64_t exp_len;
+        uint64_t mod_len;
+        bytes exp;
+        int64_t cost;
+    } const cases[] = {
+        // The minimum of EIP-2565.
+        {EVMC_BERLIN, 1, 1, 1, "03"_hex, 200},
+        {EVMC_BERLIN, 32, 0, 32, {}, 200},
+        {EVMC_BERLIN, 32, 32, 33, bytes(32, 0), 200},
+        // words^2 * (bits - 1) / 3, before and after EIP-2565.
+        {EVMC_BERLIN, 64, 32, 64, "80"_hex + bytes(31, 0), 5440},
+        {EVMC_ISTANBUL, 64, 32, 64, "80"_hex + bytes(31, 0), 52224},
+        {EVMC_ISTANBUL, 1025, 32, 1025, "80"_hex + bytes(31, 0), 4564296},
+        {EVMC_BERLIN, 256, 1, 256, "01"_hex, 341},
+        // Exponents longer than 32 bytes count 8 iterations per extra byte, and only the bit
+        // length of their first 32 bytes.
+        {EVMC_BERLIN, 32, 40, 32, bytes(39, 0) + "ff"_hex, 341},
+        {EVMC_BERLIN, 32, 40, 32, "80"_hex + bytes(39, 0), 1701},
+    };
+    for (const auto& [rev, base_len, exp_len, mod_len, exp, cost] : cases)
+    {
+        SCOPED_TRACE(testing::Message() << rev << " " << base_len << " " << exp_len);
+        const auto data = bytes(base_len, 0x02) + exp + bytes(mod_len, 0x03);
+        bytes output;
+        auto result = call_expmod(rev, base_len, exp_len, mod_len, data, cost, output);
+        EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+        EXPECT_EQ(result.gas_left, 0);
+        result = call_expmod(rev, base_len, exp_len, mod_len, data, cost - 1, output);
+        EXPECT_EQ(result.status_code, EVMC_OUT_OF_GAS);
+    }
+}
+
+TEST(modexp, huge_lengths_run_out_of_gas)
+{
+    bytes output;
+    const auto huge = std::numeric_limits<uint64_t>::max();
+    for (const auto rev : {EVMC_BYZANTIUM, EVMC_BERLIN})
+    {
+        auto result = call_expmod(rev, 1, huge, 1, "02 80"_hex, 30'000'000, output);
+        EXPECT_EQ(result.status_code, EVMC_OUT_OF_GAS);
+        result = call_expmod(rev, huge, 1, 1, "02 05 07"_hex, 30'000'000, output);
+        EXPECT_EQ(result.status_code, EVMC_OUT_OF_GAS);
+    }
+}
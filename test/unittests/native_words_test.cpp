@@ -0,0 +1,134 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+/// The number of calls of the native word extensions.
+int num_word_calls = 0;
+
+/// The extensions of the state host with the native word functions counting their calls.
+const evm_host_extensions counting_extensions = []() noexcept {
+    auto ext = evm::state::Host::extensions;
+    ext.get_storage_word = [](evmc_host_context* ctx, const evmc_address* addr,
+                               const evm_word* key) noexcept {
+        ++num_word_calls;
+        return evm::state::Host::extensions.get_storage_word(ctx, addr, key);
+    };
+    ext.set_storage_word = [](evmc_host_context* ctx, const evmc_address* addr,
+                               const evm_word* key, const evm_word* value) noexcept {
+        ++num_word_calls;
+        return evm::state::Host::extensions.set_storage_word(ctx, addr, key, value);
+    };
+    ext.get_balance_word = [](evmc_host_context* ctx, const evmc_address* addr) noexcept {
+        ++num_word_calls;
+        return evm::state::Host::extensions.get_balance_word(ctx, addr);
+    };
+    ext.emit_log_words = [](evmc_host_context* ctx, const evmc_address* addr,
+                             const uint8_t* data, size_t data_size, const evm_word topics[],
+                             size_t num_topics) noexcept {
+        ++num_word_calls;
+        evm::state::Host::extensions.emit_log_words(
+            ctx, addr, data, data_size, topics, num_topics);
+    };
+    return ext;
+}();
+
+class native_words : public vm_fixture
+{
+protected:
+    struct Result
+    {
+        evm::state::TransactionReceipt receipt;
+        std::vector<evmc::bytes32> storage;
+        int num_word_calls;
+    };
+
+    native_words() noexcept { evm_set_host_extensions(vm, &counting_extensions); }
+
+    /// Executes the transaction with the native word extensions or the regular host interface,
+    /// and reverts its changes to the state.
+    Result execute(bool words, int64_t gas_limit)
+    {
+        set_option("native_words", words ? "yes" : "no");
+        num_word_calls = 0;
+        evm::state::Transaction tx;
+        tx.sender = sender;
+        tx.recipient = to;
+        tx.value = 0xbeef;
+        tx.gas_limit = gas_limit;
+        Result r{evm::state::transition(vm, state, rev, tx_context, tx), {}, num_word_calls};
+        for (uint64_t key = 0; key < 5; ++key)
+            r.storage.push_back(state.get_storage(to, evmc::bytes32{key}));
+        state.rollback(0);
+        return r;
+    }
+
+    void expect_same_results(int64_t gas_limit)
+    {
+        SCOPED_TRACE(gas_limit);
+        const auto result = execute(true, gas_limit);
+        const auto generic = execute(false, gas_limit);
+        EXPECT_EQ(result.receipt.status, generic.receipt.status);
+        EXPECT_EQ(result.receipt.gas_used, generic.receipt.gas_used);
+        EXPECT_EQ(result.storage, generic.storage);
+        ASSERT_EQ(result.receipt.logs.size(), generic.receipt.logs.size());
+        for (size_t i = 0; i < result.receipt.logs.size(); ++i)
+        {
+            EXPECT_EQ(result.receipt.logs[i].address, generic.receipt.logs[i].address);
+            EXPECT_EQ(result.receipt.logs[i].data, generic.receipt.logs[i].data);
+            EXPECT_EQ(result.receipt.logs[i].topics, generic.receipt.logs[i].topics);
+        }
+    }
+};
+
+evmc::bytes32 to_bytes32(bytes_view b)
+{
+    evmc::bytes32 r;
+    std::copy_n(b.data(), sizeof(r), r.bytes);
+    return r;
+}
+
+/// A value with every byte different, to tell the word order apart.
+const auto big = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"_hex;
+}  // namespace
+
+TEST_F(native_words, same_results_as_host_interface)
+{
+    set_storage(to, evmc::bytes32{0}, to_bytes32("ff"_hex + bytes(30, 0) + "01"_hex));
+
+    // SSTORE(1, big) SSTORE(2, SLOAD(1) + 1) SSTORE(3, BALANCE(sender)) SSTORE(4, SELFBALANCE)
+    // LOG2(0, 0, SLOAD(0), big) SSTORE(0, 0)
+    deploy(to, "7f"_hex + big + "6001 55  6001 54 6001 01 6002 55"_hex +
+                   "615e4d 31 6003 55  47 6004 55"_hex + "7f"_hex + big +
+                   "6000 54 6000 6000 a2  6000 6000 55 00"_hex);
+
+    for (const auto r : {EVMC_ISTANBUL, EVMC_LONDON, EVMC_SHANGHAI})
+    {
+        SCOPED_TRACE(r);
+        rev = r;
+        const auto expected = execute(false, 1'000'000);
+        ASSERT_EQ(expected.receipt.status, EVMC_SUCCESS);
+        EXPECT_EQ(expected.num_word_calls, 0);
+        EXPECT_EQ(expected.storage[1], to_bytes32(big));
+        EXPECT_EQ(bytes_view(expected.storage[2].bytes, 32), big.substr(0, 31) + "20"_hex);
+        EXPECT_NE(expected.storage[3], evmc::bytes32{});
+        EXPECT_EQ(expected.storage[4], evmc::bytes32{0xbeef});
+        ASSERT_EQ(expected.receipt.logs.size(), 1);
+        EXPECT_EQ(expected.receipt.logs[0].topics[1], to_bytes32(big));
+        EXPECT_NE(execute(true, 1'000'000).num_word_calls, 0);
+
+        // The gas used is reduced by the refund: start above it and run out of gas at
+        // different instructions.
+        for (auto gas = 2 * expected.receipt.gas_used; gas > 21'000 && !HasFailure(); gas -= 997)
+            expect_same_results(gas);
+    }
+}
+
+TEST_F(native_words, requires_all_word_extensions)
+{
+    auto ext = counting_extensions;
+    ext.emit_log_words = nullptr;
+    evm_set_host_extensions(vm, &ext);
+    EXPECT_EQ(vm->set_option(vm, "native_words", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+}
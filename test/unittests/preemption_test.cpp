@@ -0,0 +1,84 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address callee{0xca11};
+
+class preemption : public vm_fixture
+{
+protected:
+    preemption()
+    {
+        // i = 100; do { i -= 1 } while (i != 0); SSTORE(0, 1)
+        deploy(callee, "6064 5b 6001 90 03 80 6002 57 50  6001 6000 55"_hex);
+        // SSTORE(0, CALL(GAS, callee, 0, 0, 0, 0, 0))
+        deploy(to, "6000 6000 6000 6000 6000 61ca11 5a f1 6000 55"_hex);
+    }
+
+    evm_execution* create_execution(evm::state::Host& host, const evmc_message& msg)
+    {
+        const auto code = state.find(to)->get_code();
+        return evm_create_execution(
+            vm, &host.get_interface(), host.to_context(), rev, &msg, code.data(), code.size());
+    }
+};
+}  // namespace
+
+TEST_F(preemption, nested_frame_is_preempted)
+{
+    set_option("call_frames");
+    const auto msg = make_message();
+    evm::state::Host host{vm, state, rev, tx_context};
+    auto* execution = create_execution(host, msg);
+    ASSERT_NE(execution, nullptr);
+    ASSERT_TRUE(evm_set_execution_slice(execution, 500));
+
+    // The loop of the callee uses 2600 gas, preempted every 20 iterations (520 gas).
+    int num_preemptions = 0;
+    evmc_result raw_result{};
+    while (evm_run_execution(execution, &raw_result) == EVM_EXECUTION_PREEMPTED)
+        ++num_preemptions;
+    evm_destroy_execution(execution);
+    const evmc::Result result{raw_result};
+
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_GE(num_preemptions, 4);
+    EXPECT_EQ(state.get_storage(to, {}), evmc::bytes32{1});
+    EXPECT_EQ(state.get_storage(callee, {}), evmc::bytes32{1});
+}
+
+TEST_F(preemption, same_gas_as_unsliced)
+{
+    set_option("call_frames");
+    const auto msg = make_message();
+    int64_t gas_left[2] = {};
+    for (const auto gas_slice : {0, 100})
+    {
+        auto copy = state;
+        evm::state::Host host{vm, copy, rev, tx_context};
+        auto* execution = create_execution(host, msg);
+        ASSERT_TRUE(evm_set_execution_slice(execution, gas_slice));
+        evmc_result raw_result{};
+        while (evm_run_execution(execution, &raw_result) != EVM_EXECUTION_DONE)
+        {
+        }
+        evm_destroy_execution(execution);
+        const evmc::Result result{raw_result};
+        EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+        gas_left[gas_slice != 0] = result.gas_left;
+    }
+    EXPECT_EQ(gas_left[1], gas_left[0]);
+}
+
+TEST_F(preemption, slice_requires_call_frames)
+{
+    const auto msg = make_message();
+    evm::state::Host host{vm, state, rev, tx_context};
+    auto* execution = create_execution(host, msg);
+    ASSERT_NE(execution, nullptr);
+    EXPECT_FALSE(evm_set_execution_slice(execution, 500));
+    EXPECT_TRUE(evm_set_execution_slice(execution, 0));
+    evm_destroy_execution(execution);
+}
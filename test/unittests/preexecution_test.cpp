@@ -0,0 +1,115 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class preexecution : public vm_fixture
+{
+protected:
+    evmc::Result preexecute(const evmc::address& addr)
+    {
+        evm::state::Host host{vm, state, rev, tx_context};
+        const auto msg = make_message(addr);
+        const auto code = state.find(addr)->get_code();
+        return evmc::Result{vm->execute(
+            vm, &host.get_interface(), host.to_context(), rev, &msg, code.data(), code.size())};
+    }
+
+    std::vector<evmc::address> accounts()
+    {
+        const evmc_address* p = nullptr;
+        const auto n = evm_get_preexecution_accounts(vm, &p);
+        return {static_cast<const evmc::address*>(p), static_cast<const evmc::address*>(p) + n};
+    }
+
+    std::vector<std::pair<evmc::address, evmc::bytes32>> storage_keys()
+    {
+        const evm_storage_key* p = nullptr;
+        const auto n = evm_get_preexecution_storage_keys(vm, &p);
+        std::vector<std::pair<evmc::address, evmc::bytes32>> keys;
+        for (size_t i = 0; i < n; ++i)
+            keys.emplace_back(p[i].address, p[i].key);
+        return keys;
+    }
+};
+
+constexpr evmc::address callee{0xca11};
+}  // namespace
+
+TEST_F(preexecution, records_accesses_without_writing)
+{
+    // SLOAD(1) BALANCE(0xbeef) SSTORE(2, 3) SSTORE(0, SLOAD(2)) LOG0(0, 0)
+    deploy(to, "6001 54 50  61beef 31 50  6003 6002 55  6002 54 6000 55  6000 6000 a0"_hex);
+    set_option("preexecution", "16");
+
+    EXPECT_EQ(preexecute(to).status_code, EVMC_SUCCESS);
+    EXPECT_EQ(accounts(), std::vector{evmc::address{0xbeef}});
+    EXPECT_EQ(storage_keys(), (std::vector<std::pair<evmc::address, evmc::bytes32>>{
+                                  {to, evmc::bytes32{1}},
+                                  {to, evmc::bytes32{2}},
+                                  {to, evmc::bytes32{0}},
+                              }));
+    EXPECT_EQ(state.checkpoint(), 0);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{2}), evmc::bytes32{});
+}
+
+TEST_F(preexecution, nested_calls_run_against_recording_host)
+{
+    // SSTORE(1, 1) SLOAD(5)
+    deploy(callee, "6001 6001 55  6005 54 50"_hex);
+    // CALL(GAS, callee, 1, 0, 0, 0, 0) SSTORE(0, 1)
+    deploy(to, "6000 6000 6000 6000 6001 61ca11 5a f1 50  6001 6000 55"_hex);
+    state.touch(to).balance = 10;
+    state.commit();
+    set_option("preexecution", "16");
+
+    EXPECT_EQ(preexecute(to).status_code, EVMC_SUCCESS);
+    EXPECT_EQ(accounts(), (std::vector{callee, to}));
+    EXPECT_EQ(storage_keys(), (std::vector<std::pair<evmc::address, evmc::bytes32>>{
+                                  {callee, evmc::bytes32{1}},
+                                  {callee, evmc::bytes32{5}},
+                                  {to, evmc::bytes32{0}},
+                              }));
+
+    // Neither the value transfer nor the writes reach the state.
+    EXPECT_EQ(state.checkpoint(), 0);
+    EXPECT_EQ(state.find(to)->balance, 10);
+    EXPECT_EQ(state.find(callee)->balance, 0);
+    EXPECT_EQ(state.get_storage(callee, evmc::bytes32{1}), evmc::bytes32{});
+}
+
+TEST_F(preexecution, creations_are_not_executed)
+{
+    // Init code: SSTORE(1, 1). Caller: MSTORE(0, init code) SSTORE(0, CREATE(0, 27, 5))
+    deploy(to, "64 6001600155 6000 52  6005 601b 6000 f0  6000 55"_hex);
+    set_option("preexecution", "16");
+
+    EXPECT_EQ(preexecute(to).status_code, EVMC_SUCCESS);
+    EXPECT_EQ(state.checkpoint(), 0);
+    EXPECT_EQ(state.find(evm::state::compute_create_address(to, 0)), nullptr);
+}
+
+TEST_F(preexecution, rejected_at_limit)
+{
+    // SLOAD(1) SLOAD(2) SLOAD(3)
+    deploy(to, "6001 54 50  6002 54 50  6003 54 50"_hex);
+    set_option("preexecution", "2");
+
+    EXPECT_EQ(preexecute(to).status_code, EVMC_REJECTED);
+    EXPECT_EQ(storage_keys().size(), 2);
+}
+
+TEST_F(preexecution, host_extensions_get_host_context)
+{
+    // SSTORE(1, SLOAD(1) + 1), the original value read through the host extensions.
+    deploy(to, "6001 54 6001 01 6001 55"_hex);
+    set_storage(to, evmc::bytes32{1}, evmc::bytes32{7});
+    set_option("storage_journal");
+    set_option("preexecution", "16");
+
+    EXPECT_EQ(preexecute(to).status_code, EVMC_SUCCESS);
+    EXPECT_EQ(storage_keys().size(), 1);
+    EXPECT_EQ(state.checkpoint(), 0);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{1}), evmc::bytes32{7});
+}
@@ -0,0 +1,57 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+struct PrefetchedKeys
+{
+    evmc::address addr;
+    std::vector<evmc::bytes32> keys;
+};
+
+std::vector<PrefetchedKeys> prefetched;
+
+class prefetch : public vm_fixture
+{
+protected:
+    evm_host_extensions extensions = evm::state::Host::extensions;
+
+    prefetch() noexcept
+    {
+        prefetched.clear();
+        extensions.prefetch_storage = [](evmc_host_context*, const evmc_address* addr,
+                                          const evmc_bytes32* keys, size_t num_keys) noexcept {
+            prefetched.push_back({*addr, {keys, keys + num_keys}});
+        };
+        evm_set_host_extensions(vm, &extensions);
+    }
+};
+}  // namespace
+
+TEST_F(prefetch, rejected_with_baseline_interpreter)
+{
+    EXPECT_EQ(vm->set_option(vm, "prefetch", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+    EXPECT_EQ(vm->set_option(vm, "prefetch", "no"), EVMC_SET_OPTION_SUCCESS);
+}
+
+TEST_F(prefetch, requires_prefetch_extension)
+{
+    set_option("advanced");
+    evm_set_host_extensions(vm, &evm::state::Host::extensions);
+    EXPECT_EQ(vm->set_option(vm, "prefetch", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+}
+
+TEST_F(prefetch, constant_keys_of_sload)
+{
+    set_option("advanced");
+    set_option("prefetch");
+
+    // SLOAD(2) SLOAD(1) SLOAD(2) SLOAD(CALLDATASIZE)
+    deploy(to, "6002 54 50  6001 54 50  6002 54 50  36 54 50"_hex);
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+
+    ASSERT_EQ(prefetched.size(), 1);
+    EXPECT_EQ(prefetched[0].addr, to);
+    EXPECT_EQ(prefetched[0].keys, (std::vector{evmc::bytes32{1}, evmc::bytes32{2}}));
+}
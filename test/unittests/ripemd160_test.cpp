@@ -0,0 +1,65 @@
+#include "utils/utils.hpp"
+#include <gtest/gtest.h>
+#include <precompiles/precompiles.hpp>
+#include <precompiles/ripemd160.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+/// The digests of the inputs of sizes around the padding boundaries, from Python's hashlib.
+struct
+{
+    size_t size;
+    const char* digest;
+} constexpr vectors[] = {
+    {0, "9c1185a5c5e9fc54612808977ee8f548b2258d31"},
+    {1, "f291ba5015df348c80853fa5bb0f7946f5c9e1b3"},
+    {55, "d572e603fa9a47ed623eaa8a5b9b6e689171214b"},
+    {56, "5578c46224cc2de8e3c709d5f70478f0539c071f"},
+    {57, "1a2b8b4d6e85dfe8ae15f95149a3a897b98efbc9"},
+    {63, "49e296f205e4ccf0eb622960d857853fffcbf721"},
+    {64, "79b913dafd7cdb22d56f1b488351435e15367d0d"},
+    {65, "3054060a23a22697f78582ae335414b2269ffd69"},
+    {119, "eb2eeb9bfc8034314edf6fef1af24f6c42da6550"},
+    {120, "e6888fd66e598e8971c75704cd4a19976646ed48"},
+    {127, "b93ba37bb476ab11fac3deaf460800d16e588ab2"},
+    {128, "13ce470e11725c14aebb0cee3782c2492d94d833"},
+    {129, "d19184054b54e4e68a0ca54f985a45e3418e2de2"},
+    {1000, "ab77fa5094e8b966f8c115e6570720b7ea0be270"},
+};
+
+/// The input of the size: byte i is i * 7 + 1.
+bytes make_input(size_t size)
+{
+    bytes input(size, 0);
+    for (size_t i = 0; i < size; ++i)
+        input[i] = static_cast<uint8_t>(i * 7 + 1);
+    return input;
+}
+}  // namespace
+
+TEST(ripemd160, padding_boundaries)
+{
+    for (const auto& [size, digest] : vectors)
+    {
+        SCOPED_TRACE(size);
+        const auto input = make_input(size);
+        uint8_t hash[20];
+        evm::precompiles::ripemd160(hash, input.data(), input.size());
+        EXPECT_EQ(to_hex({hash, sizeof(hash)}), digest);
+    }
+}
+
+TEST(ripemd160, precompile)
+{
+    const auto input = make_input(65);
+    bytes output;
+    const auto result = evm::precompiles::execute(
+        EVMC_SHANGHAI, evmc::address{0x03}, input, 2000, output);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result->gas_left, 2000 - (600 + 120 * 3));
+    // The digest is left-padded to 32 bytes.
+    EXPECT_EQ(to_hex(output), std::string(24, '0') + vectors[7].digest);
+}
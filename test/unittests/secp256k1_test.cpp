@@ -0,0 +1,157 @@
+#include "utils/utils.hpp"
+#include <evm/evm.h>
+#include <gtest/gtest.h>
+#include <precompiles/precompiles.hpp>
+#include <precompiles/secp256k1.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+/// Signatures of keccak256("message i") by the private keys 1, 2, 0xc0ffee and n - 1,
+/// from py_ecc.
+struct
+{
+    const char* hash;
+    const char* r;
+    const char* s;
+    uint8_t v;
+    const char* address;
+} constexpr vectors[] = {
+    {"06eaaa302366a2b8e60080fe649cb019814b843b9bd681df41d60bde4badd379",
+        "0b5de7a00c0f71e9d9611e3f11a2470e17b3b5afa5f277391796804175964819",
+        "00cf1aef568eff65c6324e31e3492343fd9a721cb6be2db64f6274251fede285", 27,
+        "7e5f4552091a69125d5dfcb7b8c2659029395bdf"},
+    {"f3bc792f5a550e9e8271695b0d0c1ee9b8d42b9071976b6447658021b3d8099f",
+        "1df0c58f76bdea616a16918b95322553cad57d13137387f0d8224f0a8e1d938d",
+        "2a497096c5ad72541e2e6ca4476b909bd1b00a7488157b26f7bedd2fb2d1e7d4", 28,
+        "2b5ad5c4795c026514f8317c7a215e218dccd6cf"},
+    {"c7c0c5dc03e766cef8ee95a007d3a1e89831d6d3d0cf4e66755d9318886a38df",
+        "9d0dc28650ce00c44a9dbe4dc8d3e275ff00ac70799183d765746827e5de8c6c",
+        "6598a087a2abf4c9076e8bd81a32d16ee76b751f0f52129993c9aace6b5fe3df", 27,
+        "f5a5e415061470a8b9137959180901aea72450a4"},
+    {"cb577bec04c3569c31644d4fe68bdd28a29f7a665cf11944c7aeae6dad5b60dc",
+        "9b757b3f94e503e8f5aa1c77fa279512b0201437bc6c4a111fa4431110b06a24",
+        "530607854c1eeb4c6200636b010ddcab926996c6113b208569e15721cfbb81ce", 28,
+        "80c0dbf239224071c59dd8970ab9d542e3414ab2"},
+};
+
+/// The signer of the first vector with the other parity of R.
+constexpr auto flipped_parity_address = "d043ae9174fb0264de6ea70141442677e43f5374";
+
+/// The secp256k1 group order n.
+constexpr auto order = "fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141";
+
+evmc::bytes32 to_bytes32(const char* hex)
+{
+    evmc::bytes32 r;
+    const auto b = from_hex(hex);
+    std::copy(b.begin(), b.end(), r.bytes);
+    return r;
+}
+
+evm_ecdsa_signature make_signature(size_t i, uint8_t y_parity)
+{
+    const auto& v = vectors[i];
+    return {to_bytes32(v.hash), to_bytes32(v.r), to_bytes32(v.s), y_parity};
+}
+
+/// Calls the ECRECOVER precompile and returns its output.
+bytes call_ecrecover(const char* hash, uint8_t v, const char* r, const char* s)
+{
+    const auto input = from_hex(hash) + bytes(31, 0) + bytes{v} + from_hex(r) + from_hex(s);
+    bytes output;
+    const auto result = evm::precompiles::execute(
+        EVMC_SHANGHAI, evmc::address{0x01}, input, 3000, output);
+    EXPECT_EQ(result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result->gas_left, 0);
+    return output;
+}
+}  // namespace
+
+TEST(secp256k1, ecrecover)
+{
+    for (const auto& [hash, r, s, v, address] : vectors)
+    {
+        SCOPED_TRACE(address);
+        EXPECT_EQ(to_hex(call_ecrecover(hash, v, r, s)), std::string(24, '0') + address);
+    }
+    const auto& [hash, r, s, v, address] = vectors[0];
+    EXPECT_EQ(to_hex(call_ecrecover(hash, 28, r, s)),
+        std::string(24, '0') + flipped_parity_address);
+}
+
+TEST(secp256k1, ecrecover_invalid_signatures)
+{
+    const auto& [hash, r, s, v, address] = vectors[0];
+    const auto zero = std::string(64, '0');
+    // v other than 27 or 28.
+    EXPECT_TRUE(call_ecrecover(hash, 0, r, s).empty());
+    EXPECT_TRUE(call_ecrecover(hash, 1, r, s).empty());
+    EXPECT_TRUE(call_ecrecover(hash, 29, r, s).empty());
+    // r or s zero or not below n.
+    EXPECT_TRUE(call_ecrecover(hash, v, zero.c_str(), s).empty());
+    EXPECT_TRUE(call_ecrecover(hash, v, r, zero.c_str()).empty());
+    EXPECT_TRUE(call_ecrecover(hash, v, order, s).empty());
+    EXPECT_TRUE(call_ecrecover(hash, v, r, order).empty());
+    // No point of the curve has the x coordinate 5.
+    EXPECT_TRUE(
+        call_ecrecover(hash, v, "0000000000000000000000000000000000000000000000000000000000000005",
+            s)
+            .empty());
+
+    // v with nonzero high bytes.
+    auto input = from_hex(hash) + bytes(31, 0) + bytes{v} + from_hex(r) + from_hex(s);
+    input[32] = 1;
+    bytes output;
+    evm::precompiles::execute(EVMC_SHANGHAI, evmc::address{0x01}, input, 3000, output);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(secp256k1, ecrecover_batch)
+{
+    // Enough signatures for several chunks, with invalid ones among them.
+    constexpr size_t num_signatures = 100;
+    std::vector<evm_ecdsa_signature> signatures;
+    for (size_t i = 0; i < num_signatures; ++i)
+    {
+        auto sig = make_signature(i % std::size(vectors), vectors[i % std::size(vectors)].v - 27);
+        if (i % 7 == 3)
+            sig.r = {};
+        signatures.push_back(sig);
+    }
+
+    for (const size_t num_threads : {1, 3, 0})
+    {
+        SCOPED_TRACE(num_threads);
+        std::vector<evmc_address> addresses(num_signatures, evmc::address{0xff});
+        const auto num_valid = evm_ecrecover_batch(
+            signatures.data(), signatures.size(), num_threads, addresses.data());
+        size_t expected_valid = 0;
+        for (size_t i = 0; i < num_signatures; ++i)
+        {
+            const bytes_view address{addresses[i].bytes, sizeof(addresses[i])};
+            if (i % 7 == 3)
+                EXPECT_EQ(to_hex(address), std::string(40, '0'));
+            else
+            {
+                EXPECT_EQ(to_hex(address), vectors[i % std::size(vectors)].address);
+                ++expected_valid;
+            }
+        }
+        EXPECT_EQ(num_valid, expected_valid);
+    }
+    EXPECT_EQ(evm_ecrecover_batch(nullptr, 0, 0, nullptr), 0);
+}
+
+TEST(secp256k1, ecrecover_batch_rejects_legacy_v)
+{
+    const evm_ecdsa_signature signatures[] = {
+        make_signature(0, 0), make_signature(0, 1), make_signature(1, 27), make_signature(1, 28)};
+    evmc_address addresses[std::size(signatures)];
+    EXPECT_EQ(evm_ecrecover_batch(signatures, std::size(signatures), 1, addresses), 2);
+    EXPECT_EQ(to_hex({addresses[0].bytes, 20}), vectors[0].address);
+    EXPECT_EQ(to_hex({addresses[1].bytes, 20}), flipped_parity_address);
+    EXPECT_EQ(to_hex({addresses[2].bytes, 20}), std::string(40, '0'));
+    EXPECT_EQ(to_hex({addresses[3].bytes, 20}), std::string(40, '0'));
+}
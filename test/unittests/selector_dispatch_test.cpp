@@ -0,0 +1,217 @@
+#include "vm_fixture.hpp"
+#include <advanced_analysis.hpp>
+#include <advanced_execution.hpp>
+#include <vector>
+
+using namespace evm::test;
+using evm::advanced::AdvancedCodeAnalysis;
+
+namespace
+{
+/// Where the selector dispatch chain begins.
+enum class ChainStart
+{
+    code_begin,  ///< At the beginning of the code, without a selector on the stack.
+    jumpdest,    ///< At a JUMPDEST after the selector is loaded.
+    jumpi,       ///< After the JUMPI to the fallback taken without input.
+};
+
+/// Returns code loading the selector from the input and checking it with the chain of
+/// DUP1 PUSH4 selector EQ PUSH1 dest JUMPI. The function of the i-th check returns i,
+/// the fallback following the chain returns 0xff.
+bytes make_dispatch_code(const std::vector<uint32_t>& selectors, ChainStart start)
+{
+    // PUSH0 CALLDATALOAD PUSH1 224 SHR
+    const auto load_selector = "5f 35 60e0 1c"_hex;
+    constexpr size_t check_size = 10;
+    constexpr size_t fallback_size = 9;
+    constexpr size_t function_size = 9;
+
+    size_t prologue_size = 0;
+    if (start == ChainStart::jumpdest)
+        prologue_size = load_selector.size() + 4;
+    else if (start == ChainStart::jumpi)
+        prologue_size = load_selector.size() + 5;
+    const auto fallback = prologue_size + selectors.size() * check_size;
+    const auto functions = fallback + fallback_size;
+    EXPECT_LT(functions + selectors.size() * function_size, 256);
+
+    bytes code;
+    if (start == ChainStart::jumpdest)
+    {
+        // PUSH1 chain JUMP JUMPDEST
+        code += load_selector + bytes{0x60, static_cast<uint8_t>(prologue_size - 1), 0x56, 0x5b};
+    }
+    else if (start == ChainStart::jumpi)
+    {
+        // CALLDATASIZE ISZERO PUSH1 fallback JUMPI
+        code += load_selector + bytes{0x36, 0x15, 0x60, static_cast<uint8_t>(fallback), 0x57};
+    }
+    EXPECT_EQ(code.size(), prologue_size);
+
+    for (size_t i = 0; i < selectors.size(); ++i)
+    {
+        const auto dest = static_cast<uint8_t>(functions + i * function_size);
+        code += bytes{0x80, 0x63, static_cast<uint8_t>(selectors[i] >> 24),
+            static_cast<uint8_t>(selectors[i] >> 16), static_cast<uint8_t>(selectors[i] >> 8),
+            static_cast<uint8_t>(selectors[i]), 0x14, 0x60, dest, 0x57};
+    }
+
+    // JUMPDEST MSTORE(0, result) RETURN(0, 32)
+    const auto return_result = [](uint8_t result) {
+        return bytes{0x5b, 0x60, result} + "5f 52 6020 5f f3"_hex;
+    };
+    code += return_result(0xff);
+    for (size_t i = 0; i < selectors.size(); ++i)
+        code += return_result(static_cast<uint8_t>(i));
+    EXPECT_EQ(code.size(), functions + selectors.size() * function_size);
+    return code;
+}
+
+bytes make_input(uint32_t selector)
+{
+    return {static_cast<uint8_t>(selector >> 24), static_cast<uint8_t>(selector >> 16),
+        static_cast<uint8_t>(selector >> 8), static_cast<uint8_t>(selector)};
+}
+
+class selector_dispatch : public vm_fixture
+{
+protected:
+    struct Result
+    {
+        evmc_status_code status;
+        int64_t gas_left;
+        bytes output;
+    };
+
+    bytes code;
+    AdvancedCodeAnalysis accelerated;
+    AdvancedCodeAnalysis plain;
+
+    /// Analyzes the code with the selector dispatch chains replaced by the hash table lookup
+    /// and with the chains restored.
+    void analyze(const std::vector<uint32_t>& selectors, ChainStart start)
+    {
+        code = make_dispatch_code(selectors, start);
+        accelerated = evm::advanced::analyze(rev, code);
+        plain = evm::advanced::analyze(rev, code);
+
+        const auto& op_tbl = evm::advanced::get_op_table(rev);
+        for (const auto& dispatch : plain.selector_dispatches)
+        {
+            auto& instr = plain.instrs[static_cast<size_t>(dispatch.begin)];
+            instr.fn = (instr.fn == evm::advanced::op_jumpi_dispatch_selector) ?
+                           op_tbl[OP_JUMPI].fn :
+                           op_tbl[evm::advanced::OPX_BEGINBLOCK].fn;
+        }
+    }
+
+    Result execute(const AdvancedCodeAnalysis& analysis, bytes_view input, int64_t gas)
+    {
+        auto msg = make_message(to, gas);
+        msg.input_data = input.data();
+        msg.input_size = input.size();
+        evm::state::Host host{vm, state, rev, tx_context};
+        const auto exec_state = std::make_unique<evm::advanced::AdvancedExecutionState>(
+            msg, rev, host.get_interface(), host.to_context(), code);
+        const auto result = evmc::Result{evm::advanced::execute(*exec_state, analysis)};
+        return {result.status_code, result.gas_left, {result.output_data, result.output_size}};
+    }
+
+    /// Executes the input with both analyses, expecting the same result, and returns it.
+    Result expect_same_result(bytes_view input, int64_t gas = 1'000'000)
+    {
+        const auto result = execute(accelerated, input, gas);
+        const auto expected = execute(plain, input, gas);
+        EXPECT_EQ(result.status, expected.status);
+        EXPECT_EQ(result.gas_left, expected.gas_left);
+        EXPECT_EQ(to_hex(result.output), to_hex(expected.output));
+        return result;
+    }
+
+    /// Returns the byte returned by the function the input is dispatched to.
+    uint8_t dispatch(bytes_view input)
+    {
+        const auto result = expect_same_result(input);
+        EXPECT_EQ(result.status, EVMC_SUCCESS);
+        return result.output.size() == 32 ? result.output[31] : 0;
+    }
+};
+
+const std::vector<uint32_t> selectors{
+    0xa9059cbb, 0x095ea7b3, 0x23b872dd, 0x70a08231, 0x18160ddd, 0xdd62ed3e};
+}  // namespace
+
+TEST_F(selector_dispatch, chain_at_jumpdest)
+{
+    analyze(selectors, ChainStart::jumpdest);
+    ASSERT_EQ(accelerated.selector_dispatches.size(), 1);
+    const auto& chain = accelerated.selector_dispatches.front();
+    EXPECT_EQ(accelerated.instrs[static_cast<size_t>(chain.begin)].fn,
+        evm::advanced::opx_dispatch_selector);
+    EXPECT_EQ(chain.targets.size(), selectors.size());
+
+    for (size_t i = 0; i < selectors.size(); ++i)
+        EXPECT_EQ(dispatch(make_input(selectors[i])), i);
+    EXPECT_EQ(dispatch(make_input(0x12345678)), 0xff);
+    EXPECT_EQ(dispatch("ffffffffff"_hex), 0xff);
+}
+
+TEST_F(selector_dispatch, chain_after_jumpi)
+{
+    analyze(selectors, ChainStart::jumpi);
+    ASSERT_EQ(accelerated.selector_dispatches.size(), 1);
+    const auto& chain = accelerated.selector_dispatches.front();
+    EXPECT_EQ(accelerated.instrs[static_cast<size_t>(chain.begin)].fn,
+        evm::advanced::op_jumpi_dispatch_selector);
+
+    for (size_t i = 0; i < selectors.size(); ++i)
+        EXPECT_EQ(dispatch(make_input(selectors[i])), i);
+    EXPECT_EQ(dispatch(make_input(0x12345678)), 0xff);
+    // The JUMPI to the fallback is taken.
+    EXPECT_EQ(dispatch({}), 0xff);
+}
+
+TEST_F(selector_dispatch, duplicate_selector_takes_first_match)
+{
+    const std::vector<uint32_t> with_duplicate{
+        selectors[0], selectors[1], selectors[0], selectors[2], selectors[3]};
+    analyze(with_duplicate, ChainStart::jumpdest);
+    ASSERT_EQ(accelerated.selector_dispatches.size(), 1);
+    EXPECT_EQ(accelerated.selector_dispatches.front().targets.size(), 4);
+
+    EXPECT_EQ(dispatch(make_input(selectors[0])), 0);
+    EXPECT_EQ(dispatch(make_input(selectors[3])), 4);
+    EXPECT_EQ(dispatch(make_input(0x12345678)), 0xff);
+}
+
+TEST_F(selector_dispatch, short_chain_is_not_accelerated)
+{
+    analyze({selectors[0], selectors[1], selectors[2]}, ChainStart::jumpdest);
+    EXPECT_TRUE(accelerated.selector_dispatches.empty());
+}
+
+TEST_F(selector_dispatch, insufficient_gas_falls_back_to_chain)
+{
+    for (const auto start : {ChainStart::jumpdest, ChainStart::jumpi})
+    {
+        analyze(selectors, start);
+        for (const auto& input : {make_input(selectors.back()), make_input(0x12345678)})
+        {
+            const auto gas_used = 1'000'000 - execute(plain, input, 1'000'000).gas_left;
+            for (int64_t gas = 0; gas <= gas_used && !HasFailure(); ++gas)
+            {
+                SCOPED_TRACE(gas);
+                expect_same_result(input, gas);
+            }
+        }
+    }
+}
+
+TEST_F(selector_dispatch, insufficient_stack_falls_back_to_chain)
+{
+    analyze(selectors, ChainStart::code_begin);
+    ASSERT_EQ(accelerated.selector_dispatches.size(), 1);
+    EXPECT_EQ(accelerated.selector_dispatches.front().begin, 0);
+    EXPECT_EQ(expect_same_result(make_input(selectors[0])).status, EVMC_STACK_UNDERFLOW);
+}
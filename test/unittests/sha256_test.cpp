@@ -0,0 +1,80 @@
+#include "utils/utils.hpp"
+#include <gtest/gtest.h>
+#include <precompiles/precompiles.hpp>
+#include <precompiles/sha256.hpp>
+
+using namespace evm::test;
+
+namespace
+{
+/// The digests of the inputs of sizes around the padding boundaries, from Python's hashlib.
+struct
+{
+    size_t size;
+    const char* digest;
+} constexpr vectors[] = {
+    {0, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+    {1, "4bf5122f344554c53bde2ebb8cd2b7e3d1600ad631c385a5d7cce23c7785459a"},
+    {55, "16fa57a0a3423a715d594516339f36189d6b5f93754a9714fef202616a9fabfe"},
+    {56, "c37b44e5f1b18554b36966f4f8e08bfbf3164c4b6c10374d12d89850892073c5"},
+    {57, "12b234922502022f755ab8550a3d4e202ad39c81d961a4f59ec39d5fd83d15a7"},
+    {63, "bbba992d2c85af960fb2987a1fd05e0aa82a3db3c740dd8982a9e273b75e36a3"},
+    {64, "66bd4633ed6f71c4ecfa4763bf7ba1c8ec7612de9aa6c0578a7b675207c71e0b"},
+    {65, "9f7dc47107b750a1f3d35db5d9547f24ef40da5b731b9540d4f43710a154f6c9"},
+    {119, "a3ed307b730fa77c07531300c6e4a282330011d4d4caf6bb7b63ae05950f4b66"},
+    {120, "8e3b15d9fea7472655aa069620b7f8c2e55ee1499f763200a7515fe826e99d20"},
+    {127, "44480fb9672845177f5368a08b69ea263275f2a5ec42e06a933370fe0d2968a4"},
+    {128, "e462c130fef8c97e34f7dc3ff3ad2f8b3533ab849af21c10531552a2852387a4"},
+    {129, "aa7ea4e8bf89146aeb67ff195fd8182a0e504c9d580aa7af8d2c862e14b98405"},
+    {1000, "095ecb62e30793ab4b954cd6a0586d0cc91f7ea5b1332694d8da780e98676d78"},
+};
+
+/// The input of the size: byte i is i * 7 + 1.
+bytes make_input(size_t size)
+{
+    bytes input(size, 0);
+    for (size_t i = 0; i < size; ++i)
+        input[i] = static_cast<uint8_t>(i * 7 + 1);
+    return input;
+}
+
+/// Runs the tests with the SHA extensions (true) and with the portable implementation (false).
+class sha256 : public testing::TestWithParam<bool>
+{
+protected:
+    void SetUp() override
+    {
+        if (evm::precompiles::sha256_use_sha_ni(GetParam()) != GetParam())
+            GTEST_SKIP() << "no SHA extensions";
+    }
+
+    void TearDown() override { evm::precompiles::sha256_use_sha_ni(true); }
+};
+}  // namespace
+
+TEST_P(sha256, padding_boundaries)
+{
+    for (const auto& [size, digest] : vectors)
+    {
+        SCOPED_TRACE(size);
+        const auto input = make_input(size);
+        uint8_t hash[32];
+        evm::precompiles::sha256(hash, input.data(), input.size());
+        EXPECT_EQ(to_hex({hash, sizeof(hash)}), digest);
+    }
+}
+
+TEST_P(sha256, precompile)
+{
+    const auto input = make_input(65);
+    bytes output;
+    const auto result = evm::precompiles::execute(
+        EVMC_SHANGHAI, evmc::address{0x02}, input, 1000, output);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result->gas_left, 1000 - (60 + 12 * 3));
+    EXPECT_EQ(to_hex(output), vectors[7].digest);
+}
+
+INSTANTIATE_TEST_SUITE_P(sha256, sha256, testing::Values(true, false),
+    [](const testing::TestParamInfo<bool>& info) { return info.param ? "sha_ni" : "portable"; });
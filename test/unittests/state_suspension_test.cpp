@@ -0,0 +1,70 @@
+#include "utils/latent_host.hpp"
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+constexpr evmc::address callee{0xca11};
+constexpr evmc::address beneficiary{0xbeef};
+
+class state_suspension : public vm_fixture
+{
+protected:
+    /// Executes the code at the `to` address as a suspendable execution against a latent host
+    /// and checks it never blocked on an unloaded state item.
+    evmc::Result execute_suspendable(bytes_view code)
+    {
+        deploy(to, code);
+        state.touch(to).balance = 100;
+        state.touch(callee);
+        state.commit();
+
+        evm_set_host_extensions(vm, &LatentHost::extensions);
+        LatentHost host{vm, state, rev, tx_context, {}};
+        auto results = host.execute_interleaved({make_message()});
+        EXPECT_EQ(host.num_blocking_loads(), 0);
+        return std::move(results[0]);
+    }
+};
+}  // namespace
+
+TEST_F(state_suspension, call_with_value)
+{
+    // MSTORE(0, CALL(GAS, callee, 7, 0, 0, 0, 0)) RETURN(0, 32)
+    const auto result =
+        execute_suspendable("6000 6000 6000 6000 6007 61ca11 5a f1 6000 52 6020 6000 f3"_hex);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, 32);
+    EXPECT_EQ(result.output_data[31], 1);
+    EXPECT_EQ(state.find(callee)->balance, 7);
+}
+
+TEST_F(state_suspension, callcode_with_value)
+{
+    // MSTORE(0, CALLCODE(GAS, callee, 7, 0, 0, 0, 0)) RETURN(0, 32)
+    const auto result =
+        execute_suspendable("6000 6000 6000 6000 6007 61ca11 5a f2 6000 52 6020 6000 f3"_hex);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, 32);
+    EXPECT_EQ(result.output_data[31], 1);
+}
+
+TEST_F(state_suspension, selfbalance)
+{
+    // MSTORE(0, SELFBALANCE) RETURN(0, 32)
+    const auto result = execute_suspendable("47 6000 52 6020 6000 f3"_hex);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, 32);
+    EXPECT_EQ(result.output_data[31], 100);
+}
+
+TEST_F(state_suspension, selfdestruct)
+{
+    // SELFDESTRUCT(beneficiary)
+    const auto result = execute_suspendable("61beef ff"_hex);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result.gas_left, 1'000'000 - 3 - 5000 - 2600 - 25000);
+    state.commit();
+    EXPECT_EQ(state.find(beneficiary)->balance, 100);
+}
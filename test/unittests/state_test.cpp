@@ -0,0 +1,94 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+using namespace evmc::literals;
+
+namespace
+{
+/// A view with a single account with a storage slot.
+class SingleAccountView : public evm::state::StateView
+{
+public:
+    static constexpr evmc::address addr{0xacc};
+    static constexpr evmc::bytes32 key{1};
+
+    int num_loads = 0;
+
+    std::optional<evm::state::Account> get_account(const evmc::address& a) noexcept override
+    {
+        ++num_loads;
+        if (a != addr)
+            return std::nullopt;
+        evm::state::Account account;
+        account.balance = 1;
+        return account;
+    }
+
+    evmc::bytes32 get_storage(const evmc::address& a, const evmc::bytes32& k) noexcept override
+    {
+        return (a == addr && k == key) ? evmc::bytes32{2} : evmc::bytes32{};
+    }
+};
+
+using host = vm_fixture;
+}  // namespace
+
+TEST(state, destructed_account_is_not_reloaded_from_view)
+{
+    SingleAccountView view;
+    evm::state::State state{view};
+    ASSERT_NE(state.find(view.addr), nullptr);
+    EXPECT_EQ(state.get_storage(view.addr, view.key), evmc::bytes32{2});
+    state.destruct(view.addr);
+    state.commit();
+
+    EXPECT_EQ(state.find(view.addr), nullptr);
+    EXPECT_EQ(view.num_loads, 1);
+
+    // A recreated account starts with empty storage.
+    state.touch(view.addr);
+    EXPECT_EQ(state.get_storage(view.addr, view.key), evmc::bytes32{});
+}
+
+TEST(state, reverted_destruct_keeps_account)
+{
+    SingleAccountView view;
+    evm::state::State state{view};
+    const auto checkpoint = state.checkpoint();
+    state.destruct(view.addr);
+    state.rollback(checkpoint);
+    state.commit();
+
+    ASSERT_NE(state.find(view.addr), nullptr);
+    EXPECT_EQ(state.find(view.addr)->balance, 1);
+    EXPECT_EQ(state.get_storage(view.addr, view.key), evmc::bytes32{2});
+}
+
+TEST_F(host, executes_precompiles)
+{
+    // MSTORE(0, 0x1234) CALL(GAS, 0x04, 0, 0, 32, 32, 32) SSTORE(0, MLOAD(32))
+    deploy(to, "611234 6000 52  6020 6020 6020 6000 6000 6004 5a f1 50  6020 51 6000 55"_hex);
+    set_option("precompiles", "no");
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{}), evmc::bytes32{0x1234});
+}
+
+TEST_F(host, executes_precompiles_called_with_value)
+{
+    // CALL(GAS, 0x02, 1, 0, 32, 0, 32) SSTORE(0, MLOAD(0)): SHA-256 of 32 zero bytes.
+    deploy(to, "6020 6000 6020 6000 6001 6002 5a f1 50  6000 51 6000 55"_hex);
+    set_option("precompiles");
+    EXPECT_EQ(transact(to, {}, 1'000'000, 1).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{}),
+        0x66687aadf862bd776c8fc18b8e9f8e20089714856ee233b3902a591d0d5f2925_bytes32);
+    EXPECT_EQ(state.find(evmc::address{0x02})->balance, 1);
+}
+
+TEST_F(host, precompile_out_of_gas)
+{
+    // SSTORE(0, CALL(50, 0x02, 0, 0, 32, 0, 32)): SHA-256 costs 72 gas.
+    deploy(to, "6020 6000 6020 6000 6000 6002 6032 f1 6000 55"_hex);
+    set_option("precompiles", "no");
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{}), evmc::bytes32{});
+}
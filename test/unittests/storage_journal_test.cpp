@@ -0,0 +1,118 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+using storage_journal = vm_fixture;
+
+constexpr evmc::bytes32 slot{1};
+
+/// SSTOREs the values to the slot in sequence.
+bytes sstore_sequence(const std::vector<uint8_t>& values)
+{
+    bytes code;
+    for (const auto v : values)
+        code += bytes{0x60, v, 0x60, 0x01, 0x55};
+    return code;
+}
+}  // namespace
+
+TEST_F(storage_journal, gas_and_storage_match_host)
+{
+    struct Case
+    {
+        uint8_t original;
+        std::vector<uint8_t> values;
+    };
+    const Case cases[] = {
+        {0, {1}},
+        {0, {0}},
+        {0, {1, 0}},
+        {0, {1, 2}},
+        {0, {1, 2, 0}},
+        {1, {1}},
+        {1, {2}},
+        {1, {0}},
+        {1, {0, 1}},
+        {1, {2, 1}},
+        {1, {0, 2}},
+        {1, {2, 0, 1}},
+    };
+
+    uint64_t n = 0;
+    for (const auto& c : cases)
+    {
+        SCOPED_TRACE(n);
+        const evmc::address plain{0x1000 + ++n};
+        const evmc::address journaled{0x2000 + n};
+        const auto code = sstore_sequence(c.values);
+        for (const auto& addr : {plain, journaled})
+        {
+            deploy(addr, code);
+            set_storage(addr, slot, evmc::bytes32{c.original});
+        }
+
+        set_option("storage_journal", "no");
+        const auto expected = transact(plain);
+        set_option("storage_journal");
+        const auto receipt = transact(journaled);
+
+        EXPECT_EQ(receipt.status, EVMC_SUCCESS);
+        EXPECT_EQ(receipt.status, expected.status);
+        EXPECT_EQ(receipt.gas_used, expected.gas_used);
+        EXPECT_EQ(state.get_storage(journaled, slot), state.get_storage(plain, slot));
+        EXPECT_EQ(state.get_storage(journaled, slot), evmc::bytes32{c.values.back()});
+    }
+}
+
+TEST_F(storage_journal, sload_sees_pending_writes)
+{
+    // SSTORE(1, 5) SSTORE(2, SLOAD(1))
+    deploy(to, "6005 6001 55  6001 54 6002 55"_hex);
+    set_option("storage_journal");
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{2}), evmc::bytes32{5});
+}
+
+TEST_F(storage_journal, reverted_call_drops_writes)
+{
+    constexpr evmc::address callee{0xca11};
+    // SSTORE(1, 1) REVERT(0, 0)
+    deploy(callee, "6001 6001 55  6000 6000 fd"_hex);
+    // CALL(GAS, callee, 0, 0, 0, 0, 0) SSTORE(2, 1)
+    deploy(to, "6000 6000 6000 6000 6000 61ca11 5a f1 50  6001 6002 55"_hex);
+
+    set_option("storage_journal");
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(callee, slot), evmc::bytes32{});
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{2}), evmc::bytes32{1});
+}
+
+TEST_F(storage_journal, failed_transaction_writes_nothing)
+{
+    // SSTORE(1, 1) INVALID
+    deploy(to, "6001 6001 55 fe"_hex);
+    set_option("storage_journal");
+    EXPECT_EQ(transact(to).status, EVMC_INVALID_INSTRUCTION);
+    EXPECT_EQ(state.get_storage(to, slot), evmc::bytes32{});
+}
+
+TEST_F(storage_journal, requires_original_storage_extension)
+{
+    evm_set_host_extensions(vm, nullptr);
+    EXPECT_EQ(vm->set_option(vm, "storage_journal", "yes"), EVMC_SET_OPTION_INVALID_VALUE);
+}
+
+TEST_F(storage_journal, failed_code_deposit_drops_init_code_writes)
+{
+    // Init code: SSTORE(1, 1) MSTORE8(0, 0xef) RETURN(0, 1), rejected by EIP-3541.
+    // Caller: MSTORE(0, init code) CREATE(0, 32 - 15, 15) SSTORE(0, result)
+    deploy(to, "6e 6001600155 60ef600053 60016000f3  6000 52  600f 6011 6000 f0  6000 55"_hex);
+    const auto created = evm::state::compute_create_address(to, 0);
+
+    set_option("storage_journal");
+    EXPECT_EQ(transact(to).status, EVMC_SUCCESS);
+    EXPECT_EQ(state.get_storage(to, evmc::bytes32{}), evmc::bytes32{});
+    EXPECT_EQ(state.find(created), nullptr);
+}
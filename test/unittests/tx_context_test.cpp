@@ -0,0 +1,76 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class shared_tx_context : public vm_fixture
+{
+protected:
+    /// The origin reported by the host: the transaction sender.
+    static constexpr evmc::bytes32 host_origin{0x5e4d};
+
+    shared_tx_context() noexcept
+    {
+        tx_context.block_number = 1;
+
+        // SSTORE(0, ORIGIN) SSTORE(1, NUMBER)
+        deploy(to, "32 6000 55  43 6001 55"_hex);
+    }
+
+    evmc::bytes32 origin() { return state.get_storage(to, evmc::bytes32{0}); }
+    evmc::bytes32 number() { return state.get_storage(to, evmc::bytes32{1}); }
+};
+}  // namespace
+
+TEST_F(shared_tx_context, used_when_both_parts_are_installed)
+{
+    evmc_tx_context shared{};
+    shared.block_number = 2;
+    shared.tx_origin = evmc::address{0xbbbb};
+
+    evm_set_block_context(vm, &shared);
+    transact(to);
+    EXPECT_EQ(origin(), host_origin);
+    EXPECT_EQ(number(), evmc::bytes32{1});
+
+    evm_set_tx_context(vm, &shared);
+    transact(to);
+    EXPECT_EQ(origin(), evmc::bytes32{0xbbbb});
+    EXPECT_EQ(number(), evmc::bytes32{2});
+}
+
+TEST_F(shared_tx_context, null_tx_context_falls_back_to_host)
+{
+    evmc_tx_context shared{};
+    shared.block_number = 2;
+    shared.tx_origin = evmc::address{0xbbbb};
+    evm_set_block_context(vm, &shared);
+    evm_set_tx_context(vm, &shared);
+
+    evm_set_tx_context(vm, nullptr);
+    transact(to);
+    EXPECT_EQ(origin(), host_origin);
+    EXPECT_EQ(number(), evmc::bytes32{1});
+
+    // The block part stays installed.
+    evm_set_tx_context(vm, &shared);
+    transact(to);
+    EXPECT_EQ(origin(), evmc::bytes32{0xbbbb});
+    EXPECT_EQ(number(), evmc::bytes32{2});
+}
+
+TEST_F(shared_tx_context, null_block_context_removes_both_parts)
+{
+    evmc_tx_context shared{};
+    shared.block_number = 2;
+    shared.tx_origin = evmc::address{0xbbbb};
+    evm_set_block_context(vm, &shared);
+    evm_set_tx_context(vm, &shared);
+
+    evm_set_block_context(vm, nullptr);
+    evm_set_tx_context(vm, &shared);
+    transact(to);
+    EXPECT_EQ(origin(), host_origin);
+    EXPECT_EQ(number(), evmc::bytes32{1});
+}
@@ -0,0 +1,76 @@
+#include "vm_fixture.hpp"
+
+using namespace evm::test;
+
+namespace
+{
+class unmetered : public vm_fixture
+{
+protected:
+    /// Executes the code with the "unmetered" option or not.
+    evmc::Result execute(const char* unmetered, bytes_view code, int64_t gas = 1'000'000)
+    {
+        set_option("unmetered", unmetered);
+        return vm_fixture::execute(code, gas);
+    }
+};
+}  // namespace
+
+TEST_F(unmetered, costs_are_not_charged)
+{
+    // i = 100; x = 1; do { x = x * 3 + i; i -= 1 } while (i != 0); MSTORE(0, x) RETURN(0, 32)
+    const auto code =
+        "6064 6001  5b 6003 02 81 01  90 6001 90 03 90  81 6004 57  6000 52 6020 6000 f3"_hex;
+    const auto metered = execute("no", code);
+    const auto unmetered = execute("yes", code);
+    ASSERT_EQ(metered.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(unmetered.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(to_hex({unmetered.output_data, unmetered.output_size}),
+        to_hex({metered.output_data, metered.output_size}));
+    // The budget of the 100 loop iterations.
+    EXPECT_EQ(1'000'000 - unmetered.gas_left, 100);
+}
+
+TEST_F(unmetered, dynamic_costs_are_not_charged)
+{
+    // KECCAK256(0, 64) POP  EXP(2, 255) POP  MSTORE(1000, 0)  SSTORE(1, 1)  LOG0(0, 32)
+    const auto result = execute(
+        "yes", "6040 6000 20 50  60ff 6002 0a 50  5f 6103e8 52  6001 6001 55  6020 5f a0"_hex);
+    ASSERT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(result.gas_left, 1'000'000);
+    EXPECT_EQ(result.gas_refund, 0);
+}
+
+TEST_F(unmetered, calls_share_the_budget)
+{
+    // The callee: i = 3; do { i -= 1 } while (i != 0)
+    constexpr evmc::address callee{0xca11};
+    deploy(callee, "6003  5b 6001 90 03 80 6002 57 00"_hex);
+
+    // MSTORE(0, CALL(0, callee, 0, 0, 0, 0, 0)) RETURN(0, 32): the callee gets no gas.
+    const auto code = "5f 5f 5f 5f 5f 61ca11 5f f1  5f 52 6020 5f f3"_hex;
+    const auto metered = execute("no", code);
+    const auto unmetered = execute("yes", code);
+    ASSERT_EQ(metered.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(unmetered.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(metered.output_data[31], 0);
+    EXPECT_EQ(unmetered.output_data[31], 1);
+    // The budget of the 3 loop iterations of the callee.
+    EXPECT_EQ(unmetered.gas_left, 1'000'000 - 3);
+}
+
+TEST_F(unmetered, failed_frames_return_their_budget)
+{
+    EXPECT_EQ(execute("yes", "5b fe"_hex).gas_left, 1'000'000 - 1);
+    EXPECT_EQ(execute("no", "5b fe"_hex).gas_left, 0);
+}
+
+TEST_F(unmetered, executions_are_bounded)
+{
+    // An infinite loop: JUMPDEST PUSH0 JUMP.
+    EXPECT_EQ(execute("yes", "5b 5f 56"_hex).status_code, EVMC_OUT_OF_GAS);
+
+    // MSTORE(16 MiB - 32, 0) and MSTORE(16 MiB - 31, 0): memory is limited to 16 MiB.
+    EXPECT_EQ(execute("yes", "5f 63 00ffffe0 52"_hex).status_code, EVMC_SUCCESS);
+    EXPECT_EQ(execute("yes", "5f 63 00ffffe1 52"_hex).status_code, EVMC_OUT_OF_GAS);
+}
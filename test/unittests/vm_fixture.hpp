@@ -0,0 +1,95 @@
+#pragma once
+
+#include "utils/utils.hpp"
+#include <evm/evm.h>
+#include <gtest/gtest.h>
+#include <state/host.hpp>
+#include <state/transaction.hpp>
+
+namespace evm::test
+{
+/// Executes transactions with a VM instance against an in-memory state.
+class vm_fixture : public testing::Test
+{
+protected:
+    static constexpr evmc::address sender{0x5e4d};
+    static constexpr evmc::address to{0xc0de};
+
+    evmc_vm* const vm = evmc_create_evm();
+    evmc_revision rev = EVMC_SHANGHAI;
+    evmc_tx_context tx_context{};
+    state::State state;
+
+    vm_fixture() noexcept
+    {
+        evm_set_host_extensions(vm, &state::Host::extensions);
+        state.touch(sender).balance = 1'000'000'000;
+        state.commit();
+    }
+
+    ~vm_fixture() noexcept override { vm->destroy(vm); }
+
+    void set_option(const char* name, const char* value = "yes")
+    {
+        ASSERT_EQ(vm->set_option(vm, name, value), EVMC_SET_OPTION_SUCCESS) << name;
+    }
+
+    /// Deploys the code at the address, outside of any transaction.
+    void deploy(const evmc::address& addr, bytes_view code) noexcept
+    {
+        state.set_code(addr, code);
+        state.commit();
+    }
+
+    /// Sets the storage slot, outside of any transaction.
+    void set_storage(
+        const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) noexcept
+    {
+        state.set_storage(addr, key, value);
+        state.commit();
+    }
+
+    /// Returns the message of a call from the sender to the code of the recipient.
+    static evmc_message make_message(
+        const evmc::address& recipient = to, int64_t gas = 1'000'000) noexcept
+    {
+        evmc_message msg{};
+        msg.gas = gas;
+        msg.recipient = recipient;
+        msg.code_address = recipient;
+        msg.sender = sender;
+        return msg;
+    }
+
+    /// Executes the code as the code of the `to` address, outside of any transaction.
+    evmc::Result execute(bytes_view code, int64_t gas = 1'000'000) noexcept
+    {
+        const auto msg = make_message(to, gas);
+        state::Host host{vm, state, rev, tx_context};
+        return evmc::Result{vm->execute(vm, &host.get_interface(), host.to_context(), rev, &msg,
+            code.data(), code.size())};
+    }
+
+    state::TransactionReceipt transact(const evmc::address& recipient, bytes_view input = {},
+        int64_t gas_limit = 1'000'000, const intx::uint256& value = 0) noexcept
+    {
+        state::Transaction tx;
+        tx.sender = sender;
+        tx.recipient = recipient;
+        tx.value = value;
+        tx.gas_limit = gas_limit;
+        tx.data = input;
+        return state::execute_transaction(vm, state, rev, tx_context, tx);
+    }
+
+    state::TransactionReceipt transact_create(bytes_view init_code, int64_t gas_limit = 1'000'000)
+    {
+        state::Transaction tx;
+        tx.kind = EVMC_CREATE;
+        tx.sender = sender;
+        tx.gas_limit = gas_limit;
+        tx.data = init_code;
+        return state::execute_transaction(vm, state, rev, tx_context, tx);
+    }
+};
+}  // namespace evm::test
@@ -0,0 +1,160 @@
+#include "latent_host.hpp"
+#include "utils.hpp"
+#include <cassert>
+#include <thread>
+
+namespace evm::test
+{
+const evm_host_extensions LatentHost::extensions = []() noexcept {
+    evm_host_extensions ext{};
+    ext.request_state = [](evmc_host_context* ctx, evm_state_kind kind, const evmc_address* addr,
+                            const evmc_bytes32* key) noexcept {
+        auto& host = static_cast<LatentHost&>(*reinterpret_cast<evmc::Host*>(ctx));
+        return host.request_state(kind, *addr, static_cast<const evmc::bytes32*>(key));
+    };
+    return ext;
+}();
+
+int64_t& LatentHost::load_status(
+    const evmc::address& addr, const evmc::bytes32* key) const noexcept
+{
+    return key != nullptr ? m_slots.try_emplace({addr, *key}).first :
+                            m_accounts.try_emplace(addr).first;
+}
+
+void LatentHost::load(const evmc::address& addr, const evmc::bytes32* key) const noexcept
+{
+    auto& status = load_status(addr, key);
+    if (status == loaded)
+        return;
+    const auto ready_time = (status == unloaded) ?
+                                Clock::now() + m_latency :
+                                m_loads[static_cast<size_t>(status - 1)].ready_time;
+    std::this_thread::sleep_until(ready_time);
+    status = loaded;
+    ++m_num_blocking_loads;
+}
+
+bool LatentHost::request_state(
+    evm_state_kind kind, const evmc::address& addr, const evmc::bytes32* key) noexcept
+{
+    const auto slot_key = (kind == EVM_STATE_STORAGE) ? key : nullptr;
+    auto& status = load_status(addr, slot_key);
+    if (status == loaded)
+        return true;
+    if (status == unloaded)
+    {
+        m_loads.push_back({Clock::now() + m_latency, addr,
+            slot_key != nullptr ? std::optional{*slot_key} : std::nullopt});
+        status = static_cast<int64_t>(m_loads.size());
+    }
+    m_last_load = static_cast<size_t>(status - 1);
+    return false;
+}
+
+size_t LatentHost::complete_next_load() noexcept
+{
+    assert(has_pending_loads());
+    const auto& next = m_loads[m_next_load];
+    std::this_thread::sleep_until(next.ready_time);
+    load_status(next.addr, next.key.has_value() ? &*next.key : nullptr) = loaded;
+    return m_next_load++;
+}
+
+std::vector<evmc::Result> LatentHost::execute_interleaved(
+    const std::vector<evmc_message>& msgs) noexcept
+{
+    std::vector<std::shared_ptr<const bytes>> codes(msgs.size());
+    std::vector<evm_execution*> executions(msgs.size());
+    std::vector<evmc_result> results(msgs.size());
+    std::vector<std::vector<size_t>> waiting;  // The suspended executions by load index.
+
+    const auto run = [&](size_t i) noexcept {
+        if (evm_run_execution(executions[i], &results[i]) == EVM_EXECUTION_DONE)
+        {
+            evm_destroy_execution(executions[i]);
+            return;
+        }
+        if (waiting.size() <= m_last_load)
+            waiting.resize(m_last_load + 1);
+        waiting[m_last_load].push_back(i);
+    };
+
+    for (size_t i = 0; i < msgs.size(); ++i)
+    {
+        if (const auto* account = m_state.find(msgs[i].code_address); account != nullptr)
+            codes[i] = account->code;
+        const auto code = codes[i] != nullptr ? bytes_view{*codes[i]} : bytes_view{};
+        executions[i] = evm_create_execution(
+            m_vm, &get_interface(), to_context(), m_rev, &msgs[i], code.data(), code.size());
+        if (executions[i] == nullptr)
+        {
+            results[i] = {};
+            results[i].status_code = EVMC_REJECTED;
+            continue;
+        }
+        run(i);
+    }
+
+    while (has_pending_loads())
+    {
+        const auto load_index = complete_next_load();
+        if (load_index >= waiting.size())
+            continue;
+        const auto ready = std::move(waiting[load_index]);
+        for (const auto i : ready)
+            run(i);
+    }
+
+    std::vector<evmc::Result> output;
+    output.reserve(results.size());
+    for (const auto& result : results)
+        output.emplace_back(result);
+    return output;
+}
+
+bool LatentHost::account_exists(const evmc::address& addr) const noexcept
+{
+    load(addr);
+    return Host::account_exists(addr);
+}
+
+evmc::bytes32 LatentHost::get_storage(
+    const evmc::address& addr, const evmc::bytes32& key) const noexcept
+{
+    load(addr, &key);
+    return Host::get_storage(addr, key);
+}
+
+evmc_storage_status LatentHost::set_storage(
+    const evmc::address& addr, const evmc::bytes32& key, const evmc::bytes32& value) noexcept
+{
+    load(addr, &key);
+    return Host::set_storage(addr, key, value);
+}
+
+evmc::uint256be LatentHost::get_balance(const evmc::address& addr) const noexcept
+{
+    load(addr);
+    return Host::get_balance(addr);
+}
+
+size_t LatentHost::get_code_size(const evmc::address& addr) const noexcept
+{
+    load(addr);
+    return Host::get_code_size(addr);
+}
+
+evmc::bytes32 LatentHost::get_code_hash(const evmc::address& addr) const noexcept
+{
+    load(addr);
+    return Host::get_code_hash(addr);
+}
+
+size_t LatentHost::copy_code(const evmc::address& addr, size_t code_offset, uint8_t* buffer_data,
+    size_t buffer_size) const noexcept
+{
+    load(addr);
+    return Host::copy_code(addr, code_offset, buffer_data, buffer_size);
+}
+}  // namespace evm::test
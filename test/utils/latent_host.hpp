@@ -0,0 +1,92 @@
+#pragma once
+
+#include <evm/evm.h>
+#include <state/host.hpp>
+#include <chrono>
+#include <vector>
+
+namespace evm::test
+{
+/// A Host simulating the latency of loading the state from storage, to measure the
+/// throughput of suspendable executions (evm_create_execution()) against blocking ones.
+///
+/// Accounts and storage slots start unloaded. request_state() of an unloaded item starts
+/// a load completing after the latency and returns false. Synchronous accesses of unloaded
+/// items, e.g. by executions which cannot be suspended, block the thread for the latency.
+class LatentHost : public state::Host
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// The host extensions with request_state(), to be installed in the VM.
+    static const evm_host_extensions extensions;
+
+private:
+    static constexpr int64_t unloaded = 0;
+    static constexpr int64_t loaded = -1;
+
+    struct Load
+    {
+        Clock::time_point ready_time;
+        evmc::address addr;
+        std::optional<evmc::bytes32> key;
+    };
+
+    Clock::duration m_latency;
+
+    /// The load status of the items: unloaded, loaded or the index + 1 of the pending load.
+    mutable FlatHashMap<evmc::address, int64_t, AddressHash> m_accounts;
+    mutable FlatHashMap<StorageKey, int64_t, StorageKeyHash> m_slots;
+
+    std::vector<Load> m_loads;
+    size_t m_next_load = 0;
+    size_t m_last_load = 0;
+    mutable size_t m_num_blocking_loads = 0;
+
+    int64_t& load_status(const evmc::address& addr, const evmc::bytes32* key) const noexcept;
+
+    /// Blocks until the item is loaded.
+    void load(const evmc::address& addr, const evmc::bytes32* key = nullptr) const noexcept;
+
+public:
+    LatentHost(evmc_vm* vm, state::State& state, evmc_revision rev, const evmc_tx_context& tx_context,
+        Clock::duration latency) noexcept
+      : Host{vm, state, rev, tx_context}, m_latency{latency}
+    {}
+
+    bool request_state(evm_state_kind kind, const evmc::address& addr,
+        const evmc::bytes32* key) noexcept;
+
+    /// The index of the load requested by the last request_state() returning false.
+    [[nodiscard]] size_t last_load() const noexcept { return m_last_load; }
+
+    [[nodiscard]] bool has_pending_loads() const noexcept { return m_next_load < m_loads.size(); }
+
+    /// The number of synchronous accesses which blocked the thread on an unloaded item.
+    [[nodiscard]] size_t num_blocking_loads() const noexcept { return m_num_blocking_loads; }
+
+    /// Waits for the next pending load to complete and returns its index.
+    size_t complete_next_load() noexcept;
+
+    /// Executes the call messages as suspendable executions interleaved on the calling thread,
+    /// resuming each one when its load completes. The VM must have the extensions installed.
+    std::vector<evmc::Result> execute_interleaved(const std::vector<evmc_message>& msgs) noexcept;
+
+    bool account_exists(const evmc::address& addr) const noexcept override;
+
+    evmc::bytes32 get_storage(
+        const evmc::address& addr, const evmc::bytes32& key) const noexcept override;
+
+    evmc_storage_status set_storage(const evmc::address& addr, const evmc::bytes32& key,
+        const evmc::bytes32& value) noexcept override;
+
+    evmc::uint256be get_balance(const evmc::address& addr) const noexcept override;
+
+    size_t get_code_size(const evmc::address& addr) const noexcept override;
+
+    evmc::bytes32 get_code_hash(const evmc::address& addr) const noexcept override;
+
+    size_t copy_code(const evmc::address& addr, size_t code_offset, uint8_t* buffer_data,
+        size_t buffer_size) const noexcept override;
+};
+}  // namespace evm::test
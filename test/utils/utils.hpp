@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace evm::test
+{
+using bytes = std::basic_string<uint8_t>;
+using bytes_view = std::basic_string_view<uint8_t>;
+
+/// Decodes a hex string, optionally 0x-prefixed. Whitespace is ignored so that bytecode can
+/// be written one instruction at a time. Aborts on invalid input.
+inline bytes from_hex(std::string_view hex)
+{
+    if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X'))
+        hex.remove_prefix(2);
+
+    const auto nibble = [](char c) noexcept -> int {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        std::abort();
+    };
+
+    bytes out;
+    int hi = -1;
+    for (const auto c : hex)
+    {
+        if (c == ' ' || c == '\n' || c == '\t')
+            continue;
+        if (hi < 0)
+            hi = nibble(c);
+        else
+        {
+            out.push_back(static_cast<uint8_t>((hi << 4) | nibble(c)));
+            hi = -1;
+        }
+    }
+    if (hi >= 0)
+        std::abort();
+    return out;
+}
+
+inline std::string to_hex(bytes_view data)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(data.size() * 2);
+    for (const auto b : data)
+    {
+        hex.push_back(digits[b >> 4]);
+        hex.push_back(digits[b & 0xf]);
+    }
+    return hex;
+}
+
+inline namespace literals
+{
+inline bytes operator""_hex(const char* s, size_t size)
+{
+    return from_hex({s, size});
+}
+}  // namespace literals
+}  // namespace evm::test